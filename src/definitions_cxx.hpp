@@ -916,6 +916,8 @@ enum StealableQueue {
 	STEALABLE_QUEUE_NO_SONG_AUDIO_FILE_OBJECTS,
 	STEALABLE_QUEUE_CURRENT_SONG_SAMPLE_DATA,
 	STEALABLE_QUEUE_CURRENT_SONG_SAMPLE_DATA_CONVERTED,
+	STEALABLE_QUEUE_CURRENT_SONG_SAMPLE_DATA_PROTECTED, // Loaded again soon after being stolen, or about to be played
+	STEALABLE_QUEUE_CURRENT_SONG_SAMPLE_DATA_PROTECTED_CONVERTED,
 	STEALABLE_QUEUE_CURRENT_SONG_SAMPLE_DATA_REPITCHED_CACHE,
 	STEALABLE_QUEUE_CURRENT_SONG_SAMPLE_DATA_PERC_CACHE, // This one is super valuable and compacted data - lots of work
 	                                                     // to load it all again
@@ -1005,6 +1007,7 @@ enum class IndependentNoteRowLengthIncrease {
 };
 
 // From FatFS - we need access to this:
+constexpr int32_t DIR_ModTime = 22 /* Modified time (DWORD) */;
 constexpr int32_t DIR_FileSize = 28 /* File size (DWORD) */;
 
 constexpr int32_t kMaxNumUnsignedIntegerstoRepAllParams = 2;
@@ -49,6 +49,7 @@
 #include "model/clip/instrument_clip.h"
 #include "model/clip/instrument_clip_minder.h"
 #include "model/output.h"
+#include "model/sample/sample_peak_pyramid.h"
 #include "model/settings/runtime_feature_settings.h"
 #include "model/song/song.h"
 #include "modulation/params/param_manager.h"
@@ -57,7 +58,10 @@
 #include "processing/engines/audio_engine.h"
 #include "processing/engines/cv_engine.h"
 #include "storage/audio/audio_file_manager.h"
+#include "storage/audio/cluster_prefetcher.h"
+#include "storage/cluster/compressed_cluster.h"
 #include "storage/flash_storage.h"
+#include "storage/song_autosaver.h"
 #include "storage/storage_manager.h"
 #include "util/misc.h"
 #include "util/pack.h"
@@ -797,6 +801,11 @@ extern "C" int32_t deluge_main(void) {
 
 		audioRecorder.slowRoutine();
 
+		SamplePeakPyramid::buildRoutine();
+		clusterPrefetcher.routine();
+		CompressedCluster::compressionRoutine();
+		songAutosaver.routine();
+
 #if AUTOPILOT_TEST_ENABLED
 		autoPilotStuff();
 #endif
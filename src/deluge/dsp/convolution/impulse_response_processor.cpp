@@ -16,6 +16,7 @@
  */
 
 #include "dsp/convolution/impulse_response_processor.h"
+#include "dsp/q31_lanes.h"
 
 const int32_t ir[IR_SIZE] = {
     -3203916,   8857848,   24813136,  41537808, 35217472,  15195632,  -27538592, -61984128, 1944654848,
@@ -26,3 +27,23 @@ const int32_t ir[IR_SIZE] = {
 ImpulseResponseProcessor::ImpulseResponseProcessor() {
 	memset(buffer, 0, sizeof(buffer));
 }
+
+// Every tap is even, so halving it beforehand makes the doubling multiply come out exactly as
+// multiply_32x32_rshift32_rounded() does
+void ImpulseResponseProcessor::processBlock(q31_t* samples, q31_t* samplesEnd) {
+	using deluge::dsp::Q31x2;
+
+	for (q31_t* pos = samples; pos != samplesEnd; pos += 2) {
+		Q31x2 input = Q31x2::load(pos);
+
+		(Q31x2::load(&buffer[0].l) + Q31x2::mulDoubledHighRounded(input, Q31x2::broadcast(ir[0] >> 1))).store(pos);
+
+		for (int32_t i = 1; i != IR_BUFFER_SIZE; i++) {
+			(Q31x2::load(&buffer[i].l) + Q31x2::mulDoubledHighRounded(input, Q31x2::broadcast(ir[i] >> 1)))
+			    .store(&buffer[i - 1].l);
+		}
+
+		Q31x2::mulDoubledHighRounded(input, Q31x2::broadcast(ir[IR_BUFFER_SIZE] >> 1))
+		    .store(&buffer[IR_BUFFER_SIZE - 1].l);
+	}
+}
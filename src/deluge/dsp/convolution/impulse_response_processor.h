@@ -45,4 +45,7 @@ public:
 		buffer[IR_BUFFER_SIZE - 1].l = multiply_32x32_rshift32_rounded(inputL, ir[IR_BUFFER_SIZE]);
 		buffer[IR_BUFFER_SIZE - 1].r = multiply_32x32_rshift32_rounded(inputR, ir[IR_BUFFER_SIZE]);
 	}
+
+	// Does process() on a whole interleaved L, R buffer, in place, with L and R side by side in SIMD lanes
+	void processBlock(q31_t* samples, q31_t* samplesEnd);
 };
@@ -0,0 +1,243 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "dsp/convolution/partitioned_convolver.h"
+#include "definitions_cxx.hpp"
+#include "dsp/fft/fft_config_manager.h"
+#include "mem_functions.h"
+#include "memory/memory_allocator_interface.h"
+#include "util/functions.h"
+#include <algorithm>
+#include <cstdlib>
+
+namespace deluge::dsp {
+
+int32_t PartitionedConvolver::init(int32_t newBlockSizeMagnitude, int32_t maxImpulseLength, int32_t newNumOutputs) {
+	deallocate();
+
+	// The FFT is twice the block size
+	fftConfig = FFTConfigManager::getConfig(newBlockSizeMagnitude + 1);
+	if (!fftConfig) {
+		return ERROR_INSUFFICIENT_RAM;
+	}
+
+	blockSizeMagnitude = newBlockSizeMagnitude;
+	blockSize = 1 << blockSizeMagnitude;
+	numBins = blockSize + 1;
+	maxNumPartitions = std::max<int32_t>(1, (maxImpulseLength + blockSize - 1) >> blockSizeMagnitude);
+	numOutputs = std::clamp<int32_t>(newNumOutputs, 1, kMaxNumOutputs);
+
+	uint32_t spectrumSize = numBins * sizeof(ne10_fft_cpx_int32_t);
+
+	partitionSpectra = (ne10_fft_cpx_int32_t*)allocLowSpeed(spectrumSize * maxNumPartitions * numOutputs);
+	inputSpectra = (ne10_fft_cpx_int32_t*)allocLowSpeed(spectrumSize * maxNumPartitions);
+
+	uint32_t workingSize =
+	    (blockSize * (4 + numOutputs)) * sizeof(q31_t) + spectrumSize + numOutputs * numBins * 2 * sizeof(int64_t);
+	workingMemory = (q31_t*)allocMaxSpeed(workingSize);
+
+	if (!partitionSpectra || !inputSpectra || !workingMemory) {
+		deallocate();
+		return ERROR_INSUFFICIENT_RAM;
+	}
+
+	fftInput = workingMemory;
+	previousInputBlock = fftInput + blockSize * 2;
+	currentInputBlock = previousInputBlock + blockSize;
+	q31_t* pos = currentInputBlock + blockSize;
+	for (int32_t o = 0; o < numOutputs; o++) {
+		outputBlocks[o] = pos;
+		pos += blockSize;
+	}
+	int64_t* pos64 = (int64_t*)pos;
+	for (int32_t o = 0; o < numOutputs; o++) {
+		tailSpectra64[o] = pos64;
+		pos64 += numBins * 2;
+	}
+	summedSpectrum = (ne10_fft_cpx_int32_t*)pos64;
+
+	memset(partitionSpectra, 0, spectrumSize * maxNumPartitions * numOutputs);
+	numPartitions = 1;
+	spectrumShift = 0;
+	clear();
+	initialized = true;
+	return NO_ERROR;
+}
+
+void PartitionedConvolver::deallocate() {
+	initialized = false;
+	if (partitionSpectra) {
+		delugeDealloc(partitionSpectra);
+		partitionSpectra = nullptr;
+	}
+	if (inputSpectra) {
+		delugeDealloc(inputSpectra);
+		inputSpectra = nullptr;
+	}
+	if (workingMemory) {
+		delugeDealloc(workingMemory);
+		workingMemory = nullptr;
+	}
+	fftInput = nullptr;
+	previousInputBlock = nullptr;
+	currentInputBlock = nullptr;
+	summedSpectrum = nullptr;
+	for (int32_t o = 0; o < kMaxNumOutputs; o++) {
+		outputBlocks[o] = nullptr;
+		tailSpectra64[o] = nullptr;
+	}
+}
+
+void PartitionedConvolver::clear() {
+	memset(inputSpectra, 0, numBins * sizeof(ne10_fft_cpx_int32_t) * maxNumPartitions);
+	memset(previousInputBlock, 0, blockSize * sizeof(q31_t));
+	memset(currentInputBlock, 0, blockSize * sizeof(q31_t));
+	for (int32_t o = 0; o < numOutputs; o++) {
+		memset(outputBlocks[o], 0, blockSize * sizeof(q31_t));
+		memset(tailSpectra64[o], 0, numBins * 2 * sizeof(int64_t));
+	}
+	blockPos = 0;
+	newestInputSpectrum = 0;
+	numTailProductsDone = 0;
+}
+
+// Zero-padded to twice its length, as overlap-save needs
+void PartitionedConvolver::transformPartition(q31_t const* samples, int32_t numSamples,
+                                              ne10_fft_cpx_int32_t* destination) {
+	memcpy(fftInput, samples, numSamples * sizeof(q31_t));
+	memset(&fftInput[numSamples], 0, (blockSize * 2 - numSamples) * sizeof(q31_t));
+	ne10_fft_r2c_1d_int32_neon(destination, fftInput, fftConfig, true);
+}
+
+void PartitionedConvolver::setImpulseResponse(std::span<q31_t const> left, std::span<q31_t const> right) {
+	std::span<q31_t const> impulses[kMaxNumOutputs] = {left, right};
+
+	int32_t length = 0;
+	for (int32_t o = 0; o < numOutputs; o++) {
+		length = std::max<int32_t>(length, impulses[o].size());
+	}
+	numPartitions = std::clamp<int32_t>((length + blockSize - 1) >> blockSizeMagnitude, 1, maxNumPartitions);
+
+	uint32_t biggestValue = 0;
+	for (int32_t o = 0; o < numOutputs; o++) {
+		std::span<q31_t const> impulse = impulses[o];
+		for (int32_t p = 0; p < numPartitions; p++) {
+			int32_t start = p << blockSizeMagnitude;
+			int32_t numSamples = std::clamp<int32_t>((int32_t)impulse.size() - start, 0, blockSize);
+			ne10_fft_cpx_int32_t* spectrum = getPartitionSpectrum(o, p);
+			transformPartition(impulse.data() + start, numSamples, spectrum);
+			for (int32_t b = 0; b < numBins; b++) {
+				biggestValue = std::max<uint32_t>(biggestValue, std::abs(spectrum[b].r));
+				biggestValue = std::max<uint32_t>(biggestValue, std::abs(spectrum[b].i));
+			}
+		}
+	}
+
+	// The scaled FFT divided everything by its length, so there's normally lots of headroom to take back. Leave one
+	// bit spare, for the complex multiply's sums
+	spectrumShift = biggestValue ? std::max<int32_t>(0, clz(biggestValue) - 2) : 0;
+	if (spectrumShift) {
+		for (int32_t o = 0; o < numOutputs; o++) {
+			ne10_fft_cpx_int32_t* spectrum = getPartitionSpectrum(o, 0);
+			for (int32_t b = 0; b < numPartitions * numBins; b++) {
+				spectrum[b].r <<= spectrumShift;
+				spectrum[b].i <<= spectrumShift;
+			}
+		}
+	}
+
+	clear();
+}
+
+void PartitionedConvolver::multiplyAccumulate(int64_t* __restrict__ sum, ne10_fft_cpx_int32_t const* __restrict__ in,
+                                              ne10_fft_cpx_int32_t const* __restrict__ h) {
+	for (int32_t b = 0; b < numBins; b++) {
+		sum[0] += (int64_t)in[b].r * h[b].r - (int64_t)in[b].i * h[b].i;
+		sum[1] += (int64_t)in[b].r * h[b].i + (int64_t)in[b].i * h[b].r;
+		sum += 2;
+	}
+}
+
+// Sums partitions 1 onwards into tailSpectra64, ready for the block currently coming in - as big a share of them as
+// the share of that block which has come in so far
+void PartitionedConvolver::accumulateTail(int32_t blockPosReached) {
+	int32_t numTailPartitions = numPartitions - 1;
+	int32_t numTailProducts = numOutputs * numTailPartitions;
+	int32_t numToHaveDone = (numTailProducts * blockPosReached + blockSize - 1) >> blockSizeMagnitude;
+
+	for (; numTailProductsDone < numToHaveDone; numTailProductsDone++) {
+		int32_t o = numTailProductsDone / numTailPartitions;
+		int32_t p = numTailProductsDone - o * numTailPartitions + 1;
+
+		// The newest input spectrum is from the block before the one coming in, so it goes with partition 1
+		int32_t inputIndex = newestInputSpectrum + p - 1;
+		if (inputIndex >= numPartitions) {
+			inputIndex -= numPartitions;
+		}
+		multiplyAccumulate(tailSpectra64[o], &inputSpectra[inputIndex * numBins], getPartitionSpectrum(o, p));
+	}
+}
+
+void PartitionedConvolver::processBlock() {
+	// Finish off anything the calls to process() didn't get round to
+	accumulateTail(blockSize);
+
+	// Overlap-save: transform the last two blocks of input, and the second half of what comes back out is valid
+	memcpy(fftInput, previousInputBlock, blockSize * sizeof(q31_t));
+	memcpy(&fftInput[blockSize], currentInputBlock, blockSize * sizeof(q31_t));
+	std::swap(previousInputBlock, currentInputBlock);
+
+	// The delay line runs backwards, so the input from p blocks ago is always p spectra after the newest
+	newestInputSpectrum = (newestInputSpectrum ? newestInputSpectrum : numPartitions) - 1;
+	ne10_fft_cpx_int32_t* newestSpectrum = &inputSpectra[newestInputSpectrum * numBins];
+	ne10_fft_r2c_1d_int32_neon(newestSpectrum, fftInput, fftConfig, true);
+
+	// Both FFTs divided by their length, the inverse one will too, and multiplying Q31s lost a bit.
+	// Take that all back, less the spectra's extra headroom
+	int32_t outputShift = (blockSizeMagnitude + 1) * 2 + 1 - spectrumShift;
+
+	for (int32_t o = 0; o < numOutputs; o++) {
+		// Everything but the first partition has already been summed
+		int64_t* summedSpectrum64 = tailSpectra64[o];
+		multiplyAccumulate(summedSpectrum64, newestSpectrum, getPartitionSpectrum(o, 0));
+
+		for (int32_t b = 0; b < numBins; b++) {
+			summedSpectrum[b].r = std::clamp<int64_t>(summedSpectrum64[b * 2] >> 32, INT32_MIN, INT32_MAX);
+			summedSpectrum[b].i = std::clamp<int64_t>(summedSpectrum64[b * 2 + 1] >> 32, INT32_MIN, INT32_MAX);
+		}
+
+		// And start summing afresh for the next block
+		memset(summedSpectrum64, 0, numBins * 2 * sizeof(int64_t));
+
+		ne10_fft_c2r_1d_int32_neon(fftInput, summedSpectrum, fftConfig, true);
+
+		q31_t const* valid = &fftInput[blockSize];
+		if (outputShift > 0) {
+			for (int32_t i = 0; i < blockSize; i++) {
+				outputBlocks[o][i] = lshiftAndSaturateUnknown(valid[i], outputShift);
+			}
+		}
+		else {
+			for (int32_t i = 0; i < blockSize; i++) {
+				outputBlocks[o][i] = valid[i] >> -outputShift;
+			}
+		}
+	}
+	numTailProductsDone = 0;
+}
+
+} // namespace deluge::dsp
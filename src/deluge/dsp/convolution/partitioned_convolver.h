@@ -0,0 +1,131 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "NE10.h"
+#include "util/fixedpoint.h"
+#include <cstdint>
+#include <span>
+
+namespace deluge::dsp {
+
+/*
+ * Convolves one input with up to two long impulse responses (normally the left and right of a stereo IR), using
+ * uniformly partitioned overlap-save FFT convolution.
+ *
+ * The impulse response is cut into partitions of blockSize samples, and each one is transformed once, up front. Input
+ * is gathered a block at a time; each full block gets transformed and stored in a frequency-domain delay line, and the
+ * output block is the inverse transform of the sum of (delayed input spectrum x partition spectrum) over all
+ * partitions. So per sample, the cost is two FFTs of 2 x blockSize, amortised over the block, plus one complex
+ * multiply per partition - rather than one multiply per tap.
+ *
+ * Only the first partition needs the block that's just come in - all the others use older input. So those get
+ * multiplied and summed a few at a time as the next block's input comes in, spread evenly across however many calls
+ * to process() that takes, and the block boundary only has the two FFTs and one partition's worth of multiplies left.
+ *
+ * Output comes out blockSize samples late, which is fine for a reverb.
+ *
+ * Everything's Q31. The partition spectra get scaled up to use the headroom the FFT's scaling leaves behind, and the
+ * products are summed at 64 bits, so long IRs don't lose their tails in the bottom bits.
+ */
+class PartitionedConvolver {
+public:
+	static constexpr int32_t kMaxNumOutputs = 2;
+
+	PartitionedConvolver() = default;
+	~PartitionedConvolver() { deallocate(); }
+	PartitionedConvolver(PartitionedConvolver const&) = delete;
+	PartitionedConvolver& operator=(PartitionedConvolver const&) = delete;
+
+	// Allocates everything for impulse responses up to maxImpulseLength long. Returns error status
+	int32_t init(int32_t blockSizeMagnitude, int32_t maxImpulseLength, int32_t newNumOutputs);
+	void deallocate();
+
+	// Transforms and stores the impulse responses - right is ignored if there's only one output. Anything past the
+	// maxImpulseLength given to init() gets cut off. Also clears the input history
+	void setImpulseResponse(std::span<q31_t const> left, std::span<q31_t const> right);
+
+	// Clears the input history, so nothing from before rings on
+	void clear();
+
+	// Only once init() has got everything allocated and set up
+	[[nodiscard]] bool isActive() const { return initialized; }
+	[[nodiscard]] int32_t getBlockSize() const { return blockSize; }
+	[[nodiscard]] int32_t getNumOutputs() const { return numOutputs; }
+
+	// Feeds input through, calling emit(frame, left, right) for each frame of output. With only one output, left and
+	// right are the same
+	template <typename EmitFunction>
+	void process(std::span<q31_t const> input, EmitFunction&& emit) {
+		q31_t const* right = outputBlocks[(numOutputs > 1) ? 1 : 0];
+		for (size_t frame = 0; frame < input.size(); frame++) {
+			currentInputBlock[blockPos] = input[frame];
+			emit(frame, outputBlocks[0][blockPos], right[blockPos]);
+			if (++blockPos == blockSize) {
+				processBlock();
+				blockPos = 0;
+			}
+		}
+		accumulateTail(blockPos);
+	}
+
+private:
+	void processBlock();
+	void accumulateTail(int32_t blockPosReached);
+	void multiplyAccumulate(int64_t* __restrict__ sum, ne10_fft_cpx_int32_t const* __restrict__ in,
+	                        ne10_fft_cpx_int32_t const* __restrict__ h);
+	void transformPartition(q31_t const* samples, int32_t numSamples, ne10_fft_cpx_int32_t* destination);
+	ne10_fft_cpx_int32_t* getPartitionSpectrum(int32_t output, int32_t partition) {
+		return &partitionSpectra[(output * maxNumPartitions + partition) * numBins];
+	}
+
+	ne10_fft_r2c_cfg_int32_t fftConfig = nullptr;
+	int32_t blockSize = 0;
+	int32_t blockSizeMagnitude = 0;
+	int32_t numBins = 0;
+	int32_t maxNumPartitions = 0;
+	int32_t numPartitions = 0; // Just enough for the current impulse response
+	int32_t numOutputs = 0;
+	int32_t blockPos = 0;
+	bool initialized = false;
+
+	// How many (output, partition) products have been summed into tailSpectra64 so far for the next block, out of
+	// numOutputs x (numPartitions - 1)
+	int32_t numTailProductsDone = 0;
+
+	// Partition spectra are scaled up by this many bits
+	int32_t spectrumShift = 0;
+
+	// [output][partition][bin] - in slow RAM, since it's big and only gets streamed through once per block
+	ne10_fft_cpx_int32_t* partitionSpectra = nullptr;
+
+	// [partition][bin], with newestInputSpectrum the most recent block. Also in slow RAM
+	ne10_fft_cpx_int32_t* inputSpectra = nullptr;
+	int32_t newestInputSpectrum = 0;
+
+	// The rest, in fast RAM
+	q31_t* workingMemory = nullptr;
+	q31_t* fftInput = nullptr;                          // 2 x blockSize
+	q31_t* previousInputBlock = nullptr;                // blockSize
+	q31_t* currentInputBlock = nullptr;                 // blockSize
+	q31_t* outputBlocks[kMaxNumOutputs] = {nullptr};    // blockSize each
+	ne10_fft_cpx_int32_t* summedSpectrum = nullptr;     // numBins
+	int64_t* tailSpectra64[kMaxNumOutputs] = {nullptr}; // numBins x 2 each - partitions 1 onwards, summed ahead
+};
+
+} // namespace deluge::dsp
@@ -19,6 +19,7 @@
 #include "dsp/stereo_sample.h"
 #include "mem_functions.h"
 #include "memory/memory_allocator_interface.h"
+#include <algorithm>
 #include <cmath>
 
 DelayBuffer::DelayBuffer() {
@@ -99,6 +100,56 @@ void DelayBuffer::discard() {
 	}
 }
 
+// Same as calling moveOn() (or clearAndMoveOn(), if clearBehind) numSamples times, copying out each new position as we
+// go - but done with memcpy() / memset() a run at a time, rather than a sample at a time. Returns whether we wrapped
+bool DelayBuffer::moveOnAndRead(StereoSample* destination, int32_t numSamples, bool clearBehind) {
+	// If the buffer's so short we'd go round it more than once, what we read depends on what we've just cleared
+	if (bufferEnd - bufferStart <= numSamples) {
+		bool wrapped = false;
+		for (int32_t i = 0; i < numSamples; i++) {
+			wrapped = (clearBehind ? clearAndMoveOn() : moveOn()) || wrapped;
+			destination[i] = *bufferCurrentPos;
+		}
+		return wrapped;
+	}
+
+	StereoSample* clearPos = bufferCurrentPos;
+
+	bool wrapped = false;
+	StereoSample* readPos = bufferCurrentPos + 1;
+	int32_t numLeft = numSamples;
+	while (true) {
+		if (readPos == bufferEnd) {
+			readPos = bufferStart;
+			wrapped = true;
+		}
+		int32_t numThisRun = std::min<int32_t>(numLeft, bufferEnd - readPos);
+		memcpy(destination, readPos, numThisRun * sizeof(StereoSample));
+		destination += numThisRun;
+		readPos += numThisRun;
+		numLeft -= numThisRun;
+		if (!numLeft) {
+			break;
+		}
+	}
+	bufferCurrentPos = readPos - 1;
+
+	if (clearBehind) {
+		numLeft = numSamples;
+		while (true) {
+			int32_t numThisRun = std::min<int32_t>(numLeft, bufferEnd - clearPos);
+			memset(clearPos, 0, numThisRun * sizeof(StereoSample));
+			numLeft -= numThisRun;
+			if (!numLeft) {
+				break;
+			}
+			clearPos = bufferStart;
+		}
+	}
+
+	return wrapped;
+}
+
 void DelayBuffer::setupForRender(int32_t userDelayRate, DelayBufferSetup* setup) {
 	if (userDelayRate != nativeRate) {
 		if (!isResampling && bufferStart != 0) {
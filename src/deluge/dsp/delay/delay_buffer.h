@@ -55,6 +55,8 @@ public:
 		return moveOn();
 	}
 
+	bool moveOnAndRead(StereoSample* destination, int32_t numSamples, bool clearBehind);
+
 	inline bool moveOn() {
 		bool wrapped = (++bufferCurrentPos == bufferEnd);
 		if (wrapped)
@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include "dsp/q31_lanes.h"
 #include "util/fixedpoint.h"
 #include <cstdint>
 namespace deluge::dsp::filter {
@@ -48,4 +49,19 @@ public:
 
 	q31_t memory = 0;
 };
+
+// BasicFilterComponent for two channels at once, with their memories held in lanes. Gives exactly what doFilter() and
+// doAPF() do
+[[gnu::always_inline]] inline Q31x2 doFilterLanes(Q31x2 input, Q31x2& memory, Q31x2 moveability) {
+	Q31x2 a = Q31x2::mulHighRounded(input - memory, moveability).shiftLeft<1>();
+	Q31x2 b = a + memory;
+	memory = b + a;
+	return b;
+}
+[[gnu::always_inline]] inline Q31x2 doAPFLanes(Q31x2 input, Q31x2& memory, Q31x2 moveability) {
+	Q31x2 a = Q31x2::mulHighRounded(input - memory, moveability).shiftLeft<1>();
+	Q31x2 b = a + memory;
+	memory = a + b;
+	return b.shiftLeft<1>() - input;
+}
 } // namespace deluge::dsp::filter
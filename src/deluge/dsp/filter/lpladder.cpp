@@ -239,27 +239,24 @@ void LpLadderFilter::doFilterStereo(q31_t* startSample, q31_t* endSample) {
 
 	// Half ladder
 	if (lpfMode == FilterMode::TRANSISTOR_12DB) {
-
+		LpLadderLanes lanes = loadLanes();
 		q31_t* currentSample = startSample;
 		do {
-			*currentSample = do12dBLPFOnSample(*currentSample, l);
-			currentSample += 1;
-			*currentSample = do12dBLPFOnSample(*currentSample, r);
-			currentSample += 1;
+			do12dBLPFOnLanes(Q31x2::load(currentSample), lanes).store(currentSample);
+			currentSample += 2;
 		} while (currentSample < endSample);
+		storeLanes(lanes);
 	}
 
 	// Full ladder (regular)
 	else if (lpfMode == FilterMode::TRANSISTOR_24DB) {
+		LpLadderLanes lanes = loadLanes();
 		q31_t* currentSample = startSample;
 		do {
-			*currentSample = do24dBLPFOnSample(*currentSample, l);
-
-			currentSample += 1;
-			*currentSample = do24dBLPFOnSample(*currentSample, r);
-
-			currentSample += 1;
+			do24dBLPFOnLanes(Q31x2::load(currentSample), lanes).store(currentSample);
+			currentSample += 2;
 		} while (currentSample < endSample);
+		storeLanes(lanes);
 	}
 
 	// Full ladder (drive)
@@ -320,6 +317,105 @@ void LpLadderFilter::doFilterStereo(q31_t* startSample, q31_t* endSample) {
 		}
 	}
 }
+void LpLadderFilter::doFilterStereoScalar(q31_t* startSample, q31_t* endSample) {
+	if (lpfMode == FilterMode::TRANSISTOR_12DB) {
+		q31_t* currentSample = startSample;
+		do {
+			currentSample[0] = do12dBLPFOnSample(currentSample[0], l);
+			currentSample[1] = do12dBLPFOnSample(currentSample[1], r);
+			currentSample += 2;
+		} while (currentSample < endSample);
+	}
+	else if (lpfMode == FilterMode::TRANSISTOR_24DB) {
+		q31_t* currentSample = startSample;
+		do {
+			currentSample[0] = do24dBLPFOnSample(currentSample[0], l);
+			currentSample[1] = do24dBLPFOnSample(currentSample[1], r);
+			currentSample += 2;
+		} while (currentSample < endSample);
+	}
+	else {
+		// The drive ladder is one channel at a time already
+		doFilterStereo(startSample, endSample);
+	}
+}
+
+LpLadderFilter::LpLadderLanes LpLadderFilter::loadLanes() {
+	return {
+	    .noiseLastValue = Q31x2::fromLanes(l.noiseLastValue, r.noiseLastValue),
+	    .lpf1 = Q31x2::fromLanes(l.lpfLPF1.memory, r.lpfLPF1.memory),
+	    .lpf2 = Q31x2::fromLanes(l.lpfLPF2.memory, r.lpfLPF2.memory),
+	    .lpf3 = Q31x2::fromLanes(l.lpfLPF3.memory, r.lpfLPF3.memory),
+	    .lpf4 = Q31x2::fromLanes(l.lpfLPF4.memory, r.lpfLPF4.memory),
+	};
+}
+
+void LpLadderFilter::storeLanes(LpLadderLanes const& lanes) {
+	l.noiseLastValue = lanes.noiseLastValue.get<0>();
+	r.noiseLastValue = lanes.noiseLastValue.get<1>();
+	l.lpfLPF1.memory = lanes.lpf1.get<0>();
+	r.lpfLPF1.memory = lanes.lpf1.get<1>();
+	l.lpfLPF2.memory = lanes.lpf2.get<0>();
+	r.lpfLPF2.memory = lanes.lpf2.get<1>();
+	l.lpfLPF3.memory = lanes.lpf3.get<0>();
+	r.lpfLPF3.memory = lanes.lpf3.get<1>();
+	l.lpfLPF4.memory = lanes.lpf4.get<0>();
+	r.lpfLPF4.memory = lanes.lpf4.get<1>();
+}
+
+[[gnu::always_inline]] inline Q31x2 LpLadderFilter::getNoisyMoveabilityLanes(LpLadderLanes& lanes) {
+	// Separate statements so the noise is always drawn for L first, same as doing the channels one at a time
+	q31_t noiseL = getNoise() >> 2;
+	q31_t noiseR = getNoise() >> 2;
+	Q31x2 distanceToGo = Q31x2::fromLanes(noiseL, noiseR) - lanes.noiseLastValue;
+	lanes.noiseLastValue = lanes.noiseLastValue + distanceToGo.shiftRight<7>();
+	Q31x2 moveabilityLanes = Q31x2::broadcast(moveability);
+	return moveabilityLanes + Q31x2::mulHigh(moveabilityLanes, lanes.noiseLastValue);
+}
+
+[[gnu::always_inline]] inline Q31x2 LpLadderFilter::scaleInputLanes(Q31x2 input, Q31x2 feedbacksSum) {
+	Q31x2 feedback = Q31x2::mulHighRounded(feedbacksSum, Q31x2::broadcast(processedResonance)).shiftLeft<3>();
+	Q31x2 temp =
+	    Q31x2::mulHighRounded(input - feedback, Q31x2::broadcast(divideByTotalMoveabilityAndProcessedResonance))
+	        .shiftLeft<2>();
+	if (morph > 0 || processedResonance > 510000000) {
+		Q31x2 extra = Q31x2::mulHigh(input, Q31x2::broadcast(morph)).shiftLeft<1>();
+		temp = (temp + extra).tanH<2>();
+	}
+	return temp;
+}
+
+[[gnu::always_inline]] inline Q31x2 LpLadderFilter::do12dBLPFOnLanes(Q31x2 input, LpLadderLanes& lanes) {
+	Q31x2 noisyMoveability = getNoisyMoveabilityLanes(lanes);
+
+	// One shift for all three of getFeedbackOutput()'s - it's the same, wrapping included
+	Q31x2 feedbacksSum = (Q31x2::mulHighRounded(lanes.lpf1, Q31x2::broadcast(lpf1Feedback))
+	                      + Q31x2::mulHighRounded(lanes.lpf2, Q31x2::broadcast(lpf2Feedback))
+	                      + Q31x2::mulHighRounded(lanes.lpf3, Q31x2::broadcast(divideBy1PlusTannedFrequency)))
+	                         .shiftLeft<2>();
+	Q31x2 x = scaleInputLanes(input, feedbacksSum);
+
+	Q31x2 a = doFilterLanes(x, lanes.lpf1, noisyMoveability);
+	Q31x2 b = doFilterLanes(a, lanes.lpf2, noisyMoveability);
+	return doAPFLanes(b, lanes.lpf3, noisyMoveability).shiftLeft<1>();
+}
+
+[[gnu::always_inline]] inline Q31x2 LpLadderFilter::do24dBLPFOnLanes(Q31x2 input, LpLadderLanes& lanes) {
+	Q31x2 noisyMoveability = getNoisyMoveabilityLanes(lanes);
+
+	Q31x2 feedbacksSum = (Q31x2::mulHighRounded(lanes.lpf1, Q31x2::broadcast(lpf1Feedback))
+	                      + Q31x2::mulHighRounded(lanes.lpf2, Q31x2::broadcast(lpf2Feedback))
+	                      + Q31x2::mulHighRounded(lanes.lpf3, Q31x2::broadcast(lpf3Feedback))
+	                      + Q31x2::mulHighRounded(lanes.lpf4, Q31x2::broadcast(divideBy1PlusTannedFrequency)))
+	                         .shiftLeft<2>();
+	Q31x2 x = scaleInputLanes(input, feedbacksSum);
+
+	Q31x2 a = doFilterLanes(x, lanes.lpf1, noisyMoveability);
+	Q31x2 b = doFilterLanes(a, lanes.lpf2, noisyMoveability);
+	Q31x2 c = doFilterLanes(b, lanes.lpf3, noisyMoveability);
+	return doFilterLanes(c, lanes.lpf4, noisyMoveability).shiftLeft<1>();
+}
+
 [[gnu::always_inline]] inline q31_t LpLadderFilter::do12dBLPFOnSample(q31_t input, LpLadderState& state) {
 	// For drive filter, apply some heavily lowpassed noise to the filter frequency, to add analog-ness
 	q31_t noise = getNoise() >> 2; // storageManager.devVarA;// 2;
@@ -19,6 +19,7 @@
 
 #include "dsp/filter/filter.h"
 #include "dsp/filter/ladder_components.h"
+#include "dsp/q31_lanes.h"
 #include "util/fixedpoint.h"
 
 namespace deluge::dsp::filter {
@@ -30,6 +31,9 @@ public:
 	q31_t setConfig(q31_t hpfFrequency, q31_t hpfResonance, FilterMode lpfMode, q31_t lpfMorph, q31_t filterGain);
 	void doFilter(q31_t* outputSample, q31_t* endSample, int32_t sampleIncrememt);
 	void doFilterStereo(q31_t* startSample, q31_t* endSample);
+	// One channel at a time, the way doFilterStereo() used to. It has to give exactly the same samples, and the tests
+	// and benchmarks hold it to that
+	void doFilterStereoScalar(q31_t* startSample, q31_t* endSample);
 	void resetFilter() {
 		l.reset();
 		r.reset();
@@ -68,6 +72,21 @@ private:
 
 		return temp;
 	}
+	// l and r, side by side, for doFilterStereo()
+	struct LpLadderLanes {
+		Q31x2 noiseLastValue;
+		Q31x2 lpf1;
+		Q31x2 lpf2;
+		Q31x2 lpf3;
+		Q31x2 lpf4;
+	};
+	LpLadderLanes loadLanes();
+	void storeLanes(LpLadderLanes const& lanes);
+	[[gnu::always_inline]] inline Q31x2 getNoisyMoveabilityLanes(LpLadderLanes& lanes);
+	[[gnu::always_inline]] inline Q31x2 scaleInputLanes(Q31x2 input, Q31x2 feedbacksSum);
+	[[gnu::always_inline]] inline Q31x2 do24dBLPFOnLanes(Q31x2 input, LpLadderLanes& lanes);
+	[[gnu::always_inline]] inline Q31x2 do12dBLPFOnLanes(Q31x2 input, LpLadderLanes& lanes);
+
 	[[gnu::always_inline]] inline q31_t do24dBLPFOnSample(q31_t input, LpLadderState& state);
 	[[gnu::always_inline]] inline q31_t do12dBLPFOnSample(q31_t input, LpLadderState& state);
 	[[gnu::always_inline]] inline q31_t doDriveLPFOnSample(q31_t input, LpLadderState& state);
@@ -15,6 +15,7 @@
  * If not, see <https://www.gnu.org/licenses/>.
  */
 #include "dsp/filter/svf.h"
+#include "dsp/q31_lanes.h"
 
 namespace deluge::dsp::filter {
 void SVFilter::doFilter(q31_t* startSample, q31_t* endSample, int32_t sampleIncrememt) {
@@ -26,14 +27,69 @@ void SVFilter::doFilter(q31_t* startSample, q31_t* endSample, int32_t sampleIncr
 		currentSample += sampleIncrememt;
 	} while (currentSample < endSample);
 }
+// Same as doSVF(), but with L and R running side by side in the two lanes. Gives exactly the same samples as
+// doFilterStereoScalar()
 void SVFilter::doFilterStereo(q31_t* startSample, q31_t* endSample) {
+	Q31x2 low = Q31x2::fromLanes(l.low, r.low);
+	Q31x2 band = Q31x2::fromLanes(l.band, r.band);
+
+	// fc and q are never negative, so mulHighTimes2() is exact with them
+	Q31x2 fcLanes = Q31x2::broadcast(fc);
+	Q31x2 qLanes = Q31x2::broadcast(q);
+	Q31x2 inLanes = Q31x2::broadcast(in);
+	Q31x2 cLowLanes = Q31x2::broadcast(c_low);
+	Q31x2 cHighLanes = Q31x2::broadcast(c_high);
+	Q31x2 cBandLanes = Q31x2::broadcast(c_band);
+
 	q31_t* currentSample = startSample;
 	do {
-		q31_t outs = doSVF(*currentSample, l);
+		Q31x2 input = Q31x2::mulHigh(inLanes, Q31x2::load(currentSample));
+
+		low = low + Q31x2::mulHighTimes2(band, fcLanes);
+		Q31x2 high = input - low - Q31x2::mulHighTimes2(band, qLanes);
+		band = Q31x2::mulHighTimes2(high, fcLanes) + band;
+
+		// saturate band feedback
+		band = band.tanH<3>();
+
+		Q31x2 lowi = low;
+		Q31x2 highi = high;
+		Q31x2 bandi = band;
+		// double sample to increase the cutoff frequency
+		low = low + Q31x2::mulHighTimes2(band, fcLanes);
+		high = input - low - Q31x2::mulHighTimes2(band, qLanes);
+		band = Q31x2::mulHighTimes2(high, fcLanes) + band;
+
+		lowi = lowi + low;
+		highi = highi + high;
+		bandi = bandi + band;
+
+		Q31x2 result = Q31x2::mulHighRounded(lowi, cLowLanes) + Q31x2::mulHighRounded(highi, cHighLanes);
+		if (band_mode) {
+			result = result + Q31x2::mulHighRounded(bandi, cBandLanes);
+		}
+
+		// saturate band feedback
+		band = band.tanH<3>();
+
+		// compensate for division by two on each multiply, then multiply by 1.5 to match ladders
+		(result + result.shiftLeft<1>()).store(currentSample);
+
+		currentSample += 2;
+	} while (currentSample < endSample);
+
+	l.low = low.get<0>();
+	r.low = low.get<1>();
+	l.band = band.get<0>();
+	r.band = band.get<1>();
+}
+
+void SVFilter::doFilterStereoScalar(q31_t* startSample, q31_t* endSample) {
+	q31_t* currentSample = startSample;
+	do {
+		currentSample[0] = doSVF(currentSample[0], l);
+		currentSample[1] = doSVF(currentSample[1], r);
 
-		*currentSample = outs;
-		q31_t outs2 = doSVF(*(currentSample + 1), r);
-		*(currentSample + 1) = outs2;
 		currentSample += 2;
 	} while (currentSample < endSample);
 }
@@ -29,6 +29,9 @@ public:
 	q31_t setConfig(q31_t hpfFrequency, q31_t hpfResonance, FilterMode lpfMode, q31_t lpfMorph, q31_t filterGain);
 	void doFilter(q31_t* startSample, q31_t* endSample, int32_t sampleIncrememt);
 	void doFilterStereo(q31_t* startSample, q31_t* endSample);
+	// One channel at a time, the way doFilterStereo() used to. It has to give exactly the same samples, and the tests
+	// and benchmarks hold it to that
+	void doFilterStereoScalar(q31_t* startSample, q31_t* endSample);
 	void resetFilter() {
 		l = (SVFState){0, 0};
 		r = (SVFState){0, 0};
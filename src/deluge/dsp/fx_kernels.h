@@ -0,0 +1,93 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "dsp/q31_lanes.h"
+#include "dsp/stereo_sample.h"
+#include <cstdint>
+
+/*
+ * Block kernels for the per-sample loops in ModControllableAudio::processFX(), with L and R run side by side in a
+ * Q31x2. They work on the same interleaved L, R buffers those loops always have, and each one matches the scalar loop
+ * it replaced - exactly, except where noted. tests/unit/fx_kernels_tests.cpp holds the scalar versions to check
+ * against.
+ */
+
+namespace deluge::dsp::kernels {
+
+/// Scales what came out of the delay by the feedback amount, for the digital (non-analog) delay. Leaves more headroom
+/// than the analog one, because making it clip sounds bad with pure digital
+inline void applyDigitalDelayFeedback(q31_t* buffer, q31_t* bufferEnd, q31_t feedbackAmount) {
+	Q31x2 amount = Q31x2::broadcast(feedbackAmount);
+	for (q31_t* pos = buffer; pos != bufferEnd; pos += 2) {
+		// signed_saturate<32 - 3>(), then << 2
+		Q31x2 scaled = Q31x2::mulHigh(Q31x2::load(pos), amount);
+		Q31x2::clamp(scaled, -(1 << 28), (1 << 28) - 1).shiftLeft<2>().store(pos);
+	}
+}
+
+/// HPF on delay output, to stop it "farting out". Corner frequency is somewhere around 40Hz after many repetitions
+inline void applyDelayPostHPF(q31_t* buffer, q31_t* bufferEnd, q31_t& memoryL, q31_t& memoryR) {
+	Q31x2 memory = Q31x2::fromLanes(memoryL, memoryR);
+	for (q31_t* pos = buffer; pos != bufferEnd; pos += 2) {
+		Q31x2 input = Q31x2::load(pos);
+		memory = memory + (input - memory).shiftRight<11>();
+		(input - memory).store(pos);
+	}
+	memoryL = memory.get<0>();
+	memoryR = memory.get<1>();
+}
+
+/// Adds what came out of the delay to the audio, and replaces it in the working buffer with what's to be fed back in
+inline void mixDelayOutput(StereoSample* audio, q31_t* buffer, q31_t* bufferEnd, bool pingPong) {
+	for (q31_t* pos = buffer; pos != bufferEnd; pos += 2, audio++) {
+		Q31x2 fromDelay = Q31x2::load(pos);
+		Q31x2 dry = Q31x2::load(&audio->l);
+
+		if (pingPong) {
+			pos[0] = fromDelay.get<1>();
+			pos[1] = ((audio->l + audio->r) >> 1) + fromDelay.get<0>();
+		}
+		else {
+			(dry + fromDelay).store(pos);
+		}
+
+		(dry + fromDelay).store(&audio->l);
+	}
+}
+
+/// One sample through the phaser's chain of allpass filters, for both channels at once. The doubling multiplies make
+/// this differ from doing each channel with multiply_32x32_rshift32_rounded() by a few LSBs
+inline void doPhaserAllpasses(StereoSample& phaserMemory, StereoSample* allpassMemory, int32_t numAllpasses,
+                              q31_t a1) {
+	Q31x2 memory = Q31x2::load(&phaserMemory.l);
+	Q31x2 coefficient = Q31x2::broadcast(a1);
+	Q31x2 negativeCoefficient = Q31x2::broadcast(-a1);
+
+	for (int32_t i = 0; i < numAllpasses; i++) {
+		Q31x2 whatWasInput = memory;
+		Q31x2 allpass = Q31x2::load(&allpassMemory[i].l);
+
+		memory = Q31x2::mulDoubledHighRounded(memory, negativeCoefficient).shiftLeft<1>() + allpass;
+		(Q31x2::mulDoubledHighRounded(memory, coefficient).shiftLeft<1>() + whatWasInput).store(&allpassMemory[i].l);
+	}
+
+	memory.store(&phaserMemory.l);
+}
+
+} // namespace deluge::dsp::kernels
@@ -0,0 +1,196 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "util/fixedpoint.h"
+#include "util/functions.h"
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
+#if __ARM_NEON
+#include <arm_neon.h>
+#endif
+
+namespace deluge::dsp {
+
+/**
+ * Two independent q31 channels processed side by side - usually the left and right of a StereoSample.
+ *
+ * Filters, delay feedback and the like feed back on themselves from one sample to the next, so they can't be
+ * vectorised across time - but the two channels of a stereo buffer don't depend on each other at all, and they're
+ * already interleaved in memory. On the
+ * Deluge this is a NEON D register; elsewhere it's a pair of ints that does the same saturating and rounding, so host
+ * builds produce exactly what the firmware does.
+ *
+ * mulHigh() and mulHighRounded() are exactly multiply_32x32_rshift32() and multiply_32x32_rshift32_rounded(), so code
+ * written with them gives the same samples as its scalar version. The NEON doubling multiplies, mulDoubledHigh() and
+ * mulDoubledHighRounded(), are one instruction rather than two, but only match 2 * multiply_32x32_rshift32() give or
+ * take the bottom bit.
+ */
+class Q31x2 {
+public:
+	Q31x2() = default;
+
+#if __ARM_NEON
+	static Q31x2 load(q31_t const* p) { return vld1_s32(p); }
+	static Q31x2 broadcast(q31_t value) { return vdup_n_s32(value); }
+	static Q31x2 fromLanes(q31_t l, q31_t r) { return vset_lane_s32(r, vdup_n_s32(l), 1); }
+	void store(q31_t* p) const { vst1_s32(p, v); }
+	template <int32_t lane>
+	[[nodiscard]] q31_t get() const {
+		return vget_lane_s32(v, lane);
+	}
+
+	friend Q31x2 operator+(Q31x2 a, Q31x2 b) { return vadd_s32(a.v, b.v); }
+	friend Q31x2 operator-(Q31x2 a, Q31x2 b) { return vsub_s32(a.v, b.v); }
+	template <int32_t shift>
+	[[nodiscard]] Q31x2 shiftLeft() const {
+		return vshl_n_s32(v, shift);
+	}
+	template <int32_t shift>
+	[[nodiscard]] Q31x2 shiftRight() const {
+		return vshr_n_s32(v, shift);
+	}
+	friend Q31x2 operator&(Q31x2 a, Q31x2 b) { return vand_s32(a.v, b.v); }
+	template <int32_t shift>
+	[[nodiscard]] Q31x2 shiftLeftSaturating() const {
+		return vqshl_n_s32(v, shift);
+	}
+	template <int32_t shift>
+	[[nodiscard]] Q31x2 shiftRightUnsigned() const {
+		return vreinterpret_s32_u32(vshr_n_u32(vreinterpret_u32_s32(v), shift));
+	}
+	static Q31x2 mulHigh(Q31x2 a, Q31x2 b) { return vshrn_n_s64(vmull_s32(a.v, b.v), 32); }
+	static Q31x2 mulHighRounded(Q31x2 a, Q31x2 b) { return vrshrn_n_s64(vmull_s32(a.v, b.v), 32); }
+	static Q31x2 mulDoubledHigh(Q31x2 a, Q31x2 b) { return vqdmulh_s32(a.v, b.v); }
+	static Q31x2 mulDoubledHighRounded(Q31x2 a, Q31x2 b) { return vqrdmulh_s32(a.v, b.v); }
+	static Q31x2 mulLow(Q31x2 a, Q31x2 b) { return vmul_s32(a.v, b.v); }
+	static Q31x2 min(Q31x2 a, Q31x2 b) { return vmin_s32(a.v, b.v); }
+	static Q31x2 max(Q31x2 a, Q31x2 b) { return vmax_s32(a.v, b.v); }
+
+private:
+	Q31x2(int32x2_t v) : v(v) {}
+	int32x2_t v;
+#else
+	static Q31x2 load(q31_t const* p) { return {p[0], p[1]}; }
+	static Q31x2 broadcast(q31_t value) { return {value, value}; }
+	static Q31x2 fromLanes(q31_t l, q31_t r) { return {l, r}; }
+	void store(q31_t* p) const {
+		p[0] = v[0];
+		p[1] = v[1];
+	}
+	template <int32_t lane>
+	[[nodiscard]] q31_t get() const {
+		return v[lane];
+	}
+
+	// Wrapping, like the scalar filter code and vadd/vsub
+	friend Q31x2 operator+(Q31x2 a, Q31x2 b) {
+		return {(q31_t)((uint32_t)a.v[0] + (uint32_t)b.v[0]), (q31_t)((uint32_t)a.v[1] + (uint32_t)b.v[1])};
+	}
+	friend Q31x2 operator-(Q31x2 a, Q31x2 b) {
+		return {(q31_t)((uint32_t)a.v[0] - (uint32_t)b.v[0]), (q31_t)((uint32_t)a.v[1] - (uint32_t)b.v[1])};
+	}
+	template <int32_t shift>
+	[[nodiscard]] Q31x2 shiftLeft() const {
+		return {(q31_t)((uint32_t)v[0] << shift), (q31_t)((uint32_t)v[1] << shift)};
+	}
+	template <int32_t shift>
+	[[nodiscard]] Q31x2 shiftRight() const {
+		return {v[0] >> shift, v[1] >> shift};
+	}
+	friend Q31x2 operator&(Q31x2 a, Q31x2 b) { return {a.v[0] & b.v[0], a.v[1] & b.v[1]}; }
+	// vqshl: shifts, but goes to the nearest end of the range instead of overflowing
+	template <int32_t shift>
+	[[nodiscard]] Q31x2 shiftLeftSaturating() const {
+		return {saturatingShiftLeft(v[0], shift), saturatingShiftLeft(v[1], shift)};
+	}
+	template <int32_t shift>
+	[[nodiscard]] Q31x2 shiftRightUnsigned() const {
+		return {(q31_t)((uint32_t)v[0] >> shift), (q31_t)((uint32_t)v[1] >> shift)};
+	}
+	static Q31x2 mulHigh(Q31x2 a, Q31x2 b) {
+		return {multiply_32x32_rshift32(a.v[0], b.v[0]), multiply_32x32_rshift32(a.v[1], b.v[1])};
+	}
+	static Q31x2 mulHighRounded(Q31x2 a, Q31x2 b) {
+		return {multiply_32x32_rshift32_rounded(a.v[0], b.v[0]), multiply_32x32_rshift32_rounded(a.v[1], b.v[1])};
+	}
+	static Q31x2 mulDoubledHigh(Q31x2 a, Q31x2 b) {
+		return {doublingMultiply(a.v[0], b.v[0], 0), doublingMultiply(a.v[1], b.v[1], 0)};
+	}
+	static Q31x2 mulDoubledHighRounded(Q31x2 a, Q31x2 b) {
+		return {doublingMultiply(a.v[0], b.v[0], 1u << 31), doublingMultiply(a.v[1], b.v[1], 1u << 31)};
+	}
+	// Bottom 32 bits of the product, wrapping, like vmul
+	static Q31x2 mulLow(Q31x2 a, Q31x2 b) {
+		return {(q31_t)((uint32_t)a.v[0] * (uint32_t)b.v[0]), (q31_t)((uint32_t)a.v[1] * (uint32_t)b.v[1])};
+	}
+	static Q31x2 min(Q31x2 a, Q31x2 b) { return {std::min(a.v[0], b.v[0]), std::min(a.v[1], b.v[1])}; }
+	static Q31x2 max(Q31x2 a, Q31x2 b) { return {std::max(a.v[0], b.v[0]), std::max(a.v[1], b.v[1])}; }
+
+private:
+	Q31x2(q31_t l, q31_t r) : v{l, r} {}
+
+	// vqdmulh / vqrdmulh: (2 * a * b + rounding) >> 32, saturating the one case that overflows
+	static q31_t doublingMultiply(q31_t a, q31_t b, uint32_t rounding) {
+		if (a == std::numeric_limits<q31_t>::min() && b == std::numeric_limits<q31_t>::min()) {
+			return std::numeric_limits<q31_t>::max();
+		}
+		return (q31_t)((((int64_t)a * b) * 2 + rounding) >> 32);
+	}
+
+	static q31_t saturatingShiftLeft(q31_t value, int32_t shift) {
+		return (q31_t)std::clamp<int64_t>((int64_t)value << shift, std::numeric_limits<q31_t>::min(),
+		                                  std::numeric_limits<q31_t>::max());
+	}
+
+	q31_t v[2];
+#endif
+
+public:
+	// Exactly 2 * multiply_32x32_rshift32(), as long as a and b aren't both INT32_MIN. The doubling multiply only has
+	// one more bit at the bottom than that, which this clears - two instructions, where mulHigh() and a shift are three
+	static Q31x2 mulHighTimes2(Q31x2 a, Q31x2 b) { return mulDoubledHigh(a, b) & broadcast(~1); }
+
+	static Q31x2 clamp(Q31x2 value, q31_t low, q31_t high) { return max(min(value, broadcast(high)), broadcast(low)); }
+
+	// Exactly getTanHUnknown(). Only fetching the two table entries either side goes lane by lane - NEON can't index
+	// memory per lane
+	template <uint32_t saturationAmount>
+	[[nodiscard]] Q31x2 tanH() const {
+		Q31x2 workingValue = *this;
+		if constexpr (saturationAmount != 0) {
+			// lshiftAndSaturateUnknown() saturates first, so the bits shifted in stay clear even when it clips
+			workingValue = shiftLeftSaturating<saturationAmount>() & broadcast((q31_t)(~0u << saturationAmount));
+		}
+		workingValue = workingValue + broadcast(std::numeric_limits<q31_t>::min());
+
+		// interpolateTableSigned(workingValue, 32, tanHSmall, 8)
+		Q31x2 whichValue = workingValue.shiftRightUnsigned<24>();
+		Q31x2 strength2 = workingValue.shiftRightUnsigned<8>() & broadcast(65535);
+		Q31x2 strength1 = broadcast(65536) - strength2;
+		int32_t whichValueL = whichValue.get<0>();
+		int32_t whichValueR = whichValue.get<1>();
+		Q31x2 value1 = fromLanes(tanHSmall[whichValueL], tanHSmall[whichValueR]);
+		Q31x2 value2 = fromLanes(tanHSmall[whichValueL + 1], tanHSmall[whichValueR + 1]);
+		return (mulLow(value1, strength1) + mulLow(value2, strength2)).shiftRight<saturationAmount + 2>();
+	}
+};
+
+} // namespace deluge::dsp
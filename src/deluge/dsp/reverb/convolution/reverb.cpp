@@ -0,0 +1,51 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "dsp/reverb/convolution/reverb.hpp"
+#include "definitions_cxx.hpp"
+
+namespace deluge::dsp::reverb {
+
+int32_t Convolution::setImpulseResponse(std::span<q31_t const> left, std::span<q31_t const> right) {
+	int32_t numOutputs = right.empty() ? 1 : 2;
+	if (!convolver_.isActive() || convolver_.getNumOutputs() != numOutputs) {
+		int32_t error = convolver_.init(kBlockSizeMagnitude, kMaxImpulseLength, numOutputs);
+		if (error) {
+			return error;
+		}
+	}
+	convolver_.setImpulseResponse(left, right);
+	return NO_ERROR;
+}
+
+void Convolution::process(std::span<int32_t> input, std::span<StereoSample> output) {
+	if (!convolver_.isActive()) {
+		return;
+	}
+
+	// Mid / side, with the side scaled by width. At full width, left and right come back out as they were
+	q31_t sideAmount = width_ * 1073741823.f;
+
+	convolver_.process(input, [&](size_t frame, q31_t left, q31_t right) {
+		q31_t mid = (left >> 1) + (right >> 1);
+		q31_t side = multiply_32x32_rshift32(left - right, sideAmount) << 1;
+		output[frame].l += multiply_32x32_rshift32_rounded(mid + side, getPanLeft());
+		output[frame].r += multiply_32x32_rshift32_rounded(mid - side, getPanRight());
+	});
+}
+
+} // namespace deluge::dsp::reverb
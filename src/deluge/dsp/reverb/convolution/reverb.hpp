@@ -0,0 +1,53 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "dsp/convolution/partitioned_convolver.h"
+#include "dsp/reverb/base.hpp"
+#include <span>
+
+namespace deluge::dsp::reverb {
+
+// Reverb from a user's impulse response, loaded off the SD card. Until one's been given, it's silent.
+// Width is the only parameter that means anything here - it narrows a stereo IR towards mono
+class Convolution : public Base {
+public:
+	// 512-sample partitions, so about 12ms of extra pre-delay
+	static constexpr int32_t kBlockSizeMagnitude = 9;
+
+	// About 0.75 seconds. The cost per sample goes up with the length, and this is about what fits alongside
+	// everything else
+	static constexpr int32_t kMaxImpulseLength = 1 << 15;
+
+	Convolution() = default;
+	~Convolution() override = default;
+
+	// Returns error status. right can be empty, for a mono IR
+	int32_t setImpulseResponse(std::span<q31_t const> left, std::span<q31_t const> right);
+	[[nodiscard]] bool hasImpulseResponse() const { return convolver_.isActive(); }
+
+	void process(std::span<int32_t> input, std::span<StereoSample> output) override;
+
+	void setWidth(float value) override { width_ = value; }
+	[[nodiscard]] float getWidth() const override { return width_; }
+
+private:
+	PartitionedConvolver convolver_;
+	float width_ = 1.f;
+};
+
+} // namespace deluge::dsp::reverb
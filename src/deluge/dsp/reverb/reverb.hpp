@@ -1,5 +1,6 @@
 #pragma once
 #include "base.hpp"
+#include "convolution/reverb.hpp"
 #include "freeverb/freeverb.hpp"
 #include "mutable/reverb.hpp"
 #include <algorithm>
@@ -13,6 +14,7 @@ public:
 	enum class Model {
 		FREEVERB = 0, // Freeverb is the original
 		MUTABLE,
+		CONVOLUTION, // Needs an impulse response loading into it after it's selected
 	};
 
 	Reverb()
@@ -30,6 +32,9 @@ public:
 		case Model::MUTABLE:
 			reverb_.emplace<reverb::Mutable>();
 			break;
+		case Model::CONVOLUTION:
+			reverb_.emplace<reverb::Convolution>();
+			break;
 		}
 		base_->setRoomSize(room_size_);
 		base_->setDamping(damping_);
@@ -48,6 +53,9 @@ public:
 		case Model::MUTABLE:
 			reverb_as<Mutable>().process(input, output);
 			break;
+		case Model::CONVOLUTION:
+			reverb_as<Convolution>().process(input, output);
+			break;
 		}
 	}
 
@@ -83,8 +91,9 @@ public:
 
 private:
 	std::variant<         //<
-	    reverb::Freeverb, //<
-	    reverb::Mutable   //<
+	    reverb::Freeverb,   //<
+	    reverb::Mutable,    //<
+	    reverb::Convolution //<
 	    >
 	    reverb_{};
 
@@ -532,6 +532,11 @@ PLACE_SDRAM_DATA Language english{
         {STRING_FOR_COMMUNITY_FEATURE_HIGHLIGHT_INCOMING_NOTES, "Highlight Incoming Notes"},
         {STRING_FOR_COMMUNITY_FEATURE_NORNS_LAYOUT, "Display Norns Layout"},
         {STRING_FOR_COMMUNITY_FEATURE_GRAIN_FX, "Enable Grain FX"},
+        {STRING_FOR_COMMUNITY_FEATURE_RENDER_BUDGET, "CPU Budget"},
+        {STRING_FOR_COMMUNITY_FEATURE_VOICE_DEGRADATION, "Degrade Voices Before Culling"},
+        {STRING_FOR_COMMUNITY_FEATURE_FIXED_RENDER_BLOCK, "Fixed Render Block"},
+        {STRING_FOR_COMMUNITY_FEATURE_AUTOSAVE, "Autosave"},
+        {STRING_FOR_COMMUNITY_FEATURE_BINARY_SONGS, "Save Songs in Binary"},
 
         {STRING_FOR_TRACK_STILL_HAS_CLIPS_IN_SESSION, "Track still has clips in session"},
         {STRING_FOR_DELETE_ALL_TRACKS_CLIPS_FIRST, "Delete all track's clips first"},
@@ -879,6 +884,7 @@ PLACE_SDRAM_DATA Language english{
         {STRING_FOR_MODEL, "Model"},
         {STRING_FOR_FREEVERB, "Freeverb"},
         {STRING_FOR_MUTABLE, "Mutable"},
+        {STRING_FOR_CONVOLUTION, "Convolution"},
         {STRING_FOR_DIFFUSION, "Diffusion"},
         {STRING_FOR_TIME, "Time"},
 
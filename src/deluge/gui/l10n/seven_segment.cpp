@@ -368,6 +368,11 @@ PLACE_SDRAM_DATA Language seven_segment{
         {STRING_FOR_COMMUNITY_FEATURE_HIGHLIGHT_INCOMING_NOTES, "HIGH"},
         {STRING_FOR_COMMUNITY_FEATURE_NORNS_LAYOUT, "NORN"},
         {STRING_FOR_COMMUNITY_FEATURE_GRAIN_FX, "GRFX"},
+        {STRING_FOR_COMMUNITY_FEATURE_RENDER_BUDGET, "BUDG"},
+        {STRING_FOR_COMMUNITY_FEATURE_VOICE_DEGRADATION, "DEGR"},
+        {STRING_FOR_COMMUNITY_FEATURE_FIXED_RENDER_BLOCK, "BLOK"},
+        {STRING_FOR_COMMUNITY_FEATURE_AUTOSAVE, "ASAV"},
+        {STRING_FOR_COMMUNITY_FEATURE_BINARY_SONGS, "BINS"},
 
         {STRING_FOR_TRACK_STILL_HAS_CLIPS_IN_SESSION, "CANT"},
         {STRING_FOR_DELETE_ALL_TRACKS_CLIPS_FIRST, "CANT"},
@@ -436,6 +441,7 @@ PLACE_SDRAM_DATA Language seven_segment{
         {STRING_FOR_MODEL, "MODE"},
         {STRING_FOR_FREEVERB, "FVRB"},
         {STRING_FOR_MUTABLE, "MTBL"},
+        {STRING_FOR_CONVOLUTION, "CONV"},
         {STRING_FOR_DIFFUSION, "DIFF"},
         {STRING_FOR_TIME, "TIME"},
 
@@ -434,6 +434,11 @@ enum class String : size_t {
 	STRING_FOR_COMMUNITY_FEATURE_HIGHLIGHT_INCOMING_NOTES,
 	STRING_FOR_COMMUNITY_FEATURE_NORNS_LAYOUT,
 	STRING_FOR_COMMUNITY_FEATURE_GRAIN_FX,
+	STRING_FOR_COMMUNITY_FEATURE_RENDER_BUDGET,
+	STRING_FOR_COMMUNITY_FEATURE_VOICE_DEGRADATION,
+	STRING_FOR_COMMUNITY_FEATURE_FIXED_RENDER_BLOCK,
+	STRING_FOR_COMMUNITY_FEATURE_AUTOSAVE,
+	STRING_FOR_COMMUNITY_FEATURE_BINARY_SONGS,
 
 	STRING_FOR_TRACK_STILL_HAS_CLIPS_IN_SESSION,
 	STRING_FOR_DELETE_ALL_TRACKS_CLIPS_FIRST,
@@ -804,6 +809,7 @@ enum class String : size_t {
 	STRING_FOR_MODEL,
 	STRING_FOR_FREEVERB,
 	STRING_FOR_MUTABLE,
+	STRING_FOR_CONVOLUTION,
 	STRING_FOR_DIFFUSION,
 	STRING_FOR_TIME,
 
@@ -27,5 +27,8 @@ public:
 	void readCurrentValue() override { this->setValue(std::round(AudioEngine::reverb.getDamping() * kMaxMenuValue)); }
 	void writeCurrentValue() override { AudioEngine::reverb.setDamping((float)this->getValue() / kMaxMenuValue); }
 	[[nodiscard]] int32_t getMaxValue() const override { return kMaxMenuValue; }
+	bool isRelevant(ModControllableAudio* modControllable, int32_t whichThing) override {
+		return AudioEngine::reverb.getModel() != dsp::Reverb::Model::CONVOLUTION;
+	}
 };
 } // namespace deluge::gui::menu_item::reverb
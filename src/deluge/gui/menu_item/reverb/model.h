@@ -2,7 +2,10 @@
 
 #include "dsp/reverb/reverb.hpp"
 #include "gui/menu_item/selection.h"
+#include "hid/display/display.h"
+#include "model/song/song.h"
 #include "processing/engines/audio_engine.h"
+#include "storage/audio/impulse_response_loader.h"
 #include <string_view>
 
 namespace deluge::gui::menu_item::reverb {
@@ -11,7 +14,14 @@ public:
 	using Selection::Selection;
 	void readCurrentValue() override { this->setValue(util::to_underlying(AudioEngine::reverb.getModel())); }
 	void writeCurrentValue() override {
-		AudioEngine::reverb.setModel(static_cast<dsp::Reverb::Model>(this->getValue()));
+		auto model = static_cast<dsp::Reverb::Model>(this->getValue());
+		AudioEngine::reverb.setModel(model);
+		if (model == dsp::Reverb::Model::CONVOLUTION) {
+			int32_t error = loadReverbImpulseResponse(&currentSong->reverbImpulseResponsePath);
+			if (error) {
+				display->displayError(error);
+			}
+		}
 	}
 
 	deluge::vector<std::string_view> getOptions() override {
@@ -19,6 +29,7 @@ public:
 		return {
 		    l10n::getView(STRING_FOR_FREEVERB),
 		    l10n::getView(STRING_FOR_MUTABLE),
+		    l10n::getView(STRING_FOR_CONVOLUTION),
 		};
 	}
 };
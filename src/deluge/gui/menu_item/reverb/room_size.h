@@ -28,6 +28,9 @@ public:
 	void readCurrentValue() override { this->setValue(std::round(AudioEngine::reverb.getRoomSize() * kMaxMenuValue)); }
 	void writeCurrentValue() override { AudioEngine::reverb.setRoomSize((float)this->getValue() / kMaxMenuValue); }
 	[[nodiscard]] int32_t getMaxValue() const override { return kMaxMenuValue; }
+	bool isRelevant(ModControllableAudio* modControllable, int32_t whichThing) override {
+		return AudioEngine::reverb.getModel() != dsp::Reverb::Model::CONVOLUTION;
+	}
 
 	[[nodiscard]] std::string_view getName() const override {
 		using enum l10n::String;
@@ -43,6 +43,11 @@ ShiftIsSticky menuShiftIsSticky{};
 Setting menuLightShiftLed(RuntimeFeatureSettingType::LightShiftLed);
 Setting menuEnableGrainFX(RuntimeFeatureSettingType::EnableGrainFX);
 EmulatedDisplay menuEmulatedDisplay{};
+Setting menuRenderBudget(RuntimeFeatureSettingType::RenderBudget);
+Setting menuVoiceDegradation(RuntimeFeatureSettingType::VoiceDegradation);
+Setting menuFixedRenderBlock(RuntimeFeatureSettingType::FixedRenderBlock);
+Setting menuAutosave(RuntimeFeatureSettingType::Autosave);
+Setting menuBinarySongs(RuntimeFeatureSettingType::BinarySongs);
 
 std::array<MenuItem*, RuntimeFeatureSettingType::MaxElement - kNonTopLevelSettings> subMenuEntries{
     &menuDrumRandomizer,
@@ -60,7 +65,12 @@ std::array<MenuItem*, RuntimeFeatureSettingType::MaxElement - kNonTopLevelSettin
     &menuShiftIsSticky,
     &menuLightShiftLed,
     &menuEnableGrainFX,
-    &menuEmulatedDisplay};
+    &menuEmulatedDisplay,
+    &menuRenderBudget,
+    &menuVoiceDegradation,
+    &menuFixedRenderBlock,
+    &menuAutosave,
+    &menuBinarySongs};
 
 Settings::Settings(l10n::String name, l10n::String title) : menu_item::Submenu(name, title, subMenuEntries) {
 }
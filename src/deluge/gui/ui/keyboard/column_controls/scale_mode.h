@@ -32,8 +32,9 @@ public:
 	               KeyboardLayout* layout) override;
 
 private:
-	int32_t currentScalePad = currentSong->getCurrentPresetScale();
-	int32_t previousScalePad = currentSong->getCurrentPresetScale();
+	// These get constructed statically, before there's any Song
+	int32_t currentScalePad = currentSong ? currentSong->getCurrentPresetScale() : 0;
+	int32_t previousScalePad = currentScalePad;
 	uint8_t scaleModes[8] = {0, 1, 2, 3, 4, 5, 6, 7};
 };
 
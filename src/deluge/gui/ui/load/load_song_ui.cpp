@@ -38,7 +38,9 @@
 #include "playback/playback_handler.h"
 #include "processing/engines/audio_engine.h"
 #include "storage/audio/audio_file_manager.h"
+#include "storage/audio/cluster_prefetcher.h"
 #include "storage/file_item.h"
+#include "storage/song_autosaver.h"
 #include "storage/storage_manager.h"
 #include <string.h>
 
@@ -406,8 +408,10 @@ gotErrorAfterCreatingSong:
 		preLoadedSong->loadAllSamples(true);
 		AudioEngine::logAction("h");
 
-		// If any more waiting required before the song swap actually happens, do that
+		// If any more waiting required before the song swap actually happens, do that. Now the new Song's done
+		// changing, we can read ahead for the notes it'll start with
 		while (currentUIMode != UI_MODE_LOADING_SONG_NEW_SONG_PLAYING) {
+			clusterPrefetcher.routineWhileSongSwapArmed(preLoadedSong);
 			audioFileManager.loadAnyEnqueuedClusters();
 			routineForSD();
 		}
@@ -440,6 +444,7 @@ swapDone:
 	currentSong->loadAllSamples();
 	AudioEngine::logAction("l");
 	currentSong->markAllInstrumentsAsEdited();
+	songAutosaver.songSaved(); // Nothing new to autosave yet
 
 	audioFileManager.thingFinishedLoading();
 
@@ -24,8 +24,10 @@
 #include "hid/led/pad_leds.h"
 #include "io/debug/log.h"
 #include "model/sample/sample.h"
+#include "model/settings/runtime_feature_settings.h"
 #include "model/song/song.h"
 #include "storage/audio/audio_file_manager.h"
+#include "storage/song_autosaver.h"
 #include "storage/storage_manager.h"
 #include "util/functions.h"
 #include <string.h>
@@ -437,6 +439,14 @@ fail3:
 		goto gotError;
 	}
 
+	// The XML's a good save already, so if swapping it for the binary version doesn't work out, just keep that
+	if (runtimeFeatureSettings.get(RuntimeFeatureSettingType::BinarySongs) == RuntimeFeatureStateToggle::On) {
+		int32_t binaryError = storageManager.convertFileToBinary(filePathDuringWrite.get(), "SONGS/BINARY.TMP");
+		if (binaryError) {
+			D_PRINTLN("couldn't save binary song: %d", binaryError);
+		}
+	}
+
 	// If "overwriting an existing file"...
 	if (fileAlreadyExisted) {
 
@@ -462,6 +472,7 @@ cardError:
 	// Update all of these
 	currentSong->name.set(&enteredText);
 	currentSong->dirPath.set(&currentDir);
+	songAutosaver.songSaved();
 
 	// While we're at it, save MIDI devices if there's anything new to save.
 	MIDIDeviceManager::writeDevicesToFile();
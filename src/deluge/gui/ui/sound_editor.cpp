@@ -50,6 +50,7 @@
 #include "processing/source.h"
 #include "storage/flash_storage.h"
 #include "storage/multi_range/multisample_range.h"
+#include "storage/song_autosaver.h"
 #include "storage/storage_manager.h"
 #include "util/functions.h"
 
@@ -750,6 +751,11 @@ void SoundEditor::selectEncoderAction(int8_t offset) {
 
 		getCurrentMenuItem()->selectEncoderAction(offset);
 
+		// Menu items that aren't params don't go through AutoParam or ActionLogger, so they'd go unnoticed otherwise
+		if (getCurrentMenuItem()->selectEncoderActionEditsInstrument() && !inSettingsMenu()) {
+			songAutosaver.songEdited();
+		}
+
 		if (currentSound) {
 			if (getCurrentMenuItem()->selectEncoderActionEditsInstrument()) {
 				markInstrumentAsEdited(); // TODO: make reverb and reverb-sidechain stuff exempt from this
@@ -21,6 +21,7 @@
 #include "hid/display/display.h"
 #include "hid/display/oled.h"
 #include "hid/led/pad_leds.h"
+#include "io/debug/trace.h"
 #include <utility>
 
 UI::UI() {
@@ -318,6 +319,8 @@ void doAnyPendingUIRendering() {
 		return;
 	}
 
+	TRACE_ZONE(TraceZone::UI_RENDERING);
+
 	if (currentUIMode == UI_MODE_HORIZONTAL_SCROLL || currentUIMode == UI_MODE_HORIZONTAL_ZOOM) {
 		return;
 	}
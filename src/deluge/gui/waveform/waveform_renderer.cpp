@@ -21,6 +21,7 @@
 #include "gui/waveform/waveform_render_data.h"
 #include "io/debug/log.h"
 #include "model/sample/sample.h"
+#include "model/sample/sample_peak_pyramid.h"
 #include "model/sample/sample_recorder.h"
 #include "model/voice/voice_sample.h"
 #include "processing/engines/audio_engine.h"
@@ -248,6 +249,17 @@ bool WaveformRenderer::findPeaksPerCol(Sample* sample, int64_t xScrollSamples, u
 
 	bool hadAnyTroubleLoading = false;
 
+	// Zoomed out this far - so every column covers at least one whole bin - the Sample's peak pyramid can tell us
+	// about columns without us reading the audio data
+	bool usePeakPyramid = false;
+	if (!recorder && xZoomSamples >= (SamplePeakPyramid::kBinSize << 1)) {
+		SamplePeakPyramid* peakPyramid = sample->getOrCreatePeakPyramid();
+		if (peakPyramid) {
+			peakPyramid->requestBuild();
+			usePeakPyramid = true;
+		}
+	}
+
 	for (int32_t col = xStart; col < xEnd; col++) {
 
 		if (data->colStatus[col] == COL_STATUS_INVESTIGATED) {
@@ -283,6 +295,13 @@ bool WaveformRenderer::findPeaksPerCol(Sample* sample, int64_t xScrollSamples, u
 			continue;
 		}
 
+		// Loading a Cluster for an earlier column might have stolen or moved the pyramid, so look it up afresh
+		SamplePeakPyramid* peakPyramid = usePeakPyramid ? sample->peakPyramid : NULL;
+		if (peakPyramid
+		    && peakPyramid->getPeaks(colStartSample, colEndSample, &data->minPerCol[col], &data->maxPerCol[col])) {
+			continue;
+		}
+
 		int32_t colStartByte =
 		    colStartSample * sample->numChannels * sample->byteDepth + sample->audioDataStartPosBytes;
 		int32_t colEndByte = colEndSample * sample->numChannels * sample->byteDepth + sample->audioDataStartPosBytes;
@@ -86,6 +86,7 @@ void init() {
 	uint32_t const pmcr = 0;
 	uint32_t const pmcntenset = 0b10000000000000000000000000000000u;
 
+#if defined(__arm__)
 	asm volatile("MRC p15, 0, %0, c9, c12, 0\n"
 	             // Set bit 0, the "E" flag
 	             "orr %0, #1\n"
@@ -93,6 +94,7 @@ void init() {
 	             "MCR p15, 0, %1, c9, c12, 1\n"
 	             :
 	             : "r"(pmcr), "r"(pmcntenset));
+#endif
 
 	initFlag = true;
 }
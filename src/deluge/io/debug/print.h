@@ -18,6 +18,9 @@
 #pragma once
 
 #include <cstdint>
+#if !defined(__arm__)
+#include <ctime>
+#endif
 
 class MIDIDevice;
 
@@ -26,6 +29,7 @@ const uint32_t sec = 400000000;
 const uint32_t mS = 400000;
 const uint32_t uS = 400;
 
+#if defined(__arm__)
 [[gnu::always_inline]] inline uint32_t readCycleCounter() {
 	uint32_t cycles = 0;
 	asm volatile("MRC p15, 0, %0, c9, c13, 0" : "=r"(cycles) :);
@@ -35,6 +39,18 @@ const uint32_t uS = 400;
 [[gnu::always_inline]] inline void readCycleCounter(uint32_t& time) {
 	asm volatile("MRC p15, 0, %0, c9, c13, 0" : "=r"(time) :);
 }
+#else
+// Host builds (unit tests, benchmarks) - the monotonic clock, scaled to look like the Deluge's 400MHz cycle counter
+[[gnu::always_inline]] inline uint32_t readCycleCounter() {
+	timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint32_t)((uint64_t)now.tv_sec * sec + (((uint64_t)now.tv_nsec * 2) / 5));
+}
+
+[[gnu::always_inline]] inline void readCycleCounter(uint32_t& time) {
+	time = readCycleCounter();
+}
+#endif
 
 void init();
 void print(char const* output);
@@ -0,0 +1,127 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "io/debug/trace.h"
+
+#if ENABLE_TRACE
+#include "util/cfunctions.h"
+#include <cstring>
+
+namespace Debug {
+
+TraceRingBuffer traceBuffer;
+
+namespace {
+std::array<TraceZoneStats, kNumTraceZones> zoneStats{};
+
+char const* const zoneNames[kNumTraceZones] = {
+    "audio routine", "voice render", "filters",         "mod fx",       "delay",
+    "reverb",        "compressor",   "cluster loading", "ui rendering", "voice cull",
+};
+
+char* appendString(char* pos, char const* string) {
+	size_t length = strlen(string);
+	memcpy(pos, string, length);
+	return pos + length;
+}
+
+char* appendInt(char* pos, int32_t number, int32_t minNumDigits = 1) {
+	intToString(number, pos, minNumDigits);
+	return pos + strlen(pos);
+}
+} // namespace
+
+TraceScope::TraceScope(TraceZone zone, uint16_t arg) : zone(zone) {
+	readCycleCounter(startCycles);
+	traceBuffer.push({startCycles, zone, TracePhase::BEGIN, arg});
+}
+
+TraceScope::~TraceScope() {
+	uint32_t endCycles;
+	readCycleCounter(endCycles);
+	traceBuffer.push({endCycles, zone, TracePhase::END, 0});
+
+	uint32_t deltaCycles = endCycles - startCycles;
+	TraceZoneStats& stats = zoneStats[static_cast<int32_t>(zone)];
+	stats.count++;
+	stats.totalCycles += deltaCycles;
+	if (deltaCycles > stats.maxCycles) {
+		stats.maxCycles = deltaCycles;
+	}
+}
+
+void traceInstant(TraceZone zone, uint16_t arg) {
+	traceBuffer.push({readCycleCounter(), zone, TracePhase::INSTANT, arg});
+	zoneStats[static_cast<int32_t>(zone)].count++;
+}
+
+char const* getTraceZoneName(TraceZone zone) {
+	return zoneNames[static_cast<int32_t>(zone)];
+}
+
+TraceZoneStats const& getTraceZoneStats(TraceZone zone) {
+	return zoneStats[static_cast<int32_t>(zone)];
+}
+
+void resetTrace() {
+	traceBuffer.clear();
+	zoneStats.fill({});
+}
+
+void dumpTrace() {
+	uint32_t numEvents = traceBuffer.size();
+	if (!numEvents) {
+		return;
+	}
+
+	// The cycle counter wraps every ~10s, so timestamps are made relative to the oldest event and unwrapped as we go
+	uint32_t lastCycles = traceBuffer.get(0).cycles;
+	uint64_t elapsedCycles = 0;
+
+	for (uint32_t i = 0; i < numEvents; i++) {
+		TraceEvent const& event = traceBuffer.get(i);
+		elapsedCycles += (uint32_t)(event.cycles - lastCycles);
+		lastCycles = event.cycles;
+
+		// Cycles are at 400MHz, so 2.5ns each
+		uint64_t nanoseconds = (elapsedCycles * 5) >> 1;
+
+		char buffer[128];
+		char* pos = buffer;
+		pos = appendString(pos, "{\"name\":\"");
+		pos = appendString(pos, getTraceZoneName(event.zone));
+		pos = appendString(pos, "\",\"ph\":\"");
+		pos = appendString(pos, (event.phase == TracePhase::BEGIN) ? "B" : (event.phase == TracePhase::END) ? "E" : "i");
+		pos = appendString(pos, "\",\"ts\":");
+		pos = appendInt(pos, (int32_t)(nanoseconds / 1000));
+		*pos++ = '.';
+		pos = appendInt(pos, (int32_t)(nanoseconds % 1000), 3);
+		pos = appendString(pos, ",\"pid\":0,\"tid\":0");
+		if (event.arg) {
+			pos = appendString(pos, ",\"args\":{\"n\":");
+			pos = appendInt(pos, event.arg);
+			*pos++ = '}';
+		}
+		pos = appendString(pos, "},");
+		*pos = 0;
+
+		println(buffer);
+	}
+}
+
+} // namespace Debug
+#endif
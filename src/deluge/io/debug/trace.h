@@ -0,0 +1,133 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "io/debug/print.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+/*
+ * Cycle-budget tracing.
+ *
+ * Wrap a block in TRACE_ZONE(TraceZone::REVERB) and, in builds with ENABLE_TRACE, its begin and end cycle counts get
+ * recorded into a fixed-size ring buffer, and its cost accumulated into per-zone totals. Nothing is allocated and
+ * nothing is printed while recording, so zones are cheap enough to leave around the hot paths.
+ *
+ * dumpTrace() writes the ring buffer out as Chrome trace event JSON (one event per line, via Debug::println(), so it
+ * goes out over sysex if a debug device is registered, or UART/RTT otherwise). Strip the sysex framing, wrap the lines
+ * in [ ], and chrome://tracing or ui.perfetto.dev will open it. Timestamps are in microseconds of the 400MHz cycle
+ * counter. Sysex debug subcommand 3 requests a dump.
+ *
+ * Without ENABLE_TRACE, only TraceZone is left, and the ring buffer and everything that writes to it aren't built.
+ *
+ * On the host, readCycleCounter() falls back to clock_gettime(), so the same zones can be checked in unit tests.
+ */
+
+enum class TraceZone : uint8_t {
+	AUDIO_ROUTINE,
+	VOICE_RENDER,
+	FILTERS,
+	MOD_FX,
+	DELAY,
+	REVERB,
+	COMPRESSOR,
+	CLUSTER_LOADING,
+	UI_RENDERING,
+	VOICE_CULL, // Instant event only - marks the moment the engine ran out of budget
+};
+constexpr int32_t kNumTraceZones = static_cast<int32_t>(TraceZone::VOICE_CULL) + 1;
+
+#if ENABLE_TRACE
+namespace Debug {
+
+enum class TracePhase : uint8_t { BEGIN, END, INSTANT };
+
+struct TraceEvent {
+	uint32_t cycles;
+	TraceZone zone;
+	TracePhase phase;
+	uint16_t arg; // e.g. numSamples or number of voices, whatever's useful for the zone
+};
+
+struct TraceZoneStats {
+	uint32_t count;
+	uint32_t maxCycles;
+	uint64_t totalCycles;
+};
+
+// Must be a power of 2
+constexpr uint32_t kTraceBufferSize = 1024;
+
+/// Single-producer ring buffer. The Deluge renders audio from the main loop rather than an ISR, so only one context
+/// ever writes; the atomic index just keeps a reader (e.g. a dump triggered from MIDI) from seeing torn events.
+/// When full, the oldest events are overwritten.
+class TraceRingBuffer {
+public:
+	void push(TraceEvent event) {
+		uint32_t index = writeIndex.load(std::memory_order_relaxed);
+		events[index & (kTraceBufferSize - 1)] = event;
+		writeIndex.store(index + 1, std::memory_order_release);
+	}
+
+	[[nodiscard]] uint32_t size() const {
+		uint32_t written = writeIndex.load(std::memory_order_acquire);
+		return (written < kTraceBufferSize) ? written : kTraceBufferSize;
+	}
+
+	/// i = 0 is the oldest event still held
+	[[nodiscard]] TraceEvent const& get(uint32_t i) const {
+		uint32_t written = writeIndex.load(std::memory_order_acquire);
+		return events[(written - size() + i) & (kTraceBufferSize - 1)];
+	}
+
+	void clear() { writeIndex.store(0, std::memory_order_release); }
+
+private:
+	std::array<TraceEvent, kTraceBufferSize> events;
+	std::atomic<uint32_t> writeIndex{0};
+};
+
+class TraceScope {
+public:
+	TraceScope(TraceZone zone, uint16_t arg = 0);
+	~TraceScope();
+
+private:
+	TraceZone zone;
+	uint32_t startCycles;
+};
+
+void traceInstant(TraceZone zone, uint16_t arg = 0);
+char const* getTraceZoneName(TraceZone zone);
+TraceZoneStats const& getTraceZoneStats(TraceZone zone);
+void resetTrace();
+void dumpTrace();
+
+extern TraceRingBuffer traceBuffer;
+
+} // namespace Debug
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_ZONE(...) Debug::TraceScope TRACE_CONCAT(traceScope, __LINE__)(__VA_ARGS__)
+#define TRACE_INSTANT(...) Debug::traceInstant(__VA_ARGS__)
+#else
+#define TRACE_ZONE(...)
+#define TRACE_INSTANT(...)
+#endif
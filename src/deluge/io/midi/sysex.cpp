@@ -19,6 +19,7 @@
 
 #include "io/midi/sysex.h"
 #include "io/debug/print.h"
+#include "io/debug/trace.h"
 #include "io/midi/midi_device.h"
 #include "io/midi/midi_engine.h"
 #include "util/chainload.h"
@@ -53,6 +54,16 @@ void Debug::sysexReceived(MIDIDevice* device, uint8_t* data, int32_t len) {
 #endif
 		break;
 
+	case 3:
+#if ENABLE_TRACE
+		// Dump the trace ring buffer, and optionally clear it afterwards
+		dumpTrace();
+		if (data[2] == 1) {
+			resetTrace();
+		}
+#endif
+		break;
+
 	default:
 		break;
 	}
@@ -24,6 +24,8 @@ public:
 		/// later songs to break in. This occurs since there's no mechanism to determine if a sample is going to be used
 		/// in the remainder of the song, so if there's not enough memory pressure for all stealable clusters to get
 		/// reclaimed the same few just get put on and off the list repeatedly
+		/// Sample Clusters which prove to be wanted again - see Cluster::getAppropriateQueue() - go in a separate,
+		/// protected queue, which gets around most of that.
 		reclamation_queue_[q].addToEnd(stealable);
 		longest_runs_[q] = 0xFFFFFFFF; // TODO: actually investigate neighbouring memory "run".
 	}
@@ -1,9 +1,7 @@
 #pragma once
 #include "memory/general_memory_allocator.h"
 #include <cstddef>
-extern "C" {
-void abort(void); // this is defined in reset_handler.S
-}
+#include <cstdlib> // abort(), which is defined in reset_handler.S
 namespace deluge::memory {
 
 /**
@@ -38,8 +38,9 @@ GeneralMemoryAllocator::GeneralMemoryAllocator() {
 	                                       EXTERNAL_MEMORY_END - RESERVED_EXTERNAL_ALLOCATOR);
 	regions[MEMORY_REGION_EXTERNAL].setup(emptySpacesMemoryGeneral, sizeof(emptySpacesMemoryGeneral),
 	                                      EXTERNAL_MEMORY_END - RESERVED_EXTERNAL_ALLOCATOR, EXTERNAL_MEMORY_END);
-	regions[MEMORY_REGION_INTERNAL].setup(emptySpacesMemoryInternal, sizeof(emptySpacesMemoryInternal),
-	                                      (uint32_t)&__heap_start, (uint32_t)&program_stack_start);
+	slabs.setup((uint32_t)&__heap_start, (uint32_t)&__heap_start + RESERVED_INTERNAL_SLABS);
+	regions[MEMORY_REGION_INTERNAL].setup(emptySpacesMemoryInternal, sizeof(emptySpacesMemoryInternal), slabs.end,
+	                                      (uint32_t)&program_stack_start);
 
 #if ALPHA_OR_BETA_VERSION
 	regions[MEMORY_REGION_STEALABLE].name = "stealable";
@@ -118,8 +119,13 @@ void* GeneralMemoryAllocator::alloc(uint32_t requiredSize, bool mayUseOnChipRam,
 
 	// Only allow allocating stealables in stelable region
 	if (!makeStealable) {
-		// If internal is allowed, try that first
+		// If internal is allowed, try that first - and for small things, the slabs before that
 		if (mayUseOnChipRam) {
+			address = slabs.alloc(requiredSize);
+			if (address) {
+				return address;
+			}
+
 			lock = true;
 			address = regions[MEMORY_REGION_INTERNAL].alloc(requiredSize, makeStealable, thingNotToStealFrom);
 			lock = false;
@@ -168,6 +174,9 @@ int32_t GeneralMemoryAllocator::getRegion(void* address) {
 	if (value >= regions[MEMORY_REGION_INTERNAL].start && value < regions[MEMORY_REGION_INTERNAL].end) {
 		return MEMORY_REGION_INTERNAL;
 	}
+	else if (slabs.contains(address)) { // Internal RAM too, but callers that go on to use the region must check first
+		return MEMORY_REGION_INTERNAL;
+	}
 	else if (value >= regions[MEMORY_REGION_STEALABLE].start && value < regions[MEMORY_REGION_STEALABLE].end) {
 		return MEMORY_REGION_STEALABLE;
 	}
@@ -181,12 +190,18 @@ int32_t GeneralMemoryAllocator::getRegion(void* address) {
 
 // Returns new size
 uint32_t GeneralMemoryAllocator::shortenRight(void* address, uint32_t newSize) {
+	if (slabs.contains(address)) {
+		return getAllocatedSize(address); // Slab allocations stay the size they are
+	}
 	return regions[getRegion(address)].shortenRight(address, newSize);
 }
 
 // Returns how much it was shortened by
 uint32_t GeneralMemoryAllocator::shortenLeft(void* address, uint32_t amountToShorten,
                                              uint32_t numBytesToMoveRightIfSuccessful) {
+	if (slabs.contains(address)) {
+		return 0;
+	}
 	return regions[getRegion(address)].shortenLeft(address, amountToShorten, numBytesToMoveRightIfSuccessful);
 }
 
@@ -197,7 +212,7 @@ void GeneralMemoryAllocator::extend(void* address, uint32_t minAmountToExtend, u
 	*getAmountExtendedLeft = 0;
 	*getAmountExtendedRight = 0;
 
-	if (lock) {
+	if (lock || slabs.contains(address)) {
 		return;
 	}
 
@@ -208,10 +223,16 @@ void GeneralMemoryAllocator::extend(void* address, uint32_t minAmountToExtend, u
 }
 
 uint32_t GeneralMemoryAllocator::extendRightAsMuchAsEasilyPossible(void* address) {
+	if (slabs.contains(address)) {
+		return getAllocatedSize(address);
+	}
 	return regions[getRegion(address)].extendRightAsMuchAsEasilyPossible(address);
 }
 
 void GeneralMemoryAllocator::dealloc(void* address) {
+	if (slabs.contains(address)) {
+		return slabs.dealloc(address);
+	}
 	return regions[getRegion(address)].dealloc(address);
 }
 
@@ -224,3 +245,21 @@ void GeneralMemoryAllocator::putStealableInAppropriateQueue(Stealable* stealable
 	int32_t q = stealable->getAppropriateQueue();
 	putStealableInQueue(stealable, q);
 }
+
+// Below this much fragmentation (see MemoryRegion::getFragmentation()), we leave things be
+constexpr uint32_t kFragmentationToCompactAbove = 25;
+
+void GeneralMemoryAllocator::compactionRoutine() {
+	if (lock) {
+		return;
+	}
+
+	MemoryRegion& region = regions[MEMORY_REGION_STEALABLE];
+	if (region.getFragmentation() < kFragmentationToCompactAbove) {
+		return;
+	}
+
+	lock = true;
+	region.relocateOneStealable();
+	lock = false;
+}
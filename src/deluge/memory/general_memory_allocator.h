@@ -18,12 +18,14 @@
 #pragma once
 
 #include "memory/memory_region.h"
+#include "memory/slab_allocator.h"
 
 #define MEMORY_REGION_STEALABLE 0
 #define MEMORY_REGION_INTERNAL 1
 #define MEMORY_REGION_EXTERNAL 2
 #define NUM_MEMORY_REGIONS 3
 constexpr uint32_t RESERVED_EXTERNAL_ALLOCATOR = 0x00800000;
+constexpr uint32_t RESERVED_INTERNAL_SLABS = SlabAllocator::kMaxNumPages * SlabAllocator::kPageSize;
 class Stealable;
 
 /*
@@ -90,7 +92,11 @@ public:
 	void putStealableInQueue(Stealable* stealable, int32_t q);
 	void putStealableInAppropriateQueue(Stealable* stealable);
 
+	// Call regularly while not too busy. Moves at most one Stealable, to join up empty space in the stealable region
+	void compactionRoutine();
+
 	MemoryRegion regions[NUM_MEMORY_REGIONS];
+	SlabAllocator slabs; // Tried first, for small allocations that may use internal RAM
 
 	bool lock;
 
@@ -858,3 +858,110 @@ void MemoryRegion::dealloc(void* address) {
 	numAllocations--;
 #endif
 }
+
+// How many of the biggest empty spaces relocateOneStealable() looks next to
+constexpr int32_t kNumEmptySpacesToCompactAround = 8;
+
+// One step of compaction. Looks next to the biggest few empty spaces for a Stealable which would fit in a smaller empty
+// space somewhere else, and if it finds one, moves it there - so the space it leaves behind joins the big one. Returns
+// whether it moved anything.
+bool MemoryRegion::relocateOneStealable() {
+	int32_t numEmptySpaces = emptySpaces.getNumElements();
+
+	// Index 0 is the smallest, and moving anything next to that won't help
+	for (int32_t e = numEmptySpaces - 1; e >= 1 && e >= numEmptySpaces - kNumEmptySpacesToCompactAround; e--) {
+		EmptySpaceRecord bigSpace = *(EmptySpaceRecord*)emptySpaces.getElementAddress(e);
+
+		// To the left
+		uint32_t lookLeft = *(uint32_t*)(bigSpace.address - 8);
+		if ((lookLeft & SPACE_TYPE_MASK) == SPACE_HEADER_STEALABLE) {
+			uint32_t spaceSize = lookLeft & SPACE_SIZE_MASK;
+			if (relocate((Stealable*)(bigSpace.address - 8 - spaceSize), spaceSize, bigSpace.length)) {
+				return true;
+			}
+		}
+
+		// And to the right
+		uint32_t lookRight = *(uint32_t*)(bigSpace.address + bigSpace.length + 4);
+		if ((lookRight & SPACE_TYPE_MASK) == SPACE_HEADER_STEALABLE) {
+			uint32_t spaceSize = lookRight & SPACE_SIZE_MASK;
+			if (relocate((Stealable*)(bigSpace.address + bigSpace.length + 8), spaceSize, bigSpace.length)) {
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+bool MemoryRegion::relocate(Stealable* stealable, uint32_t spaceSize, uint32_t maxDestinationSize) {
+	if (!stealable->mayBeRelocated()) {
+		return false;
+	}
+
+	// Only worth it if it fits in a smaller empty space than the one it's next to - which alloc() would then choose
+	int32_t i = emptySpaces.search(padSize(spaceSize), GREATER_OR_EQUAL);
+	if (i >= emptySpaces.getNumElements()) {
+		return false;
+	}
+	EmptySpaceRecord* destination = (EmptySpaceRecord*)emptySpaces.getElementAddress(i);
+	if (destination->length >= maxDestinationSize) {
+		return false;
+	}
+
+	// And not if that space is also right next to it, which would just shuffle it along
+	if (destination->address + destination->length + 8 == (uint32_t)stealable
+	    || (uint32_t)stealable + spaceSize + 8 == destination->address) {
+		return false;
+	}
+
+	Stealable* newStealable = (Stealable*)alloc(spaceSize, true, stealable);
+	if (!newStealable) {
+		return false;
+	}
+	memcpy(newStealable, stealable, spaceSize);
+
+	// Take the old one's place in its queue
+	BidirectionalLinkedList* list = stealable->list;
+	if (list) {
+		bool wasLast = stealable->isLast();
+		BidirectionalLinkedListNode* next = stealable->next;
+		stealable->remove();
+		if (wasLast) {
+			list->addToEnd(newStealable);
+		}
+		else {
+			next->insertOtherNodeBefore(newStealable);
+		}
+	}
+
+	newStealable->relocated(stealable);
+
+	// No destructing the old one - it lives on in the new one
+	markSpaceAsEmpty((uint32_t)stealable, spaceSize);
+	return true;
+}
+
+// How much of our empty space is in bits other than the biggest one, in percent. 0 means it's all in one place
+uint32_t MemoryRegion::getFragmentation() {
+	int32_t numEmptySpaces = emptySpaces.getNumElements();
+	if (numEmptySpaces <= 1) {
+		return 0;
+	}
+
+	uint64_t totalEmptySpace = 0;
+	for (int32_t i = 0; i < numEmptySpaces; i++) {
+		totalEmptySpace += ((EmptySpaceRecord*)emptySpaces.getElementAddress(i))->length;
+	}
+	uint32_t biggestEmptySpace = ((EmptySpaceRecord*)emptySpaces.getElementAddress(numEmptySpaces - 1))->length;
+
+	return 100 - (uint64_t)biggestEmptySpace * 100 / totalEmptySpace;
+}
+
+uint32_t MemoryRegion::getBiggestEmptySpace() {
+	int32_t numEmptySpaces = emptySpaces.getNumElements();
+	if (!numEmptySpaces) {
+		return 0;
+	}
+	return ((EmptySpaceRecord*)emptySpaces.getElementAddress(numEmptySpaces - 1))->length;
+}
@@ -53,6 +53,9 @@ public:
 	uint32_t extendRightAsMuchAsEasilyPossible(void* spaceAddress);
 	void dealloc(void* address);
 	void verifyMemoryNotFree(void* address, uint32_t spaceSize);
+	bool relocateOneStealable();
+	uint32_t getFragmentation();
+	uint32_t getBiggestEmptySpace();
 
 	uint32_t start;
 	uint32_t end;
@@ -75,6 +78,7 @@ private:
 	                                int32_t idealAmountToExtend, void* thingNotToStealFrom,
 	                                uint32_t markWithTraversalNo = 0, bool originalSpaceNeedsStealing = false);
 
+	bool relocate(Stealable* stealable, uint32_t spaceSize, uint32_t maxDestinationSize);
 	void writeTempHeadersBeforeASteal(uint32_t newStartAddress, uint32_t newSize);
 	void sanityCheck();
 	uint32_t padSize(uint32_t requiredSize);
@@ -0,0 +1,114 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "memory/slab_allocator.h"
+#include "definitions_cxx.hpp"
+#include "memory/memory_region.h"
+
+void SlabAllocator::setup(uint32_t arenaBegin, uint32_t arenaEnd) {
+	start = (arenaBegin + 7) & ~(uint32_t)7;
+	numPages = (arenaEnd - start) >> kPageSizeMagnitude;
+	if (numPages > kMaxNumPages) {
+		numPages = kMaxNumPages;
+	}
+	end = start + (numPages << kPageSizeMagnitude);
+	numPagesUsed = 0;
+
+	for (int32_t p = 0; p < kMaxNumPages; p++) {
+		pageSizeClass[p] = kPageUnused;
+	}
+}
+
+void* SlabAllocator::alloc(uint32_t requiredSize) {
+	if (!requiredSize || requiredSize > kMaxSize) {
+		return NULL;
+	}
+
+	int32_t sizeClass = 0;
+	while (getStride(sizeClass) - 8 < requiredSize) {
+		sizeClass++;
+	}
+
+	if (!freeSlots[sizeClass] && !addPage(sizeClass)) {
+		numOverflows[sizeClass]++;
+		return NULL;
+	}
+
+	FreeSlot* slot = freeSlots[sizeClass];
+	freeSlots[sizeClass] = slot->next;
+
+	*((uint32_t*)slot - 1) = (getStride(sizeClass) - 8) | SPACE_HEADER_ALLOCATED;
+
+	numFree[sizeClass]--;
+	numAllocated[sizeClass]++;
+	numAllocs[sizeClass]++;
+	return slot;
+}
+
+void SlabAllocator::dealloc(void* address) {
+	int32_t page = ((uint32_t)address - start) >> kPageSizeMagnitude;
+	int32_t sizeClass = pageSizeClass[page];
+
+#if ALPHA_OR_BETA_VERSION
+	if (sizeClass == kPageUnused || (((uint32_t)address - start) & (getStride(sizeClass) - 1)) != 8) {
+		FREEZE_WITH_ERROR("M007"); // Not something we gave out
+	}
+	if (!(*((uint32_t*)address - 1) & SPACE_HEADER_ALLOCATED)) {
+		FREEZE_WITH_ERROR("M008"); // Freed twice
+	}
+#endif
+
+	*((uint32_t*)address - 1) = SPACE_HEADER_EMPTY;
+
+	FreeSlot* slot = (FreeSlot*)address;
+	slot->next = freeSlots[sizeClass];
+	freeSlots[sizeClass] = slot;
+
+	numAllocated[sizeClass]--;
+	numFree[sizeClass]++;
+}
+
+bool SlabAllocator::addPage(int32_t sizeClass) {
+	if (numPagesUsed >= numPages) {
+		return false;
+	}
+
+	int32_t page = numPagesUsed++;
+	pageSizeClass[page] = sizeClass;
+	numPagesPerClass[sizeClass]++;
+
+	// Carve it up, back to front so allocations come out in address order
+	uint32_t stride = getStride(sizeClass);
+	uint32_t pageStart = start + (page << kPageSizeMagnitude);
+	for (int32_t i = kPageSize / stride - 1; i >= 0; i--) {
+		FreeSlot* slot = (FreeSlot*)(pageStart + i * stride + 8);
+		*((uint32_t*)slot - 1) = SPACE_HEADER_EMPTY;
+		slot->next = freeSlots[sizeClass];
+		freeSlots[sizeClass] = slot;
+		numFree[sizeClass]++;
+	}
+	return true;
+}
+
+void SlabAllocator::getStats(int32_t sizeClass, SlabStats* stats) {
+	stats->slotSize = getStride(sizeClass) - 8;
+	stats->numPages = numPagesPerClass[sizeClass];
+	stats->numAllocated = numAllocated[sizeClass];
+	stats->numFree = numFree[sizeClass];
+	stats->numAllocs = numAllocs[sizeClass];
+	stats->numOverflows = numOverflows[sizeClass];
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+struct SlabStats {
+	uint32_t slotSize;      // Usable bytes per allocation
+	uint32_t numPages;      // Pages given over to this size class so far
+	uint32_t numAllocated;  // Currently in use
+	uint32_t numFree;       // Carved out of pages but not in use
+	uint32_t numAllocs;     // Ever
+	uint32_t numOverflows;  // Times we had to say no because there were no pages left
+};
+
+/*
+ * Small allocations from internal RAM - a Note array growing, a ParamNode vector, an Action, a Consequence - would
+ * otherwise each take a trip through MemoryRegion's emptySpaces search, get padded up to minAlign, and leave little
+ * holes behind them when freed. So GeneralMemoryAllocator first tries one of these: a fixed arena, split into pages,
+ * each page given over to one size class the first time that class needs more room. Allocating and freeing is just
+ * popping and pushing a free list.
+ *
+ * Each allocation still gets the usual header in the 4 bytes before it, so getAllocatedSize() works. There's no footer,
+ * and they can't be shortened or extended - anything that tries just gets told no, and moves its data somewhere bigger,
+ * as it would if its neighbour were in the way.
+ *
+ * Pages stay with their size class once given to it.
+ */
+class SlabAllocator {
+public:
+	static constexpr int32_t kNumSizeClasses = 5;
+	static constexpr uint32_t kMaxSize = (16 << (kNumSizeClasses - 1)) - 8; // 248 bytes
+	static constexpr int32_t kPageSizeMagnitude = 12;
+	static constexpr uint32_t kPageSize = 1 << kPageSizeMagnitude;
+	static constexpr int32_t kMaxNumPages = 32;
+
+	void setup(uint32_t arenaBegin, uint32_t arenaEnd);
+
+	// Returns NULL if requiredSize is too big, or there's no room
+	void* alloc(uint32_t requiredSize);
+	void dealloc(void* address);
+
+	bool contains(void* address) {
+		return (uint32_t)address >= start && (uint32_t)address < end;
+	}
+
+	void getStats(int32_t sizeClass, SlabStats* stats);
+
+	uint32_t start = 0;
+	uint32_t end = 0;
+
+private:
+	struct FreeSlot {
+		FreeSlot* next;
+	};
+
+	static constexpr uint8_t kPageUnused = 0xFF;
+
+	// Distance between allocations - each is 8-aligned, with its header in the 4 bytes before
+	static uint32_t getStride(int32_t sizeClass) { return 16 << sizeClass; }
+
+	bool addPage(int32_t sizeClass);
+
+	FreeSlot* freeSlots[kNumSizeClasses] = {};
+	uint8_t pageSizeClass[kMaxNumPages];
+	int32_t numPages = 0;
+	int32_t numPagesUsed = 0;
+
+	uint32_t numPagesPerClass[kNumSizeClasses] = {};
+	uint32_t numAllocated[kNumSizeClasses] = {};
+	uint32_t numFree[kNumSizeClasses] = {};
+	uint32_t numAllocs[kNumSizeClasses] = {};
+	uint32_t numOverflows[kNumSizeClasses] = {};
+};
@@ -29,5 +29,10 @@ public:
 	virtual void steal(char const* errorCode) = 0; // You gotta also call the destructor after this.
 	virtual int32_t getAppropriateQueue() = 0;
 
+	// Compaction may move us elsewhere in memory, by copying. Only say yes if relocated() can then fix up everything
+	// that might be pointing at us.
+	virtual bool mayBeRelocated() { return false; }
+	virtual void relocated(Stealable* oldAddress) {} // Called on the new copy, after the old one's been unlinked.
+
 	uint32_t lastTraversalNo = 0xFFFFFFFF;
 };
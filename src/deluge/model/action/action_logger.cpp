@@ -46,6 +46,7 @@
 #include "playback/mode/session.h"
 #include "playback/playback_handler.h"
 #include "processing/engines/audio_engine.h"
+#include "storage/song_autosaver.h"
 #include "util/functions.h"
 #include <new>
 #include <string.h>
@@ -82,6 +83,9 @@ void ActionLogger::deleteLastAction() {
 
 Action* ActionLogger::getNewAction(ActionType newActionType, ActionAddition addToExistingIfPossible) {
 
+	// Callers ask for an Action just before making their edit, and make it whether they get one or not
+	songAutosaver.songEdited();
+
 	deleteLog(AFTER);
 
 	// If not on a View, not allowed!
@@ -345,6 +349,7 @@ bool ActionLogger::revert(TimeType time, bool updateVisually, bool doNavigation)
 		firstAction[time] = firstAction[time]->nextAction;
 
 		revertAction(toRevert, updateVisually, doNavigation, time);
+		songAutosaver.songEdited();
 
 		toRevert->nextAction = firstAction[1 - time];
 		firstAction[1 - time] = toRevert;
@@ -770,7 +775,9 @@ void ActionLogger::closeActionUnlessCreatedJustNow(ActionType actionType) {
 	}
 }
 
+// Gets called whenever something's changed that can't be undone - so that counts as an edit too
 void ActionLogger::deleteAllLogs() {
+	songAutosaver.songEdited();
 	deleteLog(BEFORE);
 	deleteLog(AFTER);
 }
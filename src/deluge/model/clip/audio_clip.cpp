@@ -1301,6 +1301,15 @@ bool AudioClip::shiftHorizontally(ModelStackWithTimelineCounter* modelStack, int
 	return true;
 }
 
+// So the memory allocator holds on to our audio data in preference to others'
+void AudioClip::hintWillPlaySoon() {
+	Sample* sample = (Sample*)sampleHolder.audioFile;
+	if (sample) {
+		int64_t startSample = sampleControls.reversed ? sampleHolder.getEndPos() - 1 : sampleHolder.startPos;
+		sample->hintWillPlaySoon(startSample, sampleControls.reversed);
+	}
+}
+
 uint64_t AudioClip::getCullImmunity() {
 	uint32_t distanceFromEnd = loopLength - getLivePos();
 	// We're gonna cull time-stretching ones first
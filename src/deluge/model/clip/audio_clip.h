@@ -72,6 +72,7 @@ public:
 	void abortRecording();
 	void setupPlaybackBounds();
 	uint64_t getCullImmunity();
+	void hintWillPlaySoon();
 	void posReachedEnd(ModelStackWithTimelineCounter* modelStack);
 	void copyBasicsFrom(Clip* otherClip);
 	bool willCloneOutputForOverdub() { return overdubsShouldCloneOutput; }
@@ -72,7 +72,8 @@ Clip::Clip(ClipType newType) : type(newType) {
 }
 
 Clip::~Clip() {
-	if (getCurrentClip() == this) {
+	// When a whole Song's being deleted, currentSong has already been set to NULL
+	if (currentSong && getCurrentClip() == this) {
 		currentSong->setCurrentClip(nullptr);
 	}
 }
@@ -43,6 +43,7 @@
 #include "processing/engines/cv_engine.h"
 #include "processing/sound/sound_instrument.h"
 #include "storage/storage_manager.h"
+#include "storage/xml_tag.h"
 #include <cmath>
 #include <new>
 
@@ -2435,19 +2436,20 @@ someError:
 
 		int32_t temp;
 
-		if (!strcmp(tagName, "inKeyMode")) {
+		switch (xmlTagFromName(tagName)) {
+		case XMLTag::inKeyMode: {
 			inScaleMode = storageManager.readTagOrAttributeValueInt();
-		}
+		} break;
 
-		else if (!strcmp(tagName, "instrumentPresetSlot")) {
+		case XMLTag::instrumentPresetSlot: {
 			int32_t slotHere = storageManager.readTagOrAttributeValueInt();
 			String slotChars;
 			slotChars.setInt(slotHere, 3);
 			slotChars.concatenate(&instrumentPresetName);
 			instrumentPresetName.set(&slotChars);
-		}
+		} break;
 
-		else if (!strcmp(tagName, "instrumentPresetSubSlot")) {
+		case XMLTag::instrumentPresetSubSlot: {
 			int32_t subSlotHere = storageManager.readTagOrAttributeValueInt();
 			if (subSlotHere >= 0 && subSlotHere < 26) {
 				char buffer[2];
@@ -2455,121 +2457,121 @@ someError:
 				buffer[1] = 0;
 				instrumentPresetName.concatenate(buffer);
 			}
-		}
+		} break;
 
-		else if (!strcmp(tagName, "instrumentPresetName")) {
+		case XMLTag::instrumentPresetName: {
 			storageManager.readTagOrAttributeValueString(&instrumentPresetName);
-		}
+		} break;
 
-		else if (!strcmp(tagName, "instrumentPresetFolder")) {
+		case XMLTag::instrumentPresetFolder: {
 			storageManager.readTagOrAttributeValueString(&instrumentPresetDirPath);
 			dirPathHasBeenSpecified = true;
-		}
+		} break;
 
-		else if (!strcmp(tagName, "midiChannel")) {
+		case XMLTag::midiChannel: {
 			outputTypeWhileLoading = OutputType::MIDI_OUT;
 
 			// if (!instrument) instrument = storageManager.createNewNonAudioInstrument(OutputType::MIDI_OUT, 0, -1);
 			instrumentPresetSlot = storageManager.readTagOrAttributeValueInt();
-		}
+		} break;
 
-		else if (!strcmp(tagName, "midiChannelSuffix")) {
+		case XMLTag::midiChannelSuffix: {
 			instrumentPresetSubSlot = storageManager.readTagOrAttributeValueInt();
-		}
+		} break;
 
-		else if (!strcmp(tagName, "cvChannel")) {
+		case XMLTag::cvChannel: {
 			outputTypeWhileLoading = OutputType::CV;
 
 			// if (!instrument) instrument = storageManager.createNewNonAudioInstrument(OutputType::CV, 0, -1);
 			instrumentPresetSlot = storageManager.readTagOrAttributeValueInt();
-		}
+		} break;
 
-		else if (!strcmp(tagName, "midiBank")) {
+		case XMLTag::midiBank: {
 			midiBank = storageManager.readTagOrAttributeValueInt();
-		}
+		} break;
 
-		else if (!strcmp(tagName, "midiSub")) {
+		case XMLTag::midiSub: {
 			midiSub = storageManager.readTagOrAttributeValueInt();
-		}
+		} break;
 
-		else if (!strcmp(tagName, "midiPGM")) {
+		case XMLTag::midiPGM: {
 			midiPGM = storageManager.readTagOrAttributeValueInt();
-		}
+		} break;
 
-		else if (!strcmp(tagName, "yScroll")) {
+		case XMLTag::yScroll: {
 			yScroll = storageManager.readTagOrAttributeValueInt();
-		}
+		} break;
 
-		else if (!strcmp(tagName, "keyboardLayout")) {
+		case XMLTag::keyboardLayout: {
 			keyboardState.currentLayout = (KeyboardLayoutType)storageManager.readTagOrAttributeValueInt();
-		}
+		} break;
 
-		else if (!strcmp(tagName, "yScrollKeyboard")) {
+		case XMLTag::yScrollKeyboard: {
 			keyboardState.isomorphic.scrollOffset = storageManager.readTagOrAttributeValueInt();
-		}
+		} break;
 
-		else if (!strcmp(tagName, "keyboardRowInterval")) {
+		case XMLTag::keyboardRowInterval: {
 			keyboardState.isomorphic.rowInterval = storageManager.readTagOrAttributeValueInt();
-		}
+		} break;
 
-		else if (!strcmp(tagName, "drumsScrollOffset")) {
+		case XMLTag::drumsScrollOffset: {
 			keyboardState.drums.scrollOffset = storageManager.readTagOrAttributeValueInt();
-		}
+		} break;
 
-		else if (!strcmp(tagName, "drumsEdgeSize")) {
+		case XMLTag::drumsEdgeSize: {
 			keyboardState.drums.edgeSize = storageManager.readTagOrAttributeValueInt();
-		}
+		} break;
 
-		else if (!strcmp(tagName, "inKeyScrollOffset")) {
+		case XMLTag::inKeyScrollOffset: {
 			keyboardState.inKey.scrollOffset = storageManager.readTagOrAttributeValueInt();
-		}
+		} break;
 
-		else if (!strcmp(tagName, "inKeyRowInterval")) {
+		case XMLTag::inKeyRowInterval: {
 			keyboardState.inKey.rowInterval = storageManager.readTagOrAttributeValueInt();
-		}
+		} break;
 
-		else if (!strcmp(tagName, "crossScreenEditLevel")) {
+		case XMLTag::crossScreenEditLevel: {
 			wrapEditLevel = storageManager.readTagOrAttributeValueInt();
 			wrapEditing = true;
-		}
+		} break;
 
-		else if (!strcmp(tagName, "onKeyboardScreen")) {
+		case XMLTag::onKeyboardScreen: {
 			onKeyboardScreen = storageManager.readTagOrAttributeValueInt();
-		}
+		} break;
 
-		else if (!strcmp(tagName, "onAutomationInstrumentClipView")) {
+		case XMLTag::onAutomationInstrumentClipView: {
 			onAutomationClipView = storageManager.readTagOrAttributeValueInt();
-		}
+		} break;
 
-		else if (!strcmp(tagName, "lastSelectedParamID")) {
+		case XMLTag::lastSelectedParamID: {
 			lastSelectedParamID = storageManager.readTagOrAttributeValueInt();
-		}
+		} break;
 
-		else if (!strcmp(tagName, "lastSelectedParamKind")) {
+		case XMLTag::lastSelectedParamKind: {
 			lastSelectedParamKind = static_cast<params::Kind>(storageManager.readTagOrAttributeValueInt());
-		}
+		} break;
 
-		else if (!strcmp(tagName, "lastSelectedParamShortcutX")) {
+		case XMLTag::lastSelectedParamShortcutX: {
 			lastSelectedParamShortcutX = storageManager.readTagOrAttributeValueInt();
-		}
+		} break;
 
-		else if (!strcmp(tagName, "lastSelectedParamShortcutY")) {
+		case XMLTag::lastSelectedParamShortcutY: {
 			lastSelectedParamShortcutY = storageManager.readTagOrAttributeValueInt();
-		}
+		} break;
 
-		else if (!strcmp(tagName, "lastSelectedInstrumentType")) {
+		case XMLTag::lastSelectedInstrumentType: {
 			lastSelectedOutputType = static_cast<OutputType>(storageManager.readTagOrAttributeValueInt());
-		}
+		} break;
 
-		else if (!strcmp(tagName, "affectEntire")) {
+		case XMLTag::affectEntire: {
 			affectEntire = storageManager.readTagOrAttributeValueInt();
-		}
+		} break;
 
-		else if (!strcmp(tagName, "soundMidiCommand")) { // Only for pre V2.0 song files
+		case XMLTag::soundMidiCommand: { // Only for pre V2.0 song files
 			soundMidiCommand.readChannelFromFile();
-		}
+		} break;
 
-		else if (!strcmp(tagName, "modKnobs")) { // Pre V2.0 only - for compatibility
+		case XMLTag::modKnobs: { // Pre V2.0 only - for compatibility
 
 			outputTypeWhileLoading = OutputType::MIDI_OUT;
 
@@ -2598,9 +2600,9 @@ someError:
 			if (loopLength) {
 				paramManager.getMIDIParamCollection()->makeInterpolatedCCsGoodAgain(loopLength);
 			}
-		}
+		} break;
 
-		else if (!strcmp(tagName, "arpeggiator")) {
+		case XMLTag::arpeggiator: {
 			while (*(tagName = storageManager.readNextTagOrAttributeName())) {
 
 				if (!strcmp(tagName, "rate")) {
@@ -2659,11 +2661,11 @@ someError:
 					storageManager.exitTag(tagName);
 				}
 			}
-		}
+		} break;
 
 		// For song files from before V2.0, where Instruments were stored within the Clip.
 		// Loading Instrument from another Clip.
-		else if (!strcmp(tagName, "instrument")) {
+		case XMLTag::instrument: {
 			if (*(tagName = storageManager.readNextTagOrAttributeName())) {
 				if (!strcmp(tagName, "referToTrackId")) {
 					if (!output) {
@@ -2688,10 +2690,11 @@ someError:
 					storageManager.exitTag("referToTrackId");
 				}
 			}
-		}
+		} break;
 
 		// For song files from before V2.0, where Instruments were stored within the Clip
-		else if (!strcmp(tagName, "sound") || !strcmp(tagName, "synth")) {
+		case XMLTag::sound:
+		case XMLTag::synth: {
 			if (!output) {
 				{
 					void* instrumentMemory = GeneralMemoryAllocator::get().allocMaxSpeed(sizeof(SoundInstrument));
@@ -2722,10 +2725,10 @@ loadInstrument:
 				// Add the Instrument to the Song
 				song->addOutput(output);
 			}
-		}
+		} break;
 
 		// For song files from before V2.0, where Instruments were stored within the Clip
-		else if (!strcmp(tagName, "kit")) {
+		case XMLTag::kit: {
 			if (!output) {
 				void* instrumentMemory = GeneralMemoryAllocator::get().allocMaxSpeed(sizeof(Kit));
 				if (!instrumentMemory) {
@@ -2741,9 +2744,9 @@ loadInstrument:
 				output = kit;
 				goto loadInstrument;
 			}
-		}
+		} break;
 
-		else if (!strcmp(tagName, "soundParams")) {
+		case XMLTag::soundParams: {
 			outputTypeWhileLoading = OutputType::SYNTH;
 
 			// Normal case - load in brand new ParamManager
@@ -2770,9 +2773,9 @@ createNewParamManager:
 				}
 			}
 			Sound::readParamsFromFile(&paramManager, readAutomationUpToPos);
-		}
+		} break;
 
-		else if (!strcmp(tagName, "kitParams")) {
+		case XMLTag::kitParams: {
 			outputTypeWhileLoading = OutputType::KIT;
 			error = paramManager.setupUnpatched();
 			if (error) {
@@ -2781,9 +2784,9 @@ createNewParamManager:
 
 			GlobalEffectableForClip::initParams(&paramManager);
 			GlobalEffectableForClip::readParamsFromFile(&paramManager, readAutomationUpToPos);
-		}
+		} break;
 
-		else if (!strcmp(tagName, "midiParams")) {
+		case XMLTag::midiParams: {
 			outputTypeWhileLoading = OutputType::MIDI_OUT;
 			error = paramManager.setupMIDI();
 			if (error) {
@@ -2794,9 +2797,9 @@ createNewParamManager:
 			if (error) {
 				goto someError;
 			}
-		}
+		} break;
 
-		else if (!strcmp(tagName, "noteRows")) {
+		case XMLTag::noteRows: {
 			int32_t minY = -32768;
 			while (*(tagName = storageManager.readNextTagOrAttributeName())) {
 				if (!strcmp(tagName, "noteRow")) {
@@ -2811,10 +2814,10 @@ createNewParamManager:
 				}
 				storageManager.exitTag();
 			}
-		}
+		} break;
 
 		// These are the expression params for MPE
-		else if (!strcmp(tagName, "pitchBend")) {
+		case XMLTag::pitchBend: {
 			temp = 0;
 doReadExpressionParam:
 			paramManager.ensureExpressionParamSetExists();
@@ -2823,43 +2826,44 @@ doReadExpressionParam:
 			if (expressionParams) {
 				expressionParams->readParam(summary, temp, readAutomationUpToPos);
 			}
-		}
+		} break;
 
-		else if (!strcmp(tagName, "yExpression")) {
+		case XMLTag::yExpression: {
 			temp = 1;
 			goto doReadExpressionParam;
-		}
+		} break;
 
-		else if (!strcmp(tagName, "channelPressure")) {
+		case XMLTag::channelPressure: {
 			temp = 2;
 			goto doReadExpressionParam;
-		} // -----------------------------------------------------------------------------------
+		} break; // -----------------------------------------------------------------------------------
 
-		else if (!strcmp(tagName, "expressionData")) {
+		case XMLTag::expressionData: {
 			paramManager.ensureExpressionParamSetExists();
 			ParamCollectionSummary* summary = paramManager.getExpressionParamSetSummary();
 			ExpressionParamSet* expressionParams = (ExpressionParamSet*)summary->paramCollection;
 			if (expressionParams) {
 				expressionParams->readFromFile(summary, readAutomationUpToPos);
 			}
-		}
+		} break;
 
-		else if (!strcmp(tagName, "bendRange")) {
+		case XMLTag::bendRange: {
 			temp = BEND_RANGE_MAIN;
 doReadBendRange:
 			ExpressionParamSet* expressionParams = paramManager.getOrCreateExpressionParamSet();
 			if (expressionParams) {
 				expressionParams->bendRanges[temp] = storageManager.readTagOrAttributeValueInt();
 			}
-		}
+		} break;
 
-		else if (!strcmp(tagName, "bendRangeMPE")) {
+		case XMLTag::bendRangeMPE: {
 			temp = BEND_RANGE_FINGER_LEVEL;
 			goto doReadBendRange;
-		}
+		} break;
 
-		else {
+		default:
 			readTagFromFile(tagName, song, &readAutomationUpToPos);
+			break;
 		}
 
 		storageManager.exitTag();
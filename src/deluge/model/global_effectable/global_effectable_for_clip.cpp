@@ -19,6 +19,7 @@
 #include "definitions_cxx.hpp"
 #include "gui/l10n/l10n.h"
 #include "gui/views/view.h"
+#include "io/debug/trace.h"
 #include "model/action/action.h"
 #include "model/action/action_logger.h"
 #include "processing/engines/audio_engine.h"
@@ -179,7 +180,10 @@ doNormal:
 
 		processReverbSendAndVolume(globalEffectableBuffer, numSamples, reverbBuffer, volumePostFX, postReverbVolume,
 		                           reverbSendAmount, pan, true);
-		compressor.renderVolNeutral(globalEffectableBuffer, numSamples, volumePostFX);
+		{
+			TRACE_ZONE(TraceZone::COMPRESSOR, numSamples);
+			compressor.renderVolNeutral(globalEffectableBuffer, numSamples, volumePostFX);
+		}
 		addAudio(globalEffectableBuffer, outputBuffer, numSamples);
 	}
 
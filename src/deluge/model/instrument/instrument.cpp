@@ -25,6 +25,7 @@
 #include "model/model_stack.h"
 #include "processing/engines/audio_engine.h"
 #include "storage/audio/audio_file_manager.h"
+#include "storage/song_autosaver.h"
 #include "storage/storage_manager.h"
 #include <cstring>
 #include <new>
@@ -45,6 +46,7 @@ Instrument::~Instrument() {
 // Returns whether subslot changed
 void Instrument::beenEdited(bool shouldMoveToEmptySlot) {
 	editedByUser = true;
+	songAutosaver.songEdited();
 }
 
 void Instrument::deleteAnyInstancesOfClip(InstrumentClip* clip) {
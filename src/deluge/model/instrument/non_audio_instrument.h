@@ -20,6 +20,7 @@
 #include "model/instrument/melodic_instrument.h"
 #include "model/mod_controllable/mod_controllable.h"
 #include "storage/flash_storage.h"
+#include "storage/song_autosaver.h"
 
 class ModelStack;
 class ModelStackWithSoundFlags;
@@ -44,7 +45,7 @@ public:
 	void polyphonicExpressionEventOnChannelOrNote(int32_t newValue, int32_t whichExpressionDimension,
 	                                              int32_t channelOrNote, MIDICharacteristic whichCharacteristic) final;
 
-	void beenEdited(bool shouldMoveToEmptySlot) {} // Probably don't need this anymore...
+	void beenEdited(bool shouldMoveToEmptySlot) { songAutosaver.songEdited(); }
 
 	char const* getSlotXMLTag() { return "channel"; }
 	char const* getSubSlotXMLTag() { return NULL; }
@@ -17,6 +17,7 @@
 
 #include "model/mod_controllable/mod_controllable_audio.h"
 #include "definitions_cxx.hpp"
+#include "dsp/fx_kernels.h"
 #include "deluge/model/settings/runtime_feature_settings.h"
 #include "gui/l10n/l10n.h"
 #include "gui/views/automation_view.h"
@@ -24,6 +25,7 @@
 #include "gui/views/session_view.h"
 #include "gui/views/view.h"
 #include "io/debug/log.h"
+#include "io/debug/trace.h"
 #include "io/midi/midi_device.h"
 #include "io/midi/midi_engine.h"
 #include "io/midi/midi_follow.h"
@@ -36,6 +38,7 @@
 #include "processing/engines/audio_engine.h"
 #include "processing/sound/sound.h"
 #include "storage/storage_manager.h"
+#include "storage/xml_tag.h"
 
 namespace params = deluge::modulation::params;
 
@@ -180,6 +183,7 @@ void ModControllableAudio::processFX(StereoSample* buffer, int32_t numSamples, M
 
 	// Mod FX -----------------------------------------------------------------------------------
 	if (modFXType != ModFXType::NONE) {
+		TRACE_ZONE(TraceZone::MOD_FX, numSamples);
 
 		LFOType modFXLFOWaveType;
 		int32_t modFXDelayOffset;
@@ -294,15 +298,7 @@ void ModControllableAudio::processFX(StereoSample* buffer, int32_t numSamples, M
 				phaserMemory.r = currentSample->r + (multiply_32x32_rshift32_rounded(phaserMemory.r, feedback) << 1);
 
 				// Do the allpass filters
-				for (auto& sample : allpassMemory) {
-					StereoSample whatWasInput = phaserMemory;
-
-					phaserMemory.l = (multiply_32x32_rshift32_rounded(phaserMemory.l, -_a1) << 2) + sample.l;
-					sample.l = (multiply_32x32_rshift32_rounded(phaserMemory.l, _a1) << 2) + whatWasInput.l;
-
-					phaserMemory.r = (multiply_32x32_rshift32_rounded(phaserMemory.r, -_a1) << 2) + sample.r;
-					sample.r = (multiply_32x32_rshift32_rounded(phaserMemory.r, _a1) << 2) + whatWasInput.r;
-				}
+				deluge::dsp::kernels::doPhaserAllpasses(phaserMemory, allpassMemory, kNumAllpassFiltersPhaser, _a1);
 
 				currentSample->l += phaserMemory.l;
 				currentSample->r += phaserMemory.r;
@@ -539,6 +535,7 @@ void ModControllableAudio::processFX(StereoSample* buffer, int32_t numSamples, M
 	DelayBufferSetup delaySecondarySetup;
 
 	if (delayWorkingState->doDelay) {
+		TRACE_ZONE(TraceZone::DELAY, numSamples);
 
 		if (delayWorkingState->userDelayRate != delay.userRateLastTime) {
 			delay.userRateLastTime = delayWorkingState->userDelayRate;
@@ -610,14 +607,7 @@ void ModControllableAudio::processFX(StereoSample* buffer, int32_t numSamples, M
 			// Native read
 			if (!delay.primaryBuffer.isResampling) {
 
-				int32_t* workingBufferPos = delayWorkingBuffer;
-				do {
-					wrapped = delay.primaryBuffer.clearAndMoveOn() || wrapped;
-					workingBufferPos[0] = delay.primaryBuffer.bufferCurrentPos->l;
-					workingBufferPos[1] = delay.primaryBuffer.bufferCurrentPos->r;
-
-					workingBufferPos += 2;
-				} while (workingBufferPos != workingBufferEnd);
+				wrapped = delay.primaryBuffer.moveOnAndRead((StereoSample*)delayWorkingBuffer, numSamples, true);
 			}
 
 			// Or, resampling read
@@ -662,15 +652,7 @@ void ModControllableAudio::processFX(StereoSample* buffer, int32_t numSamples, M
 
 		if (delay.analog) {
 
-			{
-				int32_t* workingBufferPos = delayWorkingBuffer;
-				do {
-					delay.impulseResponseProcessor.process(workingBufferPos[0], workingBufferPos[1],
-					                                       &workingBufferPos[0], &workingBufferPos[1]);
-
-					workingBufferPos += 2;
-				} while (workingBufferPos != workingBufferEnd);
-			}
+			delay.impulseResponseProcessor.processBlock(delayWorkingBuffer, workingBufferEnd);
 
 			{
 				int32_t* workingBufferPos = delayWorkingBuffer;
@@ -696,92 +678,18 @@ void ModControllableAudio::processFX(StereoSample* buffer, int32_t numSamples, M
 		}
 
 		else {
-			int32_t* workingBufferPos = delayWorkingBuffer;
-			do {
-				// Leave more headroom, because making it clip sounds bad with pure digital
-				workingBufferPos[0] = signed_saturate<32 - 3>(multiply_32x32_rshift32(
-				                          workingBufferPos[0], delayWorkingState->delayFeedbackAmount))
-				                      << 2;
-				workingBufferPos[1] = signed_saturate<32 - 3>(multiply_32x32_rshift32(
-				                          workingBufferPos[1], delayWorkingState->delayFeedbackAmount))
-				                      << 2;
-
-				workingBufferPos += 2;
-			} while (workingBufferPos != workingBufferEnd);
+			deluge::dsp::kernels::applyDigitalDelayFeedback(delayWorkingBuffer, workingBufferEnd,
+			                                                delayWorkingState->delayFeedbackAmount);
 		}
 
 		// HPF on delay output, to stop it "farting out". Corner frequency is somewhere around 40Hz after many
 		// repetitions
-		{
-			int32_t* workingBufferPos = delayWorkingBuffer;
-			do {
-				int32_t distanceToGoL = workingBufferPos[0] - delay.postLPFL;
-				delay.postLPFL += distanceToGoL >> 11;
-				workingBufferPos[0] -= delay.postLPFL;
-
-				int32_t distanceToGoR = workingBufferPos[1] - delay.postLPFR;
-				delay.postLPFR += distanceToGoR >> 11;
-				workingBufferPos[1] -= delay.postLPFR;
-
-				workingBufferPos += 2;
-			} while (workingBufferPos != workingBufferEnd);
-		}
-
-		{
-			StereoSample* currentSample = buffer;
-			int32_t* workingBufferPos = delayWorkingBuffer;
-			// Go through what we grabbed, sending it to the audio output buffer, and also preparing it to be fed back
-			// into the delay
-			do {
-
-				int32_t fromDelayL = workingBufferPos[0];
-				int32_t fromDelayR = workingBufferPos[1];
-
-				/*
-				if (delay.analog) {
-				    // Reduce headroom, since this sounds ok with analog sim
-				    fromDelayL = getTanH(multiply_32x32_rshift32(fromDelayL, delayWorkingState->delayFeedbackAmount), 8)
-				<< 2; fromDelayR = getTanH(multiply_32x32_rshift32(fromDelayR, delayWorkingState->delayFeedbackAmount),
-				8) << 2;
-				}
-
-				else {
-				    fromDelayL =
-				signed_saturate<delayWorkingState->delayFeedbackAmount>(multiply_32x32_rshift32(fromDelayL), 32 - 3) <<
-				2; fromDelayR =
-				signed_saturate<delayWorkingState->delayFeedbackAmount>(multiply_32x32_rshift32(fromDelayR), 32 - 3) <<
-				2;
-				}
-				*/
-
-				/*
-				// HPF on delay output, to stop it "farting out". Corner frequency is somewhere around 40Hz after many
-				repetitions int32_t distanceToGoL = fromDelayL - delay.postLPFL; delay.postLPFL += distanceToGoL >> 11;
-				fromDelayL -= delay.postLPFL;
-
-				int32_t distanceToGoR = fromDelayR - delay.postLPFR;
-				delay.postLPFR += distanceToGoR >> 11;
-				fromDelayR -= delay.postLPFR;
-				*/
-
-				// Feedback calculation, and combination with input
-				if (delay.pingPong && AudioEngine::renderInStereo) {
-					workingBufferPos[0] = fromDelayR;
-					workingBufferPos[1] = ((currentSample->l + currentSample->r) >> 1) + fromDelayL;
-				}
-				else {
-					workingBufferPos[0] = currentSample->l + fromDelayL;
-					workingBufferPos[1] = currentSample->r + fromDelayR;
-				}
+		deluge::dsp::kernels::applyDelayPostHPF(delayWorkingBuffer, workingBufferEnd, delay.postLPFL, delay.postLPFR);
 
-				// Output
-				currentSample->l += fromDelayL;
-				currentSample->r += fromDelayR;
-
-				currentSample++;
-				workingBufferPos += 2;
-			} while (workingBufferPos != workingBufferEnd);
-		}
+		// Go through what we grabbed, sending it to the audio output buffer, and also preparing it to be fed back into
+		// the delay
+		deluge::dsp::kernels::mixDelayOutput(buffer, delayWorkingBuffer, workingBufferEnd,
+		                                     delay.pingPong && AudioEngine::renderInStereo);
 
 		// And actually feedback being applied back into the actual delay primary buffer...
 		if (delay.primaryBuffer.isActive()) {
@@ -1132,52 +1040,45 @@ void ModControllableAudio::processStutter(StereoSample* buffer, int32_t numSampl
 		}
 	}
 
-	else { // PLAYING
+	else if (!stutterer.buffer.isResampling) { // PLAYING, non-resampling - read it all in one go
+		stutterer.buffer.moveOnAndRead(buffer, numSamples, false);
+	}
+
+	else { // PLAYING, resampling
 
 		do {
 			int32_t strength1;
 			int32_t strength2;
 
-			// Non-resampling read
-			if (!stutterer.buffer.isResampling) {
+			// Move forward, and clear buffer as we go
+			stutterer.buffer.longPos += delayBufferSetup.actualSpinRate;
+			uint8_t newShortPos = stutterer.buffer.longPos >> 24;
+			uint8_t shortPosDiff = newShortPos - stutterer.buffer.lastShortPos;
+			stutterer.buffer.lastShortPos = newShortPos;
+
+			while (shortPosDiff > 0) {
 				stutterer.buffer.moveOn();
-				thisSample->l = stutterer.buffer.bufferCurrentPos->l;
-				thisSample->r = stutterer.buffer.bufferCurrentPos->r;
+				shortPosDiff--;
 			}
 
-			// Or, resampling read
-			else {
-
-				// Move forward, and clear buffer as we go
-				stutterer.buffer.longPos += delayBufferSetup.actualSpinRate;
-				uint8_t newShortPos = stutterer.buffer.longPos >> 24;
-				uint8_t shortPosDiff = newShortPos - stutterer.buffer.lastShortPos;
-				stutterer.buffer.lastShortPos = newShortPos;
-
-				while (shortPosDiff > 0) {
-					stutterer.buffer.moveOn();
-					shortPosDiff--;
-				}
-
-				strength2 = (stutterer.buffer.longPos >> 8) & 65535;
-				strength1 = 65536 - strength2;
+			strength2 = (stutterer.buffer.longPos >> 8) & 65535;
+			strength1 = 65536 - strength2;
 
-				StereoSample* nextPos = stutterer.buffer.bufferCurrentPos + 1;
-				if (nextPos == stutterer.buffer.bufferEnd) {
-					nextPos = stutterer.buffer.bufferStart;
-				}
-				int32_t fromDelay1L = stutterer.buffer.bufferCurrentPos->l;
-				int32_t fromDelay1R = stutterer.buffer.bufferCurrentPos->r;
-				int32_t fromDelay2L = nextPos->l;
-				int32_t fromDelay2R = nextPos->r;
-
-				thisSample->l = (multiply_32x32_rshift32(fromDelay1L, strength1 << 14)
-				                 + multiply_32x32_rshift32(fromDelay2L, strength2 << 14))
-				                << 2;
-				thisSample->r = (multiply_32x32_rshift32(fromDelay1R, strength1 << 14)
-				                 + multiply_32x32_rshift32(fromDelay2R, strength2 << 14))
-				                << 2;
+			StereoSample* nextPos = stutterer.buffer.bufferCurrentPos + 1;
+			if (nextPos == stutterer.buffer.bufferEnd) {
+				nextPos = stutterer.buffer.bufferStart;
 			}
+			int32_t fromDelay1L = stutterer.buffer.bufferCurrentPos->l;
+			int32_t fromDelay1R = stutterer.buffer.bufferCurrentPos->r;
+			int32_t fromDelay2L = nextPos->l;
+			int32_t fromDelay2R = nextPos->r;
+
+			thisSample->l = (multiply_32x32_rshift32(fromDelay1L, strength1 << 14)
+			                 + multiply_32x32_rshift32(fromDelay2L, strength2 << 14))
+			                << 2;
+			thisSample->r = (multiply_32x32_rshift32(fromDelay1R, strength1 << 14)
+			                 + multiply_32x32_rshift32(fromDelay2R, strength2 << 14))
+			                << 2;
 		} while (++thisSample != bufferEnd);
 	}
 }
@@ -1443,25 +1344,26 @@ int32_t ModControllableAudio::readTagFromFile(char const* tagName, ParamManagerF
 
 	int32_t p;
 
-	if (!strcmp(tagName, "lpfMode")) {
+	switch (xmlTagFromName(tagName)) {
+	case XMLTag::lpfMode: {
 		lpfMode = stringToLPFType(storageManager.readTagOrAttributeValue());
 		storageManager.exitTag("lpfMode");
-	}
-	else if (!strcmp(tagName, "hpfMode")) {
+	} break;
+	case XMLTag::hpfMode: {
 		hpfMode = stringToLPFType(storageManager.readTagOrAttributeValue());
 		storageManager.exitTag("hpfMode");
-	}
-	else if (!strcmp(tagName, "filterRoute")) {
+	} break;
+	case XMLTag::filterRoute: {
 		filterRoute = stringToFilterRoute(storageManager.readTagOrAttributeValue());
 		storageManager.exitTag("filterRoute");
-	}
+	} break;
 
-	else if (!strcmp(tagName, "clippingAmount")) {
+	case XMLTag::clippingAmount: {
 		clippingAmount = storageManager.readTagOrAttributeValueInt();
 		storageManager.exitTag("clippingAmount");
-	}
+	} break;
 
-	else if (!strcmp(tagName, "delay")) {
+	case XMLTag::delay: {
 		// Set default values in case they are not configured
 		delay.syncType = SYNC_TYPE_EVEN;
 		delay.syncLevel = SYNC_LEVEL_NONE;
@@ -1514,9 +1416,9 @@ doReadPatchedParam:
 			}
 		}
 		storageManager.exitTag("delay");
-	}
+	} break;
 
-	else if (!strcmp(tagName, "audioCompressor")) {
+	case XMLTag::audioCompressor: {
 		while (*(tagName = storageManager.readNextTagOrAttributeName())) {
 			if (!strcmp(tagName, "attack")) {
 				q31_t masterCompressorAttack = storageManager.readTagOrAttributeValueInt();
@@ -1548,9 +1450,10 @@ doReadPatchedParam:
 			}
 		}
 		storageManager.exitTag("AudioCompressor");
-	}
+	} break;
 	// this is actually the sidechain but pre c1.1 songs save it as compressor
-	else if (!strcmp(tagName, "compressor") || !strcmp(tagName, "sidechain")) { // Remember, Song doesn't use this
+	case XMLTag::compressor:
+	case XMLTag::sidechain: { // Remember, Song doesn't use this
 		// Set default values in case they are not configured
 		const char* name = tagName;
 		sidechain.syncType = SYNC_TYPE_EVEN;
@@ -1578,9 +1481,9 @@ doReadPatchedParam:
 			}
 		}
 		storageManager.exitTag(name);
-	}
+	} break;
 
-	else if (!strcmp(tagName, "midiKnobs")) {
+	case XMLTag::midiKnobs: {
 
 		while (*(tagName = storageManager.readNextTagOrAttributeName())) {
 			if (!strcmp(tagName, "midiKnob")) {
@@ -1641,9 +1544,9 @@ doReadPatchedParam:
 			storageManager.exitTag();
 		}
 		storageManager.exitTag("midiKnobs");
-	}
+	} break;
 
-	else {
+	default:
 		return RESULT_TAG_UNUSED;
 	}
 
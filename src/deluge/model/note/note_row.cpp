@@ -2920,6 +2920,89 @@ uint32_t NoteRow::getNumNotes() {
 	return notes.getNumElements();
 }
 
+// Adds a Note read from the file, unless it's invalid or overlaps the previous one. Returns false only if there wasn't
+// the RAM.
+static bool addNoteFromFile(NoteVector* notes, int32_t pos, int32_t length, uint8_t velocity, uint8_t lift,
+                            uint8_t probability, int32_t* minPos) {
+	// See if that's all allowed
+	if (lift == 0 || lift > 127) {
+		lift = kDefaultLiftValue;
+	}
+	if (length <= 0) {
+		length = 1; // This happened somehow in Simon Wollwage's song, May 2020
+	}
+	if (pos < *minPos || pos > kMaxSequenceLength - length) {
+		return true;
+	}
+	if (velocity == 0 || velocity > 127) {
+		velocity = 64;
+	}
+	if ((probability & 127) > (kNumProbabilityValues + kNumIterationValues)
+	    || probability >= (kNumProbabilityValues | 128)) {
+		probability = kNumProbabilityValues;
+	}
+
+	*minPos = pos + length;
+
+	// Ok, make the note
+	int32_t i = notes->insertAtKey(pos, true);
+	if (i == -1) {
+		return false;
+	}
+	Note* newNote = notes->getElement(i);
+	newNote->setLength(length);
+	newNote->setVelocity(velocity);
+	newNote->setLift(lift);
+	newNote->setProbability(probability);
+	return true;
+}
+
+// Adds the Note stored in one entry of noteData (noteHexLength 20) or noteDataWithLift (22)
+static bool readNoteFromHex(NoteVector* notes, char const* hexChars, int32_t noteHexLength, int32_t* minPos) {
+	int32_t pos = hexToIntFixedLength(hexChars, 8);
+	int32_t length = hexToIntFixedLength(&hexChars[8], 8);
+	uint8_t velocity = hexToIntFixedLength(&hexChars[16], 2);
+
+	if (noteHexLength == 22) { // If reading lift...
+		return addNoteFromFile(notes, pos, length, velocity, hexToIntFixedLength(&hexChars[18], 2),
+		                       hexToIntFixedLength(&hexChars[20], 2), minPos);
+	}
+	else { // Or if no lift here to read
+		return addNoteFromFile(notes, pos, length, velocity, kDefaultLiftValue, hexToIntFixedLength(&hexChars[18], 2),
+		                       minPos);
+	}
+}
+
+// For noteDataWithLift in a binary song. Returns error code
+static int32_t readNotesFromBinary(NoteVector* notes) {
+	constexpr int32_t kNumRecordsPerRead = 32;
+	BinarySongFormat::NoteRecord records[kNumRecordsPerRead];
+	int32_t minPos = 0;
+
+	int32_t numBytesInRun;
+	while ((numBytesInRun = storageManager.readBinaryValueRunLength()) > 0) {
+		int32_t numRecordsLeft = numBytesInRun / sizeof(BinarySongFormat::NoteRecord);
+		notes->ensureEnoughSpaceAllocated(numRecordsLeft); // If it returns false... oh well. We'll fail later
+
+		while (numRecordsLeft) {
+			int32_t numRecordsHere = std::min(numRecordsLeft, kNumRecordsPerRead);
+			if (!storageManager.readBinaryBytes(records, numRecordsHere * sizeof(BinarySongFormat::NoteRecord))) {
+				return NO_ERROR;
+			}
+			numRecordsLeft -= numRecordsHere;
+
+			for (int32_t r = 0; r < numRecordsHere; r++) {
+				BinarySongFormat::NoteRecord* record = &records[r];
+				if (!addNoteFromFile(notes, record->pos, record->length, record->velocity, record->lift,
+				                     record->probability, &minPos)) {
+					return ERROR_INSUFFICIENT_RAM;
+				}
+			}
+		}
+	}
+	return NO_ERROR;
+}
+
 int32_t NoteRow::readFromFile(int32_t* minY, InstrumentClip* parentClip, Song* song, int32_t readAutomationUpToPos) {
 	char const* tagName;
 
@@ -3075,9 +3158,17 @@ finishedNormalStuff:
 doReadNoteData:
 			int32_t minPos = 0;
 
-			int32_t numElementsToAllocateFor = 0;
+			if (!storageManager.prepareToReadTagOrAttributeValueOneCharAtATime(true)) {
+				goto getOut;
+			}
 
-			if (!storageManager.prepareToReadTagOrAttributeValueOneCharAtATime()) {
+			if (storageManager.getBinaryValueKind() != BinarySongFormat::ValueKind::NONE) {
+				if (storageManager.getBinaryValueKind() == BinarySongFormat::ValueKind::NOTES) {
+					int32_t error = readNotesFromBinary(&notes);
+					if (error) {
+						return error;
+					}
+				}
 				goto getOut;
 			}
 
@@ -3090,73 +3181,30 @@ doReadNoteData:
 
 			while (true) {
 
-				// Every time we've reached the end of a cluster...
-				if (numElementsToAllocateFor <= 0) {
+				// Decode every whole note that's in the buffer already, straight from there...
+				int32_t numNotesHere = storageManager.getNumCharsRemainingInValue() / noteHexLength;
+				if (numNotesHere) {
+					notes.ensureEnoughSpaceAllocated(numNotesHere); // If it returns false... oh well. We'll fail later
+					char const* hexChars = &storageManager.fileClusterBuffer[storageManager.fileBufferCurrentPos];
+					storageManager.fileBufferCurrentPos += numNotesHere * noteHexLength;
 
-					// See how many more chars before the end of the cluster. If there are any...
-					uint32_t charsRemaining = storageManager.getNumCharsRemainingInValue();
-					if (charsRemaining) {
-
-						// Allocate space for the right number of notes, and remember how long it'll be before we need
-						// to do this check again
-						numElementsToAllocateFor = (uint32_t)(charsRemaining - 1) / noteHexLength + 1;
-						notes.ensureEnoughSpaceAllocated(
-						    numElementsToAllocateFor); // If it returns false... oh well. We'll fail later
+					for (int32_t n = 0; n < numNotesHere; n++) {
+						if (!readNoteFromHex(&notes, hexChars, noteHexLength, &minPos)) {
+							return ERROR_INSUFFICIENT_RAM;
+						}
+						hexChars += noteHexLength;
 					}
+					storageManager.yieldToRoutinesIfDue();
 				}
 
+				// ...then the one running over into the next cluster, if the value doesn't end here
 				char const* hexChars = storageManager.readNextCharsOfTagOrAttributeValue(noteHexLength);
 				if (!hexChars) {
 					goto getOut;
 				}
-
-				int32_t pos = hexToIntFixedLength(hexChars, 8);
-				int32_t length = hexToIntFixedLength(&hexChars[8], 8);
-				uint8_t velocity = hexToIntFixedLength(&hexChars[16], 2);
-				uint8_t lift, probability;
-
-				if (noteHexLength == 22) { // If reading lift...
-					probability = hexToIntFixedLength(&hexChars[20], 2);
-					lift = hexToIntFixedLength(&hexChars[18], 2);
-					if (lift == 0 || lift > 127) {
-						goto useDefaultLift;
-					}
-				}
-				else { // Or if no lift here to read
-					probability = hexToIntFixedLength(&hexChars[18], 2);
-useDefaultLift:
-					lift = kDefaultLiftValue;
-				}
-
-				// See if that's all allowed
-				if (length <= 0) {
-					length = 1; // This happened somehow in Simon Wollwage's song, May 2020
-				}
-				if (pos < minPos || pos > kMaxSequenceLength - length) {
-					continue;
-				}
-				if (velocity == 0 || velocity > 127) {
-					velocity = 64;
-				}
-				if ((probability & 127) > (kNumProbabilityValues + kNumIterationValues)
-				    || probability >= (kNumProbabilityValues | 128)) {
-					probability = kNumProbabilityValues;
-				}
-
-				minPos = pos + length;
-
-				// Ok, make the note
-				int32_t i = notes.insertAtKey(pos, true);
-				if (i == -1) {
+				if (!readNoteFromHex(&notes, hexChars, noteHexLength, &minPos)) {
 					return ERROR_INSUFFICIENT_RAM;
 				}
-				Note* newNote = notes.getElement(i);
-				newNote->setLength(length);
-				newNote->setVelocity(velocity);
-				newNote->setLift(lift);
-				newNote->setProbability(probability);
-
-				numElementsToAllocateFor--;
 			}
 getOut: {}
 		}
@@ -3220,25 +3268,26 @@ void NoteRow::writeToFile(int32_t drumIndex, InstrumentClip* clip) {
 		storageManager.printIndents();
 		storageManager.write("noteDataWithLift=\"0x");
 
+		// Hex for a batch of notes at a time gets put together here, then written in one go
+		constexpr int32_t kNoteHexLength = 22;
+		constexpr int32_t kNumNotesPerWrite = 16;
+		char buffer[kNoteHexLength * kNumNotesPerWrite + 1];
+		char* bufferPos = buffer;
+
 		for (int32_t n = 0; n < notes.getNumElements(); n++) {
 			Note* thisNote = notes.getElement(n);
 
-			char buffer[9];
-
-			intToHex(thisNote->pos, buffer);
-			storageManager.write(buffer);
-
-			intToHex(thisNote->getLength(), buffer);
-			storageManager.write(buffer);
+			intToHex(thisNote->pos, bufferPos);
+			intToHex(thisNote->getLength(), &bufferPos[8]);
+			intToHex(thisNote->getVelocity(), &bufferPos[16], 2);
+			intToHex(thisNote->getLift(), &bufferPos[18], 2);
+			intToHex(thisNote->getProbability(), &bufferPos[20], 2);
+			bufferPos += kNoteHexLength;
 
-			intToHex(thisNote->getVelocity(), buffer, 2);
-			storageManager.write(buffer);
-
-			intToHex(thisNote->getLift(), buffer, 2);
-			storageManager.write(buffer);
-
-			intToHex(thisNote->getProbability(), buffer, 2);
-			storageManager.write(buffer);
+			if (bufferPos == &buffer[kNoteHexLength * kNumNotesPerWrite] || n == notes.getNumElements() - 1) {
+				storageManager.write(buffer);
+				bufferPos = buffer;
+			}
 		}
 		storageManager.write("\"");
 	}
@@ -23,9 +23,12 @@
 #include "io/debug/log.h"
 #include "memory/general_memory_allocator.h"
 #include "model/sample/sample_cache.h"
+#include "model/sample/sample_peak_pyramid.h"
 #include "model/sample/sample_perc_cache_zone.h"
 #include "processing/engines/audio_engine.h"
 #include "storage/audio/audio_file_manager.h"
+#include "storage/audio/flac_stream.h"
+#include "storage/audio/sample_metadata_index.h"
 #include "storage/cluster/cluster.h"
 #include "storage/multi_range/multisample_range.h"
 #include <cmath>
@@ -71,6 +74,11 @@ Sample::Sample()
 	minValueFound = 2147483647;
 	maxValueFound = -2147483648;
 
+	peakPyramid = NULL;
+	flacStream = NULL;
+	hintedWillPlaySoon = false;
+	firstClusterHintedWillPlaySoon = 0;
+
 	percCacheMemory[0] = NULL;
 	percCacheMemory[1] = NULL;
 
@@ -104,12 +112,29 @@ Sample::~Sample() {
 	}
 
 	deletePercCache(true);
+	deletePeakPyramid();
 
 	for (int32_t i = 0; i < caches.getNumElements(); i++) {
 		SampleCacheElement* element = (SampleCacheElement*)caches.getElementAddress(i);
 		element->cache->~SampleCache();
 		delugeDealloc(element->cache);
 	}
+
+	if (flacStream) {
+		flacStream->~FlacStream();
+		delugeDealloc(flacStream);
+	}
+}
+
+// Call once the file's been found to be FLAC, in place of AudioFile::loadFile()
+int32_t Sample::loadFlacFile(SampleReader* reader, uint32_t const* topHeader, uint32_t fileSize) {
+	void* memory = GeneralMemoryAllocator::get().allocLowSpeed(sizeof(FlacStream));
+	if (!memory) {
+		return ERROR_INSUFFICIENT_RAM;
+	}
+	flacStream = new (memory) FlacStream();
+
+	return flacStream->setup(this, reader, topHeader, fileSize);
 }
 
 void Sample::deletePercCache(bool beingDestructed) {
@@ -1051,6 +1076,12 @@ calculateMIDINote:
 				midiNote = 69 + log2f(freq / 440) * 12;
 			}
 		}
+
+		// Detecting it was slow, so remember it for next time - if it was looked for the usual way
+		if (!doingSingleCycle && midiNoteFromFile == -1 && midiNote != MIDI_NOTE_ERROR && minFreqHz == 20
+		    && maxFreqHz == 10000 && doPrimeTest) {
+			sampleMetadataIndex.recordDetectedMIDINote(this);
+		}
 	}
 
 	D_PRINTLN("midiNote:  %d", midiNote);
@@ -1723,6 +1754,11 @@ int32_t Sample::getValueSpan() {
 
 void Sample::finalizeAfterLoad(uint32_t fileSize) {
 
+	// For FLAC, the audio data isn't the file - and its length is already exact
+	if (flacStream) {
+		fileSize = audioDataLengthBytes;
+	}
+
 	audioDataLengthBytes = std::min<uint64_t>(audioDataLengthBytes, fileSize - audioDataStartPosBytes);
 
 	// If floating point file, Clusers can only be float-processed (as they're loaded) once we've found the data
@@ -1740,6 +1776,80 @@ void Sample::finalizeAfterLoad(uint32_t fileSize) {
 	workOutBitMask();
 }
 
+SamplePeakPyramid* Sample::getOrCreatePeakPyramid() {
+	if (!peakPyramid && lengthInSamples) {
+		peakPyramid = SamplePeakPyramid::create(this);
+	}
+	return peakPyramid;
+}
+
+// Call if the audio data changes
+void Sample::deletePeakPyramid() {
+	if (peakPyramid) {
+		peakPyramid->~SamplePeakPyramid();
+		delugeDealloc(peakPyramid);
+		peakPyramid = NULL;
+	}
+}
+
+// For this long after a hint, our Clusters get stolen only after those of other Samples in the song
+constexpr uint32_t kWillPlaySoonHintTime = 30 * kSampleRate;
+
+// How many Clusters, from where playback will start, a hint covers. Past those, playback streams in the rest as usual
+constexpr int32_t kNumClustersHintedWillPlaySoon = 4;
+
+// Call when something's about to start playing us from startSample - e.g. an AudioClip armed to launch
+void Sample::hintWillPlaySoon(int64_t startSample, bool reversed) {
+	if (startSample < 0) {
+		startSample = 0;
+	}
+	else if (startSample > lengthInSamples - 1) {
+		startSample = lengthInSamples - 1;
+	}
+	int32_t bytesPerSample = numChannels * byteDepth;
+	int32_t startClusterIndex =
+	    (audioDataStartPosBytes + startSample * bytesPerSample) >> audioFileManager.clusterSizeMagnitude;
+
+	// Going backwards, it's the Clusters before the start that'll be played first
+	int32_t firstClusterIndex = reversed ? startClusterIndex - (kNumClustersHintedWillPlaySoon - 1) : startClusterIndex;
+	if (firstClusterIndex < 0) {
+		firstClusterIndex = 0;
+	}
+
+	bool sameAsBefore = hintedWillPlaySoon && firstClusterIndex == firstClusterHintedWillPlaySoon
+	                    && (uint32_t)(AudioEngine::audioSampleTimer - timeHintedWillPlaySoon) < kWillPlaySoonHintTime;
+	int32_t oldFirstClusterIndex = firstClusterHintedWillPlaySoon;
+	bool wasHinted = hintedWillPlaySoon;
+
+	timeHintedWillPlaySoon = AudioEngine::audioSampleTimer;
+	firstClusterHintedWillPlaySoon = firstClusterIndex;
+	hintedWillPlaySoon = true;
+	if (sameAsBefore) {
+		return;
+	}
+
+	// Any Clusters already waiting to be stolen which have come in or out of the hint need moving to their new queue
+	for (int32_t c = 0; c < clusters.getNumElements(); c++) {
+		bool inNewHint = (c >= firstClusterIndex && c < firstClusterIndex + kNumClustersHintedWillPlaySoon);
+		bool inOldHint =
+		    (wasHinted && c >= oldFirstClusterIndex && c < oldFirstClusterIndex + kNumClustersHintedWillPlaySoon);
+		if (!inNewHint && !inOldHint) {
+			continue;
+		}
+		Cluster* cluster = clusters.getElement(c)->cluster;
+		if (cluster && cluster->list && !cluster->numReasonsToBeLoaded) {
+			cluster->remove();
+			GeneralMemoryAllocator::get().putStealableInAppropriateQueue(cluster);
+		}
+	}
+}
+
+bool Sample::mayPlaySoon(int32_t clusterIndex) {
+	return hintedWillPlaySoon && clusterIndex >= firstClusterHintedWillPlaySoon
+	       && clusterIndex < firstClusterHintedWillPlaySoon + kNumClustersHintedWillPlaySoon
+	       && (uint32_t)(AudioEngine::audioSampleTimer - timeHintedWillPlaySoon) < kWillPlaySoonHintTime;
+}
+
 #if ALPHA_OR_BETA_VERSION
 void Sample::numReasonsDecreasedToZero(char const* errorCode) {
 
@@ -1761,7 +1871,7 @@ void Sample::numReasonsDecreasedToZero(char const* errorCode) {
 
 			numClusterReasons += cluster->numReasonsToBeLoaded;
 
-			if (cluster == audioFileManager.clusterBeingLoaded) {
+			if (audioFileManager.isClusterBeingLoaded(cluster)) {
 				numClusterReasons--;
 			}
 		}
@@ -1776,7 +1886,7 @@ void Sample::numReasonsDecreasedToZero(char const* errorCode) {
 			if (cluster) {
 				D_PRINT("cluster->numReasonsToBeLoaded[%d]", cluster->numReasonsToBeLoaded);
 
-				if (cluster == audioFileManager.clusterBeingLoaded) {
+				if (audioFileManager.isClusterBeingLoaded(cluster)) {
 					D_PRINTLN(" (loading)");
 				}
 				else if (!cluster->loaded) {
@@ -38,9 +38,12 @@
 
 class LoadedSamplePosReason;
 class SampleCache;
+class SamplePeakPyramid;
 class MultisampleRange;
 class TimeStretcher;
 class SampleHolder;
+class SampleReader;
+class FlacStream;
 
 class Sample final : public AudioFile {
 public:
@@ -71,6 +74,11 @@ public:
 	int32_t getFoundValueCentrePoint();
 	int32_t getValueSpan();
 	void finalizeAfterLoad(uint32_t fileSize);
+	SamplePeakPyramid* getOrCreatePeakPyramid();
+	void deletePeakPyramid();
+	void hintWillPlaySoon(int64_t startSample, bool reversed);
+	bool mayPlaySoon(int32_t clusterIndex);
+	int32_t loadFlacFile(SampleReader* reader, uint32_t const* topHeader, uint32_t fileSize);
 
 	inline void convertOneData(int32_t* value) {
 		// Floating point
@@ -124,6 +132,12 @@ public:
 	int32_t minValueFound;
 	int32_t maxValueFound;
 
+	SamplePeakPyramid* peakPyramid; // May be set to NULL if it gets stolen
+
+	uint32_t timeHintedWillPlaySoon;        // Only valid if hintedWillPlaySoon
+	int32_t firstClusterHintedWillPlaySoon; // Only valid if hintedWillPlaySoon
+	bool hintedWillPlaySoon;
+
 	OrderedResizeableArrayWithMultiWordKey caches;
 
 	uint8_t* percCacheMemory[2];                          // One for each play-direction: 0=forwards; 1=reversed
@@ -139,6 +153,8 @@ public:
 
 	SampleClusterArray clusters;
 
+	FlacStream* flacStream; // Only if loaded from a FLAC file, in which case clusters hold the decoded audio
+
 protected:
 #if ALPHA_OR_BETA_VERSION
 	void numReasonsDecreasedToZero(char const* errorCode);
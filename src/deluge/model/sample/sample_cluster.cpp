@@ -21,9 +21,11 @@
 #include "model/sample/sample.h"
 #include "storage/audio/audio_file_manager.h"
 #include "storage/cluster/cluster.h"
+#include "storage/cluster/compressed_cluster.h"
 
 SampleCluster::SampleCluster() {
 	cluster = NULL;
+	compressedCluster = NULL;
 
 	investigatedWholeLength = false;
 	minValue = 127;
@@ -32,11 +34,13 @@ SampleCluster::SampleCluster() {
 }
 
 SampleCluster::~SampleCluster() {
+	deleteCompressedCluster();
+
 	if (cluster) {
 
 #if ALPHA_OR_BETA_VERSION
 		int32_t numReasonsToBeLoaded = cluster->numReasonsToBeLoaded;
-		if (cluster == audioFileManager.clusterBeingLoaded) {
+		if (audioFileManager.isClusterBeingLoaded(cluster)) {
 			numReasonsToBeLoaded--;
 		}
 
@@ -52,6 +56,14 @@ SampleCluster::~SampleCluster() {
 	}
 }
 
+void SampleCluster::deleteCompressedCluster() {
+	if (compressedCluster) {
+		compressedCluster->~CompressedCluster(); // Removes it from the stealable list
+		delugeDealloc(compressedCluster);
+		compressedCluster = NULL;
+	}
+}
+
 void SampleCluster::ensureNoReason(Sample* sample) {
 	if (cluster) {
 		if (cluster->numReasonsToBeLoaded) {
@@ -115,9 +127,12 @@ Cluster* SampleCluster::getCluster(Sample* sample, uint32_t clusterIndex, int32_
 		// Sometimes we don't actually want to load at all - if we're re-processing a WAV file and want to overwrite a
 		// whole Cluster
 		if (loadInstruction == CLUSTER_DONT_LOAD) {
+			deleteCompressedCluster(); // The data's about to be replaced, so that'd be out of date
 			return cluster;
 		}
 
+		cluster->reloadedAfterSteal = audioFileManager.wasClusterRecentlyStolen(sample, clusterIndex);
+
 		// If loading later...
 		if (loadInstruction == CLUSTER_ENQUEUE) {
 justEnqueue:
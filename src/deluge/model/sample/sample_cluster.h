@@ -20,6 +20,7 @@
 #include "definitions_cxx.hpp"
 
 class Cluster;
+class CompressedCluster;
 class Sample;
 
 // This is a quick list item within Sample storing minimal info about one Cluster (which often won't be loaded yet) of
@@ -31,10 +32,13 @@ public:
 	Cluster* getCluster(Sample* sample, uint32_t clusterIndex, int32_t loadInstruction = CLUSTER_ENQUEUE,
 	                    uint32_t priorityRating = 0xFFFFFFFF, uint8_t* error = NULL);
 	void ensureNoReason(Sample* sample);
+	void deleteCompressedCluster();
 
 	uint32_t sdAddress; // In sectors. (Those 512 byte things. Not to be confused with clusters.)
 	Cluster* cluster; // May automatically be set to NULL if the Cluster needs to be deallocated (can only happen if it
 	                  // has no "reasons" left)
+	CompressedCluster* compressedCluster; // A packed-down copy of the data, kept in RAM while cluster is NULL. May
+	                                      // likewise be stolen at any point
 	int8_t minValue;
 	int8_t maxValue;
 	bool investigatedWholeLength;
@@ -0,0 +1,248 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "model/sample/sample_peak_pyramid.h"
+#include "definitions_cxx.hpp"
+#include "io/debug/log.h"
+#include "memory/general_memory_allocator.h"
+#include "model/sample/sample.h"
+#include "playback/playback_handler.h"
+#include "storage/audio/audio_file_manager.h"
+#include "storage/cluster/cluster.h"
+#include <new>
+
+// The one buildRoutine() is working on. Cleared if that gets deleted
+static SamplePeakPyramid* pyramidToBuild = nullptr;
+
+SamplePeakPyramid* SamplePeakPyramid::create(Sample* sample) {
+	int32_t numBinsAtLevel0 = ((sample->lengthInSamples - 1) >> kBinSizeMagnitude) + 1;
+
+	int32_t numLevels = 1;
+	int32_t totalNumBins = numBinsAtLevel0;
+	for (int32_t n = numBinsAtLevel0; n > 1 && numLevels < kMaxNumLevels; numLevels++) {
+		n = ((n - 1) >> kLevelRatioMagnitude) + 1;
+		totalNumBins += n;
+	}
+
+	void* memory =
+	    GeneralMemoryAllocator::get().allocStealable(sizeof(SamplePeakPyramid) + totalNumBins * 2 * sizeof(int16_t));
+	if (!memory) {
+		return nullptr;
+	}
+
+	SamplePeakPyramid* pyramid = new (memory) SamplePeakPyramid(sample, numLevels, numBinsAtLevel0);
+	GeneralMemoryAllocator::get().putStealableInAppropriateQueue(pyramid);
+	return pyramid;
+}
+
+SamplePeakPyramid::SamplePeakPyramid(Sample* newSample, int32_t newNumLevels, int32_t numBinsAtLevel0) {
+	sample = newSample;
+	numLevels = newNumLevels;
+	numFramesDone = 0;
+	runningMin = 2147483647;
+	runningMax = -2147483648;
+	beingBuilt = false;
+
+	int32_t startBin = 0;
+	int32_t n = numBinsAtLevel0;
+	for (int32_t l = 0; l < numLevels; l++) {
+		numBins[l] = n;
+		numBinsDone[l] = 0;
+		levelStartBin[l] = startBin;
+		startBin += n;
+		n = ((n - 1) >> kLevelRatioMagnitude) + 1;
+	}
+}
+
+SamplePeakPyramid::~SamplePeakPyramid() {
+	if (pyramidToBuild == this) {
+		pyramidToBuild = nullptr;
+	}
+}
+
+bool SamplePeakPyramid::isComplete() {
+	return numFramesDone >= sample->lengthInSamples;
+}
+
+void SamplePeakPyramid::requestBuild() {
+	if (!isComplete()) {
+		pyramidToBuild = this;
+	}
+
+	// Recently used, so move to the back of the queue for stealing
+	remove();
+	GeneralMemoryAllocator::get().putStealableInAppropriateQueue(this);
+}
+
+bool SamplePeakPyramid::getPeaks(uint64_t startFrame, uint64_t endFrame, int32_t* min, int32_t* max) {
+	if (endFrame <= startFrame) {
+		return false;
+	}
+
+	int32_t minHere = 32767;
+	int32_t maxHere = -32768;
+	auto useBin = [&](int32_t level, int32_t binIndex) {
+		if (binIndex >= numBinsDone[level]) {
+			return false;
+		}
+		int16_t* bin = getBin(level, binIndex);
+		minHere = std::min<int32_t>(minHere, bin[0]);
+		maxHere = std::max<int32_t>(maxHere, bin[1]);
+		return true;
+	};
+	if (!forEachBinWithin(startFrame, endFrame, sample->lengthInSamples, numLevels, useBin)) {
+		return false;
+	}
+
+	*min = minHere << 16;
+	*max = maxHere << 16;
+	return true;
+}
+
+void SamplePeakPyramid::buildRoutine() {
+	SamplePeakPyramid* pyramid = pyramidToBuild;
+	if (!pyramid) {
+		return;
+	}
+
+	if (pyramid->isComplete()) {
+		pyramidToBuild = nullptr;
+		return;
+	}
+
+	// Make sure neither we nor our Sample get stolen while we load a Cluster
+	Sample* sample = pyramid->sample;
+	sample->addReason();
+	pyramid->beingBuilt = true;
+
+	int32_t error = pyramid->buildFromNextCluster();
+
+	pyramid->beingBuilt = false;
+	sample->removeReason("E457");
+
+	if (error) {
+		pyramidToBuild = nullptr; // Try again next time someone asks
+	}
+}
+
+int32_t SamplePeakPyramid::buildFromNextCluster() {
+	int32_t bytesPerFrame = sample->numChannels * sample->byteDepth;
+	uint32_t frameStartByte = sample->audioDataStartPosBytes + numFramesDone * bytesPerFrame;
+	int32_t clusterIndex = frameStartByte >> audioFileManager.clusterSizeMagnitude;
+	SampleCluster* sampleCluster = sample->clusters.getElement(clusterIndex);
+
+	// While playing, don't compete with Voices for the card - just use Clusters that happen to be loaded already
+	if (playbackHandler.isEitherClockActive() && !(sampleCluster->cluster && sampleCluster->cluster->loaded)) {
+		return NO_ERROR;
+	}
+
+	Cluster* cluster = sampleCluster->getCluster(sample, clusterIndex, CLUSTER_LOAD_IMMEDIATELY);
+	if (!cluster) {
+		return ERROR_SD_CARD;
+	}
+
+	// Every frame that's wholly within this Cluster
+	uint32_t clusterStartByte = clusterIndex << audioFileManager.clusterSizeMagnitude;
+	uint32_t clusterEndByte = clusterStartByte + audioFileManager.clusterSize;
+	uint64_t endFrame =
+	    std::min<uint64_t>(sample->lengthInSamples,
+	                       (clusterEndByte - sample->audioDataStartPosBytes) / bytesPerFrame);
+
+	// Misaligned, to align with non-32-bit data - same as WaveformRenderer
+	char* readPos = &cluster->data[frameStartByte - clusterStartByte + sample->byteDepth - 4];
+
+	while (numFramesDone < endFrame) {
+		for (int32_t c = 0; c < sample->numChannels; c++) {
+			int32_t value = *(int32_t*)readPos;
+			runningMin = std::min(runningMin, value);
+			runningMax = std::max(runningMax, value);
+			readPos += sample->byteDepth;
+		}
+		numFramesDone++;
+
+		if (!(numFramesDone & (kBinSize - 1)) || numFramesDone == sample->lengthInSamples) {
+			completeBin(0, (numFramesDone - 1) >> kBinSizeMagnitude, runningMin, runningMax);
+			runningMin = 2147483647;
+			runningMax = -2147483648;
+		}
+	}
+
+	audioFileManager.removeReasonFromCluster(cluster, "E458");
+
+	// A frame straddling the boundary into the next Cluster just gets left out. Nobody's going to see it
+	if (numFramesDone < sample->lengthInSamples
+	    && sample->audioDataStartPosBytes + numFramesDone * bytesPerFrame < clusterEndByte) {
+		numFramesDone++;
+		if (!(numFramesDone & (kBinSize - 1)) || numFramesDone == sample->lengthInSamples) {
+			completeBin(0, (numFramesDone - 1) >> kBinSizeMagnitude, runningMin, runningMax);
+			runningMin = 2147483647;
+			runningMax = -2147483648;
+		}
+	}
+
+	return NO_ERROR;
+}
+
+// Once a bin's done, and with it the last of a group of bins, the one above them is done too
+void SamplePeakPyramid::completeBin(int32_t level, int32_t binIndex, int32_t minValue, int32_t maxValue) {
+	int16_t* bin = getBin(level, binIndex);
+	if (minValue > maxValue) { // No values at all
+		bin[0] = 0;
+		bin[1] = 0;
+	}
+	else {
+		bin[0] = minValue >> 16;
+		bin[1] = maxValue >> 16;
+	}
+	numBinsDone[level] = binIndex + 1;
+
+	if (level == numLevels - 1) {
+		return;
+	}
+	if (((binIndex + 1) & (kLevelRatio - 1)) && binIndex != numBins[level] - 1) {
+		return;
+	}
+
+	int32_t minAbove = 32767;
+	int32_t maxAbove = -32768;
+	for (int32_t b = binIndex & ~(kLevelRatio - 1); b <= binIndex; b++) {
+		int16_t* binBelow = getBin(level, b);
+		minAbove = std::min<int32_t>(minAbove, binBelow[0]);
+		maxAbove = std::max<int32_t>(maxAbove, binBelow[1]);
+	}
+	completeBin(level + 1, binIndex >> kLevelRatioMagnitude, minAbove << 16, maxAbove << 16);
+}
+
+bool SamplePeakPyramid::mayBeStolen(void* thingNotToStealFrom) {
+	return !beingBuilt;
+}
+
+void SamplePeakPyramid::steal(char const* errorCode) {
+	sample->peakPyramid = nullptr;
+}
+
+void SamplePeakPyramid::relocated(Stealable* oldAddress) {
+	sample->peakPyramid = this;
+	if (pyramidToBuild == oldAddress) {
+		pyramidToBuild = this;
+	}
+}
+
+int32_t SamplePeakPyramid::getAppropriateQueue() {
+	return sample->numReasonsToBeLoaded ? STEALABLE_QUEUE_CURRENT_SONG_SAMPLE_DATA_CONVERTED
+	                                    : STEALABLE_QUEUE_NO_SONG_SAMPLE_DATA_CONVERTED;
+}
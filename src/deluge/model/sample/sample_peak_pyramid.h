@@ -0,0 +1,126 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "memory/stealable.h"
+#include <cstdint>
+
+class Sample;
+
+/*
+ * A min / max overview of a Sample's whole waveform at several resolutions, so WaveformRenderer can draw zoomed-out
+ * views without going back to the audio data - and loading Clusters - every time you zoom or scroll.
+ *
+ * Level 0 has one bin per kBinSize frames, and each level above combines kLevelRatio bins of the one below. Each bin
+ * holds the top 16 bits of the lowest and highest values across all channels.
+ *
+ * It gets built front to back, one Cluster at a time, by buildRoutine() - for whichever pyramid was last asked for.
+ * Whatever's built so far can be used in the meantime. And since it can always be built again, it's Stealable.
+ */
+class SamplePeakPyramid final : public Stealable {
+public:
+	static constexpr int32_t kBinSizeMagnitude = 8;
+	static constexpr int32_t kBinSize = 1 << kBinSizeMagnitude;
+	static constexpr int32_t kLevelRatioMagnitude = 2;
+	static constexpr int32_t kLevelRatio = 1 << kLevelRatioMagnitude;
+
+	// Returns nullptr if not enough RAM
+	static SamplePeakPyramid* create(Sample* sample);
+	~SamplePeakPyramid();
+
+	// Frames are counted from the start of the audio data. Only bins wholly within the range are looked at. Returns
+	// false if that part isn't built yet, or if the range doesn't cover a whole bin
+	bool getPeaks(uint64_t startFrame, uint64_t endFrame, int32_t* min, int32_t* max);
+
+	// The bins getPeaks() looks at, in order. From the left, it's the biggest bin that starts where we're up to and
+	// doesn't go past the end - so only bins wholly within the range get used, and no peak from just outside it can
+	// show up. The very last bin of the Sample is shorter than the rest, so if the range gets to the end of the Sample,
+	// that's taken in. Calls useBin(level, binIndex) for each, and stops if that returns false. Returns false if it
+	// did, or if there wasn't even one whole bin
+	template <typename UseBin>
+	static bool forEachBinWithin(uint64_t startFrame, uint64_t endFrame, uint64_t lengthInSamples, int32_t numLevels,
+	                             UseBin useBin) {
+		uint64_t endLimit = endFrame;
+		if (endLimit >= lengthInSamples) {
+			endLimit = ((lengthInSamples - 1) | (kBinSize - 1)) + 1;
+		}
+		endLimit &= ~(uint64_t)(kBinSize - 1);
+		uint64_t pos = ((startFrame - 1) | (kBinSize - 1)) + 1;
+		if (!startFrame) {
+			pos = 0;
+		}
+		if (pos >= endLimit) {
+			return false;
+		}
+
+		while (pos < endLimit) {
+			int32_t level = 0;
+			while (level < numLevels - 1) {
+				uint64_t nextBinSize = (uint64_t)1 << (kBinSizeMagnitude + (level + 1) * kLevelRatioMagnitude);
+				if ((pos & (nextBinSize - 1)) || pos + nextBinSize > endLimit) {
+					break;
+				}
+				level++;
+			}
+
+			int32_t binSizeMagnitude = kBinSizeMagnitude + level * kLevelRatioMagnitude;
+			if (!useBin(level, (int32_t)(pos >> binSizeMagnitude))) {
+				return false;
+			}
+			pos += (uint64_t)1 << binSizeMagnitude;
+		}
+		return true;
+	}
+
+	// Makes this the one buildRoutine() works on
+	void requestBuild();
+	bool isComplete();
+
+	// Call regularly from the main loop - not from the SD routine, since it may load a Cluster
+	static void buildRoutine();
+
+	bool mayBeStolen(void* thingNotToStealFrom = nullptr);
+	void steal(char const* errorCode);
+	int32_t getAppropriateQueue();
+	bool mayBeRelocated() { return !beingBuilt; }
+	void relocated(Stealable* oldAddress);
+
+	Sample* sample;
+
+private:
+	static constexpr int32_t kMaxNumLevels = 16;
+
+	SamplePeakPyramid(Sample* newSample, int32_t newNumLevels, int32_t numBinsAtLevel0);
+
+	int32_t buildFromNextCluster();
+	void completeBin(int32_t level, int32_t binIndex, int32_t minValue, int32_t maxValue);
+	int16_t* getBin(int32_t level, int32_t binIndex) { return &bins[(levelStartBin[level] + binIndex) * 2]; }
+
+	uint64_t numFramesDone;
+	int32_t runningMin;
+	int32_t runningMax;
+	int32_t numLevels;
+	bool beingBuilt;
+
+	int32_t numBins[kMaxNumLevels];
+	int32_t numBinsDone[kMaxNumLevels];
+	int32_t levelStartBin[kMaxNumLevels];
+
+	// This has to be last!!! Min, max, min, max...
+	int16_t bins[2];
+};
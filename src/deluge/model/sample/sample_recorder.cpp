@@ -1136,6 +1136,7 @@ int32_t SampleRecorder::alterFile(MonitoringAction action, int32_t lshiftAmount,
                                   uint64_t dataLengthAfterAction) {
 
 	D_PRINTLN("altering file");
+	sample->deletePeakPyramid(); // Won't match the new data
 	int32_t currentReadClusterIndex = 0;
 	int32_t currentWriteClusterIndex = 0;
 
@@ -100,6 +100,66 @@ static void SetupEmulatedDisplaySetting(RuntimeFeatureSetting& setting, std::str
 	};
 }
 
+static void SetupRenderBudgetSetting(RuntimeFeatureSetting& setting, std::string_view displayName,
+                                     std::string_view xmlName, RuntimeFeatureStateRenderBudget def) {
+	setting.displayName = displayName;
+	setting.xmlName = xmlName;
+	setting.value = static_cast<uint32_t>(def);
+
+	setting.options = {
+	    {
+	        .displayName = display->haveOLED() ? "Reactive only" : "OFF",
+	        .value = RuntimeFeatureStateRenderBudget::ReactiveOnly,
+	    },
+	    {
+	        .displayName = "80%",
+	        .value = RuntimeFeatureStateRenderBudget::Budget80,
+	    },
+	    {
+	        .displayName = "90%",
+	        .value = RuntimeFeatureStateRenderBudget::Budget90,
+	    },
+	    {
+	        .displayName = "95%",
+	        .value = RuntimeFeatureStateRenderBudget::Budget95,
+	    },
+	};
+}
+
+// The audio routine masks audioSampleTimer with the block size, so it has to be one of the ones on offer
+static bool isRenderBlockSetting(uint32_t value) {
+	switch (value) {
+	case RuntimeFeatureStateRenderBlock::VariableWindow:
+	case RuntimeFeatureStateRenderBlock::Block32:
+	case RuntimeFeatureStateRenderBlock::Block64:
+		return true;
+	default:
+		return false;
+	}
+}
+
+static void SetupRenderBlockSetting(RuntimeFeatureSetting& setting, std::string_view displayName,
+                                    std::string_view xmlName, RuntimeFeatureStateRenderBlock def) {
+	setting.displayName = displayName;
+	setting.xmlName = xmlName;
+	setting.value = static_cast<uint32_t>(def);
+
+	setting.options = {
+	    {
+	        .displayName = display->haveOLED() ? "Variable" : "OFF",
+	        .value = RuntimeFeatureStateRenderBlock::VariableWindow,
+	    },
+	    {
+	        .displayName = "32",
+	        .value = RuntimeFeatureStateRenderBlock::Block32,
+	    },
+	    {
+	        .displayName = "64",
+	        .value = RuntimeFeatureStateRenderBlock::Block64,
+	    },
+	};
+}
+
 void RuntimeFeatureSettings::init() {
 	using enum deluge::l10n::String;
 	// Drum randomizer
@@ -167,6 +227,31 @@ void RuntimeFeatureSettings::init() {
 	// EmulatedDisplay
 	SetupEmulatedDisplaySetting(settings[RuntimeFeatureSettingType::EmulatedDisplay], "Emulated Display",
 	                            "emulatedDisplay", RuntimeFeatureStateEmulatedDisplay::Hardware);
+
+	// RenderBudget
+	SetupRenderBudgetSetting(settings[RuntimeFeatureSettingType::RenderBudget],
+	                         deluge::l10n::getView(STRING_FOR_COMMUNITY_FEATURE_RENDER_BUDGET), "renderBudget",
+	                         RuntimeFeatureStateRenderBudget::ReactiveOnly);
+
+	// VoiceDegradation
+	SetupOnOffSetting(settings[RuntimeFeatureSettingType::VoiceDegradation],
+	                  deluge::l10n::getView(STRING_FOR_COMMUNITY_FEATURE_VOICE_DEGRADATION), "voiceDegradation",
+	                  RuntimeFeatureStateToggle::Off);
+
+	// FixedRenderBlock
+	SetupRenderBlockSetting(settings[RuntimeFeatureSettingType::FixedRenderBlock],
+	                        deluge::l10n::getView(STRING_FOR_COMMUNITY_FEATURE_FIXED_RENDER_BLOCK), "fixedRenderBlock",
+	                        RuntimeFeatureStateRenderBlock::VariableWindow);
+
+	// Autosave
+	SetupOnOffSetting(settings[RuntimeFeatureSettingType::Autosave],
+	                  deluge::l10n::getView(STRING_FOR_COMMUNITY_FEATURE_AUTOSAVE), "autosave",
+	                  RuntimeFeatureStateToggle::Off);
+
+	// Binary songs
+	SetupOnOffSetting(settings[RuntimeFeatureSettingType::BinarySongs],
+	                  deluge::l10n::getView(STRING_FOR_COMMUNITY_FEATURE_BINARY_SONGS), "binarySongs",
+	                  RuntimeFeatureStateToggle::Off);
 }
 
 void RuntimeFeatureSettings::readSettingsFromFile() {
@@ -208,6 +293,11 @@ void RuntimeFeatureSettings::readSettingsFromFile() {
 			for (auto& setting : settings) {
 				if (strcmp(setting.xmlName.data(), currentName.get()) == 0) {
 					found = true;
+					// A hand-edited block size gets ignored, leaving the default
+					if (&setting == &settings[RuntimeFeatureSettingType::FixedRenderBlock]
+					    && !isRenderBlockSetting(currentValue)) {
+						continue;
+					}
 					setting.value = currentValue;
 				}
 			}
@@ -38,6 +38,12 @@ enum RuntimeFeatureStateSyncScalingAction : uint32_t { SyncScaling = 0, Fill = 1
 
 enum RuntimeFeatureStateEmulatedDisplay : uint32_t { Hardware = 0, Toggle = 1, OnBoot = 2 };
 
+// Percentage of the CPU the predictive voice culling lets a window's rendering use. 0 leaves it to the reactive culling
+enum RuntimeFeatureStateRenderBudget : uint32_t { ReactiveOnly = 0, Budget80 = 80, Budget90 = 90, Budget95 = 95 };
+
+// Length of the fixed audio render block, in samples. 0 keeps the variable, load-dependent window length
+enum RuntimeFeatureStateRenderBlock : uint32_t { VariableWindow = 0, Block32 = 32, Block64 = 64 };
+
 /// Every setting needs to be declared in here
 enum RuntimeFeatureSettingType : uint32_t {
 	DrumRandomizer,
@@ -56,6 +62,11 @@ enum RuntimeFeatureSettingType : uint32_t {
 	LightShiftLed,
 	EnableGrainFX,
 	EmulatedDisplay,
+	RenderBudget,
+	VoiceDegradation,
+	FixedRenderBlock,
+	Autosave,
+	BinarySongs,
 	MaxElement // Keep as boundary
 };
 
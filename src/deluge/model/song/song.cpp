@@ -49,6 +49,8 @@
 #include "processing/engines/audio_engine.h"
 #include "processing/engines/cv_engine.h"
 #include "processing/sound/sound_instrument.h"
+#include "storage/audio/impulse_response_loader.h"
+#include "storage/xml_tag.h"
 #include "util/lookuptables/lookuptables.h"
 #include <cstring>
 #include <new>
@@ -1369,6 +1371,9 @@ weAreInArrangementEditorOrInClipInstance:
 	storageManager.writeAttribute("dampening", damping);
 	storageManager.writeAttribute("width", width);
 	storageManager.writeAttribute("pan", AudioEngine::reverbPan);
+	if (model == deluge::dsp::Reverb::Model::CONVOLUTION && !reverbImpulseResponsePath.isEmpty()) {
+		storageManager.writeAttribute("impulseResponse", reverbImpulseResponsePath.get());
+	}
 	storageManager.writeOpeningTagEnd();
 
 	storageManager.writeOpeningTagBeginning("compressor");
@@ -1468,537 +1473,489 @@ int32_t Song::readFromFile() {
 
 	while (*(tagName = storageManager.readNextTagOrAttributeName())) {
 		// D_PRINTLN(tagName); delayMS(30);
-		switch (*(uint32_t*)tagName) {
-
-		// "reve" -> reverb
-		case 0x65766572:
-			if (!strcmp(tagName, "reverb")) {
-				while (*(tagName = storageManager.readNextTagOrAttributeName())) {
-					if (!strcmp(tagName, "model")) {
-						deluge::dsp::Reverb::Model model =
-						    static_cast<deluge::dsp::Reverb::Model>(storageManager.readTagOrAttributeValueInt());
-						if (model == deluge::dsp::Reverb::Model::FREEVERB) {
-							AudioEngine::reverb.setModel(deluge::dsp::Reverb::Model::FREEVERB);
-						}
-						else if (model == deluge::dsp::Reverb::Model::MUTABLE) {
-							AudioEngine::reverb.setModel(deluge::dsp::Reverb::Model::MUTABLE);
-						}
-						storageManager.exitTag("model");
+		switch (xmlTagFromName(tagName)) {
+
+		case XMLTag::reverb:
+			while (*(tagName = storageManager.readNextTagOrAttributeName())) {
+				if (!strcmp(tagName, "model")) {
+					deluge::dsp::Reverb::Model model =
+					    static_cast<deluge::dsp::Reverb::Model>(storageManager.readTagOrAttributeValueInt());
+					if (model == deluge::dsp::Reverb::Model::FREEVERB) {
+						AudioEngine::reverb.setModel(deluge::dsp::Reverb::Model::FREEVERB);
 					}
-					else if (!strcmp(tagName, "roomSize")) {
-						reverbRoomSize = (float)storageManager.readTagOrAttributeValueInt() / 2147483648u;
-						storageManager.exitTag("roomSize");
+					else if (model == deluge::dsp::Reverb::Model::MUTABLE) {
+						AudioEngine::reverb.setModel(deluge::dsp::Reverb::Model::MUTABLE);
 					}
-					else if (!strcmp(tagName, "dampening")) {
-						reverbDamp = (float)storageManager.readTagOrAttributeValueInt() / 2147483648u;
-						storageManager.exitTag("dampening");
-					}
-					else if (!strcmp(tagName, "width")) {
-						int32_t widthInt = storageManager.readTagOrAttributeValueInt();
-						if (widthInt == -2147483648) {
-							widthInt = 2147483647; // Was being saved incorrectly in V2.1.0-beta1 and alphas, so we fix
-							                       // it on read here!
-						}
-						reverbWidth = (float)widthInt / 2147483648u;
-						storageManager.exitTag("width");
-					}
-					else if (!strcmp(tagName, "pan")) {
-						reverbPan = storageManager.readTagOrAttributeValueInt();
-						storageManager.exitTag("pan");
-					}
-					else if (!strcmp(tagName, "compressor")) {
-						while (*(tagName = storageManager.readNextTagOrAttributeName())) {
-							if (!strcmp(tagName, "attack")) {
-								reverbSidechainAttack = storageManager.readTagOrAttributeValueInt();
-								storageManager.exitTag("attack");
-							}
-							else if (!strcmp(tagName, "release")) {
-								reverbSidechainRelease = storageManager.readTagOrAttributeValueInt();
-								storageManager.exitTag("release");
-							}
-							else if (!strcmp(tagName, "volume")) {
-								reverbSidechainVolume = storageManager.readTagOrAttributeValueInt();
-								storageManager.exitTag("volume");
-							}
-							else if (!strcmp(tagName, "shape")) {
-								reverbSidechainShape = storageManager.readTagOrAttributeValueInt();
-								storageManager.exitTag("shape");
-							}
-							else if (!strcmp(tagName, "syncLevel")) {
-								reverbSidechainSync = storageManager.readAbsoluteSyncLevelFromFile(this);
-								reverbSidechainSync = (SyncLevel)std::min((uint8_t)reverbSidechainSync, (uint8_t)9);
-								storageManager.exitTag("syncLevel");
-							}
-							else {
-								storageManager.exitTag(tagName);
-							}
-						}
-						storageManager.exitTag("compressor");
-					}
-					else {
-						storageManager.exitTag(tagName);
+					// Its impulse response gets loaded in loadAllSamples()
+					else if (model == deluge::dsp::Reverb::Model::CONVOLUTION) {
+						AudioEngine::reverb.setModel(deluge::dsp::Reverb::Model::CONVOLUTION);
 					}
+					storageManager.exitTag("model");
 				}
-			}
-			else {
-				goto unknownTag;
-			}
-			storageManager.exitTag();
-			break;
-
-		case charsToIntegerConstant('x', 'S', 'c', 'r'):
-
-			switch (*(((uint32_t*)tagName) + 1)) {
-
-			// "oll\x00" ->xScroll
-			case 0x006c6c6f:
-				xScroll[NAVIGATION_CLIP] = storageManager.readTagOrAttributeValueInt();
-				xScroll[NAVIGATION_CLIP] = std::max((int32_t)0, xScroll[NAVIGATION_CLIP]);
-				break;
-
-			// "ollS" -> xScrollSongView
-			case 0x536c6c6f:
-				if (!strcmp(tagName, "xScrollSongView")) {
-					xScrollForReturnToSongView = storageManager.readTagOrAttributeValueInt();
-					xScrollForReturnToSongView = std::max((int32_t)0, xScrollForReturnToSongView);
-					break;
+				else if (!strcmp(tagName, "impulseResponse")) {
+					storageManager.readTagOrAttributeValueString(&reverbImpulseResponsePath);
+					storageManager.exitTag("impulseResponse");
 				}
-				else {
-					goto unknownTag;
+				else if (!strcmp(tagName, "roomSize")) {
+					reverbRoomSize = (float)storageManager.readTagOrAttributeValueInt() / 2147483648u;
+					storageManager.exitTag("roomSize");
 				}
-
-			// "ollA" -> xScrollArrangementView"
-			case 0x416c6c6f:
-				if (!strcmp(tagName, "xScrollArrangementView")) {
-					xScroll[NAVIGATION_ARRANGEMENT] = storageManager.readTagOrAttributeValueInt();
-					break;
+				else if (!strcmp(tagName, "dampening")) {
+					reverbDamp = (float)storageManager.readTagOrAttributeValueInt() / 2147483648u;
+					storageManager.exitTag("dampening");
+				}
+				else if (!strcmp(tagName, "width")) {
+					int32_t widthInt = storageManager.readTagOrAttributeValueInt();
+					if (widthInt == -2147483648) {
+						widthInt = 2147483647; // Was being saved incorrectly in V2.1.0-beta1 and alphas, so we fix
+						                       // it on read here!
+					}
+					reverbWidth = (float)widthInt / 2147483648u;
+					storageManager.exitTag("width");
+				}
+				else if (!strcmp(tagName, "pan")) {
+					reverbPan = storageManager.readTagOrAttributeValueInt();
+					storageManager.exitTag("pan");
+				}
+				else if (!strcmp(tagName, "compressor")) {
+					while (*(tagName = storageManager.readNextTagOrAttributeName())) {
+						if (!strcmp(tagName, "attack")) {
+							reverbSidechainAttack = storageManager.readTagOrAttributeValueInt();
+							storageManager.exitTag("attack");
+						}
+						else if (!strcmp(tagName, "release")) {
+							reverbSidechainRelease = storageManager.readTagOrAttributeValueInt();
+							storageManager.exitTag("release");
+						}
+						else if (!strcmp(tagName, "volume")) {
+							reverbSidechainVolume = storageManager.readTagOrAttributeValueInt();
+							storageManager.exitTag("volume");
+						}
+						else if (!strcmp(tagName, "shape")) {
+							reverbSidechainShape = storageManager.readTagOrAttributeValueInt();
+							storageManager.exitTag("shape");
+						}
+						else if (!strcmp(tagName, "syncLevel")) {
+							reverbSidechainSync = storageManager.readAbsoluteSyncLevelFromFile(this);
+							reverbSidechainSync = (SyncLevel)std::min((uint8_t)reverbSidechainSync, (uint8_t)9);
+							storageManager.exitTag("syncLevel");
+						}
+						else {
+							storageManager.exitTag(tagName);
+						}
+					}
+					storageManager.exitTag("compressor");
 				}
 				else {
-					goto unknownTag;
+					storageManager.exitTag(tagName);
 				}
-
-			default:
-				goto unknownTag;
 			}
+			storageManager.exitTag();
+			break;
 
+		case XMLTag::xScroll:
+			xScroll[NAVIGATION_CLIP] = storageManager.readTagOrAttributeValueInt();
+			xScroll[NAVIGATION_CLIP] = std::max((int32_t)0, xScroll[NAVIGATION_CLIP]);
 			storageManager.exitTag();
 			break;
 
-		// "xZoo..."
-		case 0x6f6f5a78:
+		case XMLTag::xScrollSongView:
+			xScrollForReturnToSongView = storageManager.readTagOrAttributeValueInt();
+			xScrollForReturnToSongView = std::max((int32_t)0, xScrollForReturnToSongView);
+			storageManager.exitTag();
+			break;
 
-			// "xZoomSongView"
-			if (!strcmp(tagName, "xZoomSongView")) {
-				xZoomForReturnToSongView = storageManager.readTagOrAttributeValueInt();
-				xZoomForReturnToSongView = std::max((int32_t)1, xZoomForReturnToSongView);
-			}
+		case XMLTag::xScrollArrangementView:
+			xScroll[NAVIGATION_ARRANGEMENT] = storageManager.readTagOrAttributeValueInt();
+			storageManager.exitTag();
+			break;
 
-			// "xZoom"
-			else if (!strcmp(tagName, "xZoom")) {
-				xZoom[NAVIGATION_CLIP] = storageManager.readTagOrAttributeValueInt();
-				xZoom[NAVIGATION_CLIP] = std::max((uint32_t)1, xZoom[NAVIGATION_CLIP]);
-			}
-			else {
-				goto unknownTag;
-			}
+		case XMLTag::xZoomSongView:
+			xZoomForReturnToSongView = storageManager.readTagOrAttributeValueInt();
+			xZoomForReturnToSongView = std::max((int32_t)1, xZoomForReturnToSongView);
+			storageManager.exitTag();
+			break;
 
+		case XMLTag::xZoom:
+			xZoom[NAVIGATION_CLIP] = storageManager.readTagOrAttributeValueInt();
+			xZoom[NAVIGATION_CLIP] = std::max((uint32_t)1, xZoom[NAVIGATION_CLIP]);
 			storageManager.exitTag();
 			break;
 
-		// "yScr..."
-		case 0x72635379:
+		case XMLTag::yScrollSongView:
+			songViewYScroll = storageManager.readTagOrAttributeValueInt();
+			songViewYScroll = std::max(1 - kDisplayHeight, songViewYScroll);
+			storageManager.exitTag();
+			break;
 
-			switch (*(((uint32_t*)tagName) + 1)) {
+		case XMLTag::yScrollArrangementView:
+			arrangementYScroll = storageManager.readTagOrAttributeValueInt();
+			arrangementYScroll = std::max(1 - kDisplayHeight, arrangementYScroll);
+			storageManager.exitTag();
+			break;
 
-			// "ollS" -> yScrollSongView"
-			case 0x536c6c6f:
-				if (!strcmp(tagName, "yScrollSongView")) {
-					songViewYScroll = storageManager.readTagOrAttributeValueInt();
-					songViewYScroll = std::max(1 - kDisplayHeight, songViewYScroll);
-					break;
+		case XMLTag::firmwareVersion:
+		case XMLTag::earliestCompatibleFirmware: {
+			storageManager.tryReadingFirmwareTagFromFile(tagName);
+			storageManager.exitTag(tagName);
+		} break;
+		case XMLTag::preview:
+		case XMLTag::previewNumPads: {
+			storageManager.tryReadingFirmwareTagFromFile(tagName);
+			storageManager.exitTag(tagName);
+		} break;
+		case XMLTag::sessionLayout: {
+			sessionLayout = (SessionLayoutType)storageManager.readTagOrAttributeValueInt();
+			storageManager.exitTag("sessionLayout");
+		} break;
+
+		case XMLTag::songGridScrollX: {
+			songGridScrollX = storageManager.readTagOrAttributeValueInt();
+			storageManager.exitTag("songGridScrollX");
+		} break;
+
+		case XMLTag::songGridScrollY: {
+			songGridScrollY = storageManager.readTagOrAttributeValueInt();
+			storageManager.exitTag("songGridScrollY");
+		} break;
+
+		case XMLTag::xZoomArrangementView: {
+			xZoom[NAVIGATION_ARRANGEMENT] = storageManager.readTagOrAttributeValueInt();
+			storageManager.exitTag("xZoomArrangementView");
+		} break;
+
+		case XMLTag::inArrangementView: { // For V2.0 pre-beta songs. There'd be another way to detect
+			                                     // this...
+			lastClipInstanceEnteredStartPos = 0;
+			storageManager.exitTag("inArrangementView");
+		} break;
+
+		case XMLTag::currentTrackInstanceArrangementPos: {
+			lastClipInstanceEnteredStartPos = storageManager.readTagOrAttributeValueInt();
+			storageManager.exitTag("currentTrackInstanceArrangementPos");
+		} break;
+
+		case XMLTag::arrangementAutoScrollOn: {
+			arrangerAutoScrollModeActive = storageManager.readTagOrAttributeValueInt();
+			storageManager.exitTag("arrangementAutoScrollOn");
+		} break;
+
+		case XMLTag::timePerTimerTick: {
+			newTimePerTimerTick = (newTimePerTimerTick & (uint64_t)0xFFFFFFFF)
+			                      | ((uint64_t)storageManager.readTagOrAttributeValueInt() << 32);
+			storageManager.exitTag("timePerTimerTick");
+		} break;
+
+		case XMLTag::timerTickFraction: {
+			newTimePerTimerTick = (newTimePerTimerTick & ((uint64_t)0xFFFFFFFF << 32))
+			                      | (uint64_t)(uint32_t)storageManager.readTagOrAttributeValueInt();
+			storageManager.exitTag("timerTickFraction");
+		} break;
+
+		case XMLTag::inputTickMagnitude: {
+			insideWorldTickMagnitude = storageManager.readTagOrAttributeValueInt();
+			storageManager.exitTag("inputTickMagnitude");
+		} break;
+
+		case XMLTag::rootNote: {
+			rootNote = storageManager.readTagOrAttributeValueInt();
+			storageManager.exitTag("rootNote");
+		} break;
+
+		case XMLTag::swingAmount: {
+			swingAmount = storageManager.readTagOrAttributeValueInt();
+			swingAmount = std::min(swingAmount, (int8_t)49);
+			swingAmount = std::max(swingAmount, (int8_t)-49);
+			storageManager.exitTag("swingAmount");
+		} break;
+
+		case XMLTag::swingInterval: {
+			// swingInterval, unlike other "sync" type params, we're going to read as just its plain old int32_t
+			// value, and only shift it by insideWorldTickMagnitude after reading the whole song. This is
+			// because these two attributes could easily be stored in either order in the file, so we won't know
+			// both until the end. Also, in firmware pre V3.1.0-alpha, all "sync" values were stored as plain
+			// old ints, to be read irrespective of insideWorldTickMagnitude
+			swingInterval = storageManager.readTagOrAttributeValueInt();
+			swingInterval = std::min(swingInterval, (uint8_t)9);
+			storageManager.exitTag("swingInterval");
+		} break;
+
+		case XMLTag::tripletsLevel: {
+			tripletsLevel = storageManager.readTagOrAttributeValueInt();
+			storageManager.exitTag("tripletsLevel");
+			tripletsOn = true;
+		} break;
+
+		case XMLTag::activeModFunction: {
+			globalEffectable.modKnobMode = storageManager.readTagOrAttributeValueInt();
+			globalEffectable.modKnobMode = std::min(globalEffectable.modKnobMode, (uint8_t)(kNumModButtons - 1));
+			storageManager.exitTag("activeModFunction");
+		} break;
+
+		case XMLTag::affectEntire: {
+			affectEntire = storageManager.readTagOrAttributeValueInt();
+			storageManager.exitTag("affectEntire");
+		} break;
+
+		case XMLTag::midiLoopback: {
+			midiLoopback = storageManager.readTagOrAttributeValueInt();
+			storageManager.exitTag("midiLoopback");
+		} break;
+
+		case XMLTag::lastSelectedParamID: {
+			lastSelectedParamID = storageManager.readTagOrAttributeValueInt();
+			storageManager.exitTag("lastSelectedParamID");
+		} break;
+
+		case XMLTag::lastSelectedParamKind: {
+			lastSelectedParamKind = static_cast<params::Kind>(storageManager.readTagOrAttributeValueInt());
+			storageManager.exitTag("lastSelectedParamKind");
+		} break;
+
+		case XMLTag::lastSelectedParamShortcutX: {
+			lastSelectedParamShortcutX = storageManager.readTagOrAttributeValueInt();
+			storageManager.exitTag("lastSelectedParamShortcutX");
+		} break;
+
+		case XMLTag::lastSelectedParamShortcutY: {
+			lastSelectedParamShortcutY = storageManager.readTagOrAttributeValueInt();
+			storageManager.exitTag("lastSelectedParamShortcutY");
+		} break;
+
+		// legacy section, read as part of global effectable (songParams tag) post c1.1
+		case XMLTag::songCompressor: {
+			while (*(tagName = storageManager.readNextTagOrAttributeName())) {
+				if (!strcmp(tagName, "attack")) {
+					q31_t masterCompressorAttack = storageManager.readTagOrAttributeValueInt();
+					globalEffectable.compressor.setAttack(masterCompressorAttack);
+					storageManager.exitTag("attack");
 				}
-				else {
-					goto unknownTag;
+				else if (!strcmp(tagName, "release")) {
+					q31_t masterCompressorRelease = storageManager.readTagOrAttributeValueInt();
+					globalEffectable.compressor.setRelease(masterCompressorRelease);
+					storageManager.exitTag("release");
 				}
-
-			// "yScrollArrangementView"
-			case 0x416c6c6f:
-				if (!strcmp(tagName, "yScrollArrangementView")) {
-					arrangementYScroll = storageManager.readTagOrAttributeValueInt();
-					arrangementYScroll = std::max(1 - kDisplayHeight, arrangementYScroll);
-					break;
+				else if (!strcmp(tagName, "thresh")) {
+					q31_t masterCompressorThresh = storageManager.readTagOrAttributeValueInt();
+					globalEffectable.compressor.setThreshold(masterCompressorThresh);
+					storageManager.exitTag("thresh");
+				}
+				else if (!strcmp(tagName, "ratio")) {
+					q31_t masterCompressorRatio = storageManager.readTagOrAttributeValueInt();
+					globalEffectable.compressor.setRatio(masterCompressorRatio);
+					storageManager.exitTag("ratio");
+				}
+				else if (!strcmp(tagName, "compHPF")) {
+					q31_t masterCompressorSidechain = storageManager.readTagOrAttributeValueInt();
+					globalEffectable.compressor.setSidechain(masterCompressorSidechain);
+					storageManager.exitTag("compHPF");
 				}
 				else {
-					goto unknownTag;
+					storageManager.exitTag(tagName);
 				}
-
-			default:
-				goto unknownTag;
 			}
-			storageManager.exitTag();
-			break;
-
-		default:
-unknownTag:
-			if (!strcmp(tagName, "firmwareVersion") || !strcmp(tagName, "earliestCompatibleFirmware")) {
-				storageManager.tryReadingFirmwareTagFromFile(tagName);
-				storageManager.exitTag(tagName);
-			}
-			else if (!strcmp(tagName, "preview") || !strcmp(tagName, "previewNumPads")) {
-				storageManager.tryReadingFirmwareTagFromFile(tagName);
-				storageManager.exitTag(tagName);
-			}
-			else if (!strcmp(tagName, "sessionLayout")) {
-				sessionLayout = (SessionLayoutType)storageManager.readTagOrAttributeValueInt();
-				storageManager.exitTag("sessionLayout");
-			}
-
-			else if (!strcmp(tagName, "songGridScrollX")) {
-				songGridScrollX = storageManager.readTagOrAttributeValueInt();
-				storageManager.exitTag("songGridScrollX");
-			}
-
-			else if (!strcmp(tagName, "songGridScrollY")) {
-				songGridScrollY = storageManager.readTagOrAttributeValueInt();
-				storageManager.exitTag("songGridScrollY");
-			}
-
-			else if (!strcmp(tagName, "xZoomArrangementView")) {
-				xZoom[NAVIGATION_ARRANGEMENT] = storageManager.readTagOrAttributeValueInt();
-				storageManager.exitTag("xZoomArrangementView");
-			}
-
-			else if (!strcmp(tagName,
-			                 "inArrangementView")) { // For V2.0 pre-beta songs. There'd be another way to detect
-				                                     // this...
-				lastClipInstanceEnteredStartPos = 0;
-				storageManager.exitTag("inArrangementView");
-			}
-
-			else if (!strcmp(tagName, "currentTrackInstanceArrangementPos")) {
-				lastClipInstanceEnteredStartPos = storageManager.readTagOrAttributeValueInt();
-				storageManager.exitTag("currentTrackInstanceArrangementPos");
-			}
-
-			else if (!strcmp(tagName, "arrangementAutoScrollOn")) {
-				arrangerAutoScrollModeActive = storageManager.readTagOrAttributeValueInt();
-				storageManager.exitTag("arrangementAutoScrollOn");
-			}
-
-			else if (!strcmp(tagName, "timePerTimerTick")) {
-				newTimePerTimerTick = (newTimePerTimerTick & (uint64_t)0xFFFFFFFF)
-				                      | ((uint64_t)storageManager.readTagOrAttributeValueInt() << 32);
-				storageManager.exitTag("timePerTimerTick");
-			}
-
-			else if (!strcmp(tagName, "timerTickFraction")) {
-				newTimePerTimerTick = (newTimePerTimerTick & ((uint64_t)0xFFFFFFFF << 32))
-				                      | (uint64_t)(uint32_t)storageManager.readTagOrAttributeValueInt();
-				storageManager.exitTag("timerTickFraction");
-			}
-
-			else if (!strcmp(tagName, "inputTickMagnitude")) {
-				insideWorldTickMagnitude = storageManager.readTagOrAttributeValueInt();
-				storageManager.exitTag("inputTickMagnitude");
-			}
-
-			else if (!strcmp(tagName, "rootNote")) {
-				rootNote = storageManager.readTagOrAttributeValueInt();
-				storageManager.exitTag("rootNote");
-			}
-
-			else if (!strcmp(tagName, "swingAmount")) {
-				swingAmount = storageManager.readTagOrAttributeValueInt();
-				swingAmount = std::min(swingAmount, (int8_t)49);
-				swingAmount = std::max(swingAmount, (int8_t)-49);
-				storageManager.exitTag("swingAmount");
-			}
-
-			else if (!strcmp(tagName, "swingInterval")) {
-				// swingInterval, unlike other "sync" type params, we're going to read as just its plain old int32_t
-				// value, and only shift it by insideWorldTickMagnitude after reading the whole song. This is
-				// because these two attributes could easily be stored in either order in the file, so we won't know
-				// both until the end. Also, in firmware pre V3.1.0-alpha, all "sync" values were stored as plain
-				// old ints, to be read irrespective of insideWorldTickMagnitude
-				swingInterval = storageManager.readTagOrAttributeValueInt();
-				swingInterval = std::min(swingInterval, (uint8_t)9);
-				storageManager.exitTag("swingInterval");
-			}
-
-			else if (!strcmp(tagName, "tripletsLevel")) {
-				tripletsLevel = storageManager.readTagOrAttributeValueInt();
-				storageManager.exitTag("tripletsLevel");
-				tripletsOn = true;
-			}
-
-			else if (!strcmp(tagName, "activeModFunction")) {
-				globalEffectable.modKnobMode = storageManager.readTagOrAttributeValueInt();
-				globalEffectable.modKnobMode = std::min(globalEffectable.modKnobMode, (uint8_t)(kNumModButtons - 1));
-				storageManager.exitTag("activeModFunction");
-			}
-
-			else if (!strcmp(tagName, "affectEntire")) {
-				affectEntire = storageManager.readTagOrAttributeValueInt();
-				storageManager.exitTag("affectEntire");
-			}
-
-			else if (!strcmp(tagName, "midiLoopback")) {
-				midiLoopback = storageManager.readTagOrAttributeValueInt();
-				storageManager.exitTag("midiLoopback");
-			}
-
-			else if (!strcmp(tagName, "lastSelectedParamID")) {
-				lastSelectedParamID = storageManager.readTagOrAttributeValueInt();
-				storageManager.exitTag("lastSelectedParamID");
-			}
-
-			else if (!strcmp(tagName, "lastSelectedParamKind")) {
-				lastSelectedParamKind = static_cast<params::Kind>(storageManager.readTagOrAttributeValueInt());
-				storageManager.exitTag("lastSelectedParamKind");
-			}
-
-			else if (!strcmp(tagName, "lastSelectedParamShortcutX")) {
-				lastSelectedParamShortcutX = storageManager.readTagOrAttributeValueInt();
-				storageManager.exitTag("lastSelectedParamShortcutX");
-			}
-
-			else if (!strcmp(tagName, "lastSelectedParamShortcutY")) {
-				lastSelectedParamShortcutY = storageManager.readTagOrAttributeValueInt();
-				storageManager.exitTag("lastSelectedParamShortcutY");
-			}
-
-			// legacy section, read as part of global effectable (songParams tag) post c1.1
-			else if (!strcmp(tagName, "songCompressor")) {
-				while (*(tagName = storageManager.readNextTagOrAttributeName())) {
-					if (!strcmp(tagName, "attack")) {
-						q31_t masterCompressorAttack = storageManager.readTagOrAttributeValueInt();
-						globalEffectable.compressor.setAttack(masterCompressorAttack);
-						storageManager.exitTag("attack");
-					}
-					else if (!strcmp(tagName, "release")) {
-						q31_t masterCompressorRelease = storageManager.readTagOrAttributeValueInt();
-						globalEffectable.compressor.setRelease(masterCompressorRelease);
-						storageManager.exitTag("release");
-					}
-					else if (!strcmp(tagName, "thresh")) {
-						q31_t masterCompressorThresh = storageManager.readTagOrAttributeValueInt();
-						globalEffectable.compressor.setThreshold(masterCompressorThresh);
-						storageManager.exitTag("thresh");
-					}
-					else if (!strcmp(tagName, "ratio")) {
-						q31_t masterCompressorRatio = storageManager.readTagOrAttributeValueInt();
-						globalEffectable.compressor.setRatio(masterCompressorRatio);
-						storageManager.exitTag("ratio");
-					}
-					else if (!strcmp(tagName, "compHPF")) {
-						q31_t masterCompressorSidechain = storageManager.readTagOrAttributeValueInt();
-						globalEffectable.compressor.setSidechain(masterCompressorSidechain);
-						storageManager.exitTag("compHPF");
-					}
-					else {
-						storageManager.exitTag(tagName);
-					}
+			storageManager.exitTag("songCompressor");
+		} break;
+
+		case XMLTag::modeNotes: {
+			numModeNotes = 0;
+			uint8_t lowestCurrentAllowed = 0;
+
+			// Read in all the modeNotes
+			while (*(tagName = storageManager.readNextTagOrAttributeName())) {
+				if (!strcmp(tagName, "modeNote")) {
+					modeNotes[numModeNotes] = storageManager.readTagOrAttributeValueInt();
+					modeNotes[numModeNotes] =
+					    std::min((uint8_t)11, std::max(lowestCurrentAllowed, modeNotes[numModeNotes]));
+					lowestCurrentAllowed = modeNotes[numModeNotes] + 1;
+					numModeNotes++;
+					storageManager.exitTag("modeNote");
 				}
-				storageManager.exitTag("songCompressor");
-			}
-
-			else if (!strcmp(tagName, "modeNotes")) {
-				numModeNotes = 0;
-				uint8_t lowestCurrentAllowed = 0;
-
-				// Read in all the modeNotes
-				while (*(tagName = storageManager.readNextTagOrAttributeName())) {
-					if (!strcmp(tagName, "modeNote")) {
-						modeNotes[numModeNotes] = storageManager.readTagOrAttributeValueInt();
-						modeNotes[numModeNotes] =
-						    std::min((uint8_t)11, std::max(lowestCurrentAllowed, modeNotes[numModeNotes]));
-						lowestCurrentAllowed = modeNotes[numModeNotes] + 1;
-						numModeNotes++;
-						storageManager.exitTag("modeNote");
-					}
-					else {
-						storageManager.exitTag(tagName);
-					}
+				else {
+					storageManager.exitTag(tagName);
 				}
-				storageManager.exitTag("modeNotes");
 			}
+			storageManager.exitTag("modeNotes");
+		} break;
 
-			else if (!strcmp(tagName, "sections")) {
-				// Read in all the sections
-				while (*(tagName = storageManager.readNextTagOrAttributeName())) {
-					if (!strcmp(tagName, "section")) {
-
-						uint8_t id = 255;
-						MIDIDevice* device = NULL;
-						uint8_t channel = 255;
-						uint8_t note = 255;
-						int16_t numRepeats = 0;
+		case XMLTag::sections: {
+			// Read in all the sections
+			while (*(tagName = storageManager.readNextTagOrAttributeName())) {
+				if (!strcmp(tagName, "section")) {
 
-						while (*(tagName = storageManager.readNextTagOrAttributeName())) {
-							if (!strcmp(tagName, "id")) {
-								id = storageManager.readTagOrAttributeValueInt();
-							}
-
-							else if (!strcmp(tagName, "numRepeats")) {
-								numRepeats = storageManager.readTagOrAttributeValueInt();
-								if (numRepeats < -1 || numRepeats > 9999) {
-									numRepeats = 0;
-								}
-							}
+					uint8_t id = 255;
+					MIDIDevice* device = NULL;
+					uint8_t channel = 255;
+					uint8_t note = 255;
+					int16_t numRepeats = 0;
 
-							// Annoyingly, I used one-off tag names here, rather than it conforming to what the
-							// LearnedMIDI class now uses.
-							else if (!strcmp(tagName, "midiCommandDevice")) {
-								device = MIDIDeviceManager::readDeviceReferenceFromFile();
-							}
+					while (*(tagName = storageManager.readNextTagOrAttributeName())) {
+						if (!strcmp(tagName, "id")) {
+							id = storageManager.readTagOrAttributeValueInt();
+						}
 
-							else if (!strcmp(tagName, "midiCommandChannel")) {
-								channel = storageManager.readTagOrAttributeValueInt();
+						else if (!strcmp(tagName, "numRepeats")) {
+							numRepeats = storageManager.readTagOrAttributeValueInt();
+							if (numRepeats < -1 || numRepeats > 9999) {
+								numRepeats = 0;
 							}
+						}
 
-							else if (!strcmp(tagName, "midiCommandNote")) {
-								note = storageManager.readTagOrAttributeValueInt();
-							}
+						// Annoyingly, I used one-off tag names here, rather than it conforming to what the
+						// LearnedMIDI class now uses.
+						else if (!strcmp(tagName, "midiCommandDevice")) {
+							device = MIDIDeviceManager::readDeviceReferenceFromFile();
+						}
 
-							storageManager.exitTag(tagName);
+						else if (!strcmp(tagName, "midiCommandChannel")) {
+							channel = storageManager.readTagOrAttributeValueInt();
 						}
 
-						if (id < kMaxNumSections) {
-							if (channel < 16 && note < 128) {
-								sections[id].launchMIDICommand.device = device;
-								sections[id].launchMIDICommand.channelOrZone = channel;
-								sections[id].launchMIDICommand.noteOrCC = note;
-							}
-							sections[id].numRepetitions = numRepeats;
+						else if (!strcmp(tagName, "midiCommandNote")) {
+							note = storageManager.readTagOrAttributeValueInt();
 						}
-						storageManager.exitTag("section");
-					}
-					else {
+
 						storageManager.exitTag(tagName);
 					}
+
+					if (id < kMaxNumSections) {
+						if (channel < 16 && note < 128) {
+							sections[id].launchMIDICommand.device = device;
+							sections[id].launchMIDICommand.channelOrZone = channel;
+							sections[id].launchMIDICommand.noteOrCC = note;
+						}
+						sections[id].numRepetitions = numRepeats;
+					}
+					storageManager.exitTag("section");
+				}
+				else {
+					storageManager.exitTag(tagName);
 				}
-				storageManager.exitTag("sections");
 			}
+			storageManager.exitTag("sections");
+		} break;
 
-			else if (!strcmp(tagName, "instruments")) {
+		case XMLTag::instruments: {
 
-				Output** lastPointer = &firstOutput;
-				while (*(tagName = storageManager.readNextTagOrAttributeName())) {
+			Output** lastPointer = &firstOutput;
+			while (*(tagName = storageManager.readNextTagOrAttributeName())) {
 
-					void* memory;
-					Output* newOutput;
-					char const* defaultDirPath;
-					int32_t error;
+				void* memory;
+				Output* newOutput;
+				char const* defaultDirPath;
+				int32_t error;
 
-					if (!strcmp(tagName, "audioTrack")) {
-						memory = GeneralMemoryAllocator::get().allocMaxSpeed(sizeof(AudioOutput));
-						if (!memory) {
-							return ERROR_INSUFFICIENT_RAM;
-						}
-						newOutput = new (memory) AudioOutput();
-						goto loadOutput;
+				if (!strcmp(tagName, "audioTrack")) {
+					memory = GeneralMemoryAllocator::get().allocMaxSpeed(sizeof(AudioOutput));
+					if (!memory) {
+						return ERROR_INSUFFICIENT_RAM;
 					}
+					newOutput = new (memory) AudioOutput();
+					goto loadOutput;
+				}
 
-					else if (!strcmp(tagName, "sound")) {
-						memory = GeneralMemoryAllocator::get().allocMaxSpeed(sizeof(SoundInstrument));
-						if (!memory) {
-							return ERROR_INSUFFICIENT_RAM;
-						}
-						newOutput = new (memory) SoundInstrument();
-						defaultDirPath = "SYNTHS";
+				else if (!strcmp(tagName, "sound")) {
+					memory = GeneralMemoryAllocator::get().allocMaxSpeed(sizeof(SoundInstrument));
+					if (!memory) {
+						return ERROR_INSUFFICIENT_RAM;
+					}
+					newOutput = new (memory) SoundInstrument();
+					defaultDirPath = "SYNTHS";
 
 setDirPathFirst:
-						error = ((Instrument*)newOutput)->dirPath.set(defaultDirPath);
-						if (error) {
+					error = ((Instrument*)newOutput)->dirPath.set(defaultDirPath);
+					if (error) {
 gotError:
-							newOutput->~Output();
-							delugeDealloc(memory);
-							return error;
-						}
+						newOutput->~Output();
+						delugeDealloc(memory);
+						return error;
+					}
 
 loadOutput:
-						error = newOutput->readFromFile(
-						    this, NULL,
-						    0); // If it finds any default params, it'll make a ParamManager and "back it up"
-						if (error) {
-							goto gotError;
-						}
-
-						*lastPointer = newOutput;
-						lastPointer = &newOutput->next;
+					error = newOutput->readFromFile(
+					    this, NULL,
+					    0); // If it finds any default params, it'll make a ParamManager and "back it up"
+					if (error) {
+						goto gotError;
 					}
 
-					else if (!strcmp(tagName, "kit")) {
-						memory = GeneralMemoryAllocator::get().allocMaxSpeed(sizeof(Kit));
-						if (!memory) {
-							return ERROR_INSUFFICIENT_RAM;
-						}
-						newOutput = new (memory) Kit();
-						defaultDirPath = "KITS";
-						goto setDirPathFirst;
-					}
+					*lastPointer = newOutput;
+					lastPointer = &newOutput->next;
+				}
 
-					else if (!strcmp(tagName, "midiChannel") || !strcmp(tagName, "mpeZone")) {
-						memory = GeneralMemoryAllocator::get().allocMaxSpeed(sizeof(MIDIInstrument));
-						if (!memory) {
-							return ERROR_INSUFFICIENT_RAM;
-						}
-						newOutput = new (memory) MIDIInstrument();
-						goto loadOutput;
+				else if (!strcmp(tagName, "kit")) {
+					memory = GeneralMemoryAllocator::get().allocMaxSpeed(sizeof(Kit));
+					if (!memory) {
+						return ERROR_INSUFFICIENT_RAM;
 					}
+					newOutput = new (memory) Kit();
+					defaultDirPath = "KITS";
+					goto setDirPathFirst;
+				}
 
-					else if (!strcmp(tagName, "cvChannel")) {
-						memory = GeneralMemoryAllocator::get().allocMaxSpeed(sizeof(CVInstrument));
-						if (!memory) {
-							return ERROR_INSUFFICIENT_RAM;
-						}
-						newOutput = new (memory) CVInstrument();
-						goto loadOutput;
+				else if (!strcmp(tagName, "midiChannel") || !strcmp(tagName, "mpeZone")) {
+					memory = GeneralMemoryAllocator::get().allocMaxSpeed(sizeof(MIDIInstrument));
+					if (!memory) {
+						return ERROR_INSUFFICIENT_RAM;
 					}
+					newOutput = new (memory) MIDIInstrument();
+					goto loadOutput;
+				}
 
-					storageManager.exitTag(tagName);
+				else if (!strcmp(tagName, "cvChannel")) {
+					memory = GeneralMemoryAllocator::get().allocMaxSpeed(sizeof(CVInstrument));
+					if (!memory) {
+						return ERROR_INSUFFICIENT_RAM;
+					}
+					newOutput = new (memory) CVInstrument();
+					goto loadOutput;
 				}
-				storageManager.exitTag("instruments");
-			}
 
-			else if (!strcmp(tagName, "songParams")) {
-				GlobalEffectableForClip::readParamsFromFile(&paramManager, 2147483647);
-				storageManager.exitTag("songParams");
+				storageManager.exitTag(tagName);
 			}
+			storageManager.exitTag("instruments");
+		} break;
 
-			else if (!strcmp(tagName, "tracks") || !strcmp(tagName, "sessionClips")) {
-				int32_t error = readClipsFromFile(&sessionClips);
-				if (error) {
-					return error;
-				}
-				storageManager.exitTag();
+		case XMLTag::songParams: {
+			GlobalEffectableForClip::readParamsFromFile(&paramManager, 2147483647);
+			storageManager.exitTag("songParams");
+		} break;
+
+		case XMLTag::tracks:
+		case XMLTag::sessionClips: {
+			int32_t error = readClipsFromFile(&sessionClips);
+			if (error) {
+				return error;
 			}
+			storageManager.exitTag();
+		} break;
 
-			else if (!strcmp(tagName, "arrangementOnlyTracks") || !strcmp(tagName, "arrangementOnlyClips")) {
-				int32_t error = readClipsFromFile(&arrangementOnlyClips);
-				if (error) {
-					return error;
-				}
-				storageManager.exitTag();
+		case XMLTag::arrangementOnlyTracks:
+		case XMLTag::arrangementOnlyClips: {
+			int32_t error = readClipsFromFile(&arrangementOnlyClips);
+			if (error) {
+				return error;
 			}
+			storageManager.exitTag();
+		} break;
 
+		default:
+			int32_t result = globalEffectable.readTagFromFile(tagName, &paramManager, 2147483647, this);
+			if (result == NO_ERROR) {}
+			else if (result != RESULT_TAG_UNUSED) {
+				return result;
+			}
 			else {
-				int32_t result = globalEffectable.readTagFromFile(tagName, &paramManager, 2147483647, this);
-				if (result == NO_ERROR) {}
-				else if (result != RESULT_TAG_UNUSED) {
+				int32_t result = storageManager.tryReadingFirmwareTagFromFile(tagName);
+				if (result && result != RESULT_TAG_UNUSED) {
 					return result;
 				}
-				else {
-					int32_t result = storageManager.tryReadingFirmwareTagFromFile(tagName);
-					if (result && result != RESULT_TAG_UNUSED) {
-						return result;
-					}
-					if (ALPHA_OR_BETA_VERSION) {
-						D_PRINTLN("unknown tag:  %s", tagName);
-					}
-					storageManager.exitTag(tagName);
+				if (ALPHA_OR_BETA_VERSION) {
+					D_PRINTLN("unknown tag:  %s", tagName);
 				}
+				storageManager.exitTag(tagName);
 			}
+			break;
 		}
 	}
 
@@ -2289,6 +2246,13 @@ traverseClips:
 		clipArray = &arrangementOnlyClips;
 		goto traverseClips;
 	}
+
+	if (mayActuallyReadFiles && AudioEngine::reverb.getModel() == deluge::dsp::Reverb::Model::CONVOLUTION) {
+		int32_t error = loadReverbImpulseResponse(&reverbImpulseResponsePath);
+		if (error) {
+			D_PRINTLN("couldn't load reverb impulse response");
+		}
+	}
 }
 
 void Song::loadCrucialSamplesOnly() {
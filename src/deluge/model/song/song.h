@@ -359,6 +359,7 @@ public:
 	float reverbDamp;
 	float reverbWidth;
 	int32_t reverbPan;
+	String reverbImpulseResponsePath; // For the convolution reverb model
 	int32_t reverbSidechainVolume;
 	int32_t reverbSidechainShape;
 	int32_t reverbSidechainAttack;
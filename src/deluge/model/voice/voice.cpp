@@ -23,6 +23,7 @@
 #include "dsp/util.hpp"
 #include "gui/waveform/waveform_renderer.h"
 #include "io/debug/log.h"
+#include "io/debug/trace.h"
 #include "memory/general_memory_allocator.h"
 #include "model/clip/instrument_clip.h"
 #include "model/model_stack.h"
@@ -123,6 +124,7 @@ bool Voice::noteOn(ModelStackWithVoice* modelStack, int32_t newNoteCodeBeforeArp
 	noteCodeAfterArpeggiation = newNoteCodeAfterArpeggiation;
 	orderSounded = lastSoundOrder++;
 	overrideAmplitudeEnvelopeReleaseRate = 0;
+	quality = VoiceQuality::FULL;
 
 	if (newNoteCodeAfterArpeggiation >= 128) {
 		sourceValues[util::to_underlying(PatchSource::NOTE)] = 2147483647;
@@ -947,13 +949,26 @@ skipAutoRelease: {}
 	// This is the gain which gets applied to compensate for any change in gain that the filter is going to cause
 	int32_t filterGain;
 
+	// If we've been cut down to one unison part, it doesn't want turning down as if it was summed with the others
+	int32_t volumeNeutralValueForUnison =
+	    (quality >= VoiceQuality::SINGLE_UNISON) ? 134217728 : sound->volumeNeutralValueForUnison;
+
+	// The ladder LPF costs a good deal more than the SVF. Morph means drive for the ladder, so it doesn't carry over -
+	// the SVF at no morph is a plain lowpass
+	FilterMode lpfMode = sound->lpfMode;
+	q31_t lpfMorph = paramFinalValues[params::LOCAL_LPF_MORPH];
+	if (quality >= VoiceQuality::SVF_FILTER && lpfMode <= kLastLadder) {
+		lpfMode = FilterMode::SVF_BAND;
+		lpfMorph = 0;
+	}
+
 	// Prepare the filters
 	// Checking if filters should run now happens within the filterset
 	filterGain = filterSet.setConfig(
-	    paramFinalValues[params::LOCAL_LPF_FREQ], paramFinalValues[params::LOCAL_LPF_RESONANCE], doLPF, sound->lpfMode,
-	    paramFinalValues[params::LOCAL_LPF_MORPH], paramFinalValues[params::LOCAL_HPF_FREQ],
+	    paramFinalValues[params::LOCAL_LPF_FREQ], paramFinalValues[params::LOCAL_LPF_RESONANCE], doLPF, lpfMode,
+	    lpfMorph, paramFinalValues[params::LOCAL_HPF_FREQ],
 	    (paramFinalValues[params::LOCAL_HPF_RESONANCE]), // >> storageManager.devVarA) << storageManager.devVarA,
-	    doHPF, sound->hpfMode, paramFinalValues[params::LOCAL_HPF_MORPH], sound->volumeNeutralValueForUnison << 1,
+	    doHPF, sound->hpfMode, paramFinalValues[params::LOCAL_HPF_MORPH], volumeNeutralValueForUnison << 1,
 	    sound->filterRoute); // Level adjustment for unison now happens *before* the filter!
 
 	SynthMode synthMode = sound->getSynthMode();
@@ -982,7 +997,7 @@ skipAutoRelease: {}
 
 			// Apply compensation for unison
 			overallOscAmplitude =
-			    multiply_32x32_rshift32_rounded(overallOscAmplitude, sound->volumeNeutralValueForUnison) << 3;
+			    multiply_32x32_rshift32_rounded(overallOscAmplitude, volumeNeutralValueForUnison) << 3;
 
 			int32_t a = multiply_32x32_rshift32(paramFinalValues[params::LOCAL_OSC_A_VOLUME], overallOscAmplitude);
 			int32_t b = multiply_32x32_rshift32(paramFinalValues[params::LOCAL_OSC_B_VOLUME], overallOscAmplitude);
@@ -1065,7 +1080,8 @@ skipAutoRelease: {}
 	}
 
 	// whether stereo unison actually is active. if stereo is being vetoed from higher up, don't do it.
-	bool stereoUnison = sound->unisonStereoSpread && sound->numUnison > 1 && soundRenderingInStereo;
+	bool stereoUnison = sound->unisonStereoSpread && sound->numUnison > 1 && soundRenderingInStereo
+	                    && quality < VoiceQuality::MONO;
 
 	// If various conditions are met, we can cut a corner by rendering directly into the Sound's buffer
 	bool renderingDirectlyIntoSoundBuffer;
@@ -1093,8 +1109,8 @@ skipAutoRelease: {}
 					continue;
 				}
 
-				bool renderingSourceInStereo =
-				    sound->sources[s].renderInStereo(sound, (SampleHolder*)guides[s].audioFileHolder);
+				bool renderingSourceInStereo = sound->sources[s].renderInStereo(
+				    sound, (SampleHolder*)guides[s].audioFileHolder, quality < VoiceQuality::MONO);
 
 				if (renderingSourceInStereo != soundRenderingInStereo) {
 					renderingDirectlyIntoSoundBuffer = false;
@@ -1225,7 +1241,8 @@ decidedWhichBufferRenderingInto:
 				}
 			}
 
-			if (!sound->sources[s].renderInStereo(sound, (SampleHolder*)guides[s].audioFileHolder)) {
+			if (!sound->sources[s].renderInStereo(sound, (SampleHolder*)guides[s].audioFileHolder,
+			                                      quality < VoiceQuality::MONO)) {
 				renderBasicSource(sound, paramManager, s, oscBuffer, numSamples, false, sourceAmplitudesNow[s],
 				                  &unisonPartBecameInactive, overallPitchAdjust, (s == 1) && doingOscSync, oscSyncPos,
 				                  oscSyncPhaseIncrement, sourceAmplitudeIncrements[s], getPhaseIncrements,
@@ -1298,6 +1315,9 @@ decidedWhichBufferRenderingInto:
 
 		// For each unison part
 		for (int32_t u = 0; u < sound->numUnison; u++) {
+			if (quality >= VoiceQuality::SINGLE_UNISON && u != (sound->numUnison >> 1)) {
+				continue;
+			}
 
 			int32_t unisonAmplitudeL, unisonAmplitudeR;
 			shouldDoPanning((stereoUnison ? sound->unisonPan[u] : 0), &unisonAmplitudeL, &unisonAmplitudeR);
@@ -1531,7 +1551,10 @@ skipUnisonPart: {}
 				dsp::foldBuffer(oscBuffer, oscBufferEnd, paramFinalValues[params::LOCAL_FOLD]);
 			}
 			// Filters
-			filterSet.renderLongStereo(oscBuffer, oscBufferEnd);
+			{
+				TRACE_ZONE(TraceZone::FILTERS, numSamples);
+				filterSet.renderLongStereo(oscBuffer, oscBufferEnd);
+			}
 
 			// No clipping
 			if (!sound->clippingAmount) {
@@ -1614,7 +1637,10 @@ skipUnisonPart: {}
 				dsp::foldBufferPolyApproximation(oscBuffer, oscBufferEnd, foldAmount);
 			}
 
-			filterSet.renderLong(oscBuffer, oscBufferEnd, numSamples);
+			{
+				TRACE_ZONE(TraceZone::FILTERS, numSamples);
+				filterSet.renderLong(oscBuffer, oscBufferEnd, numSamples);
+			}
 
 			// No clipping
 			if (!sound->clippingAmount) {
@@ -2086,7 +2112,8 @@ pitchTooHigh:
 			}
 		}
 
-		bool stereoUnison = sound->unisonStereoSpread && sound->numUnison > 1 && stereoBuffer;
+		bool stereoUnison =
+		    sound->unisonStereoSpread && sound->numUnison > 1 && stereoBuffer && quality < VoiceQuality::MONO;
 		int32_t amplitudeL, amplitudeR;
 		shouldDoPanning((stereoUnison ? sound->unisonPan[u] : 0), &amplitudeL, &amplitudeR);
 		// used if mono source but stereoUnison active
@@ -2193,7 +2220,10 @@ pitchTooHigh:
 			if (phaseIncrement != 16777216) {
 
 				// Work out what quality we're going to do that at
-				interpolationBufferSize = sound->sources[s].sampleControls.getInterpolationBufferSize(phaseIncrement);
+				interpolationBufferSize =
+				    (quality >= VoiceQuality::LINEAR_INTERPOLATION)
+				        ? 2
+				        : sound->sources[s].sampleControls.getInterpolationBufferSize(phaseIncrement);
 
 				// And if first render, and other conditions met, see if we can use cache.
 				// It may seem like it'd be a good idea to try and set this up on note-on, rather than here in the
@@ -3258,6 +3288,61 @@ bool Voice::doFastRelease(uint32_t releaseIncrement) {
 	}
 }
 
+// Whether moving down to this tier would make any difference to how this Voice gets rendered
+bool Voice::qualityTierApplies(VoiceQuality tier) {
+	Sound* sound = assignedToSound;
+	switch (tier) {
+	case VoiceQuality::LINEAR_INTERPOLATION:
+		if (sound->getSynthMode() == SynthMode::FM) {
+			return false;
+		}
+		for (int32_t s = 0; s < kNumSources; s++) {
+			if (sound->sources[s].oscType == OscType::SAMPLE && guides[s].audioFileHolder
+			    && sound->sources[s].sampleControls.interpolationMode != InterpolationMode::LINEAR) {
+				return true;
+			}
+		}
+		return false;
+
+	case VoiceQuality::MONO:
+		return sound->unisonStereoSpread && sound->numUnison > 1;
+
+	case VoiceQuality::SVF_FILTER:
+		return sound->lpfMode <= kLastLadder && filterSet.isLPFOn();
+
+	case VoiceQuality::SINGLE_UNISON:
+		return sound->numUnison > 1;
+
+	default:
+		return false;
+	}
+}
+
+// Moves this Voice down to the next VoiceQuality tier that actually makes it cheaper, skipping any that wouldn't
+// change anything. Returns false if there's no such tier left, in which case quality is left as it was.
+bool Voice::reduceQuality() {
+	VoiceQuality newQuality =
+	    getNextVoiceQuality(quality, [this](VoiceQuality tier) { return qualityTierApplies(tier); });
+	if (newQuality == quality) {
+		return false;
+	}
+	quality = newQuality;
+
+	// Subtractive rendering skips inactive unison parts, so we can just unassign all but the middle one (which has the
+	// least detune). FM and ringmod check quality as they go, since their oscillators never go inactive
+	if (quality == VoiceQuality::SINGLE_UNISON) {
+		int32_t partToKeep = assignedToSound->numUnison >> 1;
+		for (int32_t u = 0; u < assignedToSound->numUnison; u++) {
+			if (u != partToKeep) {
+				for (int32_t s = 0; s < kNumSources; s++) {
+					unisonParts[u].sources[s].unassign(false);
+				}
+			}
+		}
+	}
+	return true;
+}
+
 bool Voice::hasReleaseStage() {
 	return (paramFinalValues[params::LOCAL_ENV_0_RELEASE] <= 18359);
 }
@@ -19,6 +19,7 @@
 
 #include "definitions_cxx.hpp"
 #include "dsp/filter/filter_set.h"
+#include "model/voice/voice_quality.h"
 #include "model/voice/voice_sample_playback_guide.h"
 #include "model/voice/voice_unison_part.h"
 #include "modulation/envelope.h"
@@ -29,6 +30,7 @@
 class StereoSample;
 class ModelStackWithVoice;
 using namespace deluge;
+
 class Voice final {
 public:
 	Voice();
@@ -83,6 +85,9 @@ public:
 
 	int32_t overrideAmplitudeEnvelopeReleaseRate;
 
+	// Goes back to FULL for each new note
+	VoiceQuality quality;
+
 	Voice* nextUnassigned;
 
 	void setAsUnassigned(ModelStackWithVoice* modelStack, bool deletingSong = false);
@@ -97,6 +102,7 @@ public:
 	            uint32_t samplesLate, bool resetEnvelopes, int32_t fromMIDIChannel, const int16_t* mpeValues);
 	void noteOff(ModelStackWithVoice* modelStack, bool allowReleaseStage = true);
 	bool doFastRelease(uint32_t releaseIncrement = 4096);
+	bool reduceQuality();
 	void randomizeOscPhases(Sound* sound);
 	void changeNoteCode(ModelStackWithVoice* modelStack, int32_t newNoteCodeBeforeArpeggiation,
 	                    int32_t newNoteCodeAfterArpeggiation, int32_t newInputMIDIChannel, const int16_t* newMPEValues);
@@ -107,6 +113,7 @@ public:
 	void expressionEventSmooth(int32_t newValue, int32_t s);
 
 private:
+	bool qualityTierApplies(VoiceQuality tier);
 	// inline int32_t doFM(uint32_t *carrierPhase, uint32_t* lastShiftedPhase, uint32_t carrierPhaseIncrement, uint32_t
 	// phaseShift);
 
@@ -0,0 +1,49 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+// Cheaper ways of rendering a Voice, which it gets moved down through when the CPU's struggling, instead of being
+// culled outright. Each tier includes all the ones before it.
+enum class VoiceQuality : uint8_t {
+	FULL,
+	LINEAR_INTERPOLATION, // Pitched samples always get linear rather than windowed-sinc interpolation
+	MONO,                 // No stereo unison spread
+	SVF_FILTER,           // A ladder LPF gets swapped for the SVF
+	SINGLE_UNISON,        // Only the middle unison part gets rendered
+};
+constexpr VoiceQuality kLowestVoiceQuality = VoiceQuality::SINGLE_UNISON;
+
+// The next tier down from quality that tierApplies(tier) says would actually make the Voice cheaper, skipping any that
+// wouldn't change anything. Returns quality itself if there's no such tier left, meaning the Voice can only be culled
+template <typename TierApplies>
+constexpr VoiceQuality getNextVoiceQuality(VoiceQuality quality, TierApplies tierApplies) {
+	for (uint8_t tier = static_cast<uint8_t>(quality) + 1; tier <= static_cast<uint8_t>(kLowestVoiceQuality); tier++) {
+		if (tierApplies(static_cast<VoiceQuality>(tier))) {
+			return static_cast<VoiceQuality>(tier);
+		}
+	}
+	return quality;
+}
+
+// When two Voices rate the same for culling (see Voice::getPriorityRating()), the one that's been degraded further goes
+// first - it's already been through the tiers that would have spared it
+constexpr bool isMoreCullable(uint32_t rating, VoiceQuality quality, uint32_t otherRating, VoiceQuality otherQuality) {
+	return rating > otherRating || (rating == otherRating && quality > otherQuality);
+}
@@ -37,6 +37,7 @@
 #include "playback/mode/playback_mode.h"
 #include "playback/playback_handler.h"
 #include "processing/engines/audio_engine.h"
+#include "storage/song_autosaver.h"
 #include "storage/storage_manager.h"
 #include "util/functions.h"
 #include <math.h>
@@ -289,10 +290,14 @@ skipThat: {}
 	if (!nodes.getNumElements() || !isPlaying) {
 		if (value != currentValue) {
 			actionLogger.recordUnautomatedParamChange(modelStack);
+			songAutosaver.songEdited();
 		}
 	}
 
 getOut:
+	if (automationChanged) {
+		songAutosaver.songEdited();
+	}
 	currentValue = value;
 	bool automatedNow = isAutomated();
 	modelStack->paramCollection->notifyParamModifiedInSomeWay(modelStack, oldValue, automationChanged, automatedBefore,
@@ -1852,17 +1857,26 @@ void AutoParam::writeToFile(bool writeAutomation, int32_t* valueForOverride) {
 
 	if (writeAutomation) {
 
+		// Hex for a batch of nodes at a time gets put together here, then written in one go
+		constexpr int32_t kNumNodesPerWrite = 16;
+		char nodesBuffer[16 * kNumNodesPerWrite + 1];
+		char* bufferPos = nodesBuffer;
+
 		for (int32_t i = 0; i < nodes.getNumElements(); i++) {
 			ParamNode* thisNode = nodes.getElement(i);
-			intToHex(thisNode->value, buffer);
-			storageManager.write(buffer);
+			intToHex(thisNode->value, bufferPos);
 
 			uint32_t pos = thisNode->pos;
 			if (thisNode->interpolated) {
 				pos |= ((uint32_t)1 << 31);
 			}
-			intToHex(pos, buffer);
-			storageManager.write(buffer);
+			intToHex(pos, &bufferPos[8]);
+			bufferPos += 16;
+
+			if (bufferPos == &nodesBuffer[16 * kNumNodesPerWrite] || i == nodes.getNumElements() - 1) {
+				storageManager.write(nodesBuffer);
+				bufferPos = nodesBuffer;
+			}
 		}
 	}
 }
@@ -1876,7 +1890,14 @@ int32_t AutoParam::readFromFile(int32_t readAutomationUpToPos) {
 	// files, we'll be overwriting a cloned ParamManager, which might have had automation.
 	deleteAutomationBasicForSetup();
 
-	if (!storageManager.prepareToReadTagOrAttributeValueOneCharAtATime()) {
+	if (!storageManager.prepareToReadTagOrAttributeValueOneCharAtATime(true)) {
+		return NO_ERROR;
+	}
+
+	if (storageManager.getBinaryValueKind() != BinarySongFormat::ValueKind::NONE) {
+		if (storageManager.getBinaryValueKind() == BinarySongFormat::ValueKind::AUTOMATION) {
+			return readFromBinary(readAutomationUpToPos);
+		}
 		return NO_ERROR;
 	}
 
@@ -1908,33 +1929,39 @@ int32_t AutoParam::readFromFile(int32_t readAutomationUpToPos) {
 	currentValue = hexToIntFixedLength(hexChars, 8);
 
 	// And now read in the automation
-	int32_t numElementsToAllocateFor = 0;
-
 	if (readAutomationUpToPos) {
 
 		int32_t prevPos = -1;
+		int32_t numNodesInBuffer = 0;
 
 		while (true) {
 
-			// Every time we've reached the end of a cluster...
-			if (numElementsToAllocateFor <= 0) {
-
-				// See how many more chars before the end of the cluster. If there are any...
-				uint32_t charsRemaining = storageManager.getNumCharsRemainingInValue();
-				if (charsRemaining) {
-
-					// Allocate space for the right number of notes, and remember how long it'll be before we need to do
-					// this check again
-					numElementsToAllocateFor = (uint32_t)(charsRemaining - 1) / 16 + 1;
+			// Every time we've used up the whole nodes in the buffer, see how many more there are before the end of
+			// it - or of the value
+			if (numNodesInBuffer <= 0) {
+				storageManager.yieldToRoutinesIfDue();
+				numNodesInBuffer = storageManager.getNumCharsRemainingInValue() / 16;
+				if (numNodesInBuffer) {
 					nodes.ensureEnoughSpaceAllocated(
-					    numElementsToAllocateFor); // If it returns false... oh well. We'll fail later
+					    numNodesInBuffer); // If it returns false... oh well. We'll fail later
 				}
 			}
 
-			hexChars = storageManager.readNextCharsOfTagOrAttributeValue(16);
-			if (!hexChars) {
-				return NO_ERROR;
+			// Take them straight from the buffer...
+			if (numNodesInBuffer > 0) {
+				hexChars = &storageManager.fileClusterBuffer[storageManager.fileBufferCurrentPos];
+				storageManager.fileBufferCurrentPos += 16;
+				numNodesInBuffer--;
 			}
+
+			// ...and then read the one running over into the next cluster, if the value doesn't end here
+			else {
+				hexChars = storageManager.readNextCharsOfTagOrAttributeValue(16);
+				if (!hexChars) {
+					return NO_ERROR;
+				}
+			}
+
 			int32_t value = hexToIntFixedLength(hexChars, 8);
 			int32_t pos = hexToIntFixedLength(&hexChars[8], 8);
 
@@ -1943,47 +1970,96 @@ int32_t AutoParam::readFromFile(int32_t readAutomationUpToPos) {
 				pos &= ~((uint32_t)1 << 31);
 			}
 
-			// Ensure there isn't some problem where nodes are out of order...
-			if (pos <= prevPos) {
-				D_PRINTLN("Automation nodes out of order");
-				continue;
+			bool reachedEnd = false;
+			int32_t error = addNodeFromFile(pos, value, interpolated, readAutomationUpToPos, &prevPos, &reachedEnd);
+			if (error || reachedEnd) {
+				return error;
 			}
+		}
+	}
 
-			// If we've reached the end of our allowed timeline length for automation...
-			if (pos >= readAutomationUpToPos) {
+	return NO_ERROR;
+}
 
-				// If there's a node actually right on the end-point - well, firmware <= 3.1.5 sometimes put one there
-				// when it should have been at pos 0. So, reinterpret that data to make it right.
-				if (pos == readAutomationUpToPos) {
-					ParamNode* firstNode = nodes.getElement(0);
-					if (!firstNode || firstNode->pos) {
-						int32_t error = nodes.insertAtIndex(0);
-						if (error) {
-							return error;
-						}
-						firstNode = nodes.getElement(0);
-						firstNode->pos = 0;
-						firstNode->value = value;
-						firstNode->interpolated = interpolated;
-					}
+// Adds a node read from the file, unless it's out of order. Sets reachedEnd once we're past readAutomationUpToPos and
+// shouldn't read any more. Returns error code
+int32_t AutoParam::addNodeFromFile(int32_t pos, int32_t value, bool interpolated, int32_t readAutomationUpToPos,
+                                   int32_t* prevPos, bool* reachedEnd) {
+	// Ensure there isn't some problem where nodes are out of order...
+	if (pos <= *prevPos) {
+		D_PRINTLN("Automation nodes out of order");
+		return NO_ERROR;
+	}
+
+	// If we've reached the end of our allowed timeline length for automation...
+	if (pos >= readAutomationUpToPos) {
+
+		// If there's a node actually right on the end-point - well, firmware <= 3.1.5 sometimes put one there
+		// when it should have been at pos 0. So, reinterpret that data to make it right.
+		if (pos == readAutomationUpToPos) {
+			ParamNode* firstNode = nodes.getElement(0);
+			if (!firstNode || firstNode->pos) {
+				int32_t error = nodes.insertAtIndex(0);
+				if (error) {
+					return error;
 				}
-				break;
+				firstNode = nodes.getElement(0);
+				firstNode->pos = 0;
+				firstNode->value = value;
+				firstNode->interpolated = interpolated;
 			}
+		}
+		*reachedEnd = true;
+		return NO_ERROR;
+	}
 
-			prevPos = pos;
+	*prevPos = pos;
 
-			int32_t nodeI = nodes.insertAtKey(pos, true);
-			if (nodeI == -1) {
-				return ERROR_INSUFFICIENT_RAM;
+	int32_t nodeI = nodes.insertAtKey(pos, true);
+	if (nodeI == -1) {
+		return ERROR_INSUFFICIENT_RAM;
+	}
+	ParamNode* node = nodes.getElement(nodeI);
+	node->value = value;
+	node->interpolated = interpolated;
+	return NO_ERROR;
+}
+
+// For an AutoParam in a binary song. Returns error code
+int32_t AutoParam::readFromBinary(int32_t readAutomationUpToPos) {
+	currentValue = storageManager.getBinaryValueHeader();
+	if (!readAutomationUpToPos) {
+		return NO_ERROR;
+	}
+
+	constexpr int32_t kNumRecordsPerRead = 32;
+	BinarySongFormat::ParamNodeRecord records[kNumRecordsPerRead];
+	int32_t prevPos = -1;
+
+	int32_t numBytesInRun;
+	while ((numBytesInRun = storageManager.readBinaryValueRunLength()) > 0) {
+		int32_t numRecordsLeft = numBytesInRun / sizeof(BinarySongFormat::ParamNodeRecord);
+		nodes.ensureEnoughSpaceAllocated(numRecordsLeft); // If it returns false... oh well. We'll fail later
+
+		while (numRecordsLeft) {
+			int32_t numRecordsHere = std::min(numRecordsLeft, kNumRecordsPerRead);
+			if (!storageManager.readBinaryBytes(records,
+			                                    numRecordsHere * sizeof(BinarySongFormat::ParamNodeRecord))) {
+				return NO_ERROR;
 			}
-			ParamNode* node = nodes.getElement(nodeI);
-			node->value = value;
-			node->interpolated = interpolated;
+			numRecordsLeft -= numRecordsHere;
 
-			numElementsToAllocateFor--;
+			for (int32_t r = 0; r < numRecordsHere; r++) {
+				BinarySongFormat::ParamNodeRecord* record = &records[r];
+				bool reachedEnd = false;
+				int32_t error = addNodeFromFile(record->pos, record->value, record->interpolated != 0,
+				                                readAutomationUpToPos, &prevPos, &reachedEnd);
+				if (error || reachedEnd) {
+					return error;
+				}
+			}
 		}
 	}
-
 	return NO_ERROR;
 }
 
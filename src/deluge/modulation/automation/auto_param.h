@@ -126,4 +126,7 @@ private:
 	void homogenizeRegionTestSuccess(int32_t pos, int32_t regionEnd, int32_t startValue, bool interpolateStart,
 	                                 bool interpolateEnd);
 	void deleteNodesBeyondPos(int32_t pos);
+	int32_t readFromBinary(int32_t readAutomationUpToPos);
+	int32_t addNodeFromFile(int32_t pos, int32_t value, bool interpolated, int32_t readAutomationUpToPos,
+	                        int32_t* prevPos, bool* reachedEnd);
 };
@@ -23,6 +23,7 @@
 #include "gui/views/view.h"
 #include "hid/display/display.h"
 #include "hid/led/pad_leds.h"
+#include "model/clip/audio_clip.h"
 #include "model/clip/clip_instance.h"
 #include "model/clip/instrument_clip.h"
 #include "model/instrument/instrument.h"
@@ -278,6 +279,10 @@ notRecording:
 				else {
 					playbackHandler.swungTicksTilNextEvent =
 					    std::min(playbackHandler.swungTicksTilNextEvent, ticksTilStart);
+
+					if (thisClip->type == ClipType::AUDIO) {
+						((AudioClip*)thisClip)->hintWillPlaySoon();
+					}
 				}
 			}
 		}
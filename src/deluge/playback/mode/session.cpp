@@ -1860,6 +1860,11 @@ void Session::armClipLowLevel(Clip* clipToArm, ArmState armState, bool mustUnarm
 
 	clipToArm->armState = armState;
 
+	// If it's going to start, its audio will be wanted soon. Arming an active Clip is to stop it, though
+	if (armState != ArmState::OFF && clipToArm->type == ClipType::AUDIO && !currentSong->isClipActive(clipToArm)) {
+		((AudioClip*)clipToArm)->hintWillPlaySoon();
+	}
+
 	// Unarm any armed Clips with same Output, if we're doing that
 	if (mustUnarmOtherClipsWithSameOutput) {
 		// All session Clips
@@ -30,11 +30,13 @@
 #include "gui/views/view.h"
 #include "hid/display/display.h"
 #include "io/debug/log.h"
+#include "io/debug/trace.h"
 #include "io/midi/midi_engine.h"
 #include "memory/general_memory_allocator.h"
 #include "model/instrument/kit.h"
 #include "model/mod_controllable/mod_controllable_audio.h"
 #include "model/sample/sample_recorder.h"
+#include "model/settings/runtime_feature_settings.h"
 #include "model/song/song.h"
 #include "model/voice/voice.h"
 #include "model/voice/voice_sample.h"
@@ -42,6 +44,7 @@
 #include "modulation/patch/patch_cable_set.h"
 #include "processing/audio_output.h"
 #include "processing/engines/cv_engine.h"
+#include "processing/engines/voice_cost_model.h"
 #include "processing/live/live_input_buffer.h"
 #include "processing/metronome/metronome.h"
 #include "processing/sound/sound.h"
@@ -141,6 +144,7 @@ uint32_t timeThereWasLastSomeReverb = 0x8FFFFFFF;
 int32_t numSamplesLastTime = 0;
 uint32_t smoothedSamples = 0;
 uint32_t nextVoiceState = 1;
+uint32_t timeLastCompaction = 0;
 bool renderInStereo = true;
 bool bypassCulling = false;
 bool audioRoutineLocked = false;
@@ -187,6 +191,9 @@ Voice* firstUnassignedVoice;
 
 // You must set up dynamic memory allocation before calling this, because of its call to setupWithPatching()
 void init() {
+	// The voice cost model (and trace zones) time things with the PMU cycle counter, which needs switching on
+	Debug::init();
+
 	paramManagerForSamplePreview = new ((void*)paramManagerForSamplePreviewMemory) ParamManagerForTimeline();
 	paramManagerForSamplePreview->setupWithPatching(); // Shouldn't be an error at init time...
 	Sound::initParams(paramManagerForSamplePreview);
@@ -255,21 +262,25 @@ void songSwapAboutToHappen() {
 // To be called when CPU is overloaded and we need to free it up. This stops the voice which has been releasing longest,
 // or if none, the voice playing longest.
 Voice* cullVoice(bool saveVoice, bool justDoFastRelease, bool definitelyCull) {
+	TRACE_INSTANT(TraceZone::VOICE_CULL, getNumVoices());
+
 	// Only include audio if doing a hard cull and not saving the voice
 	bool includeAudio = !saveVoice && !justDoFastRelease && definitelyCull;
 	// Skip releasing voices if doing a soft cull and definitely culling
 	bool skipReleasing = justDoFastRelease && definitelyCull;
 	uint32_t bestRating = 0;
+	VoiceQuality bestQuality = VoiceQuality::FULL;
 	Voice* bestVoice = NULL;
 	for (int32_t v = 0; v < activeVoices.getNumElements(); v++) {
 		Voice* thisVoice = activeVoices.getVoice(v);
 
 		uint32_t ratingThisVoice = thisVoice->getPriorityRating();
 
-		if (ratingThisVoice > bestRating) {
+		if (isMoreCullable(ratingThisVoice, thisVoice->quality, bestRating, bestQuality)) {
 			// if we're not skipping releasing voices, or if we are and this one isn't in fast release
 			if (!skipReleasing || thisVoice->envelopes[0].state < EnvelopeStage::FAST_RELEASE) {
 				bestRating = ratingThisVoice;
+				bestQuality = thisVoice->quality;
 				bestVoice = thisVoice;
 			}
 		}
@@ -282,7 +293,17 @@ Voice* cullVoice(bool saveVoice, bool justDoFastRelease, bool definitelyCull) {
 		             // https://forums.synthstrom.com/discussion/4097/beta-4-0-0-beta-1-e196-by-loading-wavetable-osc#latest
 
 		if (justDoFastRelease) {
-			if (bestVoice->envelopes[0].state < EnvelopeStage::FAST_RELEASE) {
+			// If the user would rather lose some fidelity than notes, a Voice that's still sounding gets moved down a
+			// quality tier instead. Being the most cullable already, it'll be picked again next time, so it steps down
+			// through every tier that applies to it, and only gets fast-released once there are none left
+			bool mayDegrade = runtimeFeatureSettings.get(RuntimeFeatureSettingType::VoiceDegradation)
+			                  == RuntimeFeatureStateToggle::On;
+			if (mayDegrade && bestVoice->envelopes[0].state < EnvelopeStage::RELEASE && bestVoice->reduceQuality()) {
+				D_PRINTLN("degraded 1 voice to quality %d. numSamples:  %d", util::to_underlying(bestVoice->quality),
+				          smoothedSamples);
+			}
+
+			else if (bestVoice->envelopes[0].state < EnvelopeStage::FAST_RELEASE) {
 				bool stillGoing = bestVoice->doFastRelease(65536);
 
 				if (!stillGoing) {
@@ -323,6 +344,29 @@ int32_t getNumVoices() {
 constexpr int32_t numSamplesLimit = 40; // storageManager.devVarC;
 constexpr int32_t direnessThreshold = numSamplesLimit - 17;
 
+// Never shed more than this many voices ahead of a single window - if the model's that far out, the reactive culling
+// can sort it out
+constexpr int32_t kMaxVoicesToShedPerWindow = 4;
+
+// Predictive culling: if voiceCostModel reckons this window won't fit in budgetPercent of the time it's got, start
+// degrading or fast-releasing the lowest-priority voices now, rather than waiting for numSamples to tell us we've
+// already fallen behind. Voices the model is wrong about are still caught by the numSamples-based culling.
+void shedVoicesToFitBudget(int32_t numSamples, uint32_t budgetPercent) {
+	constexpr uint32_t kCyclesPerSample = Debug::sec / kSampleRate;
+	uint32_t budgetCycles = ((uint64_t)numSamples * kCyclesPerSample * budgetPercent) / 100;
+
+	// Each go either takes a Voice down a quality tier or fast-releases it, and the prediction's redone after, with
+	// what that actually saved - so a degraded Voice that's brought things under budget doesn't get culled as well
+	int32_t numShed = 0;
+	while (numShed < kMaxVoicesToShedPerWindow && voiceCostModel.predictWindowCycles(numSamples) > budgetCycles) {
+		cullVoice(false, true, true);
+		numShed++;
+	}
+	if (numShed > 0) {
+		logAction("budget cull");
+	}
+}
+
 void routineWithClusterLoading(bool mayProcessUserActionsBetween) {
 	logAction("AudioDriver::routineWithClusterLoading");
 
@@ -393,6 +437,23 @@ void routine() {
 		audioRoutineLocked = false;
 		return;
 	}
+
+	// In fixed-block mode, windows sit on a grid of audioSampleTimer, and we wait until there's room for the rest of
+	// the current block. A block only gets split where a tick lands inside it (see below), so where each window starts
+	// and ends no longer depends on CPU load
+#ifndef REPORT_CPU_USAGE
+	int32_t fixedBlockSize = runtimeFeatureSettings.get(RuntimeFeatureSettingType::FixedRenderBlock);
+	int32_t samplesLeftInBlock = 0;
+	size_t numSamplesAvailable = numSamples;
+	if (fixedBlockSize) {
+		samplesLeftInBlock = fixedBlockSize - (audioSampleTimer & (fixedBlockSize - 1));
+		if ((int32_t)numSamples < samplesLeftInBlock) {
+			audioRoutineLocked = false;
+			return;
+		}
+	}
+#endif
+	TRACE_ZONE(TraceZone::AUDIO_ROUTINE, numSamples);
 #if AUTOMATED_TESTER_ENABLED
 	AutomatedTester::possiblyDoSomething();
 #endif
@@ -429,6 +490,11 @@ void routine() {
 	int32_t unadjustedNumSamplesBeforeLappingPlayHead = numSamples;
 #else
 	constexpr int MINSAMPLES = 16;
+
+	// A fixed block only gets rendered once there's room for it, so it's how far past that we are that says how far
+	// behind we've fallen
+	numSamples -= samplesLeftInBlock;
+
 	// two step FIR
 	if (numSamples > numSamplesLastTime) {
 		smoothedSamples = (3 * numSamples + numSamplesLastTime) >> 2;
@@ -534,21 +600,27 @@ void routine() {
 	int32_t sampleThreshold = 6; // If too low, it'll lead to bigger audio windows and stuff
 	constexpr size_t maxAdjustedNumSamples = 0.66 * SSI_TX_BUFFER_NUM_SAMPLES;
 
+	numSamples = numSamplesAvailable;
 	int32_t unadjustedNumSamplesBeforeLappingPlayHead = numSamples;
 
-	if (numSamples < maxAdjustedNumSamples) {
-		int32_t samplesOverThreshold = numSamples - sampleThreshold;
-		if (samplesOverThreshold > 0) {
-			samplesOverThreshold = samplesOverThreshold << 1;
-			numSamples = sampleThreshold + samplesOverThreshold;
-			numSamples = std::min(numSamples, maxAdjustedNumSamples);
-		}
+	if (fixedBlockSize) {
+		numSamples = samplesLeftInBlock;
 	}
+	else {
+		if (numSamples < maxAdjustedNumSamples) {
+			int32_t samplesOverThreshold = numSamples - sampleThreshold;
+			if (samplesOverThreshold > 0) {
+				samplesOverThreshold = samplesOverThreshold << 1;
+				numSamples = sampleThreshold + samplesOverThreshold;
+				numSamples = std::min(numSamples, maxAdjustedNumSamples);
+			}
+		}
 
-	// Want to round to be doing a multiple of 4 samples, so the NEON functions can be utilized most efficiently.
-	// Note - this can take numSamples up as high as SSI_TX_BUFFER_NUM_SAMPLES (currently 128).
-	if (numSamples >= 3) {
-		numSamples = (numSamples + 2) & ~3;
+		// Want to round to be doing a multiple of 4 samples, so the NEON functions can be utilized most efficiently.
+		// Note - this can take numSamples up as high as SSI_TX_BUFFER_NUM_SAMPLES (currently 128).
+		if (numSamples >= 3) {
+			numSamples = (numSamples + 2) & ~3;
+		}
 	}
 
 #endif
@@ -632,7 +704,20 @@ startAgain:
 		}
 	}
 
+#ifndef REPORT_CPU_USAGE
+	uint32_t renderBudgetPercent = runtimeFeatureSettings.get(RuntimeFeatureSettingType::RenderBudget);
+	if (renderBudgetPercent && !bypassCulling) {
+		shedVoicesToFitBudget(numSamples, renderBudgetPercent);
+	}
+#endif
+	uint32_t windowStartCycles = Debug::readCycleCounter();
+
+#ifdef REPORT_CPU_USAGE
 	numSamplesLastTime = numSamples;
+#else
+	// In fixed-block mode the window length says nothing about the load, so remember how far behind we were instead
+	numSamplesLastTime = fixedBlockSize ? numSamplesAvailable - samplesLeftInBlock : numSamples;
+#endif
 	memset(&renderingBuffer, 0, numSamples * sizeof(StereoSample));
 
 	static std::array<int32_t, SSI_TX_BUFFER_NUM_SAMPLES> reverbBuffer __attribute__((aligned(CACHE_LINE_SIZE)));
@@ -748,6 +833,7 @@ startAgain:
 		}
 
 		// Mix reverb into main render
+		TRACE_ZONE(TraceZone::REVERB, numSamples);
 		reverb.setPanLevels(reverbAmplitudeL, reverbAmplitudeR);
 		reverb.process(reverb_buffer_slice, render_buffer_slice);
 	}
@@ -802,6 +888,7 @@ startAgain:
 		    >> 1;
 		// there used to be a static subtraction of 2 nepers (natural log based dB), this is the multiplicative
 		// equivalent
+		TRACE_ZONE(TraceZone::COMPRESSOR, numSamples);
 		currentSong->globalEffectable.compressor.render(renderingBuffer.data(), numSamples,
 		                                                masterVolumeAdjustmentL >> 1, masterVolumeAdjustmentR >> 1,
 		                                                songVolume >> 3);
@@ -853,6 +940,8 @@ startAgain:
 
 	doSomeOutputting();
 
+	voiceCostModel.recordWindow(Debug::readCycleCounter() - windowStartCycles, numSamples);
+
 	/*
 	if (!getRandom255()) {
 	    D_PRINTLN("samples:  %d . voices:  %d", numSamples, getNumVoices());
@@ -1490,6 +1579,12 @@ void slowRoutine() {
 
 	// Go through all SampleRecorders, getting them to write etc
 	doRecorderCardRoutines();
+
+	// Tidy up a little of the stealable region, if we've got time to spare
+	if (!cpuDireness && (uint32_t)(audioSampleTimer - timeLastCompaction) >= (kSampleRate / 100)) {
+		timeLastCompaction = audioSampleTimer;
+		GeneralMemoryAllocator::get().compactionRoutine();
+	}
 }
 
 SampleRecorder* getNewRecorder(int32_t numChannels, AudioRecordingFolder folderID, AudioInputChannel mode,
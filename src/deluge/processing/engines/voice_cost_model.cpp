@@ -0,0 +1,125 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "processing/engines/voice_cost_model.h"
+#include "model/voice/voice.h"
+#include "model/voice/voice_vector.h"
+#include "processing/engines/audio_engine.h"
+#include "processing/sound/sound.h"
+
+VoiceCostModel voiceCostModel{};
+
+namespace {
+// Running averages move 1/8 of the way towards each new measurement
+constexpr int32_t kAveragingShift = 3;
+
+void updateAverage(uint32_t& average, uint32_t measurement) {
+	average += ((int32_t)measurement - (int32_t)average) >> kAveragingShift;
+}
+} // namespace
+
+VoiceCostModel::VoiceCostModel() {
+	voiceCosts.fill(kInitialVoiceCost);
+	overheadCost = kInitialOverheadCost;
+	voiceCyclesThisWindow = 0;
+}
+
+uint8_t VoiceCostModel::getCostClass(Sound* sound, bool doLPF, bool doHPF) {
+	FilterCost filterCost = FilterCost::NONE;
+	if ((doLPF && sound->lpfMode <= kLastLadder) || (doHPF && sound->hpfMode == FilterMode::HPLADDER)) {
+		filterCost = FilterCost::LADDER;
+	}
+	else if (doLPF || doHPF) {
+		filterCost = FilterCost::SVF;
+	}
+
+	int32_t unisonBucket = (sound->numUnison <= 1) ? 0 : (sound->numUnison <= 3) ? 1 : 2;
+
+	bool playsSamples = false;
+	if (sound->getSynthMode() != SynthMode::FM) {
+		for (int32_t s = 0; s < kNumSources; s++) {
+			OscType oscType = sound->sources[s].oscType;
+			if (oscType == OscType::SAMPLE || oscType == OscType::WAVETABLE) {
+				playsSamples = true;
+			}
+		}
+	}
+
+	int32_t costClass = util::to_underlying(sound->getSynthMode());
+	costClass = costClass * kNumFilterCosts + util::to_underlying(filterCost);
+	costClass = costClass * kNumUnisonCostBuckets + unisonBucket;
+	costClass = costClass * 2 + playsSamples;
+	return costClass;
+}
+
+// Roughly what's left of a Voice's cost at each quality tier. Tiers that don't apply to a Voice get skipped over, so
+// these are only ever approximate, but they're in the right order
+uint32_t VoiceCostModel::getQualityWeight(VoiceQuality quality) {
+	switch (quality) {
+	case VoiceQuality::FULL:
+		return kFullQualityWeight;
+	case VoiceQuality::LINEAR_INTERPOLATION:
+		return kFullQualityWeight * 13 / 16;
+	case VoiceQuality::MONO:
+		return kFullQualityWeight * 11 / 16;
+	case VoiceQuality::SVF_FILTER:
+		return kFullQualityWeight * 9 / 16;
+	default: // SINGLE_UNISON
+		return kFullQualityWeight * 6 / 16;
+	}
+}
+
+void VoiceCostModel::recordSoundRender(uint8_t costClass, uint32_t cycles, uint32_t voiceWeight, int32_t numSamples) {
+	voiceCyclesThisWindow += cycles;
+	if (!voiceWeight || numSamples <= 0) {
+		return;
+	}
+	uint32_t costPerVoiceSample = ((uint64_t)cycles << (kCostFractionBits + kQualityWeightBits))
+	                              / ((uint64_t)voiceWeight * (uint32_t)numSamples);
+	updateAverage(voiceCosts[costClass], costPerVoiceSample);
+}
+
+void VoiceCostModel::recordWindow(uint32_t cycles, int32_t numSamples) {
+	uint32_t overheadCycles = (cycles > voiceCyclesThisWindow) ? cycles - voiceCyclesThisWindow : 0;
+	voiceCyclesThisWindow = 0;
+	if (numSamples <= 0) {
+		return;
+	}
+	updateAverage(overheadCost, ((uint64_t)overheadCycles << kCostFractionBits) / (uint32_t)numSamples);
+}
+
+// Voices already in fast release will be gone within a window or two, so they don't count
+uint32_t VoiceCostModel::predictWindowCycles(int32_t numSamples) {
+	uint64_t voiceCostPerSample = 0;
+
+	// activeVoices is sorted by Sound, so we only need to look each Sound's cost up once
+	Sound* lastSound = nullptr;
+	uint32_t lastSoundVoiceCost = 0;
+	for (int32_t v = 0; v < AudioEngine::activeVoices.getNumElements(); v++) {
+		Voice* voice = AudioEngine::activeVoices.getVoice(v);
+		if (voice->envelopes[0].state >= EnvelopeStage::FAST_RELEASE) {
+			continue;
+		}
+		if (voice->assignedToSound != lastSound) {
+			lastSound = voice->assignedToSound;
+			lastSoundVoiceCost = voiceCosts[lastSound->voiceCostClass];
+		}
+		voiceCostPerSample += ((uint64_t)lastSoundVoiceCost * getQualityWeight(voice->quality)) >> kQualityWeightBits;
+	}
+
+	return ((overheadCost + voiceCostPerSample) * numSamples) >> kCostFractionBits;
+}
@@ -0,0 +1,81 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "definitions_cxx.hpp"
+#include "model/mod_controllable/filters/filter_config.h"
+#include <array>
+#include <cstdint>
+
+class Sound;
+enum class VoiceQuality : uint8_t;
+
+/*
+ * Predicts how many CPU cycles an audio window is going to take, so that AudioEngine::routine() can shed voices
+ * *before* rendering a window that wouldn't fit, rather than waiting until the DMA pointer has already slipped (which
+ * is all the numSamples-based cpuDireness logic can see).
+ *
+ * Every time a Sound renders, the cycles its Voices took get measured and folded into a running average of "cycles per
+ * Voice per sample" for that Sound's cost class - which is its synth mode, filter type, unison count and whether it
+ * plays samples or just oscillators. Everything that isn't Voice rendering (reverb, master FX, output) gets averaged
+ * as a per-sample overhead. A window's predicted cost is then just the overhead plus each active Voice's class cost,
+ * times the number of samples.
+ *
+ * A Voice that's been moved down a quality tier costs less than its class says, so each Voice's cost gets scaled by a
+ * rough weight for its tier - both when predicting, and when working the class cost out from a Sound's measurement.
+ */
+class VoiceCostModel {
+public:
+	enum class FilterCost : uint8_t { NONE, SVF, LADDER };
+
+	// Costs are kept as cycles per Voice per sample, with this many fractional bits
+	static constexpr int32_t kCostFractionBits = 8;
+
+	// Where to start before anything's been measured. A subtractive voice with a filter is somewhere around here
+	static constexpr uint32_t kInitialVoiceCost = 150 << kCostFractionBits;
+	static constexpr uint32_t kInitialOverheadCost = 1500 << kCostFractionBits;
+
+	// A full-quality Voice weighs this much
+	static constexpr int32_t kQualityWeightBits = 8;
+	static constexpr uint32_t kFullQualityWeight = 1 << kQualityWeightBits;
+
+	VoiceCostModel();
+
+	static uint8_t getCostClass(Sound* sound, bool doLPF, bool doHPF);
+	static uint32_t getQualityWeight(VoiceQuality quality);
+
+	// voiceWeight is the sum of getQualityWeight() for each Voice rendered
+	void recordSoundRender(uint8_t costClass, uint32_t cycles, uint32_t voiceWeight, int32_t numSamples);
+	void recordWindow(uint32_t cycles, int32_t numSamples);
+
+	uint32_t getVoiceCost(uint8_t costClass) { return voiceCosts[costClass]; }
+	uint32_t predictWindowCycles(int32_t numSamples);
+
+	// Cycles spent rendering Voices in the current window, so recordWindow() can subtract them out of the overhead
+	uint32_t voiceCyclesThisWindow;
+
+private:
+	static constexpr int32_t kNumUnisonCostBuckets = 3;
+	static constexpr int32_t kNumFilterCosts = 3;
+	static constexpr int32_t kNumCostClasses = kNumSynthModes * kNumFilterCosts * kNumUnisonCostBuckets * 2;
+
+	std::array<uint32_t, kNumCostClasses> voiceCosts;
+	uint32_t overheadCost;
+};
+
+extern VoiceCostModel voiceCostModel;
@@ -22,7 +22,9 @@
 #include "util/lookuptables/lookuptables.h"
 
 #pragma GCC push_options
+#if defined(__arm__)
 #pragma GCC target("fpu=neon")
+#endif
 
 #include "arm_neon_shim.h"
 
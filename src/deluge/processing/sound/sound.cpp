@@ -26,6 +26,7 @@
 #include "hid/led/indicator_leds.h"
 #include "hid/matrix/matrix_driver.h"
 #include "io/debug/log.h"
+#include "io/debug/trace.h"
 #include "memory/general_memory_allocator.h"
 #include "model/action/action.h"
 #include "model/action/action_logger.h"
@@ -46,12 +47,14 @@
 #include "modulation/patch/patcher.h"
 #include "playback/playback_handler.h"
 #include "processing/engines/audio_engine.h"
+#include "processing/engines/voice_cost_model.h"
 #include "processing/sound/sound_instrument.h"
 #include "storage/audio/audio_file_manager.h"
 #include "storage/flash_storage.h"
 #include "storage/multi_range/multi_wave_table_range.h"
 #include "storage/multi_range/multisample_range.h"
 #include "storage/storage_manager.h"
+#include "storage/xml_tag.h"
 #include "util/functions.h"
 #include "util/misc.h"
 #include <math.h>
@@ -91,6 +94,7 @@ Sound::Sound() : patcher(&patchableInfoForSound) {
 	}
 
 	numVoicesAssigned = 0;
+	voiceCostClass = 0;
 
 	sideChainSendLevel = 0;
 	polyphonic = PolyphonyMode::POLY;
@@ -468,23 +472,24 @@ void Sound::recalculatePatchingToParam(uint8_t p, ParamManagerForTimeline* param
 int32_t Sound::readTagFromFile(char const* tagName, ParamManagerForTimeline* paramManager,
                                int32_t readAutomationUpToPos, ArpeggiatorSettings* arpSettings, Song* song) {
 
-	if (!strcmp(tagName, "osc1")) {
+	switch (xmlTagFromName(tagName)) {
+	case XMLTag::osc1: {
 		int32_t error = readSourceFromFile(0, paramManager, readAutomationUpToPos);
 		if (error) {
 			return error;
 		}
 		storageManager.exitTag("osc1");
-	}
+	} break;
 
-	else if (!strcmp(tagName, "osc2")) {
+	case XMLTag::osc2: {
 		int32_t error = readSourceFromFile(1, paramManager, readAutomationUpToPos);
 		if (error) {
 			return error;
 		}
 		storageManager.exitTag("osc2");
-	}
+	} break;
 
-	else if (!strcmp(tagName, "mode")) {
+	case XMLTag::mode: {
 		char const* contents = storageManager.readTagOrAttributeValue();
 		if (synthMode != SynthMode::RINGMOD) { // Compatibility with old XML files
 			synthMode = stringToSynthMode(contents);
@@ -492,10 +497,10 @@ int32_t Sound::readTagFromFile(char const* tagName, ParamManagerForTimeline* par
 		// Uart::print("synth mode set to: ");
 		// Uart::println(synthMode);
 		storageManager.exitTag("mode");
-	}
+	} break;
 
 	// Backwards-compatible reading of old-style oscs, from pre-mid-2016 files
-	else if (!strcmp(tagName, "oscillatorA")) {
+	case XMLTag::oscillatorA: {
 		while (*(tagName = storageManager.readNextTagOrAttributeName())) {
 
 			if (!strcmp(tagName, "type")) {
@@ -526,9 +531,9 @@ int32_t Sound::readTagFromFile(char const* tagName, ParamManagerForTimeline* par
 			}
 		}
 		storageManager.exitTag("oscillatorA");
-	}
+	} break;
 
-	else if (!strcmp(tagName, "oscillatorB")) {
+	case XMLTag::oscillatorB: {
 		while (*(tagName = storageManager.readNextTagOrAttributeName())) {
 			if (!strcmp(tagName, "type")) {
 				sources[1].oscType = stringToOscType(storageManager.readTagOrAttributeValue());
@@ -559,9 +564,9 @@ int32_t Sound::readTagFromFile(char const* tagName, ParamManagerForTimeline* par
 			}
 		}
 		storageManager.exitTag("oscillatorB");
-	}
+	} break;
 
-	else if (!strcmp(tagName, "modulator1")) {
+	case XMLTag::modulator1: {
 		while (*(tagName = storageManager.readNextTagOrAttributeName())) {
 			if (!strcmp(tagName, "volume")) {
 				ENSURE_PARAM_MANAGER_EXISTS
@@ -585,9 +590,9 @@ int32_t Sound::readTagFromFile(char const* tagName, ParamManagerForTimeline* par
 			}
 		}
 		storageManager.exitTag("modulator1");
-	}
+	} break;
 
-	else if (!strcmp(tagName, "modulator2")) {
+	case XMLTag::modulator2: {
 		while (*(tagName = storageManager.readNextTagOrAttributeName())) {
 			if (!strcmp(tagName, "volume")) {
 				ENSURE_PARAM_MANAGER_EXISTS
@@ -618,9 +623,9 @@ int32_t Sound::readTagFromFile(char const* tagName, ParamManagerForTimeline* par
 			}
 		}
 		storageManager.exitTag("modulator2");
-	}
+	} break;
 
-	else if (!strcmp(tagName, "arpeggiator")) {
+	case XMLTag::arpeggiator: {
 		// Set default values in case they are not configured
 		arpSettings->syncType = SYNC_TYPE_EVEN;
 		arpSettings->syncLevel = SYNC_LEVEL_NONE;
@@ -697,49 +702,48 @@ int32_t Sound::readTagFromFile(char const* tagName, ParamManagerForTimeline* par
 		}
 
 		storageManager.exitTag("arpeggiator");
-	}
+	} break;
 
-	else if (!strcmp(tagName, "transpose")) {
+	case XMLTag::transpose: {
 		transpose = storageManager.readTagOrAttributeValueInt();
 		storageManager.exitTag("transpose");
-	}
+	} break;
 
-	else if (!strcmp(tagName, "noiseVolume")) {
+	case XMLTag::noiseVolume: {
 		ENSURE_PARAM_MANAGER_EXISTS
 		patchedParams->readParam(patchedParamsSummary, params::LOCAL_NOISE_VOLUME, readAutomationUpToPos);
 		storageManager.exitTag("noiseVolume");
-	}
+	} break;
 
-	else if (!strcmp(tagName, "ratchetAmount")) {
+	case XMLTag::ratchetAmount: {
 		ENSURE_PARAM_MANAGER_EXISTS
 		unpatchedParams->readParam(unpatchedParamsSummary, params::UNPATCHED_ARP_RATCHET_AMOUNT, readAutomationUpToPos);
 		storageManager.exitTag("ratchetAmount");
-	}
+	} break;
 
-	else if (!strcmp(tagName, "ratchetProbability")) {
+	case XMLTag::ratchetProbability: {
 		ENSURE_PARAM_MANAGER_EXISTS
 		unpatchedParams->readParam(unpatchedParamsSummary, params::UNPATCHED_ARP_RATCHET_PROBABILITY,
 		                           readAutomationUpToPos);
 		storageManager.exitTag("ratchetProbability");
-	}
+	} break;
 
-	else if (!strcmp(tagName, "sequenceLength")) {
+	case XMLTag::sequenceLength: {
 		ENSURE_PARAM_MANAGER_EXISTS
 		unpatchedParams->readParam(unpatchedParamsSummary, params::UNPATCHED_ARP_SEQUENCE_LENGTH,
 		                           readAutomationUpToPos);
 		storageManager.exitTag("sequenceLength");
-	}
+	} break;
 
-	else if (!strcmp(tagName,
-	                 "portamento")) { // This is here for compatibility only for people (Lou and Ian) who saved songs
-		                              // with firmware in September 2016
+	// This is here for compatibility only for people (Lou and Ian) who saved songs with firmware in September 2016
+	case XMLTag::portamento: {
 		ENSURE_PARAM_MANAGER_EXISTS
 		unpatchedParams->readParam(unpatchedParamsSummary, params::UNPATCHED_PORTAMENTO, readAutomationUpToPos);
 		storageManager.exitTag("portamento");
-	}
+	} break;
 
 	// For backwards compatibility. If off, switch off for all operators
-	else if (!strcmp(tagName, "oscillatorReset")) {
+	case XMLTag::oscillatorReset: {
 		int32_t value = storageManager.readTagOrAttributeValueInt();
 		if (!value) {
 			for (int32_t s = 0; s < kNumSources; s++) {
@@ -750,9 +754,9 @@ int32_t Sound::readTagFromFile(char const* tagName, ParamManagerForTimeline* par
 			}
 		}
 		storageManager.exitTag("oscillatorReset");
-	}
+	} break;
 
-	else if (!strcmp(tagName, "unison")) {
+	case XMLTag::unison: {
 		while (*(tagName = storageManager.readNextTagOrAttributeName())) {
 			if (!strcmp(tagName, "num")) {
 				int32_t contents = storageManager.readTagOrAttributeValueInt();
@@ -774,34 +778,34 @@ int32_t Sound::readTagFromFile(char const* tagName, ParamManagerForTimeline* par
 			}
 		}
 		storageManager.exitTag("unison");
-	}
+	} break;
 
-	else if (!strcmp(tagName, "oscAPitchAdjust")) {
+	case XMLTag::oscAPitchAdjust: {
 		ENSURE_PARAM_MANAGER_EXISTS
 		patchedParams->readParam(patchedParamsSummary, params::LOCAL_OSC_A_PITCH_ADJUST, readAutomationUpToPos);
 		storageManager.exitTag("oscAPitchAdjust");
-	}
+	} break;
 
-	else if (!strcmp(tagName, "oscBPitchAdjust")) {
+	case XMLTag::oscBPitchAdjust: {
 		ENSURE_PARAM_MANAGER_EXISTS
 		patchedParams->readParam(patchedParamsSummary, params::LOCAL_OSC_B_PITCH_ADJUST, readAutomationUpToPos);
 		storageManager.exitTag("oscBPitchAdjust");
-	}
+	} break;
 
-	else if (!strcmp(tagName, "mod1PitchAdjust")) {
+	case XMLTag::mod1PitchAdjust: {
 		ENSURE_PARAM_MANAGER_EXISTS
 		patchedParams->readParam(patchedParamsSummary, params::LOCAL_MODULATOR_0_PITCH_ADJUST, readAutomationUpToPos);
 		storageManager.exitTag("mod1PitchAdjust");
-	}
+	} break;
 
-	else if (!strcmp(tagName, "mod2PitchAdjust")) {
+	case XMLTag::mod2PitchAdjust: {
 		ENSURE_PARAM_MANAGER_EXISTS
 		patchedParams->readParam(patchedParamsSummary, params::LOCAL_MODULATOR_1_PITCH_ADJUST, readAutomationUpToPos);
 		storageManager.exitTag("mod2PitchAdjust");
-	}
+	} break;
 
 	// Stuff from the early-2016 format, for compatibility
-	else if (!strcmp(tagName, "fileName")) {
+	case XMLTag::fileName: {
 		ENSURE_PARAM_MANAGER_EXISTS
 
 		MultisampleRange* range = (MultisampleRange*)sources[0].getOrCreateFirstRange();
@@ -825,25 +829,25 @@ int32_t Sound::readTagFromFile(char const* tagName, ParamManagerForTimeline* par
 		    getParamFromUserValue(params::LOCAL_OSC_B_VOLUME, 0));
 
 		storageManager.exitTag("fileName");
-	}
+	} break;
 
-	else if (!strcmp(tagName, "cents")) {
+	case XMLTag::cents: {
 		int8_t newCents = storageManager.readTagOrAttributeValueInt();
 		// We don't need to call the setTranspose method here, because this will get called soon anyway, once the sample
 		// rate is known
 		sources[0].cents = (std::max((int8_t)-50, std::min((int8_t)50, newCents)));
 		storageManager.exitTag("cents");
-	}
-	else if (!strcmp(tagName, "continuous")) {
+	} break;
+	case XMLTag::continuous: {
 		sources[0].repeatMode = static_cast<SampleRepeatMode>(storageManager.readTagOrAttributeValueInt());
 		sources[0].repeatMode = std::min(sources[0].repeatMode, static_cast<SampleRepeatMode>(kNumRepeatModes - 1));
 		storageManager.exitTag("continuous");
-	}
-	else if (!strcmp(tagName, "reversed")) {
+	} break;
+	case XMLTag::reversed: {
 		sources[0].sampleControls.reversed = storageManager.readTagOrAttributeValueInt();
 		storageManager.exitTag("reversed");
-	}
-	else if (!strcmp(tagName, "zone")) {
+	} break;
+	case XMLTag::zone: {
 
 		MultisampleRange* range = (MultisampleRange*)sources[0].getOrCreateFirstRange();
 		if (!range) {
@@ -875,17 +879,17 @@ int32_t Sound::readTagFromFile(char const* tagName, ParamManagerForTimeline* par
 			}
 		}
 		storageManager.exitTag("zone");
-	}
+	} break;
 
-	else if (!strcmp(tagName, "ringMod")) {
+	case XMLTag::ringMod: {
 		int32_t contents = storageManager.readTagOrAttributeValueInt();
 		if (contents == 1) {
 			synthMode = SynthMode::RINGMOD;
 		}
 		storageManager.exitTag("ringMod");
-	}
+	} break;
 
-	else if (!strcmp(tagName, "modKnobs")) {
+	case XMLTag::modKnobs: {
 
 		int32_t k = 0;
 		int32_t w = 0;
@@ -940,42 +944,42 @@ int32_t Sound::readTagFromFile(char const* tagName, ParamManagerForTimeline* par
 			storageManager.exitTag();
 		}
 		storageManager.exitTag("modKnobs");
-	}
+	} break;
 
-	else if (!strcmp(tagName, "patchCables")) {
+	case XMLTag::patchCables: {
 		ENSURE_PARAM_MANAGER_EXISTS
 		paramManager->getPatchCableSet()->readPatchCablesFromFile(readAutomationUpToPos);
 		storageManager.exitTag("patchCables");
-	}
+	} break;
 
-	else if (!strcmp(tagName, "volume")) {
+	case XMLTag::volume: {
 		ENSURE_PARAM_MANAGER_EXISTS
 		patchedParams->readParam(patchedParamsSummary, params::GLOBAL_VOLUME_POST_FX, readAutomationUpToPos);
 		storageManager.exitTag("volume");
-	}
+	} break;
 
-	else if (!strcmp(tagName, "pan")) {
+	case XMLTag::pan: {
 		ENSURE_PARAM_MANAGER_EXISTS
 		patchedParams->readParam(patchedParamsSummary, params::LOCAL_PAN, readAutomationUpToPos);
 		storageManager.exitTag("pan");
-	}
+	} break;
 
-	else if (!strcmp(tagName, "pitchAdjust")) {
+	case XMLTag::pitchAdjust: {
 		ENSURE_PARAM_MANAGER_EXISTS
 		patchedParams->readParam(patchedParamsSummary, params::LOCAL_PITCH_ADJUST, readAutomationUpToPos);
 		storageManager.exitTag("pitchAdjust");
-	}
+	} break;
 
-	else if (!strcmp(tagName, "modFXType")) {
+	case XMLTag::modFXType: {
 		bool result = setModFXType(
 		    stringToFXType(storageManager.readTagOrAttributeValue())); // This might not work if not enough RAM
 		if (!result) {
 			display->displayError(ERROR_INSUFFICIENT_RAM);
 		}
 		storageManager.exitTag("modFXType");
-	}
+	} break;
 
-	else if (!strcmp(tagName, "fx")) {
+	case XMLTag::fx: {
 		while (*(tagName = storageManager.readNextTagOrAttributeName())) {
 
 			if (!strcmp(tagName, "type")) {
@@ -1022,9 +1026,9 @@ int32_t Sound::readTagFromFile(char const* tagName, ParamManagerForTimeline* par
 			}
 		}
 		storageManager.exitTag("fx");
-	}
+	} break;
 
-	else if (!strcmp(tagName, "lfo1")) {
+	case XMLTag::lfo1: {
 		// Set default values in case they are not configured.
 		// setLFOGlobalSyncLevel will also set type based on value.
 		setLFOGlobalSyncLevel(SYNC_LEVEL_NONE);
@@ -1052,9 +1056,9 @@ int32_t Sound::readTagFromFile(char const* tagName, ParamManagerForTimeline* par
 			}
 		}
 		storageManager.exitTag("lfo1");
-	}
+	} break;
 
-	else if (!strcmp(tagName, "lfo2")) {
+	case XMLTag::lfo2: {
 		while (*(tagName = storageManager.readNextTagOrAttributeName())) {
 			if (!strcmp(tagName, "type")) {
 				lfoLocalWaveType = stringToLFOType(storageManager.readTagOrAttributeValue());
@@ -1070,14 +1074,14 @@ int32_t Sound::readTagFromFile(char const* tagName, ParamManagerForTimeline* par
 			}
 		}
 		storageManager.exitTag("lfo2");
-	}
+	} break;
 
-	else if (!strcmp(tagName, "sideChainSend")) {
+	case XMLTag::sideChainSend: {
 		sideChainSendLevel = storageManager.readTagOrAttributeValueInt();
 		storageManager.exitTag("sideChainSend");
-	}
+	} break;
 
-	else if (!strcmp(tagName, "lpf")) {
+	case XMLTag::lpf: {
 		bool switchedOn = true; // For backwards compatibility with pre November 2015 files
 		while (*(tagName = storageManager.readNextTagOrAttributeName())) {
 			if (!strcmp(tagName, "status")) {
@@ -1115,9 +1119,9 @@ int32_t Sound::readTagFromFile(char const* tagName, ParamManagerForTimeline* par
 		}
 
 		storageManager.exitTag("lpf");
-	}
+	} break;
 
-	else if (!strcmp(tagName, "hpf")) {
+	case XMLTag::hpf: {
 		bool switchedOn = true; // For backwards compatibility with pre November 2015 files
 		while (*(tagName = storageManager.readNextTagOrAttributeName())) {
 			if (!strcmp(tagName, "status")) {
@@ -1151,9 +1155,9 @@ int32_t Sound::readTagFromFile(char const* tagName, ParamManagerForTimeline* par
 		}
 
 		storageManager.exitTag("hpf");
-	}
+	} break;
 
-	else if (!strcmp(tagName, "envelope1")) {
+	case XMLTag::envelope1: {
 		while (*(tagName = storageManager.readNextTagOrAttributeName())) {
 			if (!strcmp(tagName, "attack")) {
 				ENSURE_PARAM_MANAGER_EXISTS
@@ -1181,9 +1185,9 @@ int32_t Sound::readTagFromFile(char const* tagName, ParamManagerForTimeline* par
 		}
 
 		storageManager.exitTag("envelope1");
-	}
+	} break;
 
-	else if (!strcmp(tagName, "envelope2")) {
+	case XMLTag::envelope2: {
 		while (*(tagName = storageManager.readNextTagOrAttributeName())) {
 			if (!strcmp(tagName, "attack")) {
 				ENSURE_PARAM_MANAGER_EXISTS
@@ -1211,36 +1215,36 @@ int32_t Sound::readTagFromFile(char const* tagName, ParamManagerForTimeline* par
 		}
 
 		storageManager.exitTag("envelope2");
-	}
+	} break;
 
-	else if (!strcmp(tagName, "polyphonic")) {
+	case XMLTag::polyphonic: {
 		polyphonic = stringToPolyphonyMode(storageManager.readTagOrAttributeValue());
 		storageManager.exitTag("polyphonic");
-	}
+	} break;
 
-	else if (!strcmp(tagName, "voicePriority")) {
+	case XMLTag::voicePriority: {
 		voicePriority = static_cast<VoicePriority>(storageManager.readTagOrAttributeValueInt());
 		storageManager.exitTag("voicePriority");
-	}
+	} break;
 
-	else if (!strcmp(tagName, "reverbAmount")) {
+	case XMLTag::reverbAmount: {
 		ENSURE_PARAM_MANAGER_EXISTS
 		patchedParams->readParam(patchedParamsSummary, params::GLOBAL_REVERB_AMOUNT, readAutomationUpToPos);
 		storageManager.exitTag("reverbAmount");
-	}
+	} break;
 
-	else if (!strcmp(tagName, "defaultParams")) {
+	case XMLTag::defaultParams: {
 		ENSURE_PARAM_MANAGER_EXISTS
 		Sound::readParamsFromFile(paramManager, readAutomationUpToPos);
 		storageManager.exitTag("defaultParams");
-	}
-	else if (!strcmp(tagName, "waveFold")) {
+	} break;
+	case XMLTag::waveFold: {
 		ENSURE_PARAM_MANAGER_EXISTS
 		patchedParams->readParam(patchedParamsSummary, params::LOCAL_FOLD, readAutomationUpToPos);
 		storageManager.exitTag("waveFold");
-	}
+	} break;
 
-	else {
+	default:
 		int32_t result = ModControllableAudio::readTagFromFile(tagName, paramManager, readAutomationUpToPos, song);
 		if (result == NO_ERROR) {}
 		else if (result != RESULT_TAG_UNUSED) {
@@ -1254,6 +1258,7 @@ int32_t Sound::readTagFromFile(char const* tagName, ParamManagerForTimeline* par
 			}
 			storageManager.exitTag();
 		}
+		break;
 	}
 
 	return NO_ERROR;
@@ -2248,10 +2253,17 @@ void Sound::render(ModelStackWithThreeMainThings* modelStack, StereoSample* outp
 		bool doneFirstVoice = false;
 		*/
 
+		TRACE_ZONE(TraceZone::VOICE_RENDER, numVoicesAssigned);
+
+		voiceCostClass = VoiceCostModel::getCostClass(this, doLPF, doHPF);
+		uint32_t voiceWeightRendered = 0;
+		uint32_t voiceRenderStartCycles = Debug::readCycleCounter();
+
 		int32_t ends[2];
 		AudioEngine::activeVoices.getRangeForSound(this, ends);
 		for (int32_t v = ends[0]; v < ends[1]; v++) {
 			Voice* thisVoice = AudioEngine::activeVoices.getVoice(v);
+			voiceWeightRendered += VoiceCostModel::getQualityWeight(thisVoice->quality);
 			/*
 			if (!doneFirstVoice) {
 			    if (numVoicesAssigned > 1) {
@@ -2275,6 +2287,9 @@ void Sound::render(ModelStackWithThreeMainThings* modelStack, StereoSample* outp
 			}
 		}
 
+		voiceCostModel.recordSoundRender(voiceCostClass, Debug::readCycleCounter() - voiceRenderStartCycles,
+		                                 voiceWeightRendered, numSamples);
+
 		// If just rendered in mono, double that up to stereo now
 		if (!renderingInStereo) {
 			// We know that nothing's patched to pan, so can read it in this very basic way.
@@ -2355,6 +2370,7 @@ void Sound::render(ModelStackWithThreeMainThings* modelStack, StereoSample* outp
 	q31_t compThreshold = paramManager->getUnpatchedParamSet()->getValue(params::UNPATCHED_COMPRESSOR_THRESHOLD);
 	compressor.setThreshold(compThreshold);
 	if (compThreshold > 0) {
+		TRACE_ZONE(TraceZone::COMPRESSOR, numSamples);
 		compressor.renderVolNeutral((StereoSample*)soundBuffer, numSamples, postFXVolume);
 	}
 	else {
@@ -120,6 +120,9 @@ public:
 
 	bool skippingRendering;
 
+	// Which of voiceCostModel's classes this Sound's Voices were in, last time it rendered
+	uint8_t voiceCostClass;
+
 	uint8_t whichExpressionSourcesChangedAtSynthLevel;
 
 	// I really didn't want to store these here, since they're stored in the ParamManager, but.... complications! Always
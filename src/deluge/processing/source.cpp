@@ -79,12 +79,12 @@ void Source::recalculateFineTuner() {
 }
 
 // This function has to give the same result as Sound::renderingVoicesInStereo(). The duplication is for optimization.
-bool Source::renderInStereo(Sound* s, SampleHolder* sampleHolder) {
+bool Source::renderInStereo(Sound* s, SampleHolder* sampleHolder, bool allowStereoUnison) {
 	if (!AudioEngine::renderInStereo) {
 		return false;
 	}
 
-	if (s->unisonStereoSpread && s->numUnison > 1) {
+	if (allowStereoUnison && s->unisonStereoSpread && s->numUnison > 1) {
 		return true;
 	}
 
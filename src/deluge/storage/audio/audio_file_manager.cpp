@@ -21,6 +21,7 @@
 #include "gui/l10n/l10n.h"
 #include "hid/display/display.h"
 #include "io/debug/log.h"
+#include "io/debug/trace.h"
 #include "io/midi/midi_device_manager.h"
 #include "memory/general_memory_allocator.h"
 #include "model/sample/sample.h"
@@ -28,7 +29,12 @@
 #include "model/sample/sample_reader.h"
 #include "playback/playback_handler.h"
 #include "processing/engines/audio_engine.h"
+#include "storage/audio/flac_stream.h"
+#include "storage/audio/sample_file_key.h"
+#include "storage/audio/sample_metadata_index.h"
 #include "storage/cluster/cluster.h"
+#include "storage/cluster/compressed_cluster.h"
+#include "storage/fat_chain_reader.h"
 #include "storage/storage_manager.h"
 #include "storage/wave_table/wave_table.h"
 #include "storage/wave_table/wave_table_reader.h"
@@ -39,10 +45,6 @@ extern "C" {
 #include "fatfs/diskio.h"
 #include "fatfs/ff.h"
 
-DWORD get_fat_from_fs(                      /* 0xFFFFFFFF:Disk error, 1:Internal error, 2..0x7FFFFFFF:Cluster status */
-                      FATFS* fs, DWORD clst /* Cluster number to get the value */
-);
-
 LBA_t clst2sect(           /* !=0:Sector number, 0:Failed (invalid cluster#) */
                 FATFS* fs, /* Filesystem object */
                 DWORD clst /* Cluster# to be converted */
@@ -61,6 +63,7 @@ AudioFileManager::AudioFileManager() {
 	cardDisabled = false;
 	alternateLoadDirStatus = AlternateLoadDirStatus::NONE_SET;
 	thingTypeBeingLoaded = ThingType::NONE;
+	numClusterReloads = 0;
 
 	for (int32_t i = 0; i < kNumAudioRecordingFolders; i++) {
 		highestUsedAudioRecordingNumber[i] = -1;
@@ -70,7 +73,7 @@ AudioFileManager::AudioFileManager() {
 
 void AudioFileManager::init() {
 
-	clusterBeingLoaded = NULL;
+	numClustersBeingLoaded = 0;
 
 	int32_t error = storageManager.initSD();
 	if (!error) {
@@ -91,6 +94,10 @@ void AudioFileManager::init() {
 	void* temp = GeneralMemoryAllocator::get().allocLowSpeed(clusterSizeAtBoot + CACHE_LINE_SIZE * 2);
 	storageManager.fileClusterBuffer = (char*)temp + CACHE_LINE_SIZE;
 
+	// If this doesn't work out, Clusters just get read one at a time
+	temp = GeneralMemoryAllocator::get().allocLowSpeed(clusterSizeAtBoot * kMaxClustersPerRead + CACHE_LINE_SIZE * 2);
+	coalescedReadBuffer = temp ? (char*)temp + CACHE_LINE_SIZE : nullptr;
+
 	clusterObjectSize = sizeof(Cluster) + clusterSize;
 }
 
@@ -105,6 +112,7 @@ void AudioFileManager::setClusterSize(uint32_t newSize) {
 void AudioFileManager::cardReinserted() {
 
 	cardDisabled = false;
+	sampleMetadataIndex.forget();
 	for (int32_t i = 0; i < kNumAudioRecordingFolders; i++) {
 		highestUsedAudioRecordingNumberNeedsReChecking[i] = true;
 	}
@@ -186,9 +194,14 @@ clusterSizeChangedButItsOk:
 
 					f_close(&fileSystemStuff.currentFile);
 
+					// A FLAC Sample's own Clusters aren't on the card, so it kept the file's sectors separately
+					Sample* sample = (Sample*)thisAudioFile;
+					uint32_t oldFirstSector = sample->flacStream ? sample->flacStream->getFirstSector()
+					                                             : sample->clusters.getElement(0)->sdAddress;
+
 					// If address of first sector remained unchanged, we can be sure enough that the file hasn't been
 					// changed
-					if (firstSector == ((Sample*)thisAudioFile)->clusters.getElement(0)->sdAddress) {}
+					if (firstSector == oldFirstSector) {}
 
 					// Otherwise
 					else {
@@ -599,6 +612,8 @@ tryLoadingFromCard:
 	String usingAlternateLocation;
 
 	FilePointer effectiveFilePointer;
+	uint32_t modifiedTime = 0; // Only known if we found the directory entry ourselves
+	bool loadedFromIndex = false;
 
 	// If we got given a FilePointer, it's easy
 	if (suppliedFilePointer) {
@@ -670,6 +685,7 @@ tryNextAlternate:
 			// Ok, found file - in the alternate location.
 			effectiveFilePointer.sclust = ld_clust(&fileSystemStuff.fileSystem, alternateLoadDir.dir);
 			effectiveFilePointer.objsize = ld_dword(alternateLoadDir.dir + DIR_FileSize);
+			modifiedTime = ld_dword(alternateLoadDir.dir + DIR_ModTime);
 
 			usingAlternateLocation.set(&alternateAudioFileLoadPath);
 			*error = usingAlternateLocation.concatenate("/");
@@ -720,6 +736,8 @@ notFound:
 			// Ok, found file.
 			effectiveFilePointer.sclust = fileSystemStuff.currentFile.obj.sclust;
 			effectiveFilePointer.objsize = fileSystemStuff.currentFile.obj.objsize;
+			// Nothing's been read since f_open(), so the directory entry's still in the window
+			modifiedTime = ld_dword(fileSystemStuff.currentFile.dir_ptr + DIR_ModTime);
 		}
 	}
 
@@ -785,6 +803,7 @@ ramError:
 		uint32_t currentClusterIndex = 0;
 		uint32_t currentSDCluster =
 		    effectiveFilePointer.sclust; // Start with first cluster, whose address we already got.
+		FATChainReader fatChainReader(&fileSystemStuff.fileSystem);
 
 		while (true) {
 
@@ -796,7 +815,7 @@ ramError:
 				break;
 			}
 
-			currentSDCluster = get_fat_from_fs(&fileSystemStuff.fileSystem, currentSDCluster);
+			currentSDCluster = fatChainReader.getNextCluster(currentSDCluster);
 
 			if (currentSDCluster == 0xFFFFFFFF || currentSDCluster < 2) {
 				break;
@@ -806,6 +825,15 @@ ramError:
 		// if (!suppliedFilePointer) f_close(&fileSystemStuff.currentFile);
 
 		((SampleReader*)reader)->currentCluster = NULL;
+
+		// If we've seen this file before, we needn't read its headers again
+		SampleFileKey fileKey = {((Sample*)audioFile)->clusters.getElement(0)->sdAddress,
+		                         (uint32_t)effectiveFilePointer.objsize, modifiedTime};
+		if (sampleMetadataIndex.apply((Sample*)audioFile, fileKey)) {
+			loadedFromIndex = true;
+			*error = NO_ERROR;
+			goto ensureSafeThenCheckError;
+		}
 	}
 
 	// Or if WaveTable, we're going to read the file more normally through FatFS, so we want to "open" it.
@@ -828,6 +856,15 @@ ramError:
 	         && topHeader[2] == 0x46464941) { // "AIFF"
 		*error = audioFile->loadFile(reader, true, makeWaveTableWorkAtAllCosts);
 	}
+	else if (topHeader[0] == 0x43614C66) { // "fLaC"
+		// The decoded audio only exists Cluster by Cluster, so there's nothing for a WaveTable to read
+		if (type == AudioFileType::SAMPLE) {
+			*error = ((Sample*)audioFile)->loadFlacFile((SampleReader*)reader, topHeader, effectiveFilePointer.objsize);
+		}
+		else {
+			*error = ERROR_FILE_NOT_LOADABLE_AS_WAVETABLE;
+		}
+	}
 	else {
 		*error = ERROR_FILE_UNSUPPORTED;
 	}
@@ -857,6 +894,12 @@ audioFileError:
 
 	audioFile->finalizeAfterLoad(effectiveFilePointer.objsize);
 
+	if (type == AudioFileType::SAMPLE && !loadedFromIndex && !((Sample*)audioFile)->flacStream) {
+		SampleFileKey fileKey = {((Sample*)audioFile)->clusters.getElement(0)->sdAddress,
+		                         (uint32_t)effectiveFilePointer.objsize, modifiedTime};
+		sampleMetadataIndex.record((Sample*)audioFile, fileKey);
+	}
+
 	audioFile->removeReason("E399");
 
 	return audioFile;
@@ -918,28 +961,68 @@ void AudioFileManager::deallocateCluster(Cluster* cluster) {
 	delugeDealloc(cluster);
 }
 
-#define REPORT_LOAD_TIME 0
+// Goes by the file, not the Sample's address - a new Sample could be allocated where a deleted one was, and mustn't
+// get taken for it
+static uint32_t getStolenClusterGhost(Sample* sample, uint32_t clusterIndex) {
+	uint32_t ghost = (hashSampleFilePath(sample->filePath.get()) + clusterIndex) * 2654435761u;
+	return ghost ? ghost : 1;
+}
 
-bool AudioFileManager::loadCluster(Cluster* cluster, int32_t minNumReasonsAfter) {
+// Only the newest kNumStolenClusterGhosts are remembered, so once a Cluster's been out of memory for a while, loading
+// it again doesn't count for anything
+void AudioFileManager::clusterStolen(Cluster* cluster) {
+	stolenClusterGhosts[nextStolenClusterGhost] = getStolenClusterGhost(cluster->sample, cluster->clusterIndex);
+	nextStolenClusterGhost = (nextStolenClusterGhost + 1) & (kNumStolenClusterGhosts - 1);
+}
 
-	if (currentlyAccessingCard) {
-		return false; // Could happen if we're trying to render a waveform but we're actually already inside the SD
-		              // routine
+bool AudioFileManager::wasClusterRecentlyStolen(Sample* sample, uint32_t clusterIndex) {
+	uint32_t ghost = getStolenClusterGhost(sample, clusterIndex);
+	for (int32_t i = 0; i < kNumStolenClusterGhosts; i++) {
+		if (stolenClusterGhosts[i] == ghost) {
+			stolenClusterGhosts[i] = 0;
+			numClusterReloads++;
+			return true;
+		}
 	}
+	return false;
+}
 
-	// I don't think these should happen...
-	if (clusterBeingLoaded) {
-		return false;
-	}
-	if (AudioEngine::audioRoutineLocked) {
-		return false;
-	}
+#define REPORT_LOAD_TIME 0
 
-	clusterBeingLoaded = cluster;
-	minNumReasonsForClusterBeingLoaded = minNumReasonsAfter + 1;
+bool AudioFileManager::isClusterBeingLoaded(Cluster* cluster) {
+	for (int32_t i = 0; i < numClustersBeingLoaded; i++) {
+		if (clustersBeingLoaded[i] == cluster) {
+			return true;
+		}
+	}
+	return false;
+}
 
+// Returns how many sectors to read from the card for this Cluster - fewer than a whole Cluster's worth if it's the last
+// one in its Sample - or 0 if there's nothing there to read
+int32_t AudioFileManager::getNumSectorsToLoad(Cluster* cluster) {
 	Sample* sample = cluster->sample;
+	int32_t numSectors = clusterSize >> 9;
 
+	// If this is the last Cluster, and we do know what the audio data length is...
+	if (sample->audioDataLengthBytes && sample->audioDataLengthBytes != 0x8FFFFFFFFFFFFFFF) {
+		uint32_t audioDataEndPosBytes = sample->audioDataLengthBytes + sample->audioDataStartPosBytes;
+		uint32_t startByteThisCluster = cluster->clusterIndex << clusterSizeMagnitude;
+		int32_t bytesToRead = audioDataEndPosBytes - startByteThisCluster;
+		if (bytesToRead <= 0) {
+			D_PRINTLN("fail thing"); // Shouldn't really still happen
+			return 0;
+		}
+		if (bytesToRead < clusterSize) {
+			numSectors = ((bytesToRead - 1) >> 9) + 1;
+		}
+		// Otherwise, just leave it at the normal number of sectors
+	}
+
+	return numSectors;
+}
+
+void AudioFileManager::startLoadingCluster(Cluster* cluster, int32_t minNumReasonsAfter) {
 	if (cluster->type != ClusterType::Sample) {
 		FREEZE_WITH_ERROR("E205"); // Chris F got this, so gonna leave checking in release build
 	}
@@ -950,45 +1033,63 @@ bool AudioFileManager::loadCluster(Cluster* cluster, int32_t minNumReasonsAfter)
 		FREEZE_WITH_ERROR("E204");
 	}
 	// it'd only be in the loading queue if it had a "reason".
-	if (!sample) {
+	if (!cluster->sample) {
 		FREEZE_WITH_ERROR("E206");
 	}
+	if ((uint32_t)cluster->data & 0b11) {
+		D_PRINTLN("SD read address misaligned by  %d", (int32_t)((uint32_t)cluster->data & 0b11));
+	}
 #endif
 
+	clustersBeingLoaded[numClustersBeingLoaded++] = cluster;
+	minNumReasonsForClusterBeingLoaded = minNumReasonsAfter + 1;
+
 	addReasonToCluster(cluster); // So that it can't accidentally hit 0 reasons while we're loading it, cos then it
 	                             // might get deallocated.
+}
 
-	if (false) {
-getOutEarly:
-		clusterBeingLoaded = NULL;
-		removeReasonFromCluster(cluster, "E033");
-		return false;
+// For when the read failed. Each Cluster loses the reason startLoadingCluster() gave it
+void AudioFileManager::abandonLoadingClusters() {
+	int32_t numToAbandon = numClustersBeingLoaded;
+	numClustersBeingLoaded = 0;
+	for (int32_t i = 0; i < numToAbandon; i++) {
+		removeReasonFromCluster(clustersBeingLoaded[i], "E033");
 	}
+}
 
-	int32_t clusterIndex = cluster->clusterIndex;
+bool AudioFileManager::loadCluster(Cluster* cluster, int32_t minNumReasonsAfter) {
 
-	int32_t numSectors = clusterSize >> 9;
+	if (currentlyAccessingCard) {
+		return false; // Could happen if we're trying to render a waveform but we're actually already inside the SD
+		              // routine
+	}
 
-	// If this is the last Cluster, and we do know what the audio data length is...
-	if (sample->audioDataLengthBytes && sample->audioDataLengthBytes != 0x8FFFFFFFFFFFFFFF) {
-		uint32_t audioDataEndPosBytes = sample->audioDataLengthBytes + sample->audioDataStartPosBytes;
-		uint32_t startByteThisCluster = clusterIndex << clusterSizeMagnitude;
-		int32_t bytesToRead = audioDataEndPosBytes - startByteThisCluster;
-		if (bytesToRead <= 0) {
-			D_PRINTLN("fail thing"); // Shouldn't really still happen
-			goto getOutEarly;
-		}
-		if (bytesToRead < clusterSize) {
-			numSectors = ((bytesToRead - 1) >> 9) + 1;
-		}
-		// Otherwise, just leave it at the normal number of sectors
+	// I don't think these should happen...
+	if (numClustersBeingLoaded) {
+		return false;
+	}
+	if (AudioEngine::audioRoutineLocked) {
+		return false;
 	}
 
-#if ALPHA_OR_BETA_VERSION
-	if ((uint32_t)cluster->data & 0b11) {
-		D_PRINTLN("SD read address misaligned by  %d", (int32_t)((uint32_t)cluster->data & 0b11));
+	if (loadClusterFromCompressed(cluster, minNumReasonsAfter)) {
+		return true;
+	}
+	if (!cluster->numReasonsToBeLoaded) {
+		return false; // Nothing wants it any more, after all that
+	}
+
+	if (cluster->sample->flacStream) {
+		return loadClusterFromFlac(cluster, minNumReasonsAfter);
+	}
+
+	startLoadingCluster(cluster, minNumReasonsAfter);
+
+	int32_t numSectors = getNumSectorsToLoad(cluster);
+	if (!numSectors) {
+		abandonLoadingClusters();
+		return false;
 	}
-#endif
 
 	AudioEngine::logAction("loadCluster");
 
@@ -1007,7 +1108,8 @@ getOutEarly:
 #endif
 
 	DRESULT result = disk_read_without_streaming_first(
-	    SD_PORT, (BYTE*)cluster->data, sample->clusters.getElement(cluster->clusterIndex)->sdAddress, numSectors);
+	    SD_PORT, (BYTE*)cluster->data, cluster->sample->clusters.getElement(cluster->clusterIndex)->sdAddress,
+	    numSectors);
 
 #if REPORT_LOAD_TIME
 	uint16_t endTime = MTU2.TCNT_0;
@@ -1018,6 +1120,167 @@ getOutEarly:
 	}
 #endif
 
+	// If that failed, get out
+	if (result) {
+		abandonLoadingClusters();
+		return false;
+	}
+
+	numClustersBeingLoaded = 0;
+	finishLoadingCluster(cluster, minNumReasonsAfter);
+	return true;
+}
+
+// Loads firstCluster, which has just come off the loading queue - plus any Clusters following it in the same Sample
+// which are also waiting in the queue and sit straight after it on the card. Those all come in with one multi-sector
+// read, which saves the card a command and a seek for each one. Returns how many got loaded - or if that failed, 0, or
+// -1 if any of them still needed loading and had to go back in the queue
+int32_t AudioFileManager::loadClusterRun(Cluster* firstCluster) {
+
+	if (loadClusterFromCompressed(firstCluster)) {
+		return 1;
+	}
+	if (!firstCluster->numReasonsToBeLoaded) {
+		return 0; // Nothing wants it any more, after all that
+	}
+
+	Sample* sample = firstCluster->sample;
+
+	// FLAC frames don't line up with Clusters, so there's nothing to gain from reading several at once
+	if (sample->flacStream) {
+		if (loadClusterFromFlac(firstCluster)) {
+			return 1;
+		}
+		if (firstCluster->numReasonsToBeLoaded) {
+			enqueueCluster(firstCluster);
+			return -1;
+		}
+		return 0;
+	}
+
+	int32_t sectorsPerCluster = clusterSize >> 9;
+	int32_t maxNumClusters = coalescedReadBuffer ? kMaxClustersPerRead : 1;
+
+	startLoadingCluster(firstCluster);
+	int32_t numSectors[kMaxClustersPerRead];
+	numSectors[0] = getNumSectorsToLoad(firstCluster);
+	int32_t totalNumSectors = numSectors[0];
+	uint32_t firstSDAddress = sample->clusters.getElement(firstCluster->clusterIndex)->sdAddress;
+
+	if (totalNumSectors) {
+		while (numClustersBeingLoaded < maxNumClusters && numSectors[numClustersBeingLoaded - 1] == sectorsPerCluster) {
+			int32_t nextClusterIndex = firstCluster->clusterIndex + numClustersBeingLoaded;
+			if (nextClusterIndex >= sample->clusters.getNumElements()) {
+				break;
+			}
+			SampleCluster* nextSampleCluster = sample->clusters.getElement(nextClusterIndex);
+			Cluster* nextCluster = nextSampleCluster->cluster;
+			if (!nextCluster || nextCluster->loaded || nextSampleCluster->compressedCluster
+			    || nextSampleCluster->sdAddress != firstSDAddress + totalNumSectors) {
+				break;
+			}
+			int32_t nextNumSectors = getNumSectorsToLoad(nextCluster);
+			if (!nextNumSectors || !loadingQueue.removeIfPresent(nextCluster)) {
+				break;
+			}
+			numSectors[numClustersBeingLoaded] = nextNumSectors;
+			totalNumSectors += nextNumSectors;
+			startLoadingCluster(nextCluster);
+		}
+	}
+
+	DRESULT result = RES_ERROR;
+	if (totalNumSectors) {
+		AudioEngine::logAction("loadCluster");
+
+		// A lone Cluster reads straight into its own memory, as always
+		BYTE* readBuffer = (numClustersBeingLoaded == 1) ? (BYTE*)firstCluster->data : (BYTE*)coalescedReadBuffer;
+		result = disk_read_without_streaming_first(SD_PORT, readBuffer, firstSDAddress, totalNumSectors);
+
+		if (!result && numClustersBeingLoaded > 1) {
+			for (int32_t i = 0; i < numClustersBeingLoaded; i++) {
+				memcpy(clustersBeingLoaded[i]->data, readBuffer, numSectors[i] << 9);
+				readBuffer += numSectors[i] << 9;
+			}
+		}
+	}
+
+	if (result) {
+		// Probably the SD card got ejected. Any Clusters still with "reasons" waiting for them to become loaded need to
+		// go back in the loading queue - presumably they won't actually get loaded for a while, only when the user
+		// re-inserts the card. Ones that lost their last reason while we were trying have already been made "available"
+		int32_t numAbandoned = numClustersBeingLoaded;
+		Cluster* abandoned[kMaxClustersPerRead];
+		memcpy(abandoned, clustersBeingLoaded, numAbandoned * sizeof(Cluster*));
+		abandonLoadingClusters();
+
+		int32_t returnValue = 0;
+		for (int32_t i = 0; i < numAbandoned; i++) {
+			if (abandoned[i]->numReasonsToBeLoaded) {
+				if (abandoned[i]->type != ClusterType::Sample) {
+					FREEZE_WITH_ERROR("E237"); // Cos Chris F got an E205
+				}
+				enqueueCluster(abandoned[i]); // TODO: If that fails, it'll just get awkwardly forgotten about
+				returnValue = -1;
+			}
+		}
+		return returnValue;
+	}
+
+	// In order, so each one finds the one before it already loaded and can swap boundary bytes with it
+	int32_t numLoaded = numClustersBeingLoaded;
+	numClustersBeingLoaded = 0;
+	for (int32_t i = 0; i < numLoaded; i++) {
+		finishLoadingCluster(clustersBeingLoaded[i]);
+	}
+	return numLoaded;
+}
+
+// If a CompressedCluster kept the data, unpacks it from there rather than going to the card. Either way, that copy's
+// no longer needed afterwards. Returns false if there wasn't one, or it didn't decode - so it has to come off the card
+bool AudioFileManager::loadClusterFromCompressed(Cluster* cluster, int32_t minNumReasonsAfter) {
+	SampleCluster* sampleCluster = cluster->sample->clusters.getElement(cluster->clusterIndex);
+	if (!sampleCluster->compressedCluster) {
+		return false;
+	}
+
+	// Being loaded while it's decompressed, the same as while it's read - so it keeps a reason even if everything else
+	// lets go of it while other routines have their go
+	startLoadingCluster(cluster, minNumReasonsAfter);
+	bool success = sampleCluster->compressedCluster->decompress(cluster);
+	sampleCluster->deleteCompressedCluster();
+	if (!success) {
+		abandonLoadingClusters();
+		return false;
+	}
+
+	numClustersBeingLoaded = 0;
+	finishLoadingCluster(cluster, minNumReasonsAfter);
+	return true;
+}
+
+// For a Sample streaming from a FLAC file, the Cluster's audio gets decoded from whichever frames cover it. Returns
+// false if the card couldn't be read
+bool AudioFileManager::loadClusterFromFlac(Cluster* cluster, int32_t minNumReasonsAfter) {
+	AudioEngine::logAction("loadClusterFromFlac");
+
+	startLoadingCluster(cluster, minNumReasonsAfter);
+	if (!cluster->sample->flacStream->decodeCluster(cluster->sample, cluster->clusterIndex, cluster->data)) {
+		abandonLoadingClusters();
+		return false;
+	}
+
+	numClustersBeingLoaded = 0;
+	finishLoadingCluster(cluster, minNumReasonsAfter);
+	return true;
+}
+
+// Once the data's been read in: converts it, shares boundary bytes with neighbouring Clusters, and removes the reason
+// startLoadingCluster() gave it
+void AudioFileManager::finishLoadingCluster(Cluster* cluster, int32_t minNumReasonsAfter) {
+	Sample* sample = cluster->sample;
+	int32_t clusterIndex = cluster->clusterIndex;
+
 #if ALPHA_OR_BETA_VERSION
 	if (cluster->type != ClusterType::Sample) {
 		FREEZE_WITH_ERROR("E207");
@@ -1031,11 +1294,6 @@ getOutEarly:
 	}
 #endif
 
-	// If that failed, get out
-	if (result) {
-		goto getOutEarly;
-	}
-
 	cluster->convertDataIfNecessary();
 
 #if ALPHA_OR_BETA_VERSION
@@ -1227,7 +1485,6 @@ copy7ToMe:
 
 	cluster->loaded = true;
 
-	clusterBeingLoaded = NULL;
 	removeReasonFromCluster(cluster, "E034");
 
 #if ALPHA_OR_BETA_VERSION
@@ -1238,8 +1495,6 @@ copy7ToMe:
 		FREEZE_WITH_ERROR("E438");
 	}
 #endif
-
-	return true;
 }
 
 // Only needs calling a couple times per second. Must be called outside of the audio / SD-reading routine
@@ -1263,6 +1518,8 @@ void AudioFileManager::slowRoutine() {
 		}
 	}
 
+	sampleMetadataIndex.slowRoutine();
+
 	// NOTE: (Kate) There was dead code here referencing things that no longer
 	// exist (NUM_LOADED_SAMPLE_CHUNK_ALLOCATION_QUEUES, availableClusterQueues)
 	// It has been removed.
@@ -1282,7 +1539,7 @@ void AudioFileManager::loadAnyEnqueuedClusters(int32_t maxNum, bool mayProcessUs
 	if (currentlyAccessingCard) {
 		return;
 	}
-	if (clusterBeingLoaded) {
+	if (numClustersBeingLoaded) {
 		return; // One might be having stuff done to it, like having its data converted, but not actually reading the
 		        // card right now
 	}
@@ -1338,35 +1595,29 @@ performActionsAndGetOut:
 		}
 
 		allowSomeUserActionsEvenWhenInCardRoutine = true; // Sorry!!
-		bool success = loadCluster(cluster);
+		int32_t numLoaded;
+		{
+			// Note the audio routine gets re-entered from within this, so its zones will nest inside this one
+			TRACE_ZONE(TraceZone::CLUSTER_LOADING);
+			numLoaded = loadClusterRun(cluster);
+		}
 		allowSomeUserActionsEvenWhenInCardRoutine = false;
 
 		// If that didn't work, presumably because the SD card got ejected...
-		if (!success) {
+		if (numLoaded <= 0) {
 			D_PRINTLN("load Cluster fail");
 
-			// If the Cluster is now down to 0 reasons (i.e. it lost a reason while being loaded), then it's already
-			// been made "available" and we don't have a problem
-			if (!cluster->numReasonsToBeLoaded) {}
-
-			// Otherwise, there are still "reasons" waiting for this Cluster to become loaded, so we need to put it back
-			// in the loading queue. Presumably it won't actually get loaded for a while - only when the user re-inserts
-			// the card
-			else {
-
-				if (cluster->type != ClusterType::Sample) {
-					FREEZE_WITH_ERROR("E237"); // Cos Chris F got an E205
-				}
-
-				enqueueCluster(cluster); // TODO: If that fails, it'll just get awkwardly forgotten about
-
-				// Also, return now. Normally we stay here til there's nothing left in the load-queue, but now that
-				// would leave us in an infinite loop!
+			// If they all lost their reasons while being loaded, they've already been made "available" and we don't
+			// have a problem. Otherwise, whatever still needed loading has gone back in the queue - so return now.
+			// Normally we stay here til there's nothing left in the load-queue, but now that would leave us in an
+			// infinite loop!
+			if (numLoaded < 0) {
 				break;
 			}
+			numLoaded = 1;
 		}
 
-		count++;
+		count += numLoaded;
 		if (count >= maxNum) {
 			break; // Keep things sane?
 		}
@@ -1396,7 +1647,7 @@ void AudioFileManager::addReasonToCluster(Cluster* cluster) {
 void AudioFileManager::removeReasonFromCluster(Cluster* cluster, char const* errorCode, bool deletingSong) {
 	cluster->numReasonsToBeLoaded--;
 
-	if (cluster == clusterBeingLoaded && cluster->numReasonsToBeLoaded < minNumReasonsForClusterBeingLoaded) {
+	if (isClusterBeingLoaded(cluster) && cluster->numReasonsToBeLoaded < minNumReasonsForClusterBeingLoaded) {
 		FREEZE_WITH_ERROR("E041"); // Sven got this!
 	}
 
@@ -84,6 +84,7 @@ public:
 	                         void* dontStealFromThing = NULL);
 	int32_t enqueueCluster(Cluster* cluster, uint32_t priorityRating = 0xFFFFFFFF);
 	bool loadCluster(Cluster* cluster, int32_t minNumReasonsAfter = 0);
+	bool isClusterBeingLoaded(Cluster* cluster);
 	void loadAnyEnqueuedClusters(int32_t maxNum = 128, bool mayProcessUserActionsBetween = false);
 	void addReasonToCluster(Cluster* cluster);
 	void removeReasonFromCluster(Cluster* cluster, char const* errorCode, bool deletingSong = false);
@@ -103,6 +104,10 @@ public:
 	void deleteUnusedAudioFileFromMemoryIndexUnknown(AudioFile* audioFile);
 	bool tryToDeleteAudioFileFromMemoryIfItExists(char const* filePath);
 
+	// Remembers which Sample Clusters were stolen recently, so we can tell when one has to be loaded again
+	void clusterStolen(Cluster* cluster);
+	bool wasClusterRecentlyStolen(Sample* sample, uint32_t clusterIndex);
+
 	void thingBeginningLoading(ThingType newThingType);
 	void thingFinishedLoading();
 
@@ -117,21 +122,40 @@ public:
 	bool cardEjected;
 	bool cardDisabled;
 
-	Cluster* clusterBeingLoaded;
-	int32_t minNumReasonsForClusterBeingLoaded; // Only valid when clusterBeingLoaded is set. And this exists for bug
-	                                            // hunting only.
+	// Adjacent Clusters waiting in the loading queue get read from the card together, this many at most
+	static constexpr int32_t kMaxClustersPerRead = 4;
+
+	Cluster* clustersBeingLoaded[kMaxClustersPerRead];
+	int32_t numClustersBeingLoaded;
+	int32_t minNumReasonsForClusterBeingLoaded; // Only valid when numClustersBeingLoaded is set. And this exists for
+	                                            // bug hunting only.
 
 	String alternateAudioFileLoadPath;
 	AlternateLoadDirStatus alternateLoadDirStatus;
 	ThingType thingTypeBeingLoaded;
 	DIR alternateLoadDir;
 
+	uint32_t numClusterReloads; // Since boot - Clusters loaded again not long after being stolen
+
 	int32_t highestUsedAudioRecordingNumber[kNumAudioRecordingFolders];
 	bool highestUsedAudioRecordingNumberNeedsReChecking[kNumAudioRecordingFolders];
 
 private:
 	void setClusterSize(uint32_t newSize);
 	void cardReinserted();
+	int32_t getNumSectorsToLoad(Cluster* cluster);
+	void startLoadingCluster(Cluster* cluster, int32_t minNumReasonsAfter = 0);
+	void abandonLoadingClusters();
+	void finishLoadingCluster(Cluster* cluster, int32_t minNumReasonsAfter = 0);
+	bool loadClusterFromCompressed(Cluster* cluster, int32_t minNumReasonsAfter = 0);
+	bool loadClusterFromFlac(Cluster* cluster, int32_t minNumReasonsAfter = 0);
+	int32_t loadClusterRun(Cluster* firstCluster);
+
+	static constexpr int32_t kNumStolenClusterGhosts = 256;
+	uint32_t stolenClusterGhosts[kNumStolenClusterGhosts] = {}; // Hashes of file path and Cluster index. 0 means none
+	int32_t nextStolenClusterGhost = 0;
+
+	char* coalescedReadBuffer = nullptr; // kMaxClustersPerRead Clusters' worth, for reading them all in one go
 	int32_t readBytes(char* buffer, int32_t num, int32_t* byteIndexWithinCluster, Cluster** currentCluster,
 	                  uint32_t* currentClusterIndex, uint32_t fileSize, Sample* sample);
 	int32_t loadAiff(Sample* newSample, uint32_t fileSize, Cluster** currentCluster, uint32_t* currentClusterIndex);
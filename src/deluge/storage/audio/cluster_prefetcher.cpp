@@ -0,0 +1,238 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "storage/audio/cluster_prefetcher.h"
+#include "storage/audio/prefetch_lookahead.h"
+#include "definitions_cxx.hpp"
+#include "gui/ui/ui.h"
+#include "model/clip/instrument_clip.h"
+#include "model/drum/drum.h"
+#include "model/model_stack.h"
+#include "model/note/note.h"
+#include "model/note/note_row.h"
+#include "model/sample/sample.h"
+#include "model/sample/sample_holder.h"
+#include "model/song/song.h"
+#include "playback/mode/session.h"
+#include "playback/playback_handler.h"
+#include "processing/engines/audio_engine.h"
+#include "processing/sound/sound.h"
+#include "processing/sound/sound_drum.h"
+#include "processing/sound/sound_instrument.h"
+#include "storage/audio/audio_file_manager.h"
+#include "storage/cluster/cluster.h"
+#include "storage/multi_range/multi_range.h"
+
+ClusterPrefetcher clusterPrefetcher{};
+
+namespace {
+// How often to look ahead. How far is kPrefetchLookaheadSamples
+constexpr uint32_t kScanIntervalSamples = kSampleRate / 100;
+
+// Claimed per upcoming note, past the ones its SampleHolder already has
+constexpr int32_t kNumClustersToPrefetch = 2;
+
+// How long after its note's due we hang onto a Cluster. Plenty for the Voice to have claimed it itself
+constexpr uint32_t kHoldAfterNoteSamples = kSampleRate / 2;
+} // namespace
+
+void ClusterPrefetcher::routine() {
+	scanIfDue(nullptr);
+}
+
+void ClusterPrefetcher::routineWhileSongSwapArmed(Song* incomingSong) {
+	scanIfDue(incomingSong);
+}
+
+void ClusterPrefetcher::scanIfDue(Song* incomingSong) {
+	if (!currentSong || !playbackHandler.isEitherClockActive()) {
+		releaseAll();
+		return;
+	}
+
+	if ((int32_t)(AudioEngine::audioSampleTimer - lastScanTime) < (int32_t)kScanIntervalSamples) {
+		return;
+	}
+	lastScanTime = AudioEngine::audioSampleTimer;
+
+	while (Cluster* cluster = prefetched.takeExpired(AudioEngine::audioSampleTimer)) {
+		release(cluster);
+	}
+
+	uint32_t timePerTick = playbackHandler.getTimePerInternalTick();
+	if (!timePerTick) {
+		return;
+	}
+
+	scanSong(currentSong, 0, timePerTick);
+
+	// If a song swap is armed and coming up soon, the new Song's first notes all begin together right at the swap -
+	// just when its Voices can least afford to be waiting on the card
+	if (incomingSong && currentUIMode == UI_MODE_LOADING_SONG_UNESSENTIAL_SAMPLES_ARMED
+	    && session.launchEventAtSwungTickCount && incomingSong->lastClipInstanceEnteredStartPos == -1) {
+		int64_t ticksUntilSwap = getTicksUntilLaunch(
+		    session.launchEventAtSwungTickCount, session.numRepeatsTilLaunch,
+		    session.currentArmedLaunchLengthForOneRepeat, playbackHandler.getActualSwungTickCount());
+		if (isLaunchWithinLookahead(ticksUntilSwap, timePerTick)) {
+
+			// Unless it's been set to keep the old one, the new Song comes in at its own tempo
+			uint32_t newTimePerTick = timePerTick;
+			if (!(playbackHandler.playbackState & PLAYBACK_CLOCK_EXTERNAL_ACTIVE)
+			    && !playbackHandler.songSwapShouldPreserveTempo) {
+				newTimePerTick = incomingSong->getTimePerTimerTickRounded();
+			}
+			if (newTimePerTick) {
+				scanSong(incomingSong, ticksUntilSwap * timePerTick, newTimePerTick);
+			}
+		}
+	}
+}
+
+// For a Song that's already playing, samplesUntilStart is 0, and we look ahead from where each Clip's at. For one
+// that's yet to start, its Clips will all begin from their starts, samplesUntilStart from now
+void ClusterPrefetcher::scanSong(Song* song, uint32_t samplesUntilStart, uint32_t timePerTick) {
+	bool alreadyPlaying = (song == currentSong);
+	int32_t lookaheadTicks = getLookaheadTicks(samplesUntilStart, timePerTick);
+
+	char modelStackMemory[MODEL_STACK_MAX_SIZE];
+	ModelStack* modelStack = setupModelStackWithSong(modelStackMemory, song);
+
+	for (Output* output = song->firstOutput; output; output = output->next) {
+		if (output->type != OutputType::KIT && output->type != OutputType::SYNTH) {
+			continue;
+		}
+		Clip* clip = output->activeClip;
+		if (!clip || clip->type != ClipType::INSTRUMENT || !song->isClipActive(clip)) {
+			continue;
+		}
+		InstrumentClip* instrumentClip = (InstrumentClip*)clip;
+		ModelStackWithTimelineCounter* modelStackWithTimelineCounter = modelStack->addTimelineCounter(clip);
+
+		for (int32_t i = 0; i < instrumentClip->noteRows.getNumElements(); i++) {
+			NoteRow* noteRow = instrumentClip->noteRows.getElement(i);
+			if (noteRow->muted || noteRow->hasNoNotes()) {
+				continue;
+			}
+
+			Sound* sound;
+			int32_t note;
+			if (output->type == OutputType::KIT) {
+				if (!noteRow->drum || noteRow->drum->type != DrumType::SOUND) {
+					continue;
+				}
+				sound = (SoundDrum*)noteRow->drum;
+				note = kNoteForDrum;
+			}
+			else {
+				sound = (SoundInstrument*)output;
+				note = noteRow->y;
+			}
+
+			int32_t ticksUntilNote;
+			if (alreadyPlaying) {
+				ModelStackWithNoteRow* modelStackWithNoteRow =
+				    modelStackWithTimelineCounter->addNoteRow(instrumentClip->getNoteRowId(noteRow, i), noteRow);
+				ticksUntilNote = noteRow->getDistanceToNextNote(modelStackWithNoteRow->getLivePos(),
+				                                                modelStackWithNoteRow,
+				                                                modelStackWithNoteRow->isCurrentlyPlayingReversed());
+			}
+			else {
+				ticksUntilNote = noteRow->notes.getElement(0)->pos;
+			}
+			if (ticksUntilNote > lookaheadTicks) {
+				continue;
+			}
+
+			scanSound(sound, note, samplesUntilStart + ticksUntilNote * timePerTick);
+		}
+	}
+}
+
+void ClusterPrefetcher::scanSound(Sound* sound, int32_t note, uint32_t samplesUntilNote) {
+	uint32_t releaseTime = AudioEngine::audioSampleTimer + samplesUntilNote + kHoldAfterNoteSamples;
+
+	for (int32_t s = 0; s < kNumSources; s++) {
+		Source* source = &sound->sources[s];
+		if (source->oscType != OscType::SAMPLE || !source->ranges.getNumElements()) {
+			continue;
+		}
+		MultiRange* range = source->getRange(note);
+		if (!range) {
+			continue;
+		}
+		SampleHolder* holder = (SampleHolder*)range->getAudioFileHolder();
+		Sample* sample = (Sample*)holder->audioFile;
+		if (!sample || sample->unloadable) {
+			continue;
+		}
+
+		// Carry on from the last of the Clusters the SampleHolder is already holding
+		Cluster* lastHeld = nullptr;
+		for (int32_t l = kNumClustersLoadedAhead - 1; l >= 0 && !lastHeld; l--) {
+			lastHeld = holder->clustersForStart[l];
+		}
+		if (!lastHeld) {
+			continue;
+		}
+
+		int32_t playDirection = source->sampleControls.reversed ? -1 : 1;
+		int32_t clusterIndex = lastHeld->clusterIndex;
+		for (int32_t c = 0; c < kNumClustersToPrefetch; c++) {
+			clusterIndex += playDirection;
+			if (clusterIndex < sample->getFirstClusterIndexWithAudioData()
+			    || clusterIndex >= sample->getFirstClusterIndexWithNoAudioData()) {
+				break;
+			}
+
+			SampleCluster* sampleCluster = sample->clusters.getElement(clusterIndex);
+
+			// If we've already got it, just hang on longer
+			if (sampleCluster->cluster && prefetched.holdLonger(sampleCluster->cluster, releaseTime)) {
+				continue;
+			}
+
+			if (prefetched.isFull()) {
+				return;
+			}
+
+			Cluster* cluster = sampleCluster->getCluster(sample, clusterIndex, CLUSTER_ENQUEUE,
+			                                             getPrefetchPriorityRating(samplesUntilNote));
+			if (!cluster) {
+				return; // No RAM - nothing more we can do
+			}
+			prefetch(cluster, releaseTime);
+		}
+	}
+}
+
+// The Cluster arrives with a reason already added. We also hold one on its Sample, so that can't get deleted under us
+void ClusterPrefetcher::prefetch(Cluster* cluster, uint32_t releaseTime) {
+	cluster->sample->addReason();
+	prefetched.add(cluster, releaseTime);
+}
+
+void ClusterPrefetcher::releaseAll() {
+	while (Cluster* cluster = prefetched.takeAny()) {
+		release(cluster);
+	}
+}
+
+void ClusterPrefetcher::release(Cluster* cluster) {
+	Sample* sample = cluster->sample;
+	audioFileManager.removeReasonFromCluster(cluster, "E455");
+	sample->removeReason("E456");
+}
@@ -0,0 +1,64 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "storage/audio/prefetched_cluster_list.h"
+#include <cstdint>
+
+class Cluster;
+class Song;
+class Sound;
+
+/*
+ * Every SampleHolder already holds "reasons" on the first kNumClustersLoadedAhead Clusters from its start marker, so a
+ * note can always begin. But the Cluster after those only gets enqueued once the Voice has played through the first
+ * one - and if lots of Voices all start at once, that can be too late, and long one-shots click or drop out a moment
+ * in.
+ *
+ * So while playing, every so often we look a little way ahead in every active InstrumentClip, and for each NoteRow
+ * with a note coming up that'll play a sample, claim reasons on the next few Clusters past the ones its SampleHolder
+ * holds. Those get enqueued at a low priority - below any playing Voice's - and the reasons get let go of a while after
+ * the note's due, by which time the Voice has claimed its own.
+ *
+ * Once a song swap is armed and about to happen, the incoming Song gets the same treatment for the notes it'll start
+ * with. The fixed number of Clusters we'll hold at once keeps all this to a small, bounded amount of RAM.
+ */
+class ClusterPrefetcher {
+public:
+	// Call regularly from the main loop, outside the SD routine. Mostly returns straight away
+	void routine();
+
+	// Call instead of routine() while waiting for an armed song swap, once incomingSong has finished loading - never
+	// from inside its loadAllSamples(), which is still adding to it
+	void routineWhileSongSwapArmed(Song* incomingSong);
+
+	// Lets go of everything - which happens by itself once playback stops
+	void releaseAll();
+
+private:
+	void scanIfDue(Song* incomingSong);
+	void scanSong(Song* song, uint32_t samplesUntilStart, uint32_t timePerTick);
+	void scanSound(Sound* sound, int32_t note, uint32_t samplesUntilNote);
+	void prefetch(Cluster* cluster, uint32_t releaseTime);
+	void release(Cluster* cluster);
+
+	PrefetchedClusterList prefetched;
+	uint32_t lastScanTime = 0;
+};
+
+extern ClusterPrefetcher clusterPrefetcher;
@@ -0,0 +1,477 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "storage/audio/flac_decoder.h"
+
+// https://xiph.org/flac/format.html
+
+constexpr int32_t kMaxLPCOrder = 32;
+
+enum ChannelAssignment {
+	CHANNELS_LEFT_SIDE = 8,
+	CHANNELS_SIDE_RIGHT = 9,
+	CHANNELS_MID_SIDE = 10,
+};
+
+namespace {
+
+struct CRCTables {
+	uint8_t crc8[256];
+	uint16_t crc16[256];
+};
+
+constexpr CRCTables makeCRCTables() {
+	CRCTables tables{};
+	for (int32_t i = 0; i < 256; i++) {
+		uint8_t crc8 = i;
+		uint16_t crc16 = i << 8;
+		for (int32_t b = 0; b < 8; b++) {
+			crc8 = (crc8 & 0x80) ? ((crc8 << 1) ^ 0x07) : (crc8 << 1);
+			crc16 = (crc16 & 0x8000) ? ((crc16 << 1) ^ 0x8005) : (crc16 << 1);
+		}
+		tables.crc8[i] = crc8;
+		tables.crc16[i] = crc16;
+	}
+	return tables;
+}
+
+constexpr CRCTables crcTables = makeCRCTables();
+
+// Most significant bit first, as FLAC is. Reading past the end gives zeros, and overran() says so
+class BitReader {
+public:
+	BitReader(uint8_t const* input, uint32_t numBytes) : pos(input), end(input + numBytes) {
+		totalNumBits = numBytes * 8;
+		bitsLeft = totalNumBits;
+	}
+
+	// numBits may be up to 32
+	uint32_t read(int32_t numBits) {
+		if (!numBits) {
+			return 0;
+		}
+		refill();
+		uint32_t value = buffer >> (64 - numBits);
+		consume(numBits);
+		return value;
+	}
+
+	int32_t readSigned(int32_t numBits) {
+		if (!numBits) {
+			return 0;
+		}
+		refill();
+		int32_t value = (int64_t)buffer >> (64 - numBits);
+		consume(numBits);
+		return value;
+	}
+
+	// Counts the 0s before the next 1, and skips past them and the 1
+	uint32_t readUnary() {
+		uint32_t count = 0;
+		while (true) {
+			refill();
+			if (buffer) {
+				int32_t numZeros = __builtin_clzll(buffer);
+				consume(numZeros + 1);
+				return count + numZeros;
+			}
+			count += bitsInBuffer;
+			bitsLeft -= bitsInBuffer;
+			bitsInBuffer = 0;
+			if (overran()) {
+				return count;
+			}
+		}
+	}
+
+	void alignToByte() { consume(bitsInBuffer & 7); }
+
+	int32_t getNumBytesConsumed() { return (totalNumBits - bitsLeft) >> 3; }
+
+	bool overran() { return bitsLeft < 0; }
+
+private:
+	void refill() {
+		while (bitsInBuffer <= 56) {
+			uint64_t byte = 0;
+			if (pos < end) {
+				byte = *pos++;
+			}
+			buffer |= byte << (56 - bitsInBuffer);
+			bitsInBuffer += 8;
+		}
+	}
+
+	void consume(int32_t numBits) {
+		buffer <<= numBits;
+		bitsInBuffer -= numBits;
+		bitsLeft -= numBits;
+	}
+
+	uint8_t const* pos;
+	uint8_t const* end;
+	uint64_t buffer = 0;
+	int32_t bitsInBuffer = 0;
+	int32_t totalNumBits;
+	int32_t bitsLeft;
+};
+
+bool decodeResidual(BitReader& reader, int32_t blockSize, int32_t predictorOrder, int32_t* output) {
+	int32_t method = reader.read(2);
+	if (method > 1) {
+		return false;
+	}
+	int32_t paramNumBits = method ? 5 : 4;
+	uint32_t escapeParam = (1 << paramNumBits) - 1;
+
+	int32_t partitionOrder = reader.read(4);
+	int32_t partitionSize = blockSize >> partitionOrder;
+	if ((partitionSize << partitionOrder) != blockSize || partitionSize < predictorOrder) {
+		return false;
+	}
+
+	int32_t i = predictorOrder;
+	for (int32_t p = 0; p < (1 << partitionOrder); p++) {
+		int32_t partitionEnd = (p + 1) * partitionSize;
+		uint32_t param = reader.read(paramNumBits);
+
+		if (param == escapeParam) {
+			int32_t numBits = reader.read(5);
+			for (; i < partitionEnd; i++) {
+				output[i] = reader.readSigned(numBits);
+			}
+		}
+		else {
+			for (; i < partitionEnd; i++) {
+				uint32_t zigzagged = (reader.readUnary() << param) | reader.read(param);
+				output[i] = (zigzagged >> 1) ^ -(int32_t)(zigzagged & 1);
+			}
+		}
+
+		if (reader.overran()) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void restoreFixed(int32_t* samples, int32_t blockSize, int32_t order) {
+	switch (order) {
+	case 1:
+		for (int32_t i = 1; i < blockSize; i++) {
+			samples[i] += samples[i - 1];
+		}
+		break;
+	case 2:
+		for (int32_t i = 2; i < blockSize; i++) {
+			samples[i] += 2 * samples[i - 1] - samples[i - 2];
+		}
+		break;
+	case 3:
+		for (int32_t i = 3; i < blockSize; i++) {
+			samples[i] += 3 * (samples[i - 1] - samples[i - 2]) + samples[i - 3];
+		}
+		break;
+	case 4:
+		for (int32_t i = 4; i < blockSize; i++) {
+			samples[i] += 4 * (samples[i - 1] + samples[i - 3]) - 6 * samples[i - 2] - samples[i - 4];
+		}
+		break;
+	}
+}
+
+void restoreLPC(int32_t* samples, int32_t blockSize, int32_t order, int32_t const* coefs, int32_t shift) {
+	for (int32_t i = order; i < blockSize; i++) {
+		int64_t sum = 0;
+		for (int32_t j = 0; j < order; j++) {
+			sum += (int64_t)coefs[j] * samples[i - 1 - j];
+		}
+		samples[i] += (int32_t)(sum >> shift);
+	}
+}
+
+bool decodeSubframe(BitReader& reader, int32_t blockSize, int32_t bitsPerSample, int32_t* output) {
+	if (reader.read(1)) {
+		return false; // Padding bit has to be 0
+	}
+	int32_t type = reader.read(6);
+
+	int32_t wastedBits = 0;
+	if (reader.read(1)) {
+		wastedBits = reader.readUnary() + 1;
+		bitsPerSample -= wastedBits;
+		if (bitsPerSample <= 0) {
+			return false;
+		}
+	}
+
+	// CONSTANT
+	if (type == 0) {
+		int32_t value = reader.readSigned(bitsPerSample);
+		for (int32_t i = 0; i < blockSize; i++) {
+			output[i] = value;
+		}
+	}
+
+	// VERBATIM
+	else if (type == 1) {
+		for (int32_t i = 0; i < blockSize; i++) {
+			output[i] = reader.readSigned(bitsPerSample);
+		}
+	}
+
+	// FIXED
+	else if (type >= 8 && type <= 12) {
+		int32_t order = type - 8;
+		if (order > blockSize) {
+			return false;
+		}
+		for (int32_t i = 0; i < order; i++) {
+			output[i] = reader.readSigned(bitsPerSample);
+		}
+		if (!decodeResidual(reader, blockSize, order, output)) {
+			return false;
+		}
+		restoreFixed(output, blockSize, order);
+	}
+
+	// LPC
+	else if (type >= 32) {
+		int32_t order = type - 31;
+		if (order > blockSize) {
+			return false;
+		}
+		for (int32_t i = 0; i < order; i++) {
+			output[i] = reader.readSigned(bitsPerSample);
+		}
+		int32_t precision = reader.read(4) + 1;
+		if (precision == 16) {
+			return false;
+		}
+		int32_t shift = reader.readSigned(5);
+		if (shift < 0) {
+			return false;
+		}
+		int32_t coefs[kMaxLPCOrder];
+		for (int32_t j = 0; j < order; j++) {
+			coefs[j] = reader.readSigned(precision);
+		}
+		if (!decodeResidual(reader, blockSize, order, output)) {
+			return false;
+		}
+		restoreLPC(output, blockSize, order, coefs, shift);
+	}
+
+	else {
+		return false; // Reserved
+	}
+
+	if (wastedBits) {
+		for (int32_t i = 0; i < blockSize; i++) {
+			output[i] <<= wastedBits;
+		}
+	}
+
+	return !reader.overran();
+}
+
+} // namespace
+
+uint8_t FlacDecoder::crc8(uint8_t const* data, uint32_t numBytes) {
+	uint8_t crc = 0;
+	for (uint32_t i = 0; i < numBytes; i++) {
+		crc = crcTables.crc8[crc ^ data[i]];
+	}
+	return crc;
+}
+
+uint16_t FlacDecoder::crc16(uint8_t const* data, uint32_t numBytes) {
+	uint16_t crc = 0;
+	for (uint32_t i = 0; i < numBytes; i++) {
+		crc = (crc << 8) ^ crcTables.crc16[(crc >> 8) ^ data[i]];
+	}
+	return crc;
+}
+
+bool FlacDecoder::parseStreamInfo(uint8_t const* block, FlacStreamInfo* info) {
+	BitReader reader(block, kStreamInfoSize);
+	info->minBlockSize = reader.read(16);
+	info->maxBlockSize = reader.read(16);
+	reader.read(24); // Min frame size
+	info->maxFrameSize = reader.read(24);
+	info->sampleRate = reader.read(20);
+	info->numChannels = reader.read(3) + 1;
+	info->bitsPerSample = reader.read(5) + 1;
+	info->totalSamples = (uint64_t)reader.read(4) << 32;
+	info->totalSamples |= reader.read(32);
+
+	return (info->minBlockSize >= 16 && info->maxBlockSize >= info->minBlockSize);
+}
+
+int32_t FlacDecoder::parseFrameHeader(uint8_t const* input, uint32_t numBytes, FlacStreamInfo const& info,
+                                      FlacFrameHeader* header) {
+	if (numBytes < 6 || input[0] != 0xFF || (input[1] & 0xFE) != 0xF8) {
+		return 0;
+	}
+	if (numBytes > kMaxFrameHeaderSize) {
+		numBytes = kMaxFrameHeaderSize;
+	}
+
+	BitReader reader(input, numBytes);
+	reader.read(15);
+	bool variableBlockSize = reader.read(1);
+	int32_t blockSizeCode = reader.read(4);
+	int32_t sampleRateCode = reader.read(4);
+	header->channelAssignment = reader.read(4);
+	int32_t sampleSizeCode = reader.read(3);
+	if (reader.read(1) || blockSizeCode == 0 || sampleRateCode == 15 || header->channelAssignment > CHANNELS_MID_SIDE
+	    || sampleSizeCode == 3 || sampleSizeCode == 7) {
+		return 0;
+	}
+
+	// Sample or frame number, coded like UTF-8 but for up to 36 bits
+	uint32_t firstByte = reader.read(8);
+	int32_t numLeadingOnes = __builtin_clz(~(firstByte << 24));
+	if (numLeadingOnes == 1 || numLeadingOnes > 7) {
+		return 0;
+	}
+	uint64_t number = firstByte & (0x7F >> numLeadingOnes);
+	int32_t numExtraBytes = numLeadingOnes ? numLeadingOnes - 1 : 0;
+	for (int32_t i = 0; i < numExtraBytes; i++) {
+		uint32_t byte = reader.read(8);
+		if ((byte & 0xC0) != 0x80) {
+			return 0;
+		}
+		number = (number << 6) | (byte & 0x3F);
+	}
+
+	if (blockSizeCode == 1) {
+		header->blockSize = 192;
+	}
+	else if (blockSizeCode <= 5) {
+		header->blockSize = 576 << (blockSizeCode - 2);
+	}
+	else if (blockSizeCode == 6) {
+		header->blockSize = reader.read(8) + 1;
+	}
+	else if (blockSizeCode == 7) {
+		header->blockSize = reader.read(16) + 1;
+	}
+	else {
+		header->blockSize = 256 << (blockSizeCode - 8);
+	}
+
+	if (sampleRateCode == 12) {
+		reader.read(8);
+	}
+	else if (sampleRateCode >= 13) {
+		reader.read(16);
+	}
+
+	static constexpr int8_t bitsPerSampleForCode[] = {0, 8, 12, 0, 16, 20, 24, 0};
+	header->bitsPerSample = sampleSizeCode ? bitsPerSampleForCode[sampleSizeCode] : info.bitsPerSample;
+
+	int32_t numChannels = (header->channelAssignment >= CHANNELS_LEFT_SIDE) ? 2 : header->channelAssignment + 1;
+
+	int32_t headerSize = reader.getNumBytesConsumed();
+	if (reader.overran() || (uint32_t)headerSize >= numBytes) {
+		return 0;
+	}
+	if (crc8(input, headerSize) != input[headerSize]) {
+		return 0;
+	}
+
+	if (numChannels != info.numChannels || header->bitsPerSample != info.bitsPerSample
+	    || header->blockSize > kMaxBlockSize || (uint32_t)header->blockSize > info.maxBlockSize) {
+		return 0;
+	}
+
+	header->firstSample = variableBlockSize ? number : number * info.maxBlockSize;
+	return headerSize + 1;
+}
+
+uint32_t FlacDecoder::decodeFrame(uint8_t const* input, uint32_t numBytes, FlacStreamInfo const& info,
+                                  int32_t byteDepth, int32_t* workBuffer, uint8_t* output, FlacFrameHeader* header) {
+	int32_t headerSize = parseFrameHeader(input, numBytes, info, header);
+	if (!headerSize) {
+		return 0;
+	}
+
+	int32_t blockSize = header->blockSize;
+	int32_t numChannels = info.numChannels;
+
+	BitReader reader(input + headerSize, numBytes - headerSize);
+	for (int32_t c = 0; c < numChannels; c++) {
+		// Side channels need an extra bit
+		int32_t bitsPerSample = header->bitsPerSample;
+		if ((header->channelAssignment == CHANNELS_LEFT_SIDE && c == 1)
+		    || (header->channelAssignment == CHANNELS_SIDE_RIGHT && c == 0)
+		    || (header->channelAssignment == CHANNELS_MID_SIDE && c == 1)) {
+			bitsPerSample++;
+		}
+		if (!decodeSubframe(reader, blockSize, bitsPerSample, &workBuffer[c * kMaxBlockSize])) {
+			return 0;
+		}
+	}
+
+	reader.alignToByte();
+	uint16_t crc = reader.read(16);
+	if (reader.overran()) {
+		return 0;
+	}
+	uint32_t frameSize = headerSize + reader.getNumBytesConsumed();
+	if (crc16(input, frameSize - 2) != crc) {
+		return 0;
+	}
+
+	int32_t* left = workBuffer;
+	int32_t* right = &workBuffer[kMaxBlockSize];
+	switch (header->channelAssignment) {
+	case CHANNELS_LEFT_SIDE:
+		for (int32_t i = 0; i < blockSize; i++) {
+			right[i] = left[i] - right[i];
+		}
+		break;
+	case CHANNELS_SIDE_RIGHT:
+		for (int32_t i = 0; i < blockSize; i++) {
+			left[i] += right[i];
+		}
+		break;
+	case CHANNELS_MID_SIDE:
+		for (int32_t i = 0; i < blockSize; i++) {
+			int32_t side = right[i];
+			int32_t mid = ((uint32_t)left[i] << 1) | (side & 1);
+			left[i] = (mid + side) >> 1;
+			right[i] = (mid - side) >> 1;
+		}
+		break;
+	}
+
+	// Interleave, with the audio in the top bits - the same as a WAV file of byteDepth would have it
+	int32_t shift = byteDepth * 8 - header->bitsPerSample;
+	for (int32_t i = 0; i < blockSize; i++) {
+		for (int32_t c = 0; c < numChannels; c++) {
+			int32_t value = (uint32_t)workBuffer[c * kMaxBlockSize + i] << shift;
+			for (int32_t b = 0; b < byteDepth; b++) {
+				*output++ = value >> (b * 8);
+			}
+		}
+	}
+
+	return frameSize;
+}
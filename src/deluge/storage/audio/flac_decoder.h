@@ -0,0 +1,69 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+struct FlacStreamInfo {
+	uint32_t minBlockSize;
+	uint32_t maxBlockSize;
+	uint32_t maxFrameSize; // 0 means unknown
+	uint32_t sampleRate;
+	uint64_t totalSamples; // Per channel. 0 means unknown
+	uint8_t numChannels;
+	uint8_t bitsPerSample;
+};
+
+struct FlacFrameHeader {
+	uint64_t firstSample; // Per channel, from the start of the stream
+	int32_t blockSize;
+	int32_t channelAssignment;
+	int32_t bitsPerSample;
+};
+
+/*
+ * Decodes single FLAC frames, straight out of memory. Knows nothing about files or the card - FlacStream deals with
+ * finding the frames and reading them in.
+ *
+ * Only what Samples can be is supported: 1 or 2 channels, up to 24 bits, and blocks of up to kMaxBlockSize samples -
+ * which is everything the FLAC "subset" allows at 48kHz and below, so any normal encoder settings.
+ */
+class FlacDecoder {
+public:
+	static constexpr int32_t kMaxBlockSize = 4608;
+	static constexpr int32_t kMaxNumChannels = 2;
+	static constexpr int32_t kMaxFrameHeaderSize = 16;
+	static constexpr int32_t kStreamInfoSize = 34;
+
+	// block is the STREAMINFO metadata block's contents, after its 4-byte block header
+	static bool parseStreamInfo(uint8_t const* block, FlacStreamInfo* info);
+
+	// Checks for a valid frame header - sync code, no reserved values, right CRC - matching the stream. Returns its
+	// size in bytes, or 0 if there isn't one there
+	static int32_t parseFrameHeader(uint8_t const* input, uint32_t numBytes, FlacStreamInfo const& info,
+	                                FlacFrameHeader* header);
+
+	// Decodes the frame at input into interleaved little-endian PCM, byteDepth bytes per sample, with the audio in the
+	// top bits. workBuffer needs room for kMaxNumChannels * kMaxBlockSize values. Returns the frame's size in bytes, or
+	// 0 if it's corrupt or not all there
+	static uint32_t decodeFrame(uint8_t const* input, uint32_t numBytes, FlacStreamInfo const& info,
+	                            int32_t byteDepth, int32_t* workBuffer, uint8_t* output, FlacFrameHeader* header);
+
+	static uint8_t crc8(uint8_t const* data, uint32_t numBytes);
+	static uint16_t crc16(uint8_t const* data, uint32_t numBytes);
+};
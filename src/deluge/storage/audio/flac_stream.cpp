@@ -0,0 +1,342 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "storage/audio/flac_stream.h"
+#include "definitions_cxx.hpp"
+#include "memory/general_memory_allocator.h"
+#include "model/sample/sample.h"
+#include "model/sample/sample_reader.h"
+#include "processing/engines/audio_engine.h"
+#include "storage/audio/audio_file_manager.h"
+#include <algorithm>
+#include <string.h>
+
+extern "C" {
+#include "fatfs/diskio.h"
+
+DRESULT disk_read_without_streaming_first(BYTE pdrv, BYTE* buff, DWORD sector, UINT count);
+}
+
+// Frames bigger than this aren't supported. Even uncompressed, a 24-bit stereo frame of kMaxBlockSize fits
+constexpr uint32_t kMaxFrameSize = 32768;
+
+// How much of the file gets read at a time while indexing
+constexpr uint32_t kIndexingReadSize = 32768;
+
+// Shared between all FlacStreams, since only one Cluster gets decoded at a time. Allocated when the first FLAC file
+// gets loaded, and kept
+static uint8_t* frameBuffer = nullptr; // Enough for kMaxFrameSize plus a sector either side
+static uint8_t* pcmBuffer = nullptr;
+static int32_t* workBuffer = nullptr;
+
+static bool ensureDecodingBuffers() {
+	if (frameBuffer) {
+		return true;
+	}
+
+	uint32_t frameBufferSize = kMaxFrameSize + 1024;
+	uint32_t pcmBufferSize = FlacDecoder::kMaxBlockSize * FlacDecoder::kMaxNumChannels * 3;
+	uint32_t workBufferSize = FlacDecoder::kMaxBlockSize * FlacDecoder::kMaxNumChannels * sizeof(int32_t);
+
+	void* memory = GeneralMemoryAllocator::get().allocLowSpeed(frameBufferSize + pcmBufferSize + workBufferSize
+	                                                           + CACHE_LINE_SIZE * 2);
+	if (!memory) {
+		return false;
+	}
+
+	// The frame buffer gets read into from the card, so mustn't share a cache line with anything
+	frameBuffer = (uint8_t*)memory + CACHE_LINE_SIZE;
+	pcmBuffer = frameBuffer + frameBufferSize + CACHE_LINE_SIZE;
+	workBuffer = (int32_t*)(pcmBuffer + pcmBufferSize);
+	return true;
+}
+
+FlacStream::FlacStream() : frames(sizeof(FrameIndexEntry)) {
+	// A long file has tens of thousands of frames, and the index only gets looked at once per Cluster
+	frames.useExternalMemory = true;
+	fileSectors = nullptr;
+	fileSize = 0;
+	numSamples = 0;
+}
+
+FlacStream::~FlacStream() {
+	if (fileSectors) {
+		delugeDealloc(fileSectors);
+	}
+}
+
+int32_t FlacStream::setup(Sample* sample, SampleReader* reader, uint32_t const* topHeader, uint32_t newFileSize) {
+	fileSize = newFileSize;
+
+	uint32_t firstFrameByte;
+	int32_t error = readMetadata(reader, topHeader, &firstFrameByte);
+	if (error) {
+		return error;
+	}
+
+	if ((info.numChannels != 1 && info.numChannels != 2) || info.bitsPerSample < 4 || info.bitsPerSample > 24
+	    || info.maxBlockSize > FlacDecoder::kMaxBlockSize || info.sampleRate < 5000 || info.sampleRate > 96000) {
+		return ERROR_FILE_UNSUPPORTED;
+	}
+
+	// Done with the reader now, and the SampleClusters it was reading from are about to go
+	if (reader->currentCluster) {
+		audioFileManager.removeReasonFromCluster(reader->currentCluster, "E459");
+		reader->currentCluster = NULL;
+	}
+
+	int32_t numFileClusters = sample->clusters.getNumElements();
+	fileSectors = (uint32_t*)GeneralMemoryAllocator::get().allocLowSpeed(numFileClusters * sizeof(uint32_t));
+	if (!fileSectors) {
+		return ERROR_INSUFFICIENT_RAM;
+	}
+	for (int32_t c = 0; c < numFileClusters; c++) {
+		fileSectors[c] = sample->clusters.getElement(c)->sdAddress;
+	}
+
+	if (!ensureDecodingBuffers()) {
+		return ERROR_INSUFFICIENT_RAM;
+	}
+
+	error = indexFrames(firstFrameByte);
+	if (error) {
+		return error;
+	}
+
+	// Low bit depths go in the top bits, like 16-bit
+	sample->numChannels = info.numChannels;
+	sample->byteDepth = (info.bitsPerSample > 16) ? 3 : 2;
+	sample->rawDataFormat = RAW_DATA_FINE;
+	sample->sampleRate = info.sampleRate;
+	sample->audioDataStartPosBytes = 0;
+	sample->audioDataLengthBytes = (uint64_t)numSamples * sample->byteDepth * sample->numChannels;
+
+	// From here on, the Clusters are for the decoded audio
+	for (int32_t c = 0; c < numFileClusters; c++) {
+		sample->clusters.getElement(c)->~SampleCluster();
+	}
+	sample->clusters.empty();
+	int32_t numClusters = ((sample->audioDataLengthBytes - 1) >> audioFileManager.clusterSizeMagnitude) + 1;
+	return sample->clusters.insertSampleClustersAtEnd(numClusters);
+}
+
+int32_t FlacStream::readMetadata(SampleReader* reader, uint32_t const* topHeader, uint32_t* firstFrameByte) {
+
+	// STREAMINFO has to come first. We've already got its block header, and its first 4 bytes
+	uint8_t const* blockHeader = (uint8_t const*)&topHeader[1];
+	uint32_t blockLength = (blockHeader[1] << 16) | (blockHeader[2] << 8) | blockHeader[3];
+	if ((blockHeader[0] & 0x7F) != 0 || blockLength != FlacDecoder::kStreamInfoSize) {
+		return ERROR_FILE_CORRUPTED;
+	}
+
+	uint8_t streamInfo[FlacDecoder::kStreamInfoSize];
+	memcpy(streamInfo, &topHeader[2], 4);
+	int32_t error = reader->readBytes((char*)&streamInfo[4], FlacDecoder::kStreamInfoSize - 4);
+	if (error) {
+		return error;
+	}
+	if (!FlacDecoder::parseStreamInfo(streamInfo, &info)) {
+		return ERROR_FILE_CORRUPTED;
+	}
+
+	// Skip everything else - tags, pictures, seek tables. We'll find the frames ourselves
+	uint32_t bytePos = 8 + FlacDecoder::kStreamInfoSize;
+	bool lastBlock = blockHeader[0] & 0x80;
+	while (!lastBlock) {
+		uint8_t thisBlockHeader[4];
+		error = reader->readBytes((char*)thisBlockHeader, 4);
+		if (error) {
+			return error;
+		}
+		lastBlock = thisBlockHeader[0] & 0x80;
+		bytePos += 4 + ((thisBlockHeader[1] << 16) | (thisBlockHeader[2] << 8) | thisBlockHeader[3]);
+		if (bytePos >= fileSize) {
+			return ERROR_FILE_CORRUPTED;
+		}
+		reader->jumpForwardToBytePos(bytePos);
+	}
+
+	*firstFrameByte = bytePos;
+	return NO_ERROR;
+}
+
+// Frames don't say how long they are, so we look for each one's header after the last - which has to be at the sample
+// position the last one ended at. Between that, the sync code and the header's CRC, audio data can't be mistaken for
+// a frame header
+int32_t FlacStream::indexFrames(uint32_t firstFrameByte) {
+	void* readMemory = GeneralMemoryAllocator::get().allocLowSpeed(kIndexingReadSize + CACHE_LINE_SIZE * 2);
+	if (!readMemory) {
+		return ERROR_INSUFFICIENT_RAM;
+	}
+	uint8_t* readBuffer = (uint8_t*)readMemory + CACHE_LINE_SIZE;
+	uint32_t readStart = 0;
+	uint32_t readEnd = 0;
+
+	int32_t error = NO_ERROR;
+	uint32_t nextSample = 0;
+	uint32_t lastFrameByte = 0;
+
+	for (uint32_t pos = firstFrameByte; pos < fileSize;) {
+		if (pos + FlacDecoder::kMaxFrameHeaderSize > readEnd && readEnd < fileSize) {
+			readStart = pos & ~(uint32_t)511;
+			uint32_t numBytes = std::min(kIndexingReadSize, fileSize - readStart);
+			if (!readFileBytes(readStart, numBytes, readBuffer, true)) {
+				error = ERROR_SD_CARD;
+				break;
+			}
+			readEnd = readStart + numBytes;
+		}
+
+		uint8_t const* here = &readBuffer[pos - readStart];
+		FlacFrameHeader header;
+		int32_t headerSize = 0;
+		if (*here == 0xFF) {
+			headerSize = FlacDecoder::parseFrameHeader(here, readEnd - pos, info, &header);
+		}
+
+		if (headerSize && header.firstSample == nextSample) {
+			int32_t i = frames.getNumElements();
+			if (i && pos - lastFrameByte > kMaxFrameSize) {
+				error = ERROR_FILE_UNSUPPORTED;
+				break;
+			}
+			error = frames.insertAtIndex(i);
+			if (error) {
+				break;
+			}
+			FrameIndexEntry* entry = (FrameIndexEntry*)frames.getElementAddress(i);
+			entry->fileByte = pos;
+			entry->firstSample = nextSample;
+
+			lastFrameByte = pos;
+			nextSample += header.blockSize;
+			if (info.totalSamples && nextSample >= info.totalSamples) {
+				break;
+			}
+			pos += headerSize;
+		}
+
+		// The first frame has to be straight after the metadata
+		else if (!frames.getNumElements()) {
+			error = ERROR_FILE_CORRUPTED;
+			break;
+		}
+
+		else {
+			pos++;
+		}
+	}
+
+	delugeDealloc(readMemory);
+
+	if (!error && !frames.getNumElements()) {
+		error = ERROR_FILE_CORRUPTED;
+	}
+
+	numSamples = nextSample;
+	if (info.totalSamples && info.totalSamples < numSamples) {
+		numSamples = info.totalSamples;
+	}
+	return error;
+}
+
+// Returns the last frame starting at or before sample
+int32_t FlacStream::findFrame(uint32_t sample) {
+	int32_t rangeBegin = 0;
+	int32_t rangeEnd = frames.getNumElements();
+	while (rangeEnd - rangeBegin > 1) {
+		int32_t proposedI = (rangeBegin + rangeEnd) >> 1;
+		if (((FrameIndexEntry*)frames.getElementAddress(proposedI))->firstSample <= sample) {
+			rangeBegin = proposedI;
+		}
+		else {
+			rangeEnd = proposedI;
+		}
+	}
+	return rangeBegin;
+}
+
+// Reads the whole sectors containing those bytes into buffer, and returns where the first of them ended up, or NULL
+// if the card couldn't be read. mayServiceStreaming lets any Clusters waiting to load get loaded first, as normal card
+// access would - which must be avoided while already loading one
+uint8_t* FlacStream::readFileBytes(uint32_t fileByte, uint32_t numBytes, uint8_t* buffer, bool mayServiceStreaming) {
+	uint32_t sectorsPerCluster = audioFileManager.clusterSize >> 9;
+	uint32_t sector = fileByte >> 9;
+	uint32_t endSector = (fileByte + numBytes + 511) >> 9;
+	uint8_t* writePos = buffer;
+
+	while (sector < endSector) {
+		uint32_t sectorWithinCluster = sector & (sectorsPerCluster - 1);
+		uint32_t numSectors = std::min(endSector - sector, sectorsPerCluster - sectorWithinCluster);
+		uint32_t address = fileSectors[sector / sectorsPerCluster] + sectorWithinCluster;
+
+		DRESULT result = mayServiceStreaming
+		                     ? disk_read(SD_PORT, writePos, address, numSectors)
+		                     : disk_read_without_streaming_first(SD_PORT, writePos, address, numSectors);
+		if (result) {
+			return NULL;
+		}
+		writePos += numSectors << 9;
+		sector += numSectors;
+	}
+
+	return buffer + (fileByte & 511);
+}
+
+bool FlacStream::decodeCluster(Sample* sample, int32_t clusterIndex, char* output) {
+	int32_t bytesPerSample = sample->byteDepth * sample->numChannels;
+	uint64_t clusterStartByte = (uint64_t)clusterIndex << audioFileManager.clusterSizeMagnitude;
+	uint64_t clusterEndByte =
+	    std::min<uint64_t>(clusterStartByte + audioFileManager.clusterSize, sample->audioDataLengthBytes);
+
+	int32_t numFrames = frames.getNumElements();
+	for (int32_t f = findFrame(clusterStartByte / bytesPerSample); f < numFrames; f++) {
+		FrameIndexEntry* entry = (FrameIndexEntry*)frames.getElementAddress(f);
+		FrameIndexEntry* nextEntry = (f + 1 < numFrames) ? (FrameIndexEntry*)frames.getElementAddress(f + 1) : NULL;
+
+		uint64_t frameStartByte = (uint64_t)entry->firstSample * bytesPerSample;
+		uint64_t frameEndByte = (uint64_t)(nextEntry ? nextEntry->firstSample : numSamples) * bytesPerSample;
+		if (frameStartByte >= clusterEndByte) {
+			break;
+		}
+
+		uint32_t numBytes = std::min((nextEntry ? nextEntry->fileByte : fileSize) - entry->fileByte, kMaxFrameSize);
+		uint8_t* input = readFileBytes(entry->fileByte, numBytes, frameBuffer, false);
+		if (!input) {
+			return false;
+		}
+
+		// If a frame's damaged, there's nothing for it but silence
+		FlacFrameHeader header;
+		if (!FlacDecoder::decodeFrame(input, numBytes, info, sample->byteDepth, workBuffer, pcmBuffer, &header)) {
+			memset(pcmBuffer, 0, frameEndByte - frameStartByte);
+		}
+
+		uint64_t copyStartByte = std::max(frameStartByte, clusterStartByte);
+		uint64_t copyEndByte = std::min(frameEndByte, clusterEndByte);
+		if (copyEndByte > copyStartByte) {
+			memcpy(&output[copyStartByte - clusterStartByte], &pcmBuffer[copyStartByte - frameStartByte],
+			       copyEndByte - copyStartByte);
+		}
+
+		// A Cluster can take a good few frames, so let the audio have a go between each. No other Cluster can start
+		// loading - and using the buffers - til this one's done
+		AudioEngine::routineWithClusterLoading();
+	}
+
+	return true;
+}
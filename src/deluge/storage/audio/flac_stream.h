@@ -0,0 +1,67 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "storage/audio/flac_decoder.h"
+#include "util/container/array/resizeable_array.h"
+#include <cstdint>
+
+class Sample;
+class SampleReader;
+
+/*
+ * Lets a Sample play straight from a FLAC file.
+ *
+ * The Sample's Clusters then hold decoded audio rather than the file's own bytes - laid out just as a WAV's data chunk
+ * would be, from byte 0 - so nothing reading from them needs to know. When AudioFileManager needs one of them loaded,
+ * it comes here instead of reading the card itself, and we read and decode whichever FLAC frames cover it.
+ *
+ * To know which frames those are, every frame in the file gets found and indexed when it's first loaded. That's just
+ * a scan for frame headers, not a decode, but it does mean reading the whole file through once.
+ */
+class FlacStream {
+public:
+	FlacStream();
+	~FlacStream();
+
+	// Call once the file's been found to start with "fLaC". topHeader is the 12 bytes the reader has already read.
+	// Sets the Sample up to match - including swapping its SampleClusters for ones covering the decoded audio
+	int32_t setup(Sample* sample, SampleReader* reader, uint32_t const* topHeader, uint32_t newFileSize);
+
+	// Fills in the decoded audio that Cluster clusterIndex should hold. Returns false if the card couldn't be read
+	bool decodeCluster(Sample* sample, int32_t clusterIndex, char* output);
+
+	uint32_t getFirstSector() { return fileSectors[0]; }
+
+private:
+	struct FrameIndexEntry {
+		uint32_t fileByte;
+		uint32_t firstSample;
+	};
+
+	int32_t readMetadata(SampleReader* reader, uint32_t const* topHeader, uint32_t* firstFrameByte);
+	int32_t indexFrames(uint32_t firstFrameByte);
+	int32_t findFrame(uint32_t sample);
+	uint8_t* readFileBytes(uint32_t fileByte, uint32_t numBytes, uint8_t* buffer, bool mayServiceStreaming);
+
+	FlacStreamInfo info;
+	uint32_t* fileSectors; // First sector of each of the file's clusters
+	uint32_t fileSize;
+	uint32_t numSamples;
+	ResizeableArray frames;
+};
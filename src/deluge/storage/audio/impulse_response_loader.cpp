@@ -0,0 +1,145 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "storage/audio/impulse_response_loader.h"
+#include "definitions_cxx.hpp"
+#include "dsp/reverb/reverb.hpp"
+#include "memory/general_memory_allocator.h"
+#include "model/sample/sample.h"
+#include "processing/engines/audio_engine.h"
+#include "storage/audio/audio_file_manager.h"
+#include "storage/cluster/cluster.h"
+#include "util/d_string.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Reads single bytes out of a Sample's Clusters, loading each one as it's needed. Slow, but an IR only gets read once
+class ClusterByteReader {
+public:
+	ClusterByteReader(Sample* sample) : sample(sample) {}
+	~ClusterByteReader() {
+		if (cluster) {
+			audioFileManager.removeReasonFromCluster(cluster, "E454");
+		}
+	}
+
+	// Returns error status
+	int32_t read(uint32_t bytePos, uint8_t* value) {
+		int32_t clusterIndex = bytePos >> audioFileManager.clusterSizeMagnitude;
+		if (clusterIndex != currentClusterIndex) {
+			if (cluster) {
+				audioFileManager.removeReasonFromCluster(cluster, "E454");
+			}
+			uint8_t error = NO_ERROR;
+			cluster = sample->clusters.getElement(clusterIndex)
+			              ->getCluster(sample, clusterIndex, CLUSTER_LOAD_IMMEDIATELY, 0, &error);
+			if (!cluster) {
+				currentClusterIndex = -1;
+				return error ? error : ERROR_SD_CARD;
+			}
+			currentClusterIndex = clusterIndex;
+		}
+		*value = cluster->data[bytePos & (audioFileManager.clusterSize - 1)];
+		return NO_ERROR;
+	}
+
+private:
+	Sample* sample;
+	Cluster* cluster = nullptr;
+	int32_t currentClusterIndex = -1;
+};
+
+} // namespace
+
+int32_t loadReverbImpulseResponse(String* filePath) {
+	using deluge::dsp::reverb::Convolution;
+
+	if (filePath->isEmpty()) {
+		int32_t error = filePath->set(DEFAULT_REVERB_IMPULSE_RESPONSE_PATH);
+		if (error) {
+			return error;
+		}
+	}
+
+	uint8_t error;
+	Sample* sample =
+	    (Sample*)audioFileManager.getAudioFileFromFilename(filePath, true, &error, nullptr, AudioFileType::SAMPLE);
+	if (!sample) {
+		return error ? error : ERROR_FILE_NOT_FOUND;
+	}
+	sample->addReason();
+
+	int32_t numChannels = std::min<int32_t>(sample->numChannels, 2);
+
+	// Anything at 88.2kHz or over gets every other sample taken. Other rates just get played back as if they were
+	// 44.1kHz
+	int32_t step = (sample->sampleRate >= 88200) ? 2 : 1;
+	int32_t length = std::min<uint64_t>(sample->lengthInSamples / step, Convolution::kMaxImpulseLength);
+
+	q31_t* impulse = (q31_t*)GeneralMemoryAllocator::get().allocMaxSpeed(length * numChannels * sizeof(q31_t));
+	if (!impulse) {
+		sample->removeReason("E453");
+		return ERROR_INSUFFICIENT_RAM;
+	}
+
+	// Deinterleave, and top-align whatever the bit depth was
+	ClusterByteReader reader(sample);
+	uint32_t bytesPerFrame = sample->byteDepth * sample->numChannels;
+	float energy = 0;
+	for (int32_t i = 0; i < length && !error; i++) {
+		for (int32_t c = 0; c < numChannels; c++) {
+			uint32_t bytePos = sample->audioDataStartPosBytes + i * step * bytesPerFrame + c * sample->byteDepth;
+			uint32_t value = 0;
+			for (int32_t b = 0; b < sample->byteDepth; b++) {
+				uint8_t byte;
+				error = reader.read(bytePos + b, &byte);
+				if (error) {
+					break;
+				}
+				value |= (uint32_t)byte << ((4 - sample->byteDepth + b) * 8);
+			}
+			impulse[c * length + i] = value;
+			energy += ((float)(q31_t)value * (float)(q31_t)value) / numChannels;
+		}
+	}
+
+	if (!error) {
+		// Each channel gets an energy of about 1/4, so a unit impulse comes out at half volume and a long tail at
+		// a similar loudness
+		float gain = energy ? 0.5f / std::sqrt(energy / ((float)2147483648u * (float)2147483648u)) : 0;
+		for (int32_t i = 0; i < length * numChannels; i++) {
+			impulse[i] = std::clamp<float>(impulse[i] * gain, -2147483648.f, 2147483520.f);
+		}
+
+		std::span<q31_t const> left{impulse, (size_t)length};
+		std::span<q31_t const> right{};
+		if (numChannels == 2) {
+			right = {impulse + length, (size_t)length};
+		}
+
+		if (AudioEngine::reverb.getModel() != deluge::dsp::Reverb::Model::CONVOLUTION) {
+			AudioEngine::reverb.setModel(deluge::dsp::Reverb::Model::CONVOLUTION);
+		}
+		error = AudioEngine::reverb.reverb_as<Convolution>().setImpulseResponse(left, right);
+	}
+
+	GeneralMemoryAllocator::get().dealloc(impulse);
+	sample->removeReason("E453");
+	return error;
+}
@@ -0,0 +1,30 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+class String;
+
+// Where to look if the Song doesn't say
+#define DEFAULT_REVERB_IMPULSE_RESPONSE_PATH "REVERBS/IR.WAV"
+
+// Reads a WAV file off the card and gives it to the convolution reverb as its impulse response, normalised so that
+// different IRs come out at roughly the same level. If filePath is empty, it gets set to the default. Returns error
+// status
+int32_t loadReverbImpulseResponse(String* filePath);
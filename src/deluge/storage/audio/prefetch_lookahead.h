@@ -0,0 +1,47 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "definitions_cxx.hpp"
+#include <cstdint>
+
+// How far ahead ClusterPrefetcher looks for notes
+constexpr uint32_t kPrefetchLookaheadSamples = kSampleRate / 4;
+
+// Swung ticks from now until an armed launch happens - which is after the last of its repeats, not the next one.
+// Negative if it's already overdue
+constexpr int64_t getTicksUntilLaunch(int64_t launchEventAtSwungTickCount, int32_t numRepeatsTilLaunch,
+                                      int32_t launchLengthForOneRepeat, int64_t swungTickCountNow) {
+	return launchEventAtSwungTickCount + (int64_t)(numRepeatsTilLaunch - 1) * launchLengthForOneRepeat
+	       - swungTickCountNow;
+}
+
+// Whether a launch ticksUntilLaunch away is close enough to look at the incoming Song's first notes yet
+constexpr bool isLaunchWithinLookahead(int64_t ticksUntilLaunch, uint32_t timePerTick) {
+	return ticksUntilLaunch >= 0 && ticksUntilLaunch * timePerTick <= kPrefetchLookaheadSamples;
+}
+
+// How many ticks ahead to look for notes, in a Song starting samplesUntilStart from now. Rounded up, so a note right
+// at the end of the lookahead still counts. -1 if the Song starts beyond the lookahead altogether, so not even a note
+// right at its start does
+constexpr int32_t getLookaheadTicks(uint32_t samplesUntilStart, uint32_t timePerTick) {
+	if (samplesUntilStart > kPrefetchLookaheadSamples) {
+		return -1;
+	}
+	return (kPrefetchLookaheadSamples - samplesUntilStart) / timePerTick + 1;
+}
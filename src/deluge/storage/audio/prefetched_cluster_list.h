@@ -0,0 +1,94 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+class Cluster;
+
+// Behind any playing Voice - see Voice::getPriorityRating() - but ahead of Clusters being loaded for the sake of it.
+// Sooner notes come first, and ones too far off to tell apart just share the last rating rather than wrapping round to
+// the front of the queue
+constexpr uint32_t kPrefetchPriorityRating = 0xFFFF0000;
+
+constexpr uint32_t getPrefetchPriorityRating(uint32_t samplesUntilNote) {
+	return kPrefetchPriorityRating + std::min<uint32_t>(samplesUntilNote >> 4, 0xFFFF);
+}
+
+/*
+ * Which Clusters ClusterPrefetcher is holding a reason on, and until when (in audioSampleTimer time). This just keeps
+ * count - adding and removing the reasons is up to whoever takes Clusters in and out.
+ */
+class PrefetchedClusterList {
+public:
+	static constexpr int32_t kMaxNumClusters = 32;
+
+	// If the Cluster's already held, keeps it until releaseTime if that's later than it was going to be, and returns
+	// true. Otherwise returns false, and it's up to the caller to add() it
+	bool holdLonger(Cluster* cluster, uint32_t releaseTime) {
+		for (int32_t i = 0; i < numClusters; i++) {
+			if (held[i].cluster == cluster) {
+				if ((int32_t)(releaseTime - held[i].releaseTime) > 0) {
+					held[i].releaseTime = releaseTime;
+				}
+				return true;
+			}
+		}
+		return false;
+	}
+
+	[[nodiscard]] bool isFull() const { return numClusters == kMaxNumClusters; }
+	[[nodiscard]] int32_t getNumClusters() const { return numClusters; }
+
+	// Check isFull() first
+	void add(Cluster* cluster, uint32_t releaseTime) {
+		held[numClusters].cluster = cluster;
+		held[numClusters].releaseTime = releaseTime;
+		numClusters++;
+	}
+
+	// Takes one Cluster whose release time has come out of the list and returns it, or nullptr if there aren't any
+	Cluster* takeExpired(uint32_t timeNow) {
+		for (int32_t i = numClusters - 1; i >= 0; i--) {
+			if ((int32_t)(timeNow - held[i].releaseTime) >= 0) {
+				return take(i);
+			}
+		}
+		return nullptr;
+	}
+
+	// Takes any Cluster out of the list and returns it, or nullptr once it's empty
+	Cluster* takeAny() { return numClusters ? take(numClusters - 1) : nullptr; }
+
+private:
+	struct HeldCluster {
+		Cluster* cluster;
+		uint32_t releaseTime;
+	};
+
+	Cluster* take(int32_t i) {
+		Cluster* cluster = held[i].cluster;
+		numClusters--;
+		held[i] = held[numClusters];
+		return cluster;
+	}
+
+	HeldCluster held[kMaxNumClusters];
+	int32_t numClusters = 0;
+};
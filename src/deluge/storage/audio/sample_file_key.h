@@ -0,0 +1,51 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+// FAT doesn't care about case, so neither do we
+constexpr uint32_t hashSampleFilePath(char const* path) {
+	uint32_t hash = 2166136261u; // FNV-1a
+	for (; *path; path++) {
+		char c = *path;
+		if (c >= 'a' && c <= 'z') {
+			c -= 32;
+		}
+		hash = (hash ^ (uint8_t)c) * 16777619u;
+	}
+	return hash;
+}
+
+/*
+ * Which version of a file on the card something was read from - all from its directory entry, which AudioFileManager
+ * has in hand when it finds the file. A file edited in place on a computer can keep its first sector and its size, but
+ * not its modified time.
+ */
+struct SampleFileKey {
+	uint32_t firstSector;
+	uint32_t fileSize;
+	uint32_t modifiedTime; // FAT date in the top 16 bits, time in the bottom. 0 if we didn't get to see it
+
+	// Whether what's remembered under this key still holds for the file now on the card. Never, if either side
+	// doesn't know the modified time
+	[[nodiscard]] constexpr bool stillMatches(SampleFileKey const& onCard) const {
+		return modifiedTime && onCard.modifiedTime && firstSector == onCard.firstSector
+		       && fileSize == onCard.fileSize && modifiedTime == onCard.modifiedTime;
+	}
+};
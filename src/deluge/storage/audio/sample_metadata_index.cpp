@@ -0,0 +1,243 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "storage/audio/sample_metadata_index.h"
+#include "definitions_cxx.hpp"
+#include "io/debug/log.h"
+#include "model/sample/sample.h"
+#include "model/sample/sample_cluster.h"
+#include "playback/playback_handler.h"
+#include "processing/engines/audio_engine.h"
+#include "storage/storage_manager.h"
+#include "util/functions.h"
+#include <string.h>
+
+extern "C" {
+#include "fatfs/ff.h"
+}
+
+SampleMetadataIndex sampleMetadataIndex{};
+
+namespace {
+constexpr uint32_t kFileMagic = charsToIntegerConstant('D', 'S', 'M', 'I');
+constexpr uint32_t kFileVersion = 2;
+
+// Entries are read and written this many at a time
+constexpr int32_t kNumEntriesPerChunk = 16;
+
+constexpr uint32_t kSaveDelaySamples = kSampleRate * 5;
+
+struct FileHeader {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t entrySize;
+	uint32_t numEntries;
+};
+} // namespace
+
+SampleMetadataIndex::SampleMetadataIndex() : entries(sizeof(Entry)) {
+	// Up to a couple of hundred KB, looked at once per file load
+	entries.useExternalMemory = true;
+}
+
+SampleMetadataIndex::Entry* SampleMetadataIndex::find(Sample* sample) {
+	int32_t i = entries.searchExact(hashSampleFilePath(sample->filePath.get()));
+	if (i == -1) {
+		return nullptr;
+	}
+	return (Entry*)entries.getElementAddress(i);
+}
+
+bool SampleMetadataIndex::apply(Sample* sample, SampleFileKey const& fileKey) {
+	if (!fileKey.modifiedTime) {
+		return false;
+	}
+	ensureLoaded();
+
+	Entry* entry = find(sample);
+	if (!entry || !entry->fileKey.stillMatches(fileKey)) {
+		return false;
+	}
+
+	sample->numChannels = entry->numChannels;
+	sample->byteDepth = entry->byteDepth;
+	sample->rawDataFormat = entry->rawDataFormat;
+	sample->sampleRate = entry->sampleRate;
+	sample->audioDataStartPosBytes = entry->audioDataStartPosBytes;
+	sample->audioDataLengthBytes = entry->audioDataLengthBytes;
+	sample->fileLoopStartSamples = entry->fileLoopStartSamples;
+	sample->fileLoopEndSamples = entry->fileLoopEndSamples;
+	sample->waveTableCycleSize = entry->waveTableCycleSize;
+	sample->fileExplicitlySpecifiesSelfAsWaveTable = entry->fileExplicitlySpecifiesSelfAsWaveTable;
+	sample->midiNoteFromFile = entry->midiNoteFromFile;
+	sample->midiNote = entry->detectedMIDINote;
+	return true;
+}
+
+void SampleMetadataIndex::record(Sample* sample, SampleFileKey const& fileKey) {
+	// Without the modified time, we'd never be able to tell the entry was still good
+	if (!fileKey.modifiedTime) {
+		return;
+	}
+	ensureLoaded();
+
+	uint32_t pathHash = hashSampleFilePath(sample->filePath.get());
+	Entry* entry = find(sample);
+	if (!entry) {
+		if (entries.getNumElements() >= kMaxNumEntries) {
+			// Make room by forgetting one, more or less at random
+			entries.deleteAtIndex(pathHash % entries.getNumElements());
+		}
+		int32_t i = entries.insertAtKey(pathHash);
+		if (i == -1) {
+			return; // No RAM. Never mind
+		}
+		entry = (Entry*)entries.getElementAddress(i);
+	}
+
+	entry->pathHash = pathHash;
+	entry->fileKey = fileKey;
+	entry->audioDataStartPosBytes = sample->audioDataStartPosBytes;
+	entry->audioDataLengthBytes = sample->audioDataLengthBytes;
+	entry->sampleRate = sample->sampleRate;
+	entry->fileLoopStartSamples = sample->fileLoopStartSamples;
+	entry->fileLoopEndSamples = sample->fileLoopEndSamples;
+	entry->waveTableCycleSize = sample->waveTableCycleSize;
+	entry->midiNoteFromFile = sample->midiNoteFromFile;
+	entry->detectedMIDINote = MIDI_NOTE_UNSET;
+	entry->numChannels = sample->numChannels;
+	entry->byteDepth = sample->byteDepth;
+	entry->rawDataFormat = sample->rawDataFormat;
+	entry->fileExplicitlySpecifiesSelfAsWaveTable = sample->fileExplicitlySpecifiesSelfAsWaveTable;
+
+	dirty = true;
+	timeLastChanged = AudioEngine::audioSampleTimer;
+}
+
+void SampleMetadataIndex::recordDetectedMIDINote(Sample* sample) {
+	Entry* entry = find(sample);
+	if (!entry || entry->fileKey.firstSector != sample->clusters.getElement(0)->sdAddress) {
+		return;
+	}
+	entry->detectedMIDINote = sample->midiNote;
+	dirty = true;
+	timeLastChanged = AudioEngine::audioSampleTimer;
+}
+
+void SampleMetadataIndex::forget() {
+	entries.empty();
+	loaded = false;
+	dirty = false;
+}
+
+void SampleMetadataIndex::slowRoutine() {
+	if (dirty && !playbackHandler.isEitherClockActive()
+	    && (uint32_t)(AudioEngine::audioSampleTimer - timeLastChanged) >= kSaveDelaySamples) {
+		save();
+	}
+}
+
+// If there's no file, or it's no good, we just start from empty
+void SampleMetadataIndex::ensureLoaded() {
+	if (loaded) {
+		return;
+	}
+	loaded = true;
+
+	FIL file;
+	if (f_open(&file, SAMPLE_METADATA_INDEX_PATH, FA_READ) != FR_OK) {
+		return;
+	}
+
+	FileHeader header;
+	Entry chunk[kNumEntriesPerChunk];
+	uint32_t numEntriesLeft;
+	UINT numBytesRead;
+	FRESULT result = f_read(&file, &header, sizeof(header), &numBytesRead);
+	if (result != FR_OK || numBytesRead != sizeof(header) || header.magic != kFileMagic
+	    || header.version != kFileVersion || header.entrySize != sizeof(Entry) || header.numEntries > kMaxNumEntries) {
+		goto fileNoGood;
+	}
+
+	if (!entries.ensureEnoughSpaceAllocated(header.numEntries)) {
+		f_close(&file);
+		return;
+	}
+
+	numEntriesLeft = header.numEntries;
+	while (numEntriesLeft) {
+		uint32_t numEntriesThisChunk = std::min<uint32_t>(numEntriesLeft, kNumEntriesPerChunk);
+		result = f_read(&file, chunk, numEntriesThisChunk * sizeof(Entry), &numBytesRead);
+		if (result != FR_OK || numBytesRead != numEntriesThisChunk * sizeof(Entry)) {
+			goto fileNoGood;
+		}
+
+		// They were written in order, so each one goes on the end
+		for (uint32_t e = 0; e < numEntriesThisChunk; e++) {
+			int32_t i = entries.getNumElements();
+			if (i && (int32_t)chunk[e].pathHash <= entries.getKeyAtIndex(i - 1)) {
+				goto fileNoGood;
+			}
+			if (entries.insertAtIndex(i) != NO_ERROR) {
+				goto fileNoGood;
+			}
+			memcpy(entries.getElementAddress(i), &chunk[e], sizeof(Entry));
+		}
+		numEntriesLeft -= numEntriesThisChunk;
+	}
+
+	f_close(&file);
+	D_PRINTLN("sample index: %d entries", entries.getNumElements());
+	return;
+
+fileNoGood:
+	D_PRINTLN("sample index no good");
+	entries.empty();
+	f_close(&file);
+}
+
+void SampleMetadataIndex::save() {
+	dirty = false;
+
+	FIL file;
+	int32_t error = storageManager.createFile(&file, SAMPLE_METADATA_INDEX_PATH, true);
+	if (error) {
+		return;
+	}
+
+	FileHeader header = {kFileMagic, kFileVersion, sizeof(Entry), (uint32_t)entries.getNumElements()};
+	UINT numBytesWritten;
+	FRESULT result = f_write(&file, &header, sizeof(header), &numBytesWritten);
+
+	Entry chunk[kNumEntriesPerChunk];
+	int32_t e = 0;
+	while (result == FR_OK && e < entries.getNumElements()) {
+		int32_t numEntriesThisChunk = std::min<int32_t>(entries.getNumElements() - e, kNumEntriesPerChunk);
+		for (int32_t c = 0; c < numEntriesThisChunk; c++) {
+			memcpy(&chunk[c], entries.getElementAddress(e + c), sizeof(Entry));
+		}
+		result = f_write(&file, chunk, numEntriesThisChunk * sizeof(Entry), &numBytesWritten);
+		e += numEntriesThisChunk;
+	}
+
+	f_close(&file);
+
+	// If that went wrong, delete it rather than leave half a file there
+	if (result != FR_OK) {
+		f_unlink(SAMPLE_METADATA_INDEX_PATH);
+	}
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "storage/audio/sample_file_key.h"
+#include "util/container/array/ordered_resizeable_array.h"
+#include <cstdint>
+
+class Sample;
+
+#define SAMPLE_METADATA_INDEX_PATH "SAMPLES/SAMPLEINDEX.BIN"
+
+/*
+ * Remembers what each WAV / AIFF file's headers said, so that next time it's loaded - normally as part of a song -
+ * AudioFileManager can skip reading and parsing them. Also remembers any pitch that had to be detected for it, since
+ * that's an FFT or several.
+ *
+ * Entries are keyed by a hash of the file path, and only count while SampleFileKey says it's still the same file.
+ *
+ * The whole lot lives in external RAM, gets read from the card the first time it's needed, and gets written back a few
+ * seconds after it last changed, while not playing.
+ */
+class SampleMetadataIndex {
+public:
+	SampleMetadataIndex();
+
+	// If we know about this file, fills in everything its headers would have, and returns true. The Sample must already
+	// have its filePath
+	bool apply(Sample* sample, SampleFileKey const& fileKey);
+
+	// Call after a Sample's been loaded from its headers the normal way
+	void record(Sample* sample, SampleFileKey const& fileKey);
+
+	// Call once pitch detection has found a note for a Sample
+	void recordDetectedMIDINote(Sample* sample);
+
+	void slowRoutine();
+
+	// For when a different card might have gone in
+	void forget();
+
+private:
+	struct Entry {
+		uint32_t pathHash; // Key - must stay first
+		SampleFileKey fileKey;
+		uint32_t audioDataStartPosBytes;
+		uint32_t audioDataLengthBytes;
+		uint32_t sampleRate;
+		uint32_t fileLoopStartSamples;
+		uint32_t fileLoopEndSamples;
+		uint32_t waveTableCycleSize;
+		float midiNoteFromFile;
+		float detectedMIDINote; // MIDI_NOTE_UNSET if we've never had to detect it
+		uint8_t numChannels;
+		uint8_t byteDepth;
+		uint8_t rawDataFormat;
+		uint8_t fileExplicitlySpecifiesSelfAsWaveTable;
+	};
+
+	static constexpr int32_t kMaxNumEntries = 4096;
+
+	Entry* find(Sample* sample);
+	void ensureLoaded();
+	void save();
+
+	OrderedResizeableArrayWith32bitKey entries;
+	bool loaded = false;
+	bool dirty = false;
+	uint32_t timeLastChanged = 0;
+};
+
+extern SampleMetadataIndex sampleMetadataIndex;
@@ -0,0 +1,51 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "definitions_cxx.hpp"
+#include <cstdint>
+
+/*
+ * When SongAutosaver should take its next copy of the Song: once it's got unsaved changes, the user's left it alone
+ * for kQuietTimeSamples, and it's been kMinIntervalSamples since the last one. All times are audioSampleTimer times.
+ */
+class AutosaveSchedule {
+public:
+	static constexpr uint32_t kQuietTimeSamples = kSampleRate * 3;
+	static constexpr uint32_t kMinIntervalSamples = kSampleRate * 60;
+
+	void songEdited(uint32_t timeNow);
+
+	// Everything up to now has been saved by the user, or came from the file just loaded
+	void songSaved(uint32_t timeNow);
+
+	bool isDue(uint32_t timeNow) const;
+
+	// The Song's been copied for an autosave. Edits from now on are for the next one
+	void autosaveStarted(uint32_t timeNow);
+
+	// What was copied didn't make it onto the card, so it's still unsaved. Tries again after the usual interval
+	void autosaveFailed();
+
+	bool hasUnsavedChanges() const { return haveUnsavedChanges; }
+
+private:
+	bool haveUnsavedChanges = false;
+	uint32_t timeLastEdited = 0;
+	uint32_t timeLastAutosaved = 0;
+};
@@ -0,0 +1,474 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "storage/binary_song_format.h"
+#include "definitions_cxx.hpp"
+#include "util/d_string.h"
+#include <algorithm>
+#include <cstring>
+
+using ValueKind = BinarySongFormat::ValueKind;
+
+namespace {
+constexpr int32_t kBufferSize = 512;
+constexpr int32_t kRecordsPerRun = 32;
+constexpr int32_t kRecordSize = sizeof(BinarySongFormat::NoteRecord); // Same for both kinds
+constexpr int32_t kMaxNameLength = 31;
+
+constexpr int32_t kNoteHexLength = 22;
+constexpr int32_t kNodeHexLength = 16;
+
+class Reader {
+public:
+	Reader(BinarySongFormat::Source& source) : source(source) {}
+
+	// Returns the next byte, or -1 at the end or on error
+	int32_t get() {
+		if (pos == end && !refill()) {
+			return -1;
+		}
+		numBytesRead++;
+		return buffer[pos++];
+	}
+
+	// With no dest, just skips them. Returns false if there weren't that many bytes
+	bool read(void* dest, uint32_t numBytes) {
+		uint8_t* destBytes = (uint8_t*)dest;
+		while (numBytes) {
+			if (pos == end && !refill()) {
+				return false;
+			}
+			int32_t numBytesHere = std::min<uint32_t>(numBytes, end - pos);
+			if (destBytes) {
+				memcpy(destBytes, &buffer[pos], numBytesHere);
+				destBytes += numBytesHere;
+			}
+			pos += numBytesHere;
+			numBytes -= numBytesHere;
+			numBytesRead += numBytesHere;
+		}
+		return true;
+	}
+
+	// For when something ran out - was it the input that went wrong, or just ended?
+	int32_t getErrorForEnd(int32_t errorIfJustEnded) { return failed ? ERROR_SD_CARD : errorIfJustEnded; }
+
+	uint32_t numBytesRead = 0;
+
+private:
+	bool refill() {
+		int32_t numBytesHere = source.read(buffer, kBufferSize);
+		if (numBytesHere <= 0) {
+			failed = (numBytesHere < 0);
+			return false;
+		}
+		pos = 0;
+		end = numBytesHere;
+		return true;
+	}
+
+	BinarySongFormat::Source& source;
+	uint8_t buffer[kBufferSize];
+	int32_t pos = 0;
+	int32_t end = 0;
+	bool failed = false;
+};
+
+class Writer {
+public:
+	Writer(BinarySongFormat::Sink& sink) : sink(sink) {}
+
+	void put(uint8_t byte) { write(&byte, 1); }
+
+	void write(void const* data, int32_t numBytes) {
+		uint8_t const* bytes = (uint8_t const*)data;
+		totalBytes += numBytes;
+		while (numBytes) {
+			if (numBuffered == kBufferSize) {
+				flush();
+			}
+			int32_t numBytesHere = std::min(numBytes, kBufferSize - numBuffered);
+			memcpy(&buffer[numBuffered], bytes, numBytesHere);
+			numBuffered += numBytesHere;
+			bytes += numBytesHere;
+			numBytes -= numBytesHere;
+		}
+	}
+
+	// Returns false if anything's failed to write, this time or before
+	bool flush() {
+		if (numBuffered && !failed) {
+			failed = !sink.write(buffer, numBuffered);
+		}
+		numBuffered = 0;
+		return !failed;
+	}
+
+	uint32_t totalBytes = 0; // Including what's still in the buffer
+
+private:
+	BinarySongFormat::Sink& sink;
+	uint8_t buffer[kBufferSize];
+	int32_t numBuffered = 0;
+	bool failed = false;
+};
+
+bool isUpperCaseHexDigit(int32_t c) {
+	return (c >= '0' && c <= '9') || (c >= 'A' && c <= 'F');
+}
+
+// Which kind of binary an attribute value could become, going by its name. Automation can be under all sorts of
+// names, so that's any hex value of the right shape other than these two - and only AutoParam writes those
+ValueKind getPossibleValueKind(char const* name) {
+	if (!strcmp(name, "noteDataWithLift")) {
+		return ValueKind::NOTES;
+	}
+	if (!strcmp(name, "noteData") || !strcmp(name, "clipInstances")) {
+		return ValueKind::NONE;
+	}
+	return ValueKind::AUTOMATION;
+}
+
+int32_t copyRestOfValue(Reader& reader, Writer& writer, int32_t quote) {
+	int32_t c;
+	do {
+		c = reader.get();
+		if (c < 0) {
+			return reader.getErrorForEnd(NO_ERROR);
+		}
+		writer.put(c);
+	} while (c != quote);
+	return NO_ERROR;
+}
+
+// Collects records into runs, and writes each one out when it's full
+class RunWriter {
+public:
+	RunWriter(Writer& writer) : writer(writer) {}
+
+	void add(void const* record) {
+		memcpy(&run[numRecords * kRecordSize], record, kRecordSize);
+		if (++numRecords == kRecordsPerRun) {
+			flush();
+		}
+	}
+
+	// Writes out the last run, and the empty one that ends the value
+	void finish() {
+		flush();
+		flush();
+	}
+
+private:
+	void flush() {
+		uint32_t numBytes = numRecords * kRecordSize;
+		writer.write(&numBytes, sizeof(numBytes));
+		writer.write(run, numBytes);
+		numRecords = 0;
+	}
+
+	Writer& writer;
+	uint8_t run[kRecordsPerRun * kRecordSize];
+	int32_t numRecords = 0;
+};
+
+void addRecordFromHex(RunWriter& runWriter, char const* hexChars, ValueKind kind) {
+	if (kind == ValueKind::NOTES) {
+		BinarySongFormat::NoteRecord record{};
+		record.pos = hexToIntFixedLength(hexChars, 8);
+		record.length = hexToIntFixedLength(&hexChars[8], 8);
+		record.velocity = hexToIntFixedLength(&hexChars[16], 2);
+		record.lift = hexToIntFixedLength(&hexChars[18], 2);
+		record.probability = hexToIntFixedLength(&hexChars[20], 2);
+		runWriter.add(&record);
+	}
+	else {
+		BinarySongFormat::ParamNodeRecord record{};
+		record.value = hexToIntFixedLength(hexChars, 8);
+		uint32_t pos = hexToIntFixedLength(&hexChars[8], 8);
+		record.pos = pos & ~((uint32_t)1 << 31);
+		record.interpolated = pos >> 31;
+		runWriter.add(&record);
+	}
+}
+
+// Call just past the opening quote, once that's been written. Writes the rest of the value, up to and including the
+// closing quote - in binary if it's hex of the right shape for its kind
+int32_t convertValueToBinary(Reader& reader, Writer& writer, int32_t quote, ValueKind kind) {
+	if (kind == ValueKind::NONE) {
+		return copyRestOfValue(reader, writer, quote);
+	}
+
+	int32_t headerLength = (kind == ValueKind::AUTOMATION) ? 8 : 0;
+	int32_t recordLength = (kind == ValueKind::NOTES) ? kNoteHexLength : kNodeHexLength;
+
+	// Look far enough ahead to see whether it's "0x", then the header and at least one record, all in hex
+	char hexChars[2 + 8 + kNoteHexLength];
+	int32_t lookaheadLength = 2 + headerLength + recordLength;
+	int32_t numChars = 0;
+	while (numChars < lookaheadLength) {
+		int32_t c = reader.get();
+		if (c < 0) {
+			writer.write(hexChars, numChars);
+			return reader.getErrorForEnd(NO_ERROR);
+		}
+		if (c == quote) {
+			writer.write(hexChars, numChars);
+			writer.put(quote);
+			return NO_ERROR;
+		}
+		hexChars[numChars] = c;
+		bool stillFits = (numChars < 2) ? (c == "0x"[numChars]) : isUpperCaseHexDigit(c);
+		numChars++;
+		if (!stillFits) {
+			writer.write(hexChars, numChars);
+			return copyRestOfValue(reader, writer, quote);
+		}
+	}
+
+	writer.put(BinarySongFormat::kBinaryValueMarker);
+	writer.put((uint8_t)kind);
+	int32_t header = headerLength ? hexToIntFixedLength(&hexChars[2], headerLength) : 0;
+	writer.write(&header, sizeof(header));
+
+	RunWriter runWriter(writer);
+	memmove(hexChars, &hexChars[2 + headerLength], recordLength);
+	numChars = recordLength;
+	while (true) {
+		if (numChars == recordLength) {
+			addRecordFromHex(runWriter, hexChars, kind);
+			numChars = 0;
+		}
+		int32_t c = reader.get();
+		if (c == quote) {
+			break;
+		}
+		if (c < 0) {
+			return reader.getErrorForEnd(ERROR_FILE_CORRUPTED);
+		}
+		if (!isUpperCaseHexDigit(c)) {
+			return ERROR_FILE_CORRUPTED;
+		}
+		hexChars[numChars++] = c;
+	}
+
+	// The hex readers would drop a part-record, so the binary can't have it either
+	if (numChars) {
+		return ERROR_FILE_CORRUPTED;
+	}
+
+	runWriter.finish();
+	writer.put(quote);
+	return NO_ERROR;
+}
+
+// Call just past the kBinaryValueMarker. Writes the value as the hex it came from
+int32_t convertValueToHex(Reader& reader, Writer& writer) {
+	uint8_t kind;
+	int32_t header;
+	if (!reader.read(&kind, sizeof(kind)) || !reader.read(&header, sizeof(header))) {
+		return reader.getErrorForEnd(ERROR_FILE_CORRUPTED);
+	}
+	if (kind != (uint8_t)ValueKind::NOTES && kind != (uint8_t)ValueKind::AUTOMATION) {
+		return ERROR_FILE_CORRUPTED;
+	}
+
+	char hexChars[kNoteHexLength + 1];
+	writer.write("0x", 2);
+	if (kind == (uint8_t)ValueKind::AUTOMATION) {
+		intToHex(header, hexChars, 8);
+		writer.write(hexChars, 8);
+	}
+
+	while (true) {
+		uint32_t numBytes;
+		if (!reader.read(&numBytes, sizeof(numBytes))) {
+			return reader.getErrorForEnd(ERROR_FILE_CORRUPTED);
+		}
+		if (!numBytes) {
+			return NO_ERROR;
+		}
+		if (numBytes % kRecordSize) {
+			return ERROR_FILE_CORRUPTED;
+		}
+
+		for (uint32_t r = 0; r < numBytes / kRecordSize; r++) {
+			if (kind == (uint8_t)ValueKind::NOTES) {
+				BinarySongFormat::NoteRecord record;
+				if (!reader.read(&record, sizeof(record))) {
+					return reader.getErrorForEnd(ERROR_FILE_CORRUPTED);
+				}
+				intToHex(record.pos, hexChars, 8);
+				intToHex(record.length, &hexChars[8], 8);
+				intToHex(record.velocity, &hexChars[16], 2);
+				intToHex(record.lift, &hexChars[18], 2);
+				intToHex(record.probability, &hexChars[20], 2);
+				writer.write(hexChars, kNoteHexLength);
+			}
+			else {
+				BinarySongFormat::ParamNodeRecord record;
+				if (!reader.read(&record, sizeof(record))) {
+					return reader.getErrorForEnd(ERROR_FILE_CORRUPTED);
+				}
+				uint32_t pos = record.pos;
+				if (record.interpolated) {
+					pos |= ((uint32_t)1 << 31);
+				}
+				intToHex(record.value, hexChars, 8);
+				intToHex(pos, &hexChars[8], 8);
+				writer.write(hexChars, kNodeHexLength);
+			}
+		}
+	}
+}
+} // namespace
+
+int32_t BinarySongFormat::convertXMLToBinary(Source& source, Sink& sink) {
+	Reader reader(source);
+	Writer writer(sink);
+
+	FileHeader fileHeader{kMagic, kVersion};
+	ChunkHeader chunkHeader{kDocumentChunk, 0};
+	writer.write(&fileHeader, sizeof(fileHeader));
+	writer.write(&chunkHeader, sizeof(chunkHeader));
+
+	// Only tags have attributes, so only in those do we need to keep track of names and look out for values
+	char name[kMaxNameLength + 1];
+	int32_t nameLength = 0;
+	bool nameEnded = false;
+	bool pastEqualsSign = false;
+	bool inTag = false;
+
+	int32_t c;
+	while ((c = reader.get()) >= 0) {
+		writer.put(c);
+
+		if (!inTag) {
+			inTag = (c == '<');
+			nameLength = 0;
+			pastEqualsSign = false;
+			continue;
+		}
+
+		switch (c) {
+		case '>':
+			inTag = false;
+			break;
+
+		case '=':
+			pastEqualsSign = true;
+			break;
+
+		case '"':
+		case '\'':
+			if (pastEqualsSign) {
+				name[nameLength] = 0;
+				int32_t error = convertValueToBinary(reader, writer, c, getPossibleValueKind(name));
+				if (error) {
+					return error;
+				}
+			}
+			nameLength = 0;
+			pastEqualsSign = false;
+			break;
+
+		case ' ':
+		case '\t':
+		case '\r':
+		case '\n':
+			nameEnded = true;
+			break;
+
+		default:
+			if (nameEnded || pastEqualsSign) {
+				nameLength = 0;
+				nameEnded = false;
+				pastEqualsSign = false;
+			}
+			if (nameLength < kMaxNameLength) {
+				name[nameLength++] = c;
+			}
+		}
+	}
+
+	int32_t error = reader.getErrorForEnd(NO_ERROR);
+	if (error) {
+		return error;
+	}
+
+	// Now the document's length is known, it can go in its ChunkHeader
+	if (!writer.flush()) {
+		return ERROR_WRITE_FAIL;
+	}
+	chunkHeader.length = writer.totalBytes - sizeof(fileHeader) - sizeof(chunkHeader);
+	if (!sink.writeAt(sizeof(fileHeader), &chunkHeader, sizeof(chunkHeader))) {
+		return ERROR_WRITE_FAIL;
+	}
+	return NO_ERROR;
+}
+
+int32_t BinarySongFormat::convertBinaryToXML(Source& source, Sink& sink) {
+	Reader reader(source);
+	Writer writer(sink);
+
+	FileHeader fileHeader;
+	if (!reader.read(&fileHeader, sizeof(fileHeader))) {
+		return reader.getErrorForEnd(ERROR_FILE_CORRUPTED);
+	}
+	if (fileHeader.magic != kMagic) {
+		return ERROR_FILE_CORRUPTED;
+	}
+	if (fileHeader.version > kVersion) {
+		return ERROR_FILE_FIRMWARE_VERSION_TOO_NEW;
+	}
+
+	// Skip any chunks before the document
+	ChunkHeader chunkHeader;
+	while (true) {
+		if (!reader.read(&chunkHeader, sizeof(chunkHeader))) {
+			return reader.getErrorForEnd(ERROR_FILE_CORRUPTED);
+		}
+		if (chunkHeader.id == kDocumentChunk) {
+			break;
+		}
+		if (!reader.read(NULL, chunkHeader.length)) {
+			return reader.getErrorForEnd(ERROR_FILE_CORRUPTED);
+		}
+	}
+
+	uint32_t documentEnd = reader.numBytesRead + chunkHeader.length;
+	while (reader.numBytesRead < documentEnd) {
+		int32_t c = reader.get();
+		if (c < 0) {
+			return reader.getErrorForEnd(ERROR_FILE_CORRUPTED);
+		}
+		if (c == kBinaryValueMarker) {
+			int32_t error = convertValueToHex(reader, writer);
+			if (error) {
+				return error;
+			}
+		}
+		else {
+			writer.put(c);
+		}
+	}
+
+	if (!writer.flush()) {
+		return ERROR_WRITE_FAIL;
+	}
+	return NO_ERROR;
+}
@@ -0,0 +1,94 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "util/functions.h"
+#include <cstdint>
+
+/*
+ * The optional binary song file, written with the BinarySongs community setting on. It starts with a FileHeader, and
+ * then has chunks, each a ChunkHeader followed by its contents. Readers skip any chunk they don't know. Version 1 has
+ * just the one, kDocumentChunk, and it comes last: it's the song's XML, except that note data and automation attribute
+ * values are binary instead of hex. So StorageManager reads a binary song through the same XML reader as any other -
+ * only NoteRow and AutoParam see any difference - and convertBinaryToXML() gives back exactly the XML that went in.
+ *
+ * A binary value sits between the quotes as a text one would. It's kBinaryValueMarker, then a ValueKind byte, a 32-bit
+ * header, then runs - each a 32-bit byte count followed by that many bytes of records - ending with an empty run. XML
+ * text can't contain kBinaryValueMarker, so there's no mistaking one for text. All numbers are little-endian.
+ */
+class BinarySongFormat {
+public:
+	static constexpr uint32_t kMagic = charsToIntegerConstant('D', 'B', 'I', 'N');
+	static constexpr uint32_t kVersion = 1;
+	static constexpr uint32_t kDocumentChunk = charsToIntegerConstant('D', 'O', 'C', 'U');
+	static constexpr char kBinaryValueMarker = 0x01;
+
+	struct FileHeader {
+		uint32_t magic;
+		uint32_t version;
+	};
+
+	struct ChunkHeader {
+		uint32_t id;
+		uint32_t length; // Not including this header
+	};
+
+	enum class ValueKind : uint8_t {
+		NONE,       // A text value
+		NOTES,      // noteDataWithLift. Header is 0, then NoteRecords
+		AUTOMATION, // Any AutoParam. Header is its currentValue, then ParamNodeRecords
+	};
+
+	// The same fields as one note's hex in noteDataWithLift, in the same order
+	struct NoteRecord {
+		int32_t pos;
+		int32_t length;
+		uint8_t velocity;
+		uint8_t lift;
+		uint8_t probability;
+		uint8_t unused;
+	};
+
+	struct ParamNodeRecord {
+		int32_t value;
+		int32_t pos;
+		uint8_t interpolated;
+		uint8_t unused[3];
+	};
+
+	// Where the converters get their input from and send their output to. read() returns how many bytes it got - which
+	// is only 0 at the end - or -1 for an error
+	class Source {
+	public:
+		virtual int32_t read(void* buffer, int32_t maxNumBytes) = 0;
+	};
+
+	class Sink {
+	public:
+		virtual bool write(void const* data, int32_t numBytes) = 0;
+		virtual bool writeAt(uint32_t pos, void const* data, int32_t numBytes) = 0;
+	};
+
+	// These return an error code. Converting XML fails with ERROR_FILE_CORRUPTED if any note data or automation isn't
+	// quite how this firmware writes it, since then there'd be no binary that converted back to exactly the same XML
+	static int32_t convertXMLToBinary(Source& source, Sink& sink);
+	static int32_t convertBinaryToXML(Source& source, Sink& sink);
+};
+
+static_assert(sizeof(BinarySongFormat::NoteRecord) == 12);
+static_assert(sizeof(BinarySongFormat::ParamNodeRecord) == 12);
@@ -31,6 +31,8 @@ Cluster::Cluster() {
 	loaded = false;
 	numReasonsHeldBySampleRecorder = 0;
 	numReasonsToBeLoaded = 0;
+	reloadedAfterSteal = false;
+	notCompressible = false;
 	// type is not set here, set it yourself (can't remember exact reason...)
 }
 
@@ -161,8 +163,18 @@ int32_t Cluster::getAppropriateQueue() {
 
 	// Or, if it has a Sample...
 	else if (sample) {
-		q = sample->numReasonsToBeLoaded ? STEALABLE_QUEUE_CURRENT_SONG_SAMPLE_DATA
-		                                 : STEALABLE_QUEUE_NO_SONG_SAMPLE_DATA;
+		if (!sample->numReasonsToBeLoaded) {
+			q = STEALABLE_QUEUE_NO_SONG_SAMPLE_DATA;
+		}
+
+		// Clusters that are only seen once get stolen before those we know or expect will be needed again - so a
+		// one-off pass through a long sample doesn't push out the loops the song keeps coming back to
+		else if (reloadedAfterSteal || sample->mayPlaySoon(clusterIndex)) {
+			q = STEALABLE_QUEUE_CURRENT_SONG_SAMPLE_DATA_PROTECTED;
+		}
+		else {
+			q = STEALABLE_QUEUE_CURRENT_SONG_SAMPLE_DATA;
+		}
 
 		if (sample->rawDataFormat) {
 			q++;
@@ -182,6 +194,7 @@ void Cluster::steal(char const* errorCode) {
 			FREEZE_WITH_ERROR("E181");
 		}
 		sample->clusters.getElement(clusterIndex)->cluster = NULL;
+		audioFileManager.clusterStolen(this);
 		break;
 
 	case ClusterType::SAMPLE_CACHE:
@@ -230,3 +243,37 @@ bool Cluster::mayBeStolen(void* thingNotToStealFrom) {
 	}
 	return true;
 }
+
+// SampleCache Clusters aren't moved - SampleCache keeps its own array of them, and a Voice may be writing into one
+// without holding a reason
+bool Cluster::mayBeRelocated() {
+	if (numReasonsToBeLoaded || !loaded) {
+		return false;
+	}
+
+	switch (type) {
+	case ClusterType::Sample:
+		return true;
+
+	case ClusterType::PERC_CACHE_FORWARDS:
+	case ClusterType::PERC_CACHE_REVERSED:
+		return !sample->numReasonsToBeLoaded; // Voices read these without reasons
+	}
+	return false;
+}
+
+void Cluster::relocated(Stealable* oldAddress) {
+	switch (type) {
+	case ClusterType::Sample:
+		sample->clusters.getElement(clusterIndex)->cluster = this;
+		break;
+
+	case ClusterType::PERC_CACHE_FORWARDS:
+	case ClusterType::PERC_CACHE_REVERSED:
+		sample->percCacheClusters[type == ClusterType::PERC_CACHE_REVERSED][clusterIndex] = this;
+		break;
+
+	default:
+		break;
+	}
+}
@@ -34,6 +34,8 @@ public:
 	bool mayBeStolen(void* thingNotToStealFrom);
 	void steal(char const* errorCode);
 	int32_t getAppropriateQueue();
+	bool mayBeRelocated();
+	void relocated(Stealable* oldAddress);
 
 	ClusterType type;
 	int8_t numReasonsHeldBySampleRecorder;
@@ -45,6 +47,8 @@ public:
 	SampleCache* sampleCache;
 	char firstThreeBytesPreDataConversion[3];
 	bool loaded;
+	bool reloadedAfterSteal; // So it's proven to be wanted again, and gets to stay around longer this time
+	bool notCompressible;    // CompressedCluster already tried, and it wouldn't pack down far enough
 
 	char dummy[CACHE_LINE_SIZE];
 
@@ -0,0 +1,253 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "storage/cluster/cluster_codec.h"
+
+// A Rice quotient this big means the value gets written out whole instead, in kEscapeNumBits bits
+constexpr int32_t kEscapeQuotient = 24;
+constexpr int32_t kEscapeNumBits = 28; // Enough for the biggest residual from 24-bit values
+constexpr int32_t kRiceParamNumBits = 5;
+constexpr int32_t kMaxRiceParam = kEscapeNumBits - 1;
+
+namespace {
+
+class BitWriter {
+public:
+	BitWriter(uint8_t* output, uint32_t maxBytes) : pos(output), start(output), end(output + maxBytes) {}
+
+	// numBits may be up to 32
+	void write(uint32_t value, int32_t numBits) {
+		if (overflowed) {
+			return;
+		}
+		buffer |= (uint64_t)value << bitsInBuffer;
+		bitsInBuffer += numBits;
+		while (bitsInBuffer >= 8) {
+			if (pos == end) {
+				overflowed = true;
+				return;
+			}
+			*pos++ = buffer;
+			buffer >>= 8;
+			bitsInBuffer -= 8;
+		}
+	}
+
+	// Returns the number of bytes written, or 0 if we ran out of room
+	uint32_t finish() {
+		if (bitsInBuffer) {
+			write(0, 8 - bitsInBuffer);
+		}
+		return overflowed ? 0 : pos - start;
+	}
+
+	bool overflowed = false;
+
+private:
+	uint8_t* pos;
+	uint8_t* start;
+	uint8_t* end;
+	uint64_t buffer = 0;
+	int32_t bitsInBuffer = 0;
+};
+
+class BitReader {
+public:
+	BitReader(uint8_t const* input, uint32_t numBytes) : pos(input), end(input + numBytes) {
+		bitsLeft = numBytes * 8;
+		refill();
+	}
+
+	// numBits may be up to 32
+	uint32_t read(int32_t numBits) {
+		refill();
+		uint32_t value = buffer & ((1ull << numBits) - 1);
+		consume(numBits);
+		return value;
+	}
+
+	// Counts the 1s before the next 0, up to kEscapeQuotient, and skips past them and the 0
+	int32_t readQuotient() {
+		refill();
+		uint32_t inverted = ~(uint32_t)buffer;
+		int32_t quotient = inverted ? __builtin_ctz(inverted) : 32;
+		if (quotient >= kEscapeQuotient) {
+			consume(kEscapeQuotient);
+			return kEscapeQuotient;
+		}
+		consume(quotient + 1);
+		return quotient;
+	}
+
+	bool overran() { return bitsLeft < 0; }
+
+private:
+	void refill() {
+		while (bitsInBuffer <= 56) {
+			uint64_t byte = 0;
+			if (pos < end) {
+				byte = *pos++;
+			}
+			buffer |= byte << bitsInBuffer;
+			bitsInBuffer += 8;
+		}
+	}
+
+	void consume(int32_t numBits) {
+		buffer >>= numBits;
+		bitsInBuffer -= numBits;
+		bitsLeft -= numBits;
+	}
+
+	uint8_t const* pos;
+	uint8_t const* end;
+	uint64_t buffer = 0;
+	int32_t bitsInBuffer = 0;
+	int32_t bitsLeft;
+};
+
+inline int32_t readValue(uint8_t const* address, int32_t byteDepth) {
+	if (byteDepth == 2) {
+		return (int16_t)(address[0] | (address[1] << 8));
+	}
+	return (int32_t)((address[0] << 8) | (address[1] << 16) | (address[2] << 24)) >> 8;
+}
+
+inline void writeValue(uint8_t* address, int32_t byteDepth, int32_t value) {
+	address[0] = value;
+	address[1] = value >> 8;
+	if (byteDepth == 3) {
+		address[2] = value >> 16;
+	}
+}
+
+} // namespace
+
+uint32_t ClusterCodec::encode(uint8_t const* input, uint32_t numBytes, int32_t byteDepth, int32_t numChannels,
+                              uint8_t* output, uint32_t maxOutputBytes, BetweenBlocksFunction betweenBlocks) {
+	int32_t bytesPerFrame = byteDepth * numChannels;
+	int32_t numFrames = numBytes / bytesPerFrame;
+
+	BitWriter writer(output, maxOutputBytes);
+	uint32_t residuals[kBlockSize];
+
+	for (int32_t c = 0; c < numChannels; c++) {
+		uint8_t const* channelInput = input + c * byteDepth;
+		int32_t prev1 = 0;
+		int32_t prev2 = 0;
+
+		for (int32_t blockStart = 0; blockStart < numFrames; blockStart += kBlockSize) {
+			int32_t blockSize = numFrames - blockStart;
+			if (blockSize > kBlockSize) {
+				blockSize = kBlockSize;
+			}
+
+			// Work out the residuals, zigzagged so small negative ones stay small
+			uint64_t sum = 0;
+			for (int32_t i = 0; i < blockSize; i++) {
+				int32_t value = readValue(channelInput + (blockStart + i) * bytesPerFrame, byteDepth);
+				int32_t residual = value - (2 * prev1 - prev2);
+				prev2 = prev1;
+				prev1 = value;
+				residuals[i] = (residual << 1) ^ (residual >> 31);
+				sum += residuals[i];
+			}
+
+			// Rice parameter of about log2 of the mean
+			int32_t riceParam = 0;
+			while (riceParam < kMaxRiceParam && ((uint64_t)blockSize << (riceParam + 1)) <= sum) {
+				riceParam++;
+			}
+			writer.write(riceParam, kRiceParamNumBits);
+
+			for (int32_t i = 0; i < blockSize; i++) {
+				uint32_t quotient = residuals[i] >> riceParam;
+				if (quotient >= kEscapeQuotient) {
+					writer.write((1 << kEscapeQuotient) - 1, kEscapeQuotient);
+					writer.write(residuals[i], kEscapeNumBits);
+				}
+				else {
+					writer.write((1 << quotient) - 1, quotient + 1);
+					writer.write(residuals[i] & ((1 << riceParam) - 1), riceParam);
+				}
+			}
+
+			if (writer.overflowed) {
+				return 0;
+			}
+
+			if (betweenBlocks) {
+				betweenBlocks();
+			}
+		}
+	}
+
+	return writer.finish();
+}
+
+bool ClusterCodec::decode(uint8_t const* input, uint32_t inputBytes, int32_t byteDepth, int32_t numChannels,
+                          uint8_t* output, uint32_t numBytes, BetweenBlocksFunction betweenBlocks) {
+	int32_t bytesPerFrame = byteDepth * numChannels;
+	int32_t numFrames = numBytes / bytesPerFrame;
+
+	BitReader reader(input, inputBytes);
+
+	for (int32_t c = 0; c < numChannels; c++) {
+		uint8_t* channelOutput = output + c * byteDepth;
+		int32_t prev1 = 0;
+		int32_t prev2 = 0;
+
+		for (int32_t blockStart = 0; blockStart < numFrames; blockStart += kBlockSize) {
+			int32_t blockSize = numFrames - blockStart;
+			if (blockSize > kBlockSize) {
+				blockSize = kBlockSize;
+			}
+
+			int32_t riceParam = reader.read(kRiceParamNumBits);
+			if (riceParam > kMaxRiceParam) {
+				return false;
+			}
+
+			for (int32_t i = 0; i < blockSize; i++) {
+				uint32_t quotient = reader.readQuotient();
+				uint32_t zigzagged;
+				if (quotient == kEscapeQuotient) {
+					zigzagged = reader.read(kEscapeNumBits);
+				}
+				else {
+					zigzagged = (quotient << riceParam) | reader.read(riceParam);
+				}
+				int32_t residual = (zigzagged >> 1) ^ -(int32_t)(zigzagged & 1);
+
+				int32_t value = residual + (2 * prev1 - prev2);
+				prev2 = prev1;
+				prev1 = value;
+				writeValue(channelOutput + (blockStart + i) * bytesPerFrame, byteDepth, value);
+			}
+
+			if (reader.overran()) {
+				return false;
+			}
+
+			if (betweenBlocks) {
+				betweenBlocks();
+			}
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,45 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+/*
+ * Lossless packing of little-endian 16- or 24-bit PCM, for keeping Cluster data in RAM at around half the size.
+ *
+ * Each channel is predicted from its previous two values (the same fixed second-order predictor FLAC uses), and what's
+ * left over is Rice coded, with the Rice parameter chosen afresh for every kBlockSize frames. Anything too big for
+ * that just gets written out whole, after an escape code.
+ */
+class ClusterCodec {
+public:
+	static constexpr int32_t kBlockSize = 256;
+
+	// Called after each block, if given - so whoever's encoding or decoding a whole Cluster can let the audio routine
+	// and so on have a go in between
+	using BetweenBlocksFunction = void (*)();
+
+	// numBytes must be a whole number of frames. Returns how many bytes got written, or 0 if it wouldn't fit in
+	// maxOutputBytes - in which case it's probably not worth it anyway.
+	static uint32_t encode(uint8_t const* input, uint32_t numBytes, int32_t byteDepth, int32_t numChannels,
+	                       uint8_t* output, uint32_t maxOutputBytes, BetweenBlocksFunction betweenBlocks = nullptr);
+
+	// Writes numBytes back out - the same as went into encode(). Returns false if the input doesn't add up
+	static bool decode(uint8_t const* input, uint32_t inputBytes, int32_t byteDepth, int32_t numChannels,
+	                   uint8_t* output, uint32_t numBytes, BetweenBlocksFunction betweenBlocks = nullptr);
+};
@@ -0,0 +1,230 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "storage/cluster/compressed_cluster.h"
+#include "definitions_cxx.hpp"
+#include "memory/general_memory_allocator.h"
+#include "model/sample/sample.h"
+#include "processing/engines/audio_engine.h"
+#include "storage/audio/audio_file_manager.h"
+#include "storage/cluster/cluster.h"
+#include "storage/cluster/cluster_codec.h"
+#include "storage/storage_manager.h"
+#include <algorithm>
+#include <new>
+#include <string.h>
+
+// If it won't pack down to this proportion of a Cluster, it's not worth it
+constexpr int32_t kMaxCompressedSizeNumerator = 3;
+constexpr int32_t kMaxCompressedSizeDenominator = 4;
+
+// How far along each queue to look for something to compress
+constexpr int32_t kMaxNumClustersToLookAt = 8;
+
+// Stolen first to last. These only ever hold unconverted Sample Clusters
+constexpr int32_t queuesToCompressFrom[] = {
+    STEALABLE_QUEUE_NO_SONG_SAMPLE_DATA,
+    STEALABLE_QUEUE_CURRENT_SONG_SAMPLE_DATA,
+    STEALABLE_QUEUE_CURRENT_SONG_SAMPLE_DATA_PROTECTED,
+};
+
+static uint32_t timeLastCompression = 0;
+
+// Going through a whole Cluster takes long enough that the audio and UI need a go in the middle. Compressing happens
+// from the main loop, and decompressing in place of a card read, while the Cluster's marked as being loaded - so
+// either way, other Clusters can't get loaded over the top of it
+static void yieldBetweenBlocks() {
+	storageManager.yieldToRoutinesIfDue();
+}
+
+static uint32_t getMaxCompressedSize() {
+	return audioFileManager.clusterSize * kMaxCompressedSizeNumerator / kMaxCompressedSizeDenominator;
+}
+
+// Where the encoded data goes before we know how big it is. Allocated the first time it's needed
+static uint8_t* compressionBuffer = nullptr;
+static uint32_t compressionBufferSize = 0;
+
+void CompressedCluster::compressionRoutine() {
+	if (AudioEngine::cpuDireness
+	    || (uint32_t)(AudioEngine::audioSampleTimer - timeLastCompression) < (kSampleRate / 100)) {
+		return;
+	}
+	timeLastCompression = AudioEngine::audioSampleTimer;
+
+	// Only once memory's full - before that, nothing's about to be stolen
+	MemoryRegion& region = GeneralMemoryAllocator::get().regions[MEMORY_REGION_STEALABLE];
+	if (region.getBiggestEmptySpace() >= audioFileManager.clusterObjectSize) {
+		return;
+	}
+
+	// Before picking a Cluster - getting this might steal one
+	uint32_t maxSize = getMaxCompressedSize();
+	if (compressionBufferSize < maxSize) {
+		if (compressionBuffer) {
+			delugeDealloc(compressionBuffer);
+		}
+		compressionBuffer = (uint8_t*)GeneralMemoryAllocator::get().allocLowSpeed(maxSize);
+		if (!compressionBuffer) {
+			compressionBufferSize = 0;
+			return;
+		}
+		compressionBufferSize = maxSize;
+	}
+
+	for (int32_t q : queuesToCompressFrom) {
+		BidirectionalLinkedList& queue = region.cache_manager().queue(q);
+		int32_t numLookedAt = 0;
+		for (Cluster* cluster = (Cluster*)queue.getFirst(); cluster && numLookedAt < kMaxNumClustersToLookAt;
+		     cluster = (Cluster*)queue.getNext(cluster), numLookedAt++) {
+			if (mayCompress(cluster)) {
+				compress(cluster);
+				return;
+			}
+		}
+	}
+}
+
+bool CompressedCluster::mayCompress(Cluster* cluster) {
+	if (cluster->type != ClusterType::Sample || !cluster->loaded || cluster->numReasonsToBeLoaded
+	    || cluster->notCompressible) {
+		return false;
+	}
+
+	Sample* sample = cluster->sample;
+	return (sample->rawDataFormat == RAW_DATA_FINE && (sample->byteDepth == 2 || sample->byteDepth == 3)
+	        && sample->audioDataLengthBytes && sample->audioDataLengthBytes != 0x8FFFFFFFFFFFFFFF);
+}
+
+bool CompressedCluster::compress(Cluster* cluster) {
+	Sample* sample = cluster->sample;
+	uint32_t clusterIndex = cluster->clusterIndex;
+	uint32_t clusterSize = audioFileManager.clusterSize;
+	int32_t bytesPerFrame = sample->byteDepth * sample->numChannels;
+
+	// Work out which bytes hold whole frames of audio
+	uint64_t clusterStartByte = (uint64_t)clusterIndex << audioFileManager.clusterSizeMagnitude;
+	uint64_t audioEndByte = sample->audioDataStartPosBytes + sample->audioDataLengthBytes;
+	if (audioEndByte <= clusterStartByte) {
+		cluster->notCompressible = true;
+		return false;
+	}
+
+	uint32_t frameStart;
+	if (sample->audioDataStartPosBytes >= clusterStartByte) {
+		frameStart = sample->audioDataStartPosBytes - clusterStartByte;
+		if (frameStart >= clusterSize) {
+			cluster->notCompressible = true;
+			return false;
+		}
+	}
+	else {
+		uint32_t bytesIntoFrame = (clusterStartByte - sample->audioDataStartPosBytes) % bytesPerFrame;
+		frameStart = bytesIntoFrame ? (bytesPerFrame - bytesIntoFrame) : 0;
+	}
+
+	uint32_t audioEnd = std::min<uint64_t>(clusterSize, audioEndByte - clusterStartByte);
+	uint32_t frameEnd = frameStart;
+	if (audioEnd > frameStart) {
+		frameEnd += (audioEnd - frameStart) / bytesPerFrame * bytesPerFrame;
+	}
+	uint32_t dataEnd = std::min<uint32_t>(clusterSize, ((audioEnd - 1) | 511) + 1); // Whole sectors, as loaded
+
+	uint32_t numKeptBytes = frameStart + dataEnd - frameEnd;
+	uint32_t maxSize = getMaxCompressedSize();
+	if (sizeof(CompressedCluster) + numKeptBytes >= maxSize) {
+		cluster->notCompressible = true;
+		return false;
+	}
+
+	// While we're yielding, the Cluster mustn't get stolen, nor its Sample deleted
+	audioFileManager.addReasonToCluster(cluster);
+	sample->addReason();
+
+	// Kept bytes first, then the encoded ones after them - the same as they'll be in the CompressedCluster
+	memcpy(compressionBuffer, cluster->data, frameStart);
+	memcpy(compressionBuffer + frameStart, &cluster->data[frameEnd], dataEnd - frameEnd);
+	uint32_t numEncodedBytes = ClusterCodec::encode(
+	    (uint8_t*)&cluster->data[frameStart], frameEnd - frameStart, sample->byteDepth, sample->numChannels,
+	    compressionBuffer + numKeptBytes, maxSize - sizeof(CompressedCluster) - numKeptBytes, yieldBetweenBlocks);
+
+	// If a Voice wanted it while we were going, it stays as it is - we can have another go once it's finished with
+	bool wantedMeanwhile = (cluster->numReasonsToBeLoaded > 1);
+	audioFileManager.removeReasonFromCluster(cluster, "E460");
+	sample->removeReason("E461");
+	if (wantedMeanwhile) {
+		return false;
+	}
+	if (!numEncodedBytes) {
+		cluster->notCompressible = true;
+		return false;
+	}
+
+	// Give up the Cluster first - so its memory can be where the compressed version goes, if nowhere's better
+	SampleCluster* sampleCluster = sample->clusters.getElement(clusterIndex);
+	sampleCluster->cluster = nullptr;
+	audioFileManager.deallocateCluster(cluster);
+
+	uint32_t totalSize = numKeptBytes + numEncodedBytes;
+	void* memory = GeneralMemoryAllocator::get().allocStealable(sizeof(CompressedCluster) + totalSize);
+	if (!memory) {
+		return false; // Same as if it had been stolen
+	}
+
+	CompressedCluster* compressedCluster = new (memory) CompressedCluster();
+	compressedCluster->sample = sample;
+	compressedCluster->clusterIndex = clusterIndex;
+	compressedCluster->frameStart = frameStart;
+	compressedCluster->frameEnd = frameEnd;
+	compressedCluster->dataEnd = dataEnd;
+	compressedCluster->numEncodedBytes = numEncodedBytes;
+	compressedCluster->beingDecompressed = false;
+	memcpy(compressedCluster->data, compressionBuffer, totalSize);
+
+	sampleCluster->compressedCluster = compressedCluster;
+	GeneralMemoryAllocator::get().putStealableInAppropriateQueue(compressedCluster);
+	return true;
+}
+
+bool CompressedCluster::decompress(Cluster* cluster) {
+	uint32_t numKeptBytes = frameStart + dataEnd - frameEnd;
+
+	memcpy(cluster->data, data, frameStart);
+	memcpy(&cluster->data[frameEnd], &data[frameStart], dataEnd - frameEnd);
+
+	// Can't have this moving or disappearing while other routines get a go
+	beingDecompressed = true;
+	bool success =
+	    ClusterCodec::decode(&data[numKeptBytes], numEncodedBytes, sample->byteDepth, sample->numChannels,
+	                         (uint8_t*)&cluster->data[frameStart], frameEnd - frameStart, yieldBetweenBlocks);
+	beingDecompressed = false;
+	return success;
+}
+
+void CompressedCluster::steal(char const* errorCode) {
+	sample->clusters.getElement(clusterIndex)->compressedCluster = nullptr;
+}
+
+void CompressedCluster::relocated(Stealable* oldAddress) {
+	sample->clusters.getElement(clusterIndex)->compressedCluster = this;
+}
+
+// Worth more than the raw Clusters - it takes loading and compressing to get one of these back
+int32_t CompressedCluster::getAppropriateQueue() {
+	return sample->numReasonsToBeLoaded ? STEALABLE_QUEUE_CURRENT_SONG_SAMPLE_DATA_CONVERTED
+	                                    : STEALABLE_QUEUE_NO_SONG_SAMPLE_DATA_CONVERTED;
+}
@@ -0,0 +1,66 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "memory/stealable.h"
+#include <cstdint>
+
+class Cluster;
+class Sample;
+
+/*
+ * A Sample Cluster's data, packed with ClusterCodec, taking around half the RAM.
+ *
+ * Once memory's full, compressionRoutine() takes Clusters that are next in line to be stolen and swaps them for one of
+ * these - so they stay in RAM for longer, rather than having to come off the card again. And when one's needed again,
+ * AudioFileManager unpacks it into a fresh Cluster instead of reading the card - so nothing reading from Clusters has
+ * to know about any of this.
+ *
+ * Only for plain 16- and 24-bit PCM, which is what most Samples are. Anything needing conversion stays as it is.
+ */
+class CompressedCluster final : public Stealable {
+public:
+	// Call regularly from the main loop. Compresses one Cluster at most
+	static void compressionRoutine();
+
+	// Writes the data back into cluster, which must be for the same Sample and index, and be being loaded - it lets
+	// other routines run as it goes. Returns false if that fails
+	bool decompress(Cluster* cluster);
+
+	bool mayBeStolen(void* thingNotToStealFrom = nullptr) { return !beingDecompressed; }
+	void steal(char const* errorCode);
+	int32_t getAppropriateQueue();
+	bool mayBeRelocated() { return !beingDecompressed; }
+	void relocated(Stealable* oldAddress);
+
+	Sample* sample;
+	uint32_t clusterIndex;
+
+private:
+	static bool mayCompress(Cluster* cluster);
+	static bool compress(Cluster* cluster);
+
+	uint32_t frameStart;      // Bytes before this within the Cluster are kept as they are
+	uint32_t frameEnd;        // And so are bytes from here til dataEnd
+	uint32_t dataEnd;         // Bytes after this didn't come from the card, so aren't kept at all
+	uint32_t numEncodedBytes; // What ClusterCodec made of everything between frameStart and frameEnd
+	bool beingDecompressed;
+
+	// This has to be last!!! The kept bytes, then the encoded ones
+	uint8_t data[4];
+};
@@ -0,0 +1,84 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "storage/fat_chain_reader.h"
+#include "definitions.h"
+#include <algorithm>
+#include <string.h>
+
+extern "C" {
+#include "fatfs/diskio.h"
+
+DWORD get_fat_from_fs(FATFS* fs, DWORD clst);
+}
+
+namespace {
+// Shared between all FATChainReaders - there's only ever one walking a chain at a time. Cache-line aligned, since it
+// gets DMA'd into
+alignas(CACHE_LINE_SIZE) uint8_t fatWindow[FF_MAX_SS * FATChainReader::kNumSectorsPerWindow];
+} // namespace
+
+bool FATChainReader::loadWindow(LBA_t sector) {
+	LBA_t fatEnd = fs->fatbase + fs->fsize;
+	int32_t numSectors = std::min<LBA_t>(kNumSectorsPerWindow, fatEnd - sector);
+
+	if (disk_read(fs->pdrv, fatWindow, sector, numSectors) != RES_OK) {
+		windowNumSectors = 0;
+		return false;
+	}
+
+	// FatFS's own window might hold a newer copy of one of these sectors, not written back yet
+	if (fs->winsect >= sector && fs->winsect < sector + numSectors) {
+		memcpy(&fatWindow[(fs->winsect - sector) * FF_MAX_SS], fs->win, FF_MAX_SS);
+	}
+
+	windowStart = sector;
+	windowNumSectors = numSectors;
+	return true;
+}
+
+DWORD FATChainReader::getNextCluster(DWORD cluster) {
+	if (cluster < 2 || cluster >= fs->n_fatent) {
+		return 1;
+	}
+
+	int32_t entrySize;
+	if (fs->fs_type == FS_FAT32) {
+		entrySize = 4;
+	}
+	else if (fs->fs_type == FS_FAT16) {
+		entrySize = 2;
+	}
+	else {
+		return get_fat_from_fs(fs, cluster);
+	}
+
+	uint32_t byteOffset = cluster * entrySize;
+	LBA_t sector = fs->fatbase + byteOffset / FF_MAX_SS;
+
+	if (!windowNumSectors || sector < windowStart || sector >= windowStart + windowNumSectors) {
+		if (!loadWindow(sector)) {
+			return 0xFFFFFFFF;
+		}
+	}
+
+	uint8_t const* entry = &fatWindow[(sector - windowStart) * FF_MAX_SS + byteOffset % FF_MAX_SS];
+	if (entrySize == 4) {
+		return (*(uint32_t const*)entry) & 0x0FFFFFFF; // Mask out the upper 4 bits
+	}
+	return *(uint16_t const*)entry;
+}
@@ -0,0 +1,49 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+extern "C" {
+#include "fatfs/ff.h"
+}
+
+/*
+ * For walking a whole file's cluster chain, as AudioFileManager does to get every SampleCluster's sdAddress up front.
+ * get_fat_from_fs() goes through FatFS's one-sector window, so that's a separate card read for every 128 clusters
+ * even when the file's contiguous - and a fragmented file hopping back and forth between parts of the FAT can end up
+ * reading the same sectors again and again. Instead, this reads the FAT in bigger windows of its own.
+ *
+ * FAT12 entries can straddle sectors, and FAT12 cards are tiny anyway, so those just go through get_fat_from_fs().
+ */
+class FATChainReader {
+public:
+	explicit FATChainReader(FATFS* fs) : fs(fs) {}
+
+	// Same return values as get_fat_from_fs(): 0xFFFFFFFF for a disk error, 1 for an internal error, otherwise the
+	// cluster's FAT entry - so normally the next cluster in the chain
+	DWORD getNextCluster(DWORD cluster);
+
+	static constexpr int32_t kNumSectorsPerWindow = 8;
+
+private:
+
+	bool loadWindow(LBA_t sector);
+
+	FATFS* fs;
+	LBA_t windowStart = 0;
+	int32_t windowNumSectors = 0;
+};
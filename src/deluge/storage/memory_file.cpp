@@ -0,0 +1,79 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "storage/memory_file.h"
+#include "definitions_cxx.hpp"
+#include "memory/general_memory_allocator.h"
+#include <algorithm>
+#include <cstring>
+
+int32_t MemoryFile::append(void const* data, int32_t numBytes) {
+	if (numBytes <= 0) {
+		return NO_ERROR;
+	}
+
+	Chunk* chunk = (Chunk*)GeneralMemoryAllocator::get().allocExternal(sizeof(Chunk) + numBytes);
+	if (!chunk) {
+		return ERROR_INSUFFICIENT_RAM;
+	}
+	chunk->next = nullptr;
+	chunk->numBytes = numBytes;
+	memcpy(chunk->data, data, numBytes);
+
+	if (lastChunk) {
+		lastChunk->next = chunk;
+	}
+	else {
+		firstChunk = chunk;
+		readChunk = chunk;
+		readPosInChunk = 0;
+	}
+	lastChunk = chunk;
+	size += numBytes;
+	return NO_ERROR;
+}
+
+void MemoryFile::clear() {
+	while (firstChunk) {
+		Chunk* next = firstChunk->next;
+		GeneralMemoryAllocator::get().deallocExternal(firstChunk);
+		firstChunk = next;
+	}
+	lastChunk = nullptr;
+	size = 0;
+	rewind();
+}
+
+int32_t MemoryFile::readNext(void const** bytes, int32_t maxNumBytes) {
+	while (readChunk && readPosInChunk == readChunk->numBytes) {
+		readChunk = readChunk->next;
+		readPosInChunk = 0;
+	}
+	if (!readChunk) {
+		return 0;
+	}
+
+	int32_t numBytes = std::min(maxNumBytes, readChunk->numBytes - readPosInChunk);
+	*bytes = &readChunk->data[readPosInChunk];
+	readPosInChunk += numBytes;
+	return numBytes;
+}
+
+void MemoryFile::rewind() {
+	readChunk = firstChunk;
+	readPosInChunk = 0;
+}
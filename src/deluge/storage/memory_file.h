@@ -0,0 +1,56 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+/*
+ * A file's contents, built up in external RAM to be put on the card later - a bit at a time if need be. It's kept as a
+ * list of chunks, one per append(), so it never needs one big allocation or any copying as it grows. Reading back
+ * goes from front to back.
+ */
+class MemoryFile {
+public:
+	MemoryFile() = default;
+	~MemoryFile() { clear(); }
+	MemoryFile(MemoryFile const&) = delete;
+	MemoryFile& operator=(MemoryFile const&) = delete;
+
+	// Returns an error code - ERROR_INSUFFICIENT_RAM if there wasn't room
+	int32_t append(void const* data, int32_t numBytes);
+	void clear();
+	uint32_t getSize() const { return size; }
+
+	// Points bytes at the next contiguous bytes, up to maxNumBytes of them, and returns how many. Only 0 at the end
+	int32_t readNext(void const** bytes, int32_t maxNumBytes);
+	void rewind();
+
+private:
+	struct Chunk {
+		Chunk* next;
+		int32_t numBytes;
+		uint8_t data[];
+	};
+
+	Chunk* firstChunk = nullptr;
+	Chunk* lastChunk = nullptr;
+	uint32_t size = 0;
+
+	Chunk* readChunk = nullptr;
+	int32_t readPosInChunk = 0;
+};
@@ -0,0 +1,192 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "storage/song_autosaver.h"
+#include "definitions_cxx.hpp"
+#include "gui/ui/audio_recorder.h"
+#include "gui/ui/root_ui.h"
+#include "gui/ui/ui.h"
+#include "hid/led/pad_leds.h"
+#include "io/debug/log.h"
+#include "model/settings/runtime_feature_settings.h"
+#include "model/song/song.h"
+#include "playback/playback_handler.h"
+#include "processing/engines/audio_engine.h"
+#include "storage/audio/audio_file_manager.h"
+#include "storage/storage_manager.h"
+#include "util/functions.h"
+#include <cstring>
+
+extern uint8_t currentlyAccessingCard;
+
+SongAutosaver songAutosaver{};
+
+namespace {
+constexpr char const* kAutosaveFilePath = "SONGS/AUTOSAVE.XML";
+constexpr char const* kPreviousAutosaveFilePath = "SONGS/AUTOSAVE PREVIOUS.XML";
+constexpr char const* kAutosaveTempFilePath = "SONGS/AUTOSAVE.TMP"; // Not .XML, so the song browser won't show it
+
+// How much goes onto the card each time routine() is called - a few sectors, so no one go holds up the UI for long
+constexpr int32_t kBytesPerSlice = 4096;
+} // namespace
+
+void SongAutosaver::songEdited() {
+	schedule.songEdited(AudioEngine::audioSampleTimer);
+}
+
+void SongAutosaver::songSaved() {
+	schedule.songSaved(AudioEngine::audioSampleTimer);
+}
+
+void SongAutosaver::routine() {
+	// A copy that's on its way to the card gets finished whatever the setting says now. Sample Clusters the Song's
+	// waiting on come first, though
+	if (writingTempFile) {
+		if (currentlyAccessingCard || audioFileManager.loadingQueue.getNumElements()) {
+			return;
+		}
+		bool finished = false;
+		int32_t error = writeNextSlice(&finished);
+		if (!error && finished) {
+			error = replaceAutosave();
+		}
+		if (error) {
+			D_PRINTLN("autosave failed: %d", error);
+			abandonWriting();
+			schedule.autosaveFailed();
+		}
+		return;
+	}
+
+	if (!currentSong
+	    || runtimeFeatureSettings.get(RuntimeFeatureSettingType::Autosave) != RuntimeFeatureStateToggle::On) {
+		return;
+	}
+
+	uint32_t timeNow = AudioEngine::audioSampleTimer;
+	if (!schedule.isDue(timeNow)) {
+		return;
+	}
+
+	// Only from a plain view with nothing held or half-done - otherwise the Song may be mid-edit, and anything else
+	// using PadLEDs::imageStore would get its contents overwritten below. And not while recording, which is changing
+	// the Song as it goes and needs the card itself
+	if (getCurrentUI() != getRootUI() || !isNoUIModeActive() || currentlyAccessingCard
+	    || playbackHandler.isCurrentlyRecording() || audioRecorder.recordingSource != AudioInputChannel::NONE
+	    || currentSong->hasAnyPendingNextOverdubs()) {
+		return;
+	}
+
+	// Edits from here on are for the next autosave - if this one fails, they're all still unsaved
+	schedule.autosaveStarted(timeNow);
+	int32_t error = copySong();
+	if (error) {
+		D_PRINTLN("autosave failed: %d", error);
+		schedule.autosaveFailed();
+	}
+}
+
+// Writes the Song into songCopy, and gets the temp file ready for it. This is the only part that holds up the UI, and
+// it's all RAM, so it's over as quickly as the CPU can do it
+int32_t SongAutosaver::copySong() {
+	AudioEngine::logAction("SongAutosaver::copySong");
+
+	// The song browser shows what the pads looked like when the Song was saved
+	memcpy(PadLEDs::imageStore, PadLEDs::image, sizeof(PadLEDs::image));
+
+	storageManager.createXMLFileInMemory(&songCopy);
+	currentSong->writeToFile();
+	int32_t error = storageManager.finishWritingToMemory();
+	if (error) {
+		songCopy.clear();
+		return error;
+	}
+
+	error = storageManager.createFile(&tempFile, kAutosaveTempFilePath, true);
+	if (error) {
+		songCopy.clear();
+		return error;
+	}
+
+	songCopy.rewind();
+	writingTempFile = true;
+	return NO_ERROR;
+}
+
+int32_t SongAutosaver::writeNextSlice(bool* finished) {
+	void const* bytes;
+	int32_t numBytes = songCopy.readNext(&bytes, kBytesPerSlice);
+	if (!numBytes) {
+		*finished = true;
+		return NO_ERROR;
+	}
+
+	UINT numBytesWritten;
+	FRESULT result = f_write(&tempFile, bytes, numBytes, &numBytesWritten);
+	if (result != FR_OK) {
+		return fresultToDelugeErrorCode(result);
+	}
+	if (numBytesWritten != numBytes) {
+		return ERROR_SD_CARD_FULL;
+	}
+	return NO_ERROR;
+}
+
+// The temp file's all there. Checks it made it onto the card whole, then puts it in place of the old autosave
+int32_t SongAutosaver::replaceAutosave() {
+	writingTempFile = false;
+	uint32_t expectedSize = songCopy.getSize();
+	songCopy.clear();
+
+	FRESULT result = f_close(&tempFile);
+	if (result != FR_OK) {
+		return ERROR_WRITE_FAIL;
+	}
+	result = f_stat(kAutosaveTempFilePath, &staticFNO);
+	if (result != FR_OK || staticFNO.fsize != expectedSize) {
+		return ERROR_WRITE_FAIL;
+	}
+
+	// Only now that there's a whole new one, replace the old one. Except the first time since switch-on, when the old
+	// one might be all that's left of whatever was lost in a crash, so it gets kept as the previous autosave instead
+	if (!keptPreviousAutosave) {
+		f_unlink(kPreviousAutosaveFilePath);
+		result = f_rename(kAutosaveFilePath, kPreviousAutosaveFilePath);
+		keptPreviousAutosave = true;
+	}
+	else {
+		result = f_unlink(kAutosaveFilePath);
+	}
+	if (result != FR_OK && result != FR_NO_FILE) {
+		return fresultToDelugeErrorCode(result);
+	}
+	result = f_rename(kAutosaveTempFilePath, kAutosaveFilePath);
+	if (result != FR_OK) {
+		return fresultToDelugeErrorCode(result);
+	}
+
+	return NO_ERROR;
+}
+
+void SongAutosaver::abandonWriting() {
+	if (writingTempFile) {
+		f_close(&tempFile);
+		f_unlink(kAutosaveTempFilePath);
+		writingTempFile = false;
+	}
+	songCopy.clear();
+}
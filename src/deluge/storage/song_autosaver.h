@@ -0,0 +1,61 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "storage/autosave_schedule.h"
+#include "storage/memory_file.h"
+#include <cstdint>
+
+extern "C" {
+#include "fatfs/ff.h"
+}
+
+/*
+ * With the Autosave community setting on, keeps a copy of the current Song in SONGS/AUTOSAVE.XML, so that after a crash
+ * or power cut, there's something recent to load from the song browser.
+ *
+ * Whatever applies an edit to the Song tells us. Once AutosaveSchedule says one's due, we write the whole Song out -
+ * into RAM, which takes no card access, so button and pad presses only wait for as long as the CPU takes over it. Then
+ * routine() puts that on the card a slice at a time, between sample Cluster loads, with the UI carrying on as normal
+ * in between - so it happens during playback too. It goes to a temp file first, so there's always a whole autosave
+ * there. The one left from before switch-on is kept as SONGS/AUTOSAVE PREVIOUS.XML.
+ */
+class SongAutosaver {
+public:
+	// Call regularly from the main loop, outside the card routine. Mostly returns straight away
+	void routine();
+
+	void songEdited();
+
+	// Call once the Song's been saved or loaded - it's got no unsaved changes then
+	void songSaved();
+
+private:
+	int32_t copySong();
+	int32_t writeNextSlice(bool* finished);
+	int32_t replaceAutosave();
+	void abandonWriting();
+
+	AutosaveSchedule schedule;
+	MemoryFile songCopy;
+	FIL tempFile;
+	bool writingTempFile = false;
+	bool keptPreviousAutosave = false;
+};
+
+extern SongAutosaver songAutosaver;
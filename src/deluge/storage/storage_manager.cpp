@@ -17,6 +17,7 @@
 
 #include "storage/storage_manager.h"
 #include "definitions_cxx.hpp"
+#include "drivers/mtu/mtu.h"
 #include "drivers/pic/pic.h"
 #include "gui/ui/sound_editor.h"
 #include "gui/ui_timer_manager.h"
@@ -36,6 +37,8 @@
 #include "processing/sound/sound_drum.h"
 #include "processing/sound/sound_instrument.h"
 #include "storage/audio/audio_file_manager.h"
+#include "storage/memory_file.h"
+#include "util/cfunctions.h"
 #include <string.h>
 
 extern "C" {
@@ -63,6 +66,9 @@ struct FileSystemStuff fileSystemStuff;
 
 StorageManager::StorageManager() {
 	fileClusterBuffer = NULL;
+	timeLastYielded = 0;
+	binaryValueKind = BinarySongFormat::ValueKind::NONE;
+	memoryFileBeingWritten = NULL;
 
 	devVarA = 150;
 	devVarB = 8;
@@ -169,746 +175,27 @@ void StorageManager::printIndents() {
 	}
 }
 
-char stringBuffer[kFilenameBufferSize] __attribute__((aligned(CACHE_LINE_SIZE)));
+// How often to let audio and the UI have a go while reading or writing a file. Worked out once at startup, as it's
+// looked at for every tag
+uint16_t const yieldIntervalFastTimerCount = usToFastTimerCount(1000);
 
-#define BETWEEN_TAGS 0
-#define IN_TAG_NAME 1
-#define IN_TAG_PAST_NAME 2
-#define IN_ATTRIBUTE_NAME 3
-#define PAST_ATTRIBUTE_NAME 4
-#define PAST_EQUALS_SIGN 5
-#define IN_ATTRIBUTE_VALUE 6
-
-// Only call this if IN_TAG_NAME
-// TODO: this is very sub-optimal and still calls readCharXML()
-char const* StorageManager::readTagName() {
-
-	if (false) {
-skipToNextTag:
-		skipUntilChar('>');
-		skipUntilChar('<');
-	}
-
-	char thisChar;
-	int32_t charPos = 0;
-
-	while (readCharXML(&thisChar)) {
-		switch (thisChar) {
-		case '/':
-			goto skipPastRest;
-
-		case ' ':
-		case '\r':
-		case '\n':
-		case '\t':
-			xmlArea = IN_TAG_PAST_NAME;
-			goto getOut;
-
-		case '?':
-			goto skipToNextTag;
-
-		case '>':
-			xmlArea = BETWEEN_TAGS;
-			goto getOut;
-
-		default:
-			if (!charPos) {
-				tagDepthFile++;
-			}
-
-			// Store this character, if space in our un-ideal buffer
-			if (charPos < kFilenameBufferSize - 1) {
-				stringBuffer[charPos++] = thisChar;
-			}
-		}
-	}
-
-getOut:
-	xmlReadDone();
-
-	if (false) {
-skipPastRest:
-		tagDepthFile--;
-		skipUntilChar('>');
-		xmlArea = BETWEEN_TAGS;
-	}
-
-	stringBuffer[charPos] = 0;
-	return stringBuffer;
-}
-
-// Only call when IN_TAG_PAST_NAME
-char const* StorageManager::readNextAttributeName() {
-
-	char thisChar;
-	int32_t charPos = 0;
-
-	while (readCharXML(&thisChar)) {
-		switch (thisChar) {
-		case ' ':
-		case '\r':
-		case '\n':
-		case '\t':
-			break;
-
-		case '/':
-			tagDepthFile--;
-			skipUntilChar('>');
-			// No break
-
-		case '>':
-			xmlArea = BETWEEN_TAGS;
-			// No break
-
-		case '<': // This is an error - there definitely shouldn't be a '<' inside a tag! TODO: make way to return error
-			goto noMoreAttributes;
-
-		default:
-			goto doReadName;
-		}
-	}
-
-noMoreAttributes:
-	return "";
-
-	// Here, we're in IN_ATTRIBUTE_NAME, and we're not allowed to leave this while loop until our xmlArea changes to
-	// something else
-	// - or there's an error or file-end, in which case we'll return error below
-doReadName:
-	xmlArea = IN_ATTRIBUTE_NAME;
-	tagDepthFile++;
-	fileBufferCurrentPos--; // This means we don't need to call readXMLFileClusterIfNecessary()
-
-	bool haveReachedNameEnd = false;
-
-	// This is basically copied and tweaked from readUntilChar()
-	do {
-		int32_t bufferPosAtStart = fileBufferCurrentPos;
-		while (fileBufferCurrentPos < currentReadBufferEndPos) {
-			char thisChar = fileClusterBuffer[fileBufferCurrentPos];
-
-			switch (thisChar) {
-			case ' ':
-			case '\r':
-			case '\n':
-			case '\t':
-				xmlArea = PAST_ATTRIBUTE_NAME;
-				goto reachedNameEnd;
-
-			case '=':
-				xmlArea = PAST_EQUALS_SIGN;
-				goto reachedNameEnd;
-
-			// If we get a close-tag name, it means we saw some sorta attribute name with no value, which isn't allowed,
-			// so treat it as invalid
-			case '>':
-				xmlArea = BETWEEN_TAGS;
-				goto noMoreAttributes;
-
-				// TODO: a '/' should get us outta here too...
-			}
-
-			fileBufferCurrentPos++;
-		}
-
-		if (false) {
-reachedNameEnd:
-			xmlReadDone();
-			haveReachedNameEnd = true;
-			// If possible, just return a pointer to the chars within the existing buffer
-			if (!charPos && fileBufferCurrentPos < currentReadBufferEndPos) {
-				fileClusterBuffer[fileBufferCurrentPos] = 0; // NULL end of the string we're returning
-				fileBufferCurrentPos++;                      // Gets us past the endChar
-				return &fileClusterBuffer[bufferPosAtStart];
-			}
-		}
-
-		int32_t numCharsHere = fileBufferCurrentPos - bufferPosAtStart;
-		int32_t numCharsToCopy = std::min<int32_t>(numCharsHere, kFilenameBufferSize - 1 - charPos);
-
-		if (numCharsToCopy > 0) {
-			memcpy(&stringBuffer[charPos], &fileClusterBuffer[bufferPosAtStart], numCharsToCopy);
-
-			charPos += numCharsToCopy;
-		}
-
-		if (haveReachedNameEnd) {
-			stringBuffer[charPos] = 0;
-			fileBufferCurrentPos++; // Gets us past the endChar
-			return stringBuffer;
-		}
-
-	} while (fileBufferCurrentPos == currentReadBufferEndPos && readXMLFileClusterIfNecessary());
-
-	// If here, file ended
-	return "";
-}
-
-char charAtEndOfValue;
-
-char const* StorageManager::readNextTagOrAttributeName() {
-
-	char const* toReturn;
-	int32_t tagDepthStart = tagDepthFile;
-
-	switch (xmlArea) {
-
-	default:
-#if ALPHA_OR_BETA_VERSION
-		// Can happen with invalid files, though I'm implementing error checks whenever a user alerts me to a scenario.
-		// Fraser got this, Nov 2021.
-		FREEZE_WITH_ERROR("E365");
-#else
-		__builtin_unreachable();
-#endif
-		break;
-
-	case IN_ATTRIBUTE_VALUE: // Could have been left here during a char-at-a-time read
-		skipUntilChar(charAtEndOfValue);
-		xmlArea = IN_TAG_PAST_NAME;
-		// No break
-
-	case IN_TAG_PAST_NAME:
-		toReturn = readNextAttributeName();
-		// If depth has changed, this means we met a /> and must get out
-		if (*toReturn || tagDepthFile != tagDepthStart) {
-			break;
-		}
-		// No break
-
-	case BETWEEN_TAGS:
-		skipUntilChar('<');
-		xmlArea = IN_TAG_NAME;
-		// No break
-
-	case IN_TAG_NAME:
-		toReturn = readTagName();
-	}
-
-	if (*toReturn) {
-		/*
-		for (int32_t t = 0; t < tagDepthCaller; t++) {
-D_PRINTLN("\t");
-		}
-		D_PRINTLN(toReturn);
-		*/
-		tagDepthCaller++;
-		AudioEngine::logAction(toReturn);
-	}
-
-	return toReturn;
-}
-
-// Only call if PAST_ATTRIBUTE_NAME or PAST_EQUALS_SIGN
-// Returns the quote character that opens the value - or 0 if fail
-bool StorageManager::getIntoAttributeValue() {
-
-	char thisChar;
-
-	switch (xmlArea) {
-	case PAST_ATTRIBUTE_NAME:
-		while (readCharXML(&thisChar)) {
-			switch (thisChar) {
-			case ' ':
-			case '\r':
-			case '\n':
-			case '\t':
-				break;
-
-			case '=':
-				xmlArea = PAST_EQUALS_SIGN;
-				goto pastEqualsSign;
-
-			default:
-				return false; // There shouldn't be any other characters. If there are, that's an error
-			}
-		}
-
-		break;
-
-	case PAST_EQUALS_SIGN:
-pastEqualsSign:
-		while (readCharXML(&thisChar)) {
-			switch (thisChar) {
-			case ' ':
-			case '\r':
-			case '\n':
-			case '\t':
-				break;
-
-			case '"':
-			case '\'':
-				goto inAttributeValue;
-
-			default:
-				return false; // There shouldn't be any other characters. If there are, that's an error
-			}
-		}
-		break;
-	}
-
-	if (false) {
-inAttributeValue:
-		xmlArea = IN_ATTRIBUTE_VALUE;
-		tagDepthFile--;
-		charAtEndOfValue = thisChar;
-		return true;
-	}
-
-	return false; // Fail
-}
-
-// Only call if PAST_ATTRIBUTE_NAME or PAST_EQUALS_SIGN
-char const* StorageManager::readAttributeValue() {
-
-	if (!getIntoAttributeValue()) {
-		return "";
-	}
-	xmlArea = IN_TAG_PAST_NAME; // How it'll be after this next call
-	return readUntilChar(charAtEndOfValue);
-}
-
-// Only call if PAST_ATTRIBUTE_NAME or PAST_EQUALS_SIGN
-int32_t StorageManager::readAttributeValueInt() {
-
-	if (!getIntoAttributeValue()) {
-		return 0;
+// Call often while reading or writing a file. Goes by time rather than counting reads or bytes, since how long those
+// take varies so much - with the card, the Cluster size, and how much is in each tag
+void StorageManager::yieldToRoutinesIfDue() {
+	if ((uint16_t)(*TCNT[TIMER_SYSTEM_FAST] - timeLastYielded) < yieldIntervalFastTimerCount) {
+		return;
 	}
-	xmlArea = IN_TAG_PAST_NAME; // How it'll be after this next call
-	return readIntUntilChar(charAtEndOfValue);
-}
 
-// Only call if PAST_ATTRIBUTE_NAME or PAST_EQUALS_SIGN
-int32_t StorageManager::readAttributeValueString(String* string) {
+	AudioEngine::routineWithClusterLoading();
 
-	if (!getIntoAttributeValue()) {
-		string->clear();
-		return NO_ERROR;
-	}
-	else {
-		int32_t error = readStringUntilChar(string, charAtEndOfValue);
-		if (!error) {
-			xmlArea = IN_TAG_PAST_NAME;
-		}
-		return error;
-	}
-}
+	uiTimerManager.routine();
 
-void StorageManager::xmlReadDone() {
-	xmlReadCount++; // Increment first, cos we don't want to call SD routine immediately when it's 0
-
-	if (!(xmlReadCount & 63)) { // 511 bad. 255 almost fine. 127 almost always fine
-		AudioEngine::routineWithClusterLoading();
-
-		uiTimerManager.routine();
-
-		if (display->haveOLED()) {
-			oledRoutine();
-		}
-		PIC::flush();
+	if (display->haveOLED()) {
+		oledRoutine();
 	}
-}
-
-void StorageManager::skipUntilChar(char endChar) {
-
-	readXMLFileClusterIfNecessary(); // Does this need to be here? Originally I didn't have it...
-	do {
-		while (fileBufferCurrentPos < currentReadBufferEndPos && fileClusterBuffer[fileBufferCurrentPos] != endChar) {
-			fileBufferCurrentPos++;
-		}
-
-	} while (fileBufferCurrentPos == currentReadBufferEndPos && readXMLFileClusterIfNecessary());
-
-	fileBufferCurrentPos++; // Gets us past the endChar
+	PIC::flush();
 
-	xmlReadDone();
-}
-
-// Returns memory error. If error, caller must deal with the fact that the end-character hasn't been reached
-int32_t StorageManager::readStringUntilChar(String* string, char endChar) {
-
-	int32_t newStringPos = 0;
-
-	do {
-		int32_t bufferPosNow = fileBufferCurrentPos;
-		while (bufferPosNow < currentReadBufferEndPos && fileClusterBuffer[bufferPosNow] != endChar) {
-			bufferPosNow++;
-		}
-
-		int32_t numCharsHere = bufferPosNow - fileBufferCurrentPos;
-
-		if (numCharsHere) {
-			int32_t error =
-			    string->concatenateAtPos(&fileClusterBuffer[fileBufferCurrentPos], newStringPos, numCharsHere);
-
-			fileBufferCurrentPos = bufferPosNow;
-
-			if (error) {
-				return error;
-			}
-
-			newStringPos += numCharsHere;
-		}
-
-	} while (fileBufferCurrentPos == currentReadBufferEndPos && readXMLFileClusterIfNecessary());
-
-	fileBufferCurrentPos++; // Gets us past the endChar
-
-	xmlReadDone();
-	return NO_ERROR;
-}
-
-char const* StorageManager::readUntilChar(char endChar) {
-	int32_t charPos = 0;
-
-	do {
-		int32_t bufferPosAtStart = fileBufferCurrentPos;
-		while (fileBufferCurrentPos < currentReadBufferEndPos && fileClusterBuffer[fileBufferCurrentPos] != endChar) {
-			fileBufferCurrentPos++;
-		}
-
-		// If possible, just return a pointer to the chars within the existing buffer
-		if (!charPos && fileBufferCurrentPos < currentReadBufferEndPos) {
-			fileClusterBuffer[fileBufferCurrentPos] = 0;
-
-			fileBufferCurrentPos++; // Gets us past the endChar
-			return &fileClusterBuffer[bufferPosAtStart];
-		}
-
-		int32_t numCharsHere = fileBufferCurrentPos - bufferPosAtStart;
-		int32_t numCharsToCopy = std::min<int32_t>(numCharsHere, kFilenameBufferSize - 1 - charPos);
-
-		if (numCharsToCopy > 0) {
-			memcpy(&stringBuffer[charPos], &fileClusterBuffer[bufferPosAtStart], numCharsToCopy);
-
-			charPos += numCharsToCopy;
-		}
-
-	} while (fileBufferCurrentPos == currentReadBufferEndPos && readXMLFileClusterIfNecessary());
-
-	fileBufferCurrentPos++; // Gets us past the endChar
-
-	xmlReadDone();
-
-	stringBuffer[charPos] = 0;
-	return stringBuffer;
-}
-
-// Unlike readUntilChar(), above, does not put a null character at the end of the returned "string". And, has a preset
-// number of chars. And, returns NULL when nothing more to return. numChars must be <= FILENAME_BUFFER_SIZE
-char const* StorageManager::readNextCharsOfTagOrAttributeValue(int32_t numChars) {
-
-	int32_t charPos = 0;
-
-	do {
-		int32_t bufferPosAtStart = fileBufferCurrentPos;
-		int32_t bufferPosAtEnd = bufferPosAtStart + numChars - charPos;
-
-		int32_t currentReadBufferEndPosNow = std::min<int32_t>(currentReadBufferEndPos, bufferPosAtEnd);
-
-		while (fileBufferCurrentPos < currentReadBufferEndPosNow) {
-			if (fileClusterBuffer[fileBufferCurrentPos] == charAtEndOfValue) {
-				goto reachedEndCharEarly;
-			}
-			fileBufferCurrentPos++;
-		}
-
-		int32_t numCharsHere = fileBufferCurrentPos - bufferPosAtStart;
-
-		// If we were able to just read the whole thing in one go, just return a pointer to the chars within the
-		// existing buffer
-		if (numCharsHere == numChars) {
-			xmlReadDone();
-			return &fileClusterBuffer[bufferPosAtStart];
-		}
-
-		// Otherwise, so long as we read something, add it to our buffer we're putting the output in
-		if (numCharsHere > 0) {
-			memcpy(&stringBuffer[charPos], &fileClusterBuffer[bufferPosAtStart], numCharsHere);
-
-			charPos += numCharsHere;
-
-			// And if we've now got all the chars we needed, return
-			if (charPos == numChars) {
-				xmlReadDone();
-				return stringBuffer;
-			}
-		}
-
-	} while (fileBufferCurrentPos == currentReadBufferEndPos && readXMLFileClusterIfNecessary());
-
-	// If we're here, the file ended
-	return NULL;
-
-	// And, additional bit we jump to when end-char reached
-reachedEndCharEarly:
-	fileBufferCurrentPos++; // Gets us past the endChar
-	if (charAtEndOfValue == '<') {
-		xmlArea = IN_TAG_NAME;
-	}
-	else {
-		xmlArea = IN_TAG_PAST_NAME; // Could be ' or "
-	}
-	return NULL;
-}
-
-// This is almost never called now - TODO: get rid
-char StorageManager::readNextCharOfTagOrAttributeValue() {
-
-	char thisChar;
-	if (!readCharXML(&thisChar)) {
-		return 0;
-	}
-	if (thisChar == charAtEndOfValue) {
-		if (charAtEndOfValue == '<') {
-			xmlArea = IN_TAG_NAME;
-		}
-		else {
-			xmlArea = IN_TAG_PAST_NAME; // Could be ' or "
-		}
-		xmlReadDone();
-		return 0;
-	}
-	return thisChar;
-}
-
-// Will always skip up until the end-char, even if it doesn't like the contents it sees
-int32_t StorageManager::readIntUntilChar(char endChar) {
-	uint32_t number = 0;
-	char thisChar;
-
-	if (!readCharXML(&thisChar)) {
-		return 0;
-	}
-
-	bool isNegative = (thisChar == '-');
-	if (!isNegative) {
-		goto readDigit;
-	}
-
-	while (readCharXML(&thisChar)) {
-readDigit:
-		if (!(thisChar >= '0' && thisChar <= '9')) {
-			goto getOut;
-		}
-		number *= 10;
-		number += (thisChar - '0');
-	}
-
-	if (false) {
-getOut:
-		if (thisChar != endChar) {
-			skipUntilChar(endChar);
-		}
-	}
-
-	if (isNegative) {
-		if (number >= 2147483648) {
-			return -2147483648;
-		}
-		else {
-			return -(int32_t)number;
-		}
-	}
-	else {
-		return number;
-	}
-}
-
-char const* StorageManager::readTagOrAttributeValue() {
-
-	switch (xmlArea) {
-
-	case BETWEEN_TAGS:
-		xmlArea = IN_TAG_NAME; // How it'll be after this call
-		return readUntilChar('<');
-
-	case PAST_ATTRIBUTE_NAME:
-	case PAST_EQUALS_SIGN:
-		return readAttributeValue();
-
-	case IN_TAG_PAST_NAME: // Could happen if trying to read a value but instead of a value there are multiple more
-	                       // contents, like attributes etc. Obviously not "meant" to happen, but we need to cope.
-		return "";
-
-	default:
-		FREEZE_WITH_ERROR("BBBB");
-		__builtin_unreachable();
-	}
-}
-
-int32_t StorageManager::readTagOrAttributeValueInt() {
-
-	switch (xmlArea) {
-
-	case BETWEEN_TAGS:
-		xmlArea = IN_TAG_NAME; // How it'll be after this call
-		return readIntUntilChar('<');
-
-	case PAST_ATTRIBUTE_NAME:
-	case PAST_EQUALS_SIGN:
-		return readAttributeValueInt();
-
-	case IN_TAG_PAST_NAME: // Could happen if trying to read a value but instead of a value there are multiple more
-	                       // contents, like attributes etc. Obviously not "meant" to happen, but we need to cope.
-		return 0;
-
-	default:
-		FREEZE_WITH_ERROR("BBBB");
-		__builtin_unreachable();
-	}
-}
-
-// This isn't super optimal, like the int32_t version is, but only rarely used
-int32_t StorageManager::readTagOrAttributeValueHex(int32_t errorValue) {
-	char const* string = readTagOrAttributeValue();
-	if (string[0] != '0' || string[1] != 'x') {
-		return errorValue;
-	}
-	return hexToInt(&string[2]);
-}
-
-// Returns memory error
-int32_t StorageManager::readTagOrAttributeValueString(String* string) {
-
-	int32_t error;
-
-	switch (xmlArea) {
-	case BETWEEN_TAGS:
-		error = readStringUntilChar(string, '<');
-		if (!error) {
-			xmlArea = IN_TAG_NAME;
-		}
-		return error;
-
-	case PAST_ATTRIBUTE_NAME:
-	case PAST_EQUALS_SIGN:
-		return readAttributeValueString(string);
-
-	case IN_TAG_PAST_NAME: // Could happen if trying to read a value but instead of a value there are multiple more
-	                       // contents, like attributes etc. Obviously not "meant" to happen, but we need to cope.
-		return ERROR_FILE_CORRUPTED;
-
-	default:
-		if (ALPHA_OR_BETA_VERSION) {
-			FREEZE_WITH_ERROR("BBBB");
-		}
-		__builtin_unreachable();
-	}
-}
-
-int32_t StorageManager::getNumCharsRemainingInValue() {
-
-	int32_t pos = fileBufferCurrentPos;
-	while (pos < currentReadBufferEndPos && fileClusterBuffer[pos] != charAtEndOfValue) {
-		pos++;
-	}
-
-	return pos - fileBufferCurrentPos;
-}
-
-// Returns whether we're all good to go
-bool StorageManager::prepareToReadTagOrAttributeValueOneCharAtATime() {
-	switch (xmlArea) {
-
-	case BETWEEN_TAGS:
-		// xmlArea = IN_TAG_NAME; // How it'll be after reading all chars
-		charAtEndOfValue = '<';
-		return true;
-
-	case PAST_ATTRIBUTE_NAME:
-	case PAST_EQUALS_SIGN:
-		return getIntoAttributeValue();
-
-	default:
-		if (ALPHA_OR_BETA_VERSION) {
-			FREEZE_WITH_ERROR("CCCC");
-		}
-		__builtin_unreachable();
-	}
-}
-
-// Returns whether successful loading took place
-bool StorageManager::readXMLFileClusterIfNecessary() {
-
-	// Load next Cluster if necessary
-	if (fileBufferCurrentPos >= audioFileManager.clusterSize) {
-		xmlReadCount = 0;
-		bool result = readXMLFileCluster();
-		if (!result) {
-			xmlReachedEnd = true;
-		}
-		return result;
-	}
-
-	// Watch out for end of file
-	if (fileBufferCurrentPos >= currentReadBufferEndPos) {
-		xmlReachedEnd = true;
-	}
-
-	return false;
-}
-
-uint32_t StorageManager::readCharXML(char* thisChar) {
-
-	bool stillGoing = readXMLFileClusterIfNecessary();
-	if (xmlReachedEnd) {
-		return 0;
-	}
-
-	*thisChar = fileClusterBuffer[fileBufferCurrentPos];
-
-	fileBufferCurrentPos++;
-
-	return 1;
-}
-
-void StorageManager::exitTag(char const* exitTagName) {
-	// back out the file depth to one less than the caller depth
-	while (tagDepthFile >= tagDepthCaller) {
-
-		if (xmlReachedEnd) {
-			return;
-		}
-
-		switch (xmlArea) {
-
-		case IN_ATTRIBUTE_VALUE: // Could get left in here after a char-at-a-time read
-			skipUntilChar(charAtEndOfValue);
-			xmlArea = IN_TAG_PAST_NAME;
-			// No break
-
-		case IN_TAG_PAST_NAME:
-			readNextAttributeName();
-			break;
-
-		case PAST_ATTRIBUTE_NAME:
-		case PAST_EQUALS_SIGN:
-			readAttributeValue();
-			break;
-
-		case BETWEEN_TAGS:
-			skipUntilChar('<');
-			xmlArea = IN_TAG_NAME;
-			// Got to next tag start
-			// No break
-
-		case IN_TAG_NAME:
-			readTagName();
-			break;
-
-		default:
-			if (ALPHA_OR_BETA_VERSION) {
-				FREEZE_WITH_ERROR("AAAA"); // Really shouldn't be possible anymore, I feel fairly certain...
-			}
-			__builtin_unreachable();
-		}
-	}
-	// It is possible for caller and file tag depths to get out of sync due to faulty error handling
-	// On exit reset the caller depth to match tag depth. File depth represents the parsers view of
-	// where we are in the xml parsing, caller depth represents the callers view. The caller can be shallower
-	// as the file will open past empty or unused tags, but should never be deeper.
-	tagDepthCaller = tagDepthFile;
+	timeLastYielded = *TCNT[TIMER_SYSTEM_FAST];
 }
 
 void StorageManager::readMidiCommand(uint8_t* channel, uint8_t* note) {
@@ -1041,6 +328,24 @@ int32_t StorageManager::createXMLFile(char const* filePath, bool mayOverwrite, b
 	return NO_ERROR;
 }
 
+void StorageManager::createXMLFileInMemory(MemoryFile* memoryFile) {
+	memoryFileBeingWritten = memoryFile;
+
+	fileBufferCurrentPos = 0;
+	fileTotalBytesWritten = 0;
+	fileAccessFailedDuring = false;
+
+	write("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
+
+	indentAmount = 0;
+}
+
+int32_t StorageManager::finishWritingToMemory() {
+	int32_t error = fileAccessFailedDuring ? ERROR_INSUFFICIENT_RAM : writeBufferToFile();
+	memoryFileBeingWritten = NULL;
+	return error;
+}
+
 bool StorageManager::fileExists(char const* pathName) {
 	int32_t error = initSD();
 	if (error) {
@@ -1070,10 +375,10 @@ bool StorageManager::fileExists(char const* pathName, FilePointer* fp) {
 	return true;
 }
 
-// TODO: this is really inefficient
 void StorageManager::write(char const* output) {
 
-	while (*output) {
+	int32_t numCharsLeft = strlen(output);
+	while (numCharsLeft) {
 
 		if (fileBufferCurrentPos == audioFileManager.clusterSize) {
 
@@ -1088,28 +393,28 @@ void StorageManager::write(char const* output) {
 			fileBufferCurrentPos = 0;
 		}
 
-		fileClusterBuffer[fileBufferCurrentPos] = *output;
-
-		output++;
-		fileBufferCurrentPos++;
-
-		// Ensure we do some of the audio routine once in a while
-		if (!(fileBufferCurrentPos & 0b11111111)) {
-			AudioEngine::logAction("writeCharXML");
+		int32_t numCharsHere =
+		    std::min<int32_t>(numCharsLeft, audioFileManager.clusterSize - fileBufferCurrentPos);
+		memcpy(&fileClusterBuffer[fileBufferCurrentPos], output, numCharsHere);
 
-			AudioEngine::routineWithClusterLoading();
+		output += numCharsHere;
+		numCharsLeft -= numCharsHere;
+		fileBufferCurrentPos += numCharsHere;
+	}
 
-			uiTimerManager.routine();
+	yieldToRoutinesIfDue();
+}
 
-			if (display->haveOLED()) {
-				oledRoutine();
-			}
-			PIC::flush();
+int32_t StorageManager::writeBufferToFile() {
+	if (memoryFileBeingWritten) {
+		int32_t error = memoryFileBeingWritten->append(fileClusterBuffer, fileBufferCurrentPos);
+		if (error) {
+			return error;
 		}
+		fileTotalBytesWritten += fileBufferCurrentPos;
+		return NO_ERROR;
 	}
-}
 
-int32_t StorageManager::writeBufferToFile() {
 	UINT bytesWritten;
 	FRESULT result = f_write(&fileSystemStuff.currentFile, fileClusterBuffer, fileBufferCurrentPos, &bytesWritten);
 	if (result != FR_OK || bytesWritten != fileBufferCurrentPos) {
@@ -1190,6 +495,79 @@ int32_t StorageManager::closeFileAfterWriting(char const* path, char const* begi
 	return NO_ERROR;
 }
 
+namespace {
+class FileSource : public BinarySongFormat::Source {
+public:
+	FileSource(FIL* file) : file(file) {}
+
+	int32_t read(void* buffer, int32_t maxNumBytes) override {
+		UINT numBytesRead;
+		if (f_read(file, buffer, maxNumBytes, &numBytesRead) != FR_OK) {
+			return -1;
+		}
+		storageManager.yieldToRoutinesIfDue();
+		return numBytesRead;
+	}
+
+	FIL* file;
+};
+
+class FileSink : public BinarySongFormat::Sink {
+public:
+	FileSink(FIL* file) : file(file) {}
+
+	bool write(void const* data, int32_t numBytes) override {
+		UINT numBytesWritten;
+		return (f_write(file, data, numBytes, &numBytesWritten) == FR_OK && numBytesWritten == numBytes);
+	}
+
+	bool writeAt(uint32_t pos, void const* data, int32_t numBytes) override {
+		FSIZE_t posNow = f_tell(file);
+		return (f_lseek(file, pos) == FR_OK && write(data, numBytes) && f_lseek(file, posNow) == FR_OK);
+	}
+
+	FIL* file;
+};
+} // namespace
+
+// Swaps an XML file that's just been written for the same thing in BinarySongFormat. That gets written to tempPath
+// first, so if anything goes wrong, the XML's still there
+int32_t StorageManager::convertFileToBinary(char const* path, char const* tempPath) {
+	AudioEngine::logAction("convertFileToBinary");
+
+	FIL xmlFile;
+	FRESULT result = f_open(&xmlFile, path, FA_READ);
+	if (result != FR_OK) {
+		return fresultToDelugeErrorCode(result);
+	}
+
+	int32_t error = createFile(&fileSystemStuff.currentFile, tempPath, true);
+	if (error) {
+		f_close(&xmlFile);
+		return error;
+	}
+
+	FileSource source(&xmlFile);
+	FileSink sink(&fileSystemStuff.currentFile);
+	error = BinarySongFormat::convertXMLToBinary(source, sink);
+	f_close(&xmlFile);
+	result = f_close(&fileSystemStuff.currentFile);
+	if (!error && result != FR_OK) {
+		error = ERROR_WRITE_FAIL;
+	}
+	if (error) {
+		f_unlink(tempPath);
+		return error;
+	}
+
+	result = f_unlink(path);
+	if (result != FR_OK) {
+		f_unlink(tempPath);
+		return fresultToDelugeErrorCode(result);
+	}
+	return fresultToDelugeErrorCode(f_rename(tempPath, path));
+}
+
 bool StorageManager::lseek(uint32_t pos) {
 	FRESULT result = f_lseek(&fileSystemStuff.currentFile, pos);
 	if (result != FR_OK) {
@@ -1205,17 +583,17 @@ int32_t StorageManager::openXMLFile(FilePointer* filePointer, char const* firstT
 	AudioEngine::logAction("openXMLFile");
 
 	openFilePointer(filePointer);
+	startReadingXML();
 
-	// Prep to read first Cluster shortly
-	fileBufferCurrentPos = audioFileManager.clusterSize;
-	currentReadBufferEndPos = audioFileManager.clusterSize;
-
-	firmwareVersionOfFileBeingRead = FIRMWARE_OLD;
-
-	tagDepthFile = 0;
-	tagDepthCaller = 0;
-	xmlReachedEnd = false;
-	xmlArea = BETWEEN_TAGS;
+	// A binary song starts with its own header, and the XML comes after that
+	if (readXMLFileCluster() && currentReadBufferEndPos >= sizeof(BinarySongFormat::FileHeader)
+	    && *(uint32_t*)fileClusterBuffer == BinarySongFormat::kMagic) {
+		int32_t error = skipToBinaryDocument();
+		if (error) {
+			f_close(&fileSystemStuff.currentFile);
+			return error;
+		}
+	}
 
 	char const* tagName;
 
@@ -1236,6 +614,28 @@ int32_t StorageManager::openXMLFile(FilePointer* filePointer, char const* firstT
 	return ERROR_FILE_CORRUPTED;
 }
 
+int32_t StorageManager::skipToBinaryDocument() {
+	BinarySongFormat::FileHeader fileHeader;
+	readRawBytes(&fileHeader, sizeof(fileHeader));
+	if (fileHeader.version > BinarySongFormat::kVersion) {
+		return ERROR_FILE_FIRMWARE_VERSION_TOO_NEW;
+	}
+
+	// Skip any chunks we don't know
+	while (true) {
+		BinarySongFormat::ChunkHeader chunkHeader;
+		if (!readRawBytes(&chunkHeader, sizeof(chunkHeader))) {
+			return ERROR_FILE_CORRUPTED;
+		}
+		if (chunkHeader.id == BinarySongFormat::kDocumentChunk) {
+			return NO_ERROR;
+		}
+		if (!readRawBytes(NULL, chunkHeader.length)) {
+			return ERROR_FILE_CORRUPTED;
+		}
+	}
+}
+
 int32_t StorageManager::tryReadingFirmwareTagFromFile(char const* tagName, bool ignoreIncorrectFirmware) {
 
 	if (!strcmp(tagName, "firmwareVersion")) {
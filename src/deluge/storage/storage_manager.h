@@ -18,6 +18,7 @@
 #pragma once
 
 #include "definitions_cxx.hpp"
+#include "storage/binary_song_format.h"
 #include <cstdint>
 
 extern "C" {
@@ -45,6 +46,7 @@ class String;
 class MIDIParamCollection;
 class ParamManager;
 class SoundDrum;
+class MemoryFile;
 
 class StorageManager {
 public:
@@ -67,9 +69,13 @@ public:
 
 	int32_t createFile(FIL* file, char const* filePath, bool mayOverwrite);
 	int32_t createXMLFile(char const* pathName, bool mayOverwrite = false, bool displayErrors = true);
+	// Like createXMLFile(), but what's written goes into memoryFile instead of onto the card, until
+	// finishWritingToMemory(). That returns an error code
+	void createXMLFileInMemory(MemoryFile* memoryFile);
+	int32_t finishWritingToMemory();
 	int32_t openXMLFile(FilePointer* filePointer, char const* firstTagName, char const* altTagName = "",
 	                    bool ignoreIncorrectFirmware = false);
-	bool prepareToReadTagOrAttributeValueOneCharAtATime();
+	bool prepareToReadTagOrAttributeValueOneCharAtATime(bool mayBeBinary = false);
 	char readNextCharOfTagOrAttributeValue();
 	char const* readNextCharsOfTagOrAttributeValue(int32_t numChars);
 	void readMidiCommand(uint8_t* channel, uint8_t* note = NULL);
@@ -108,6 +114,19 @@ public:
 	int32_t readTagOrAttributeValueString(String* string);
 	int32_t checkSpaceOnCard();
 
+	// In a binary song, note data and automation values can be binary - see BinarySongFormat. Whatever reads those
+	// passes mayBeBinary to prepareToReadTagOrAttributeValueOneCharAtATime(), then if getBinaryValueKind() isn't NONE,
+	// reads the value a run at a time with these. Any other reader just sees an empty value
+	BinarySongFormat::ValueKind getBinaryValueKind() { return binaryValueKind; }
+	int32_t getBinaryValueHeader() { return binaryValueHeader; }
+	int32_t readBinaryValueRunLength();
+	bool readBinaryBytes(void* dest, int32_t numBytes);
+
+	int32_t convertFileToBinary(char const* path, char const* tempPath);
+
+	// Call often during any long job on what's been read, as readers and writers here do themselves
+	void yieldToRoutinesIfDue();
+
 	SyncType readSyncTypeFromFile(Song* song);
 	void writeSyncTypeToFile(Song* song, char const* name, SyncType value, bool onNewLine = true);
 	SyncLevel readAbsoluteSyncLevelFromFile(Song* song);
@@ -134,26 +153,46 @@ public:
 private:
 	uint8_t indentAmount;
 
+	// Where in the XML we've read up to
+	enum : uint8_t {
+		BETWEEN_TAGS,
+		IN_TAG_NAME,
+		IN_TAG_PAST_NAME,
+		IN_ATTRIBUTE_NAME,
+		PAST_ATTRIBUTE_NAME,
+		PAST_EQUALS_SIGN,
+		IN_ATTRIBUTE_VALUE,
+	};
 	uint8_t xmlArea;
 	bool xmlReachedEnd;
 	int32_t tagDepthCaller; // How deeply indented in XML the main Deluge classes think we are, as data being read.
 	int32_t tagDepthFile; // Will temporarily be different to the above as unwanted / unused XML tags parsed on the way
 	                      // to finding next useful data.
-	int32_t xmlReadCount;
+	uint16_t timeLastYielded; // On TIMER_SYSTEM_FAST
+
+	BinarySongFormat::ValueKind binaryValueKind; // Of the attribute value we're in, if IN_ATTRIBUTE_VALUE
+	int32_t binaryValueHeader;
+	uint32_t binaryBytesLeftInRun;
+
+	MemoryFile* memoryFileBeingWritten; // Or NULL if writing to the card
 
+	void startReadingXML();
+	int32_t findCharInBuffer(char endChar);
 	void skipUntilChar(char endChar);
 	char const* readTagName();
 	char const* readNextAttributeName();
 	char const* readUntilChar(char endChar);
 	char const* readAttributeValue();
 	int32_t readIntUntilChar(char endChar);
-	bool getIntoAttributeValue();
+	bool getIntoAttributeValue(bool mayBeBinary = false);
 	int32_t readAttributeValueInt();
 	bool readXMLFileClusterIfNecessary();
 	int32_t readStringUntilChar(String* string, char endChar);
 	int32_t readAttributeValueString(String* string);
 	void restoreBackedUpCharIfNecessary();
-	void xmlReadDone();
+	bool readRawBytes(void* dest, uint32_t numBytes);
+	void skipRestOfValue();
+	int32_t skipToBinaryDocument();
 
 	int32_t writeBufferToFile();
 };
@@ -64,6 +64,18 @@ void WaveTable::bandDataBeingStolen(WaveTableBandData* bandData) {
 	}
 }
 
+void WaveTable::bandDataRelocated(WaveTableBandData* oldBandData, WaveTableBandData* newBandData) {
+	for (int32_t b = 0; b < bands.getNumElements(); b++) {
+		WaveTableBand* band = (WaveTableBand*)bands.getElementAddress(b);
+		if (band->data == oldBandData) {
+			band->data = newBandData;
+			band->dataAccessAddress =
+			    (int16_t*)((uint32_t)band->dataAccessAddress + (uint32_t)newBandData - (uint32_t)oldBandData);
+			break;
+		}
+	}
+}
+
 #define numBitsInInput 16
 #define numBitsInTableSize 8
 #define lshiftAmount (16 + numBitsInTableSize - numBitsInInput)
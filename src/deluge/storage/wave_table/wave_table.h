@@ -51,6 +51,7 @@ public:
 	              WaveTableReader* reader = NULL);
 	void deleteAllBandsAndData();
 	void bandDataBeingStolen(WaveTableBandData* bandData);
+	void bandDataRelocated(WaveTableBandData* oldBandData, WaveTableBandData* newBandData);
 
 	int32_t numCycles;
 	int32_t numCyclesMagnitude;
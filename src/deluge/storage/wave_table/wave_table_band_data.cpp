@@ -48,3 +48,12 @@ void WaveTableBandData::steal(char const* errorCode) {
 int32_t WaveTableBandData::getAppropriateQueue() {
 	return STEALABLE_QUEUE_NO_SONG_WAVETABLE_BAND_DATA;
 }
+
+// Only while nothing's playing from us - Voices read straight from dataAccessAddress
+bool WaveTableBandData::mayBeRelocated() {
+	return (waveTable && !waveTable->numReasonsToBeLoaded);
+}
+
+void WaveTableBandData::relocated(Stealable* oldAddress) {
+	waveTable->bandDataRelocated((WaveTableBandData*)oldAddress, this);
+}
@@ -28,6 +28,8 @@ public:
 	bool mayBeStolen(void* thingNotToStealFrom = nullptr);
 	void steal(char const* errorCode);
 	int32_t getAppropriateQueue();
+	bool mayBeRelocated();
+	void relocated(Stealable* oldAddress);
 
 	WaveTable* waveTable;
 };
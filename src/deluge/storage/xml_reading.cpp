@@ -0,0 +1,862 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "storage/storage_manager.h"
+#include "definitions_cxx.hpp"
+#include "hid/display/display.h"
+#include "processing/engines/audio_engine.h"
+#include "storage/audio/audio_file_manager.h"
+#include "util/d_string.h"
+#include <string.h>
+
+// StorageManager's XML reading. It gets at the file only through readXMLFileCluster() and yieldToRoutinesIfDue(),
+// which stay in storage_manager.cpp, so the unit tests can build this with those faked
+
+char stringBuffer[kFilenameBufferSize] __attribute__((aligned(CACHE_LINE_SIZE)));
+
+// Once the file's open, before the first readXMLFileCluster()
+void StorageManager::startReadingXML() {
+	// Prep to read first Cluster shortly
+	fileBufferCurrentPos = audioFileManager.clusterSize;
+	currentReadBufferEndPos = audioFileManager.clusterSize;
+
+	firmwareVersionOfFileBeingRead = FIRMWARE_OLD;
+
+	tagDepthFile = 0;
+	tagDepthCaller = 0;
+	xmlReachedEnd = false;
+	xmlArea = BETWEEN_TAGS;
+	binaryValueKind = BinarySongFormat::ValueKind::NONE;
+}
+
+// Adds chars from the file buffer onto what's in stringBuffer so far, as much as fits. Returns the new length
+static int32_t appendToStringBuffer(char const* chars, int32_t numChars, int32_t charPos) {
+	int32_t numCharsToCopy = std::min<int32_t>(numChars, kFilenameBufferSize - 1 - charPos);
+	if (numCharsToCopy > 0) {
+		memcpy(&stringBuffer[charPos], chars, numCharsToCopy);
+		charPos += numCharsToCopy;
+	}
+	return charPos;
+}
+
+static inline bool isTagNameEnd(char thisChar) {
+	switch (thisChar) {
+	case '/':
+	case ' ':
+	case '\r':
+	case '\n':
+	case '\t':
+	case '?':
+	case '>':
+		return true;
+	default:
+		return false;
+	}
+}
+
+// Only call this if IN_TAG_NAME. If the whole name is within the buffer, returns it from there rather than copying it
+char const* StorageManager::readTagName() {
+
+	char const* toReturn = stringBuffer;
+	int32_t charPos = 0;
+	bool haveNameChars = false;
+
+	while (true) {
+		int32_t bufferPosAtStart = fileBufferCurrentPos;
+		while (fileBufferCurrentPos < currentReadBufferEndPos
+		       && !isTagNameEnd(fileClusterBuffer[fileBufferCurrentPos])) {
+			fileBufferCurrentPos++;
+		}
+		int32_t numCharsHere = fileBufferCurrentPos - bufferPosAtStart;
+		if (numCharsHere) {
+			haveNameChars = true;
+		}
+
+		// Name continues into the next Cluster, or the file ended
+		if (fileBufferCurrentPos >= currentReadBufferEndPos) {
+			charPos = appendToStringBuffer(&fileClusterBuffer[bufferPosAtStart], numCharsHere, charPos);
+			if (readXMLFileClusterIfNecessary()) {
+				continue;
+			}
+			yieldToRoutinesIfDue();
+			break;
+		}
+
+		char endChar = fileClusterBuffer[fileBufferCurrentPos];
+
+		// A "<?xml ...?>" or similar. Skip it, and read the next tag's name instead
+		if (endChar == '?') {
+			charPos = appendToStringBuffer(&fileClusterBuffer[bufferPosAtStart], numCharsHere, charPos);
+			skipUntilChar('>');
+			skipUntilChar('<');
+			continue;
+		}
+
+		// A closing tag, or the end of one with no contents. Skipping to its end could load the next Cluster, so the
+		// name has to be copied out first
+		if (endChar == '/') {
+			charPos = appendToStringBuffer(&fileClusterBuffer[bufferPosAtStart], numCharsHere, charPos);
+			tagDepthFile--;
+			fileBufferCurrentPos++;
+			skipUntilChar('>');
+			xmlArea = BETWEEN_TAGS;
+			break;
+		}
+
+		xmlArea = (endChar == '>') ? BETWEEN_TAGS : IN_TAG_PAST_NAME;
+
+		if (!charPos) {
+			fileClusterBuffer[fileBufferCurrentPos] = 0; // NULL end of the string we're returning
+			toReturn = &fileClusterBuffer[bufferPosAtStart];
+		}
+		else {
+			charPos = appendToStringBuffer(&fileClusterBuffer[bufferPosAtStart], numCharsHere, charPos);
+		}
+		fileBufferCurrentPos++; // Gets us past the endChar
+		yieldToRoutinesIfDue();
+		break;
+	}
+
+	if (haveNameChars) {
+		tagDepthFile++;
+	}
+
+	stringBuffer[charPos] = 0;
+	return toReturn;
+}
+
+// Only call when IN_TAG_PAST_NAME
+char const* StorageManager::readNextAttributeName() {
+
+	char thisChar;
+	int32_t charPos = 0;
+
+	while (readCharXML(&thisChar)) {
+		switch (thisChar) {
+		case ' ':
+		case '\r':
+		case '\n':
+		case '\t':
+			break;
+
+		case '/':
+			tagDepthFile--;
+			skipUntilChar('>');
+			// No break
+
+		case '>':
+			xmlArea = BETWEEN_TAGS;
+			// No break
+
+		case '<': // This is an error - there definitely shouldn't be a '<' inside a tag! TODO: make way to return error
+			goto noMoreAttributes;
+
+		default:
+			goto doReadName;
+		}
+	}
+
+noMoreAttributes:
+	return "";
+
+	// Here, we're in IN_ATTRIBUTE_NAME, and we're not allowed to leave this while loop until our xmlArea changes to
+	// something else
+	// - or there's an error or file-end, in which case we'll return error below
+doReadName:
+	xmlArea = IN_ATTRIBUTE_NAME;
+	tagDepthFile++;
+	fileBufferCurrentPos--; // This means we don't need to call readXMLFileClusterIfNecessary()
+
+	bool haveReachedNameEnd = false;
+
+	// This is basically copied and tweaked from readUntilChar()
+	do {
+		int32_t bufferPosAtStart = fileBufferCurrentPos;
+		while (fileBufferCurrentPos < currentReadBufferEndPos) {
+			char thisChar = fileClusterBuffer[fileBufferCurrentPos];
+
+			switch (thisChar) {
+			case ' ':
+			case '\r':
+			case '\n':
+			case '\t':
+				xmlArea = PAST_ATTRIBUTE_NAME;
+				goto reachedNameEnd;
+
+			case '=':
+				xmlArea = PAST_EQUALS_SIGN;
+				goto reachedNameEnd;
+
+			// If we get a close-tag name, it means we saw some sorta attribute name with no value, which isn't allowed,
+			// so treat it as invalid
+			case '>':
+				xmlArea = BETWEEN_TAGS;
+				goto noMoreAttributes;
+
+				// TODO: a '/' should get us outta here too...
+			}
+
+			fileBufferCurrentPos++;
+		}
+
+		if (false) {
+reachedNameEnd:
+			yieldToRoutinesIfDue();
+			haveReachedNameEnd = true;
+			// If possible, just return a pointer to the chars within the existing buffer
+			if (!charPos && fileBufferCurrentPos < currentReadBufferEndPos) {
+				fileClusterBuffer[fileBufferCurrentPos] = 0; // NULL end of the string we're returning
+				fileBufferCurrentPos++;                      // Gets us past the endChar
+				return &fileClusterBuffer[bufferPosAtStart];
+			}
+		}
+
+		charPos = appendToStringBuffer(&fileClusterBuffer[bufferPosAtStart], fileBufferCurrentPos - bufferPosAtStart,
+		                               charPos);
+
+		if (haveReachedNameEnd) {
+			stringBuffer[charPos] = 0;
+			fileBufferCurrentPos++; // Gets us past the endChar
+			return stringBuffer;
+		}
+
+	} while (fileBufferCurrentPos == currentReadBufferEndPos && readXMLFileClusterIfNecessary());
+
+	// If here, file ended
+	return "";
+}
+
+char charAtEndOfValue;
+
+char const* StorageManager::readNextTagOrAttributeName() {
+
+	char const* toReturn;
+	int32_t tagDepthStart = tagDepthFile;
+
+	switch (xmlArea) {
+
+	default:
+#if ALPHA_OR_BETA_VERSION
+		// Can happen with invalid files, though I'm implementing error checks whenever a user alerts me to a scenario.
+		// Fraser got this, Nov 2021.
+		FREEZE_WITH_ERROR("E365");
+#else
+		__builtin_unreachable();
+#endif
+		break;
+
+	case IN_ATTRIBUTE_VALUE: // Could have been left here during a char-at-a-time read
+		skipRestOfValue();
+		// No break
+
+	case IN_TAG_PAST_NAME:
+		toReturn = readNextAttributeName();
+		// If depth has changed, this means we met a /> and must get out
+		if (*toReturn || tagDepthFile != tagDepthStart) {
+			break;
+		}
+		// No break
+
+	case BETWEEN_TAGS:
+		skipUntilChar('<');
+		xmlArea = IN_TAG_NAME;
+		// No break
+
+	case IN_TAG_NAME:
+		toReturn = readTagName();
+	}
+
+	if (*toReturn) {
+		/*
+		for (int32_t t = 0; t < tagDepthCaller; t++) {
+D_PRINTLN("\t");
+		}
+		D_PRINTLN(toReturn);
+		*/
+		tagDepthCaller++;
+		AudioEngine::logAction(toReturn);
+	}
+
+	return toReturn;
+}
+
+// Only call if PAST_ATTRIBUTE_NAME or PAST_EQUALS_SIGN
+// Returns the quote character that opens the value - or 0 if fail. A binary value gets skipped unless mayBeBinary -
+// then 0 gets returned for that too
+bool StorageManager::getIntoAttributeValue(bool mayBeBinary) {
+
+	char thisChar;
+
+	switch (xmlArea) {
+	case PAST_ATTRIBUTE_NAME:
+		while (readCharXML(&thisChar)) {
+			switch (thisChar) {
+			case ' ':
+			case '\r':
+			case '\n':
+			case '\t':
+				break;
+
+			case '=':
+				xmlArea = PAST_EQUALS_SIGN;
+				goto pastEqualsSign;
+
+			default:
+				return false; // There shouldn't be any other characters. If there are, that's an error
+			}
+		}
+
+		break;
+
+	case PAST_EQUALS_SIGN:
+pastEqualsSign:
+		while (readCharXML(&thisChar)) {
+			switch (thisChar) {
+			case ' ':
+			case '\r':
+			case '\n':
+			case '\t':
+				break;
+
+			case '"':
+			case '\'':
+				goto inAttributeValue;
+
+			default:
+				return false; // There shouldn't be any other characters. If there are, that's an error
+			}
+		}
+		break;
+	}
+
+	if (false) {
+inAttributeValue:
+		xmlArea = IN_ATTRIBUTE_VALUE;
+		tagDepthFile--;
+		charAtEndOfValue = thisChar;
+		binaryValueKind = BinarySongFormat::ValueKind::NONE;
+
+		readXMLFileClusterIfNecessary();
+		if (fileBufferCurrentPos < currentReadBufferEndPos
+		    && fileClusterBuffer[fileBufferCurrentPos] == BinarySongFormat::kBinaryValueMarker) {
+			fileBufferCurrentPos++;
+			uint8_t kind;
+			if (!readRawBytes(&kind, sizeof(kind)) || !readRawBytes(&binaryValueHeader, sizeof(binaryValueHeader))) {
+				return false;
+			}
+			binaryValueKind = (BinarySongFormat::ValueKind)kind;
+			binaryBytesLeftInRun = 0;
+			if (!mayBeBinary) {
+				skipRestOfValue();
+				return false;
+			}
+		}
+		return true;
+	}
+
+	return false; // Fail
+}
+
+// Only call if PAST_ATTRIBUTE_NAME or PAST_EQUALS_SIGN
+char const* StorageManager::readAttributeValue() {
+
+	if (!getIntoAttributeValue()) {
+		return "";
+	}
+	xmlArea = IN_TAG_PAST_NAME; // How it'll be after this next call
+	return readUntilChar(charAtEndOfValue);
+}
+
+// Only call if PAST_ATTRIBUTE_NAME or PAST_EQUALS_SIGN
+int32_t StorageManager::readAttributeValueInt() {
+
+	if (!getIntoAttributeValue()) {
+		return 0;
+	}
+	xmlArea = IN_TAG_PAST_NAME; // How it'll be after this next call
+	return readIntUntilChar(charAtEndOfValue);
+}
+
+// Only call if PAST_ATTRIBUTE_NAME or PAST_EQUALS_SIGN
+int32_t StorageManager::readAttributeValueString(String* string) {
+
+	if (!getIntoAttributeValue()) {
+		string->clear();
+		return NO_ERROR;
+	}
+	else {
+		int32_t error = readStringUntilChar(string, charAtEndOfValue);
+		if (!error) {
+			xmlArea = IN_TAG_PAST_NAME;
+		}
+		return error;
+	}
+}
+
+// Where endChar next is in the buffer from fileBufferCurrentPos on - or if it isn't, the end of what's in the buffer.
+// memchr() goes a word at a time, which for long values and skipped tags is much quicker than going char by char
+int32_t StorageManager::findCharInBuffer(char endChar) {
+	int32_t numCharsLeft = (int32_t)currentReadBufferEndPos - fileBufferCurrentPos;
+	if (numCharsLeft <= 0) {
+		return fileBufferCurrentPos;
+	}
+	char const* found = (char const*)memchr(&fileClusterBuffer[fileBufferCurrentPos], endChar, numCharsLeft);
+	return found ? (found - fileClusterBuffer) : currentReadBufferEndPos;
+}
+
+void StorageManager::skipUntilChar(char endChar) {
+
+	readXMLFileClusterIfNecessary(); // Does this need to be here? Originally I didn't have it...
+	do {
+		fileBufferCurrentPos = findCharInBuffer(endChar);
+	} while (fileBufferCurrentPos == currentReadBufferEndPos && readXMLFileClusterIfNecessary());
+
+	fileBufferCurrentPos++; // Gets us past the endChar
+
+	yieldToRoutinesIfDue();
+}
+
+// Returns memory error. If error, caller must deal with the fact that the end-character hasn't been reached
+int32_t StorageManager::readStringUntilChar(String* string, char endChar) {
+
+	int32_t newStringPos = 0;
+
+	do {
+		int32_t bufferPosNow = findCharInBuffer(endChar);
+
+		int32_t numCharsHere = bufferPosNow - fileBufferCurrentPos;
+
+		if (numCharsHere) {
+			int32_t error =
+			    string->concatenateAtPos(&fileClusterBuffer[fileBufferCurrentPos], newStringPos, numCharsHere);
+
+			fileBufferCurrentPos = bufferPosNow;
+
+			if (error) {
+				return error;
+			}
+
+			newStringPos += numCharsHere;
+		}
+
+	} while (fileBufferCurrentPos == currentReadBufferEndPos && readXMLFileClusterIfNecessary());
+
+	fileBufferCurrentPos++; // Gets us past the endChar
+
+	yieldToRoutinesIfDue();
+	return NO_ERROR;
+}
+
+char const* StorageManager::readUntilChar(char endChar) {
+	int32_t charPos = 0;
+
+	do {
+		int32_t bufferPosAtStart = fileBufferCurrentPos;
+		fileBufferCurrentPos = findCharInBuffer(endChar);
+
+		// If possible, just return a pointer to the chars within the existing buffer
+		if (!charPos && fileBufferCurrentPos < currentReadBufferEndPos) {
+			fileClusterBuffer[fileBufferCurrentPos] = 0;
+
+			fileBufferCurrentPos++; // Gets us past the endChar
+			return &fileClusterBuffer[bufferPosAtStart];
+		}
+
+		charPos = appendToStringBuffer(&fileClusterBuffer[bufferPosAtStart], fileBufferCurrentPos - bufferPosAtStart,
+		                               charPos);
+
+	} while (fileBufferCurrentPos == currentReadBufferEndPos && readXMLFileClusterIfNecessary());
+
+	fileBufferCurrentPos++; // Gets us past the endChar
+
+	yieldToRoutinesIfDue();
+
+	stringBuffer[charPos] = 0;
+	return stringBuffer;
+}
+
+// Unlike readUntilChar(), above, does not put a null character at the end of the returned "string". And, has a preset
+// number of chars. And, returns NULL when nothing more to return. numChars must be <= FILENAME_BUFFER_SIZE
+char const* StorageManager::readNextCharsOfTagOrAttributeValue(int32_t numChars) {
+
+	int32_t charPos = 0;
+
+	do {
+		int32_t bufferPosAtStart = fileBufferCurrentPos;
+		int32_t bufferPosAtEnd = bufferPosAtStart + numChars - charPos;
+
+		int32_t currentReadBufferEndPosNow = std::min<int32_t>(currentReadBufferEndPos, bufferPosAtEnd);
+
+		while (fileBufferCurrentPos < currentReadBufferEndPosNow) {
+			if (fileClusterBuffer[fileBufferCurrentPos] == charAtEndOfValue) {
+				goto reachedEndCharEarly;
+			}
+			fileBufferCurrentPos++;
+		}
+
+		int32_t numCharsHere = fileBufferCurrentPos - bufferPosAtStart;
+
+		// If we were able to just read the whole thing in one go, just return a pointer to the chars within the
+		// existing buffer
+		if (numCharsHere == numChars) {
+			yieldToRoutinesIfDue();
+			return &fileClusterBuffer[bufferPosAtStart];
+		}
+
+		// Otherwise, so long as we read something, add it to our buffer we're putting the output in
+		if (numCharsHere > 0) {
+			memcpy(&stringBuffer[charPos], &fileClusterBuffer[bufferPosAtStart], numCharsHere);
+
+			charPos += numCharsHere;
+
+			// And if we've now got all the chars we needed, return
+			if (charPos == numChars) {
+				yieldToRoutinesIfDue();
+				return stringBuffer;
+			}
+		}
+
+	} while (fileBufferCurrentPos == currentReadBufferEndPos && readXMLFileClusterIfNecessary());
+
+	// If we're here, the file ended
+	return NULL;
+
+	// And, additional bit we jump to when end-char reached
+reachedEndCharEarly:
+	fileBufferCurrentPos++; // Gets us past the endChar
+	if (charAtEndOfValue == '<') {
+		xmlArea = IN_TAG_NAME;
+	}
+	else {
+		xmlArea = IN_TAG_PAST_NAME; // Could be ' or "
+	}
+	return NULL;
+}
+
+// This is almost never called now - TODO: get rid
+char StorageManager::readNextCharOfTagOrAttributeValue() {
+
+	char thisChar;
+	if (!readCharXML(&thisChar)) {
+		return 0;
+	}
+	if (thisChar == charAtEndOfValue) {
+		if (charAtEndOfValue == '<') {
+			xmlArea = IN_TAG_NAME;
+		}
+		else {
+			xmlArea = IN_TAG_PAST_NAME; // Could be ' or "
+		}
+		yieldToRoutinesIfDue();
+		return 0;
+	}
+	return thisChar;
+}
+
+// Will always skip up until the end-char, even if it doesn't like the contents it sees
+int32_t StorageManager::readIntUntilChar(char endChar) {
+	uint32_t number = 0;
+	bool isNegative = false;
+	bool isFirstChar = true;
+
+	readXMLFileClusterIfNecessary();
+	do {
+		while (fileBufferCurrentPos < currentReadBufferEndPos) {
+			char thisChar = fileClusterBuffer[fileBufferCurrentPos++];
+
+			if (isFirstChar) {
+				isFirstChar = false;
+				if (thisChar == '-') {
+					isNegative = true;
+					continue;
+				}
+			}
+
+			if (!(thisChar >= '0' && thisChar <= '9')) {
+				if (thisChar != endChar) {
+					skipUntilChar(endChar);
+				}
+				goto gotNumber;
+			}
+			number *= 10;
+			number += (thisChar - '0');
+		}
+	} while (readXMLFileClusterIfNecessary());
+
+gotNumber:
+	if (isNegative) {
+		if (number >= 2147483648) {
+			return -2147483648;
+		}
+		else {
+			return -(int32_t)number;
+		}
+	}
+	else {
+		return number;
+	}
+}
+
+char const* StorageManager::readTagOrAttributeValue() {
+
+	switch (xmlArea) {
+
+	case BETWEEN_TAGS:
+		xmlArea = IN_TAG_NAME; // How it'll be after this call
+		return readUntilChar('<');
+
+	case PAST_ATTRIBUTE_NAME:
+	case PAST_EQUALS_SIGN:
+		return readAttributeValue();
+
+	case IN_TAG_PAST_NAME: // Could happen if trying to read a value but instead of a value there are multiple more
+	                       // contents, like attributes etc. Obviously not "meant" to happen, but we need to cope.
+		return "";
+
+	default:
+		FREEZE_WITH_ERROR("BBBB");
+		__builtin_unreachable();
+	}
+}
+
+int32_t StorageManager::readTagOrAttributeValueInt() {
+
+	switch (xmlArea) {
+
+	case BETWEEN_TAGS:
+		xmlArea = IN_TAG_NAME; // How it'll be after this call
+		return readIntUntilChar('<');
+
+	case PAST_ATTRIBUTE_NAME:
+	case PAST_EQUALS_SIGN:
+		return readAttributeValueInt();
+
+	case IN_TAG_PAST_NAME: // Could happen if trying to read a value but instead of a value there are multiple more
+	                       // contents, like attributes etc. Obviously not "meant" to happen, but we need to cope.
+		return 0;
+
+	default:
+		FREEZE_WITH_ERROR("BBBB");
+		__builtin_unreachable();
+	}
+}
+
+// This isn't super optimal, like the int32_t version is, but only rarely used
+int32_t StorageManager::readTagOrAttributeValueHex(int32_t errorValue) {
+	char const* string = readTagOrAttributeValue();
+	if (string[0] != '0' || string[1] != 'x') {
+		return errorValue;
+	}
+	return hexToInt(&string[2]);
+}
+
+// Returns memory error
+int32_t StorageManager::readTagOrAttributeValueString(String* string) {
+
+	int32_t error;
+
+	switch (xmlArea) {
+	case BETWEEN_TAGS:
+		error = readStringUntilChar(string, '<');
+		if (!error) {
+			xmlArea = IN_TAG_NAME;
+		}
+		return error;
+
+	case PAST_ATTRIBUTE_NAME:
+	case PAST_EQUALS_SIGN:
+		return readAttributeValueString(string);
+
+	case IN_TAG_PAST_NAME: // Could happen if trying to read a value but instead of a value there are multiple more
+	                       // contents, like attributes etc. Obviously not "meant" to happen, but we need to cope.
+		return ERROR_FILE_CORRUPTED;
+
+	default:
+		if (ALPHA_OR_BETA_VERSION) {
+			FREEZE_WITH_ERROR("BBBB");
+		}
+		__builtin_unreachable();
+	}
+}
+
+// Only counts what's in the buffer now - not any further Clusters the value runs on into
+int32_t StorageManager::getNumCharsRemainingInValue() {
+	return findCharInBuffer(charAtEndOfValue) - fileBufferCurrentPos;
+}
+
+// Returns whether we're all good to go. Only pass mayBeBinary if you'll check getBinaryValueKind() after
+bool StorageManager::prepareToReadTagOrAttributeValueOneCharAtATime(bool mayBeBinary) {
+	switch (xmlArea) {
+
+	case BETWEEN_TAGS:
+		// xmlArea = IN_TAG_NAME; // How it'll be after reading all chars
+		charAtEndOfValue = '<';
+		binaryValueKind = BinarySongFormat::ValueKind::NONE;
+		return true;
+
+	case PAST_ATTRIBUTE_NAME:
+	case PAST_EQUALS_SIGN:
+		return getIntoAttributeValue(mayBeBinary);
+
+	default:
+		if (ALPHA_OR_BETA_VERSION) {
+			FREEZE_WITH_ERROR("CCCC");
+		}
+		__builtin_unreachable();
+	}
+}
+
+// Straight from the file, across Clusters. With no dest, just skips them. Returns false if the file ended first
+bool StorageManager::readRawBytes(void* dest, uint32_t numBytes) {
+	uint8_t* destBytes = (uint8_t*)dest;
+	while (numBytes) {
+		if (fileBufferCurrentPos >= currentReadBufferEndPos) {
+			readXMLFileClusterIfNecessary();
+			if (xmlReachedEnd) {
+				return false;
+			}
+		}
+		uint32_t numBytesHere = std::min<uint32_t>(numBytes, currentReadBufferEndPos - fileBufferCurrentPos);
+		if (destBytes) {
+			memcpy(destBytes, &fileClusterBuffer[fileBufferCurrentPos], numBytesHere);
+			destBytes += numBytesHere;
+		}
+		fileBufferCurrentPos += numBytesHere;
+		numBytes -= numBytesHere;
+	}
+	yieldToRoutinesIfDue();
+	return true;
+}
+
+// Reads the number of bytes in the binary value's next run, skipping whatever wasn't read of the last one. Returns 0
+// once there are no more, and the value's been left - or -1 if the file ended
+int32_t StorageManager::readBinaryValueRunLength() {
+	uint32_t numBytes;
+	if (!readRawBytes(NULL, binaryBytesLeftInRun) || !readRawBytes(&numBytes, sizeof(numBytes))
+	    || numBytes > (uint32_t)INT32_MAX) {
+		binaryBytesLeftInRun = 0;
+		return -1;
+	}
+	binaryBytesLeftInRun = numBytes;
+
+	if (!numBytes) {
+		char closingQuote;
+		readCharXML(&closingQuote);
+		binaryValueKind = BinarySongFormat::ValueKind::NONE;
+		xmlArea = IN_TAG_PAST_NAME;
+	}
+	return numBytes;
+}
+
+// Only call for as many bytes as readBinaryValueRunLength() said there were, or fewer
+bool StorageManager::readBinaryBytes(void* dest, int32_t numBytes) {
+	binaryBytesLeftInRun -= numBytes;
+	return readRawBytes(dest, numBytes);
+}
+
+// Only call if IN_ATTRIBUTE_VALUE
+void StorageManager::skipRestOfValue() {
+	if (binaryValueKind == BinarySongFormat::ValueKind::NONE) {
+		skipUntilChar(charAtEndOfValue);
+	}
+	else {
+		while (readBinaryValueRunLength() > 0) {}
+	}
+	binaryValueKind = BinarySongFormat::ValueKind::NONE;
+	xmlArea = IN_TAG_PAST_NAME;
+}
+
+// Returns whether successful loading took place
+bool StorageManager::readXMLFileClusterIfNecessary() {
+
+	// Load next Cluster if necessary
+	if (fileBufferCurrentPos >= audioFileManager.clusterSize) {
+		bool result = readXMLFileCluster();
+		if (!result) {
+			xmlReachedEnd = true;
+		}
+		return result;
+	}
+
+	// Watch out for end of file
+	if (fileBufferCurrentPos >= currentReadBufferEndPos) {
+		xmlReachedEnd = true;
+	}
+
+	return false;
+}
+
+uint32_t StorageManager::readCharXML(char* thisChar) {
+
+	bool stillGoing = readXMLFileClusterIfNecessary();
+	if (xmlReachedEnd) {
+		return 0;
+	}
+
+	*thisChar = fileClusterBuffer[fileBufferCurrentPos];
+
+	fileBufferCurrentPos++;
+
+	return 1;
+}
+
+void StorageManager::exitTag(char const* exitTagName) {
+	// back out the file depth to one less than the caller depth
+	while (tagDepthFile >= tagDepthCaller) {
+
+		if (xmlReachedEnd) {
+			return;
+		}
+
+		switch (xmlArea) {
+
+		case IN_ATTRIBUTE_VALUE: // Could get left in here after a char-at-a-time read
+			skipRestOfValue();
+			// No break
+
+		case IN_TAG_PAST_NAME:
+			readNextAttributeName();
+			break;
+
+		case PAST_ATTRIBUTE_NAME:
+		case PAST_EQUALS_SIGN:
+			readAttributeValue();
+			break;
+
+		case BETWEEN_TAGS:
+			skipUntilChar('<');
+			xmlArea = IN_TAG_NAME;
+			// Got to next tag start
+			// No break
+
+		case IN_TAG_NAME:
+			readTagName();
+			break;
+
+		default:
+			if (ALPHA_OR_BETA_VERSION) {
+				FREEZE_WITH_ERROR("AAAA"); // Really shouldn't be possible anymore, I feel fairly certain...
+			}
+			__builtin_unreachable();
+		}
+	}
+	// It is possible for caller and file tag depths to get out of sync due to faulty error handling
+	// On exit reset the caller depth to match tag depth. File depth represents the parsers view of
+	// where we are in the xml parsing, caller depth represents the callers view. The caller can be shallower
+	// as the file will open past empty or unused tags, but should never be deeper.
+	tagDepthCaller = tagDepthFile;
+}
+
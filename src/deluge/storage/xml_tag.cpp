@@ -0,0 +1,152 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "storage/xml_tag.h"
+#include <string.h>
+
+namespace {
+
+constexpr char const* kTagNames[] = {
+#define XML_TAG_NAME(name) #name,
+    XML_TAGS(XML_TAG_NAME)
+#undef XML_TAG_NAME
+};
+
+constexpr int32_t kNumTags = sizeof(kTagNames) / sizeof(char const*);
+
+// Each name's hash picks a bucket, and each bucket has its own seed, found below, which sends its names to slots no
+// other name uses. That's "hash and displace" - much quicker to build than finding one seed that works for every name
+constexpr int32_t kNumBucketsMagnitude = 6;
+constexpr int32_t kNumSlotsMagnitude = 8;
+constexpr int32_t kNumBuckets = 1 << kNumBucketsMagnitude;
+constexpr int32_t kNumSlots = 1 << kNumSlotsMagnitude;
+
+static_assert(kNumTags <= kNumSlots * 2 / 3, "Too many XML tags for the hash table - increase kNumSlotsMagnitude");
+
+// FNV-1a
+constexpr uint32_t hashName(char const* name) {
+	uint32_t hash = 2166136261u;
+	while (*name) {
+		hash = (hash ^ (uint8_t)*name) * 16777619u;
+		name++;
+	}
+	return hash;
+}
+
+constexpr int32_t getBucket(uint32_t hash) {
+	return hash >> (32 - kNumBucketsMagnitude);
+}
+
+constexpr int32_t getSlot(uint32_t hash, uint32_t seed) {
+	uint32_t mixed = hash ^ (seed * 0x9E3779B9u);
+	mixed = (mixed ^ (mixed >> 16)) * 0x85EBCA6Bu;
+	mixed = (mixed ^ (mixed >> 13)) * 0xC2B2AE35u;
+	return (mixed ^ (mixed >> 16)) >> (32 - kNumSlotsMagnitude);
+}
+
+struct PerfectHashTable {
+	uint16_t seeds[kNumBuckets];
+	XMLTag slots[kNumSlots];
+	bool valid;
+};
+
+// Puts bucket b's names in the table using that seed - unless any would land on a taken slot, or on each other
+constexpr bool tryPlacingBucket(PerfectHashTable& table, uint32_t const* hashes, int32_t b, uint32_t seed) {
+	int32_t slotsTaken[kNumTags]{};
+	int32_t numTaken = 0;
+	for (int32_t t = 0; t < kNumTags; t++) {
+		if (getBucket(hashes[t]) != b) {
+			continue;
+		}
+		int32_t slot = getSlot(hashes[t], seed);
+		if (table.slots[slot] != XMLTag::UNKNOWN) {
+			return false;
+		}
+		for (int32_t i = 0; i < numTaken; i++) {
+			if (slotsTaken[i] == slot) {
+				return false;
+			}
+		}
+		slotsTaken[numTaken++] = slot;
+	}
+
+	numTaken = 0;
+	for (int32_t t = 0; t < kNumTags; t++) {
+		if (getBucket(hashes[t]) == b) {
+			table.slots[slotsTaken[numTaken++]] = (XMLTag)t;
+		}
+	}
+	table.seeds[b] = seed;
+	return true;
+}
+
+constexpr PerfectHashTable buildTable() {
+	PerfectHashTable table{};
+	for (int32_t s = 0; s < kNumSlots; s++) {
+		table.slots[s] = XMLTag::UNKNOWN;
+	}
+
+	uint32_t hashes[kNumTags]{};
+	int32_t bucketSizes[kNumBuckets]{};
+	int32_t maxBucketSize = 0;
+	for (int32_t t = 0; t < kNumTags; t++) {
+		hashes[t] = hashName(kTagNames[t]);
+		int32_t size = ++bucketSizes[getBucket(hashes[t])];
+		if (size > maxBucketSize) {
+			maxBucketSize = size;
+		}
+	}
+
+	// Fullest buckets first, while there are the most free slots to choose from
+	for (int32_t size = maxBucketSize; size > 0; size--) {
+		for (int32_t b = 0; b < kNumBuckets; b++) {
+			if (bucketSizes[b] != size) {
+				continue;
+			}
+			uint32_t seed = 0;
+			while (!tryPlacingBucket(table, hashes, b, seed)) {
+				if (++seed > 0xFFFF) {
+					return table; // Not valid
+				}
+			}
+		}
+	}
+
+	table.valid = true;
+	return table;
+}
+
+constexpr PerfectHashTable table = buildTable();
+static_assert(table.valid, "Couldn't build a perfect hash table of the XML tags");
+
+} // namespace
+
+XMLTag xmlTagFromName(char const* name) {
+	uint32_t hash = hashName(name);
+	XMLTag tag = table.slots[getSlot(hash, table.seeds[getBucket(hash)])];
+	if (tag == XMLTag::UNKNOWN || strcmp(kTagNames[(int32_t)tag], name)) {
+		return XMLTag::UNKNOWN;
+	}
+	return tag;
+}
+
+char const* xmlTagToName(XMLTag tag) {
+	if (tag >= XMLTag::UNKNOWN) {
+		return "";
+	}
+	return kTagNames[(int32_t)tag];
+}
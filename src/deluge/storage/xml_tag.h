@@ -0,0 +1,58 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+// Every tag name which the file-reading code switches on, rather than strcmp()ing against one by one. A tag needs
+// adding here before it can be a case in one of those switches. Keep in alphabetical order
+#define XML_TAGS(X) \
+	X(activeModFunction) X(affectEntire) X(arpeggiator) X(arrangementAutoScrollOn) X(arrangementOnlyClips) \
+	X(arrangementOnlyTracks) X(audioCompressor) X(bendRange) X(bendRangeMPE) X(cents) X(channelPressure) \
+	X(clippingAmount) X(compressor) X(continuous) X(crossScreenEditLevel) X(currentTrackInstanceArrangementPos) \
+	X(cvChannel) X(defaultParams) X(delay) X(drumsEdgeSize) X(drumsScrollOffset) X(earliestCompatibleFirmware) \
+	X(envelope1) X(envelope2) X(expressionData) X(fileName) X(filterRoute) X(firmwareVersion) X(fx) X(hpf) X(hpfMode) \
+	X(inArrangementView) X(inKeyMode) X(inKeyRowInterval) X(inKeyScrollOffset) X(inputTickMagnitude) X(instrument) \
+	X(instrumentPresetFolder) X(instrumentPresetName) X(instrumentPresetSlot) X(instrumentPresetSubSlot) \
+	X(instruments) X(keyboardLayout) X(keyboardRowInterval) X(kit) X(kitParams) X(lastSelectedInstrumentType) \
+	X(lastSelectedParamID) X(lastSelectedParamKind) X(lastSelectedParamShortcutX) X(lastSelectedParamShortcutY) \
+	X(lfo1) X(lfo2) X(lpf) X(lpfMode) X(midiBank) X(midiChannel) X(midiChannelSuffix) X(midiKnobs) X(midiLoopback) \
+	X(midiPGM) X(midiParams) X(midiSub) X(mod1PitchAdjust) X(mod2PitchAdjust) X(modFXType) X(modKnobs) X(mode) \
+	X(modeNotes) X(modulator1) X(modulator2) X(noiseVolume) X(noteRows) X(onAutomationInstrumentClipView) \
+	X(onKeyboardScreen) X(osc1) X(osc2) X(oscAPitchAdjust) X(oscBPitchAdjust) X(oscillatorA) X(oscillatorB) \
+	X(oscillatorReset) X(pan) X(patchCables) X(pitchAdjust) X(pitchBend) X(polyphonic) X(portamento) X(preview) \
+	X(previewNumPads) X(ratchetAmount) X(ratchetProbability) X(reverb) X(reverbAmount) X(reversed) X(ringMod) \
+	X(rootNote) X(sections) X(sequenceLength) X(sessionClips) X(sessionLayout) X(sideChainSend) X(sidechain) \
+	X(songCompressor) X(songGridScrollX) X(songGridScrollY) X(songParams) X(sound) X(soundMidiCommand) X(soundParams) \
+	X(swingAmount) X(swingInterval) X(synth) X(timePerTimerTick) X(timerTickFraction) X(tracks) X(transpose) \
+	X(tripletsLevel) X(unison) X(voicePriority) X(volume) X(waveFold) X(xScroll) X(xScrollArrangementView) \
+	X(xScrollSongView) X(xZoom) X(xZoomArrangementView) X(xZoomSongView) X(yExpression) X(yScroll) \
+	X(yScrollArrangementView) X(yScrollKeyboard) X(yScrollSongView) X(zone)
+
+enum class XMLTag : uint16_t {
+#define XML_TAG_ENUM(name) name,
+	XML_TAGS(XML_TAG_ENUM)
+#undef XML_TAG_ENUM
+	UNKNOWN, // Any name not in the list above
+};
+
+// Looks the name up in a perfect hash table built at compile time - so that's one hash of the name and one strcmp(),
+// however many tags there are
+XMLTag xmlTagFromName(char const* name);
+
+char const* xmlTagToName(XMLTag tag);
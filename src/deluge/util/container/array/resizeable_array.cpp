@@ -55,6 +55,7 @@ ResizeableArray::ResizeableArray(int32_t newElementSize, int32_t newMaxNumEmptyS
       numExtraSpacesToAllocate(newNumExtrarSpacesToAllocate) {
 	emptyingShouldFreeMemory = true;
 	staticMemoryAllocationSize = 0;
+	useExternalMemory = false;
 
 #if RESIZEABLE_ARRAY_DO_LOCKS
 	lock = false;
@@ -74,6 +75,13 @@ ResizeableArray::~ResizeableArray() {
 	LOCK_EXIT
 }
 
+void* ResizeableArray::allocateMemory(uint32_t requiredSize, void* thingNotToStealFrom) {
+	if (useExternalMemory) {
+		return GeneralMemoryAllocator::get().allocLowSpeed(requiredSize, thingNotToStealFrom);
+	}
+	return GeneralMemoryAllocator::get().allocMaxSpeed(requiredSize, thingNotToStealFrom);
+}
+
 void ResizeableArray::init() {
 
 	LOCK_ENTRY
@@ -150,7 +158,7 @@ int32_t ResizeableArray::copyElementsFromOldMemory(void* __restrict__ otherMemor
 	else {
 		int32_t newSize = numElements + 1;
 		uint32_t allocatedSize = newSize * elementSize;
-		memory = GeneralMemoryAllocator::get().allocMaxSpeed(allocatedSize);
+		memory = allocateMemory(allocatedSize);
 
 		if (!memory) {
 			numElements = 0;
@@ -475,7 +483,7 @@ bool ResizeableArray::ensureEnoughSpaceAllocated(int32_t numAdditionalElementsNe
 
 		uint32_t allocatedMemorySize = numAdditionalElementsNeeded * elementSize;
 
-		void* newMemory = GeneralMemoryAllocator::get().allocMaxSpeed(allocatedMemorySize);
+		void* newMemory = allocateMemory(allocatedMemorySize);
 		if (!newMemory) {
 			LOCK_EXIT
 			return false;
@@ -551,10 +559,10 @@ getBrandNewMemory:
 #endif
 
 		uint32_t newMemoryAllocationSize = (newNum + numExtraSpacesToAllocate) * elementSize;
-		newMemory = GeneralMemoryAllocator::get().allocMaxSpeed(newMemoryAllocationSize);
+		newMemory = allocateMemory(newMemoryAllocationSize);
 		if (!newMemory) {
 			newMemoryAllocationSize = newNum * elementSize;
-			newMemory = GeneralMemoryAllocator::get().allocMaxSpeed(newMemoryAllocationSize);
+			newMemory = allocateMemory(newMemoryAllocationSize);
 		}
 
 		// If that didn't work...
@@ -917,7 +925,7 @@ int32_t ResizeableArray::insertAtIndex(int32_t i, int32_t numToInsert, void* thi
 
 		uint32_t allocatedMemorySize = newMemorySize * elementSize;
 
-		void* newMemory = GeneralMemoryAllocator::get().allocMaxSpeed(allocatedMemorySize, thingNotToStealFrom);
+		void* newMemory = allocateMemory(allocatedMemorySize, thingNotToStealFrom);
 		if (!newMemory) {
 			LOCK_EXIT
 			return ERROR_INSUFFICIENT_RAM;
@@ -1094,8 +1102,7 @@ getBrandNewMemory:
 
 getBrandNewMemoryAgain:
 			uint32_t allocatedSize = desiredSize;
-			void* __restrict__ newMemory =
-			    GeneralMemoryAllocator::get().allocMaxSpeed(allocatedSize, thingNotToStealFrom);
+			void* __restrict__ newMemory = allocateMemory(allocatedSize, thingNotToStealFrom);
 
 			// If that didn't work...
 			if (!newMemory) {
@@ -59,6 +59,9 @@ public:
 	bool emptyingShouldFreeMemory;
 	uint32_t staticMemoryAllocationSize;
 
+	// For big arrays that don't get accessed often enough to need to be fast - then they don't take up internal RAM
+	bool useExternalMemory;
+
 protected:
 	void* memory;
 	int32_t numElements;
@@ -68,6 +71,8 @@ protected:
 	int32_t moveCount;
 #endif
 
+	void* allocateMemory(uint32_t requiredSize, void* thingNotToStealFrom = NULL);
+
 #if RESIZEABLE_ARRAY_DO_LOCKS
 	bool lock;
 	void freezeOnLock();
@@ -19,6 +19,7 @@
 #include "definitions_cxx.hpp"
 #include "memory/general_memory_allocator.h"
 #include "util/cfunctions.h"
+#include <array>
 #include <cstring>
 
 const char nothing = 0;
@@ -326,28 +327,34 @@ bool String::equalsCaseIrrespective(char const* otherChars) {
  * String formatting and parsing functions
 \**********************************************************************************************************************/
 
-char halfByteToHexChar(uint8_t thisHalfByte) {
-	if (thisHalfByte < 10) {
-		return 48 + thisHalfByte;
+static char const hexDigits[] = "0123456789ABCDEF";
+
+// Value of each hex digit, indexed by its char - so decoding one is a single load rather than a compare and branch.
+// We only ever write upper case, but lower case is accepted too. Anything that isn't a hex digit reads as 0.
+static constexpr auto hexCharValues = [] {
+	std::array<uint8_t, 256> values{};
+	for (int32_t i = 0; i < 10; i++) {
+		values['0' + i] = i;
 	}
-	else {
-		return 55 + thisHalfByte;
+	for (int32_t i = 0; i < 6; i++) {
+		values['A' + i] = 10 + i;
+		values['a' + i] = 10 + i;
 	}
+	return values;
+}();
+
+char halfByteToHexChar(uint8_t thisHalfByte) {
+	return hexDigits[thisHalfByte & 15];
 }
 
-char hexCharToHalfByte(unsigned char hexChar) {
-	if (hexChar >= 65) {
-		return hexChar - 55;
-	}
-	else {
-		return hexChar - 48;
-	}
+[[gnu::always_inline]] static inline uint32_t hexCharToHalfByte(unsigned char hexChar) {
+	return hexCharValues[hexChar];
 }
 
 void intToHex(uint32_t number, char* output, int32_t numChars) {
 	output[numChars] = 0;
 	for (int32_t i = numChars - 1; i >= 0; i--) {
-		output[i] = halfByteToHexChar(number & 15);
+		output[i] = hexDigits[number & 15];
 		number >>= 4;
 	}
 }
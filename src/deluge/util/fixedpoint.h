@@ -16,6 +16,7 @@
  */
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
 // signed 31 fractional bits (e.g. one would be 1<<31 but can't be represented)
 using q31_t = int32_t;
@@ -89,16 +90,16 @@ static inline q31_t multiply_32x32_rshift32(q31_t a, q31_t b) {
 	return (q31_t)(((int64_t)a * (int64_t)b) >> 32);
 }
 
-// This multiplies two numbers in signed Q31 fixed point and rounds the result
+// This multiplies two numbers in signed Q31 fixed point and rounds the result - as smmulr does
 
 static inline q31_t multiply_32x32_rshift32_rounded(q31_t a, q31_t b) {
-	return (q31_t)(((int64_t)a * (int64_t)b) >> 32);
+	return (q31_t)(((int64_t)a * (int64_t)b + 0x80000000) >> 32);
 }
 
 // Multiplies A and B, adds to sum, and returns output
 
 static inline q31_t multiply_accumulate_32x32_rshift32_rounded(q31_t sum, q31_t a, q31_t b) {
-	return sum + (q31_t)(((int64_t)a * (int64_t)b) >> 32);
+	return sum + (q31_t)(((int64_t)a * (int64_t)b + 0x80000000) >> 32);
 }
 
 // Multiplies A and B, subtracts from sum, and returns output
@@ -110,12 +111,13 @@ static inline q31_t multiply_subtract_32x32_rshift32_rounded(q31_t sum, q31_t a,
 // computes limit((val >> rshift), 2**bits)
 template <uint8_t bits>
 static inline int32_t signed_saturate(int32_t val) {
-	return std::min(val, 1 << bits);
+	constexpr int64_t limit = (int64_t)1 << (bits - 1);
+	return (int32_t)std::clamp<int64_t>(val, -limit, limit - 1);
 }
 
 static inline int32_t add_saturation(int32_t a, int32_t b) __attribute__((always_inline, unused));
 static inline int32_t add_saturation(int32_t a, int32_t b) {
-	return a + b;
+	return (int32_t)std::clamp<int64_t>((int64_t)a + b, INT32_MIN, INT32_MAX);
 }
 
 inline int32_t clz(uint32_t input) {
@@ -1231,7 +1231,8 @@ void getThingFilename(char const* thingName, int16_t currentSlot, int8_t current
 bool isAudioFilename(char const* filename) {
 	char* dotPos = strrchr(filename, '.');
 	return (dotPos != 0
-	        && (!strcasecmp(dotPos, ".WAV") || !strcasecmp(dotPos, ".AIF") || !strcasecmp(dotPos, ".AIFF")));
+	        && (!strcasecmp(dotPos, ".WAV") || !strcasecmp(dotPos, ".AIF") || !strcasecmp(dotPos, ".AIFF")
+	            || !strcasecmp(dotPos, ".FLAC")));
 }
 
 bool isAiffFilename(char const* filename) {
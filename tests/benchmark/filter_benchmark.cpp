@@ -0,0 +1,86 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Times each filter's stereo path - L and R in lanes - against doing the channels one at a time, on the same buffers.
+// The two give the same samples, so this is purely about speed. Built for the host, the lanes are Q31x2's plain C++
+// pair rather than NEON, so only a build for the Deluge itself shows what the lanes are worth there. Usage:
+//
+//   FilterBenchmark [--buffers N]
+
+#include "definitions_cxx.hpp"
+#include "dsp/filter/lpladder.h"
+#include "dsp/filter/svf.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+using deluge::dsp::filter::LpLadderFilter;
+using deluge::dsp::filter::SVFilter;
+
+namespace {
+
+constexpr int32_t kBufferSamples = SSI_TX_BUFFER_NUM_SAMPLES;
+
+template <typename FilterType>
+double timeNanosecondsPerSample(FilterMode mode, int32_t numBuffers, void (FilterType::*render)(q31_t*, q31_t*)) {
+	FilterType filter{};
+	filter.configure(400000000, 400000000, mode, 1 << 26, ONE_Q31);
+
+	std::vector<q31_t> buffer(kBufferSamples * 2);
+	uint32_t state = 12345;
+	for (q31_t& sample : buffer) {
+		state = state * 1664525 + 1013904223;
+		sample = (q31_t)state >> 2;
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	for (int32_t i = 0; i < numBuffers; i++) {
+		(filter.*render)(&buffer[0], &buffer[kBufferSamples * 2]);
+	}
+	auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::nano>(end - start).count() / ((double)numBuffers * kBufferSamples);
+}
+
+template <typename FilterType>
+void compare(char const* name, FilterMode mode, int32_t numBuffers) {
+	double lanes = timeNanosecondsPerSample<FilterType>(mode, numBuffers, &FilterType::doFilterStereo);
+	double scalar = timeNanosecondsPerSample<FilterType>(mode, numBuffers, &FilterType::doFilterStereoScalar);
+	printf("%-12s lanes %6.2f ns/sample, one channel at a time %6.2f ns/sample (%.2fx)\n", name, lanes, scalar,
+	       scalar / lanes);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	int32_t numBuffers = 100000;
+	for (int32_t i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "--buffers") && i + 1 < argc) {
+			numBuffers = atoi(argv[++i]);
+		}
+		else {
+			fprintf(stderr, "Unknown or incomplete argument: %s\n", argv[i]);
+			return 1;
+		}
+	}
+
+	compare<SVFilter>("svf", FilterMode::SVF_BAND, numBuffers);
+	compare<LpLadderFilter>("ladder 12dB", FilterMode::TRANSISTOR_12DB, numBuffers);
+	compare<LpLadderFilter>("ladder 24dB", FilterMode::TRANSISTOR_24DB, numBuffers);
+	return 0;
+}
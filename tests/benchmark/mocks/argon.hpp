@@ -0,0 +1,73 @@
+#pragma once
+
+// Just as much of argon as the reverb's DualCosineOscillator uses, so the offline renderer doesn't need the real one
+// fetched and built for ARM
+
+#include <cstddef>
+#include <initializer_list>
+
+namespace argon {
+
+template <typename T>
+class Neon64 {
+public:
+	static constexpr size_t lanes = 8 / sizeof(T);
+
+	constexpr Neon64() = default;
+	constexpr Neon64(T value) {
+		for (size_t i = 0; i < lanes; i++) {
+			lane[i] = value;
+		}
+	}
+	constexpr Neon64(std::initializer_list<T> values) {
+		size_t i = 0;
+		for (T value : values) {
+			lane[i++] = value;
+		}
+	}
+
+	[[nodiscard]] constexpr size_t size() const { return lanes; }
+	constexpr T& operator[](size_t i) { return lane[i]; }
+	constexpr T const& operator[](size_t i) const { return lane[i]; }
+
+	template <typename Function>
+	constexpr void each_lane(Function function) {
+		for (size_t i = 0; i < lanes; i++) {
+			function(lane[i], (int)i);
+		}
+	}
+
+	constexpr Neon64 operator+(Neon64 const& other) const {
+		return combine(other, [](T a, T b) { return a + b; });
+	}
+	constexpr Neon64 operator-(Neon64 const& other) const {
+		return combine(other, [](T a, T b) { return a - b; });
+	}
+	constexpr Neon64 operator*(Neon64 const& other) const {
+		return combine(other, [](T a, T b) { return a * b; });
+	}
+
+private:
+	template <typename Operation>
+	constexpr Neon64 combine(Neon64 const& other, Operation operation) const {
+		Neon64 result;
+		for (size_t i = 0; i < lanes; i++) {
+			result.lane[i] = operation(lane[i], other.lane[i]);
+		}
+		return result;
+	}
+
+	T lane[lanes]{};
+};
+
+template <typename T>
+constexpr Neon64<T> operator*(T value, Neon64<T> const& vector) {
+	return Neon64<T>(value) * vector;
+}
+
+template <typename T>
+constexpr Neon64<T> operator-(T value, Neon64<T> const& vector) {
+	return Neon64<T>(value) - vector;
+}
+
+} // namespace argon
@@ -0,0 +1,299 @@
+#pragma once
+
+// The NEON intrinsics the render path uses, one lane at a time, so the offline renderer can build the firmware's own
+// Voice and WaveTable code on the host. Each does what the ARM reference says it does - including saturation and
+// rounding - since the point is to render exactly what the Deluge would. Add to this as the render path needs more
+
+#include <cstdint>
+#include <cstring>
+
+typedef int16_t int16x4_t __attribute__((vector_size(8)));
+typedef int16_t int16x8_t __attribute__((vector_size(16)));
+typedef int32_t int32x2_t __attribute__((vector_size(8)));
+typedef int32_t int32x4_t __attribute__((vector_size(16)));
+typedef uint16_t uint16x4_t __attribute__((vector_size(8)));
+typedef uint32_t uint32x4_t __attribute__((vector_size(16)));
+
+struct int16x8x2_t {
+	int16x8_t val[2];
+};
+
+struct int16x8x4_t {
+	int16x8_t val[4];
+};
+
+namespace neon_on_host {
+
+inline int32_t saturate32(int64_t value) {
+	return (value > INT32_MAX) ? INT32_MAX : (value < INT32_MIN) ? INT32_MIN : (int32_t)value;
+}
+
+inline int16_t saturate16(int32_t value) {
+	return (value > INT16_MAX) ? INT16_MAX : (value < INT16_MIN) ? INT16_MIN : (int16_t)value;
+}
+
+// Signed vector arithmetic wraps, as it does on the Deluge
+template <typename Vector>
+inline Vector add(Vector a, Vector b) {
+	Vector result;
+	for (int32_t i = 0; i < (int32_t)(sizeof(Vector) / sizeof(a[0])); i++) {
+		result[i] = (decltype(+a[0]))((uint32_t)a[i] + (uint32_t)b[i]);
+	}
+	return result;
+}
+
+template <typename Vector>
+inline Vector sub(Vector a, Vector b) {
+	Vector result;
+	for (int32_t i = 0; i < (int32_t)(sizeof(Vector) / sizeof(a[0])); i++) {
+		result[i] = (decltype(+a[0]))((uint32_t)a[i] - (uint32_t)b[i]);
+	}
+	return result;
+}
+
+} // namespace neon_on_host
+
+// Loads and stores
+
+inline int16x8_t vld1q_s16(int16_t const* p) {
+	int16x8_t result;
+	memcpy(&result, p, sizeof(result));
+	return result;
+}
+
+inline int32x4_t vld1q_s32(int32_t const* p) {
+	int32x4_t result;
+	memcpy(&result, p, sizeof(result));
+	return result;
+}
+
+inline uint32x4_t vld1q_u32(uint32_t const* p) {
+	uint32x4_t result;
+	memcpy(&result, p, sizeof(result));
+	return result;
+}
+
+inline uint32x4_t vld1q_lane_u32(uint32_t const* p, uint32x4_t v, int32_t lane) {
+	uint32_t value;
+	memcpy(&value, p, sizeof(value));
+	v[lane] = value;
+	return v;
+}
+
+inline int16x8x4_t vld4q_s16(int16_t const* p) {
+	int16x8x4_t result;
+	for (int32_t i = 0; i < 8; i++) {
+		for (int32_t v = 0; v < 4; v++) {
+			result.val[v][i] = p[i * 4 + v];
+		}
+	}
+	return result;
+}
+
+inline void vst1q_s32(int32_t* p, int32x4_t v) {
+	memcpy(p, &v, sizeof(v));
+}
+
+// Lanes
+
+inline int32_t vget_lane_s32(int32x2_t v, int32_t lane) {
+	return v[lane];
+}
+
+inline uint32_t vgetq_lane_u32(uint32x4_t v, int32_t lane) {
+	return v[lane];
+}
+
+inline int16x4_t vset_lane_s16(int16_t value, int16x4_t v, int32_t lane) {
+	v[lane] = value;
+	return v;
+}
+
+inline uint16x4_t vset_lane_u16(uint16_t value, uint16x4_t v, int32_t lane) {
+	v[lane] = value;
+	return v;
+}
+
+inline int32x4_t vsetq_lane_s32(int32_t value, int32x4_t v, int32_t lane) {
+	v[lane] = value;
+	return v;
+}
+
+inline uint32x4_t vsetq_lane_u32(uint32_t value, uint32x4_t v, int32_t lane) {
+	v[lane] = value;
+	return v;
+}
+
+inline int16x4_t vget_low_s16(int16x8_t v) {
+	return int16x4_t{v[0], v[1], v[2], v[3]};
+}
+
+inline int16x4_t vget_high_s16(int16x8_t v) {
+	return int16x4_t{v[4], v[5], v[6], v[7]};
+}
+
+inline int32x2_t vget_low_s32(int32x4_t v) {
+	return int32x2_t{v[0], v[1]};
+}
+
+inline int32x2_t vget_high_s32(int32x4_t v) {
+	return int32x2_t{v[2], v[3]};
+}
+
+inline int16x4_t vdup_n_s16(int16_t value) {
+	return int16x4_t{value, value, value, value};
+}
+
+inline int32x4_t vdupq_n_s32(int32_t value) {
+	return int32x4_t{value, value, value, value};
+}
+
+inline uint32x4_t vdupq_n_u32(uint32_t value) {
+	return uint32x4_t{value, value, value, value};
+}
+
+inline int16x4_t vreinterpret_s16_u16(uint16x4_t v) {
+	return (int16x4_t)v;
+}
+
+inline int32x4_t vreinterpretq_s32_u32(uint32x4_t v) {
+	return (int32x4_t)v;
+}
+
+// Arithmetic
+
+inline int32x2_t vadd_s32(int32x2_t a, int32x2_t b) {
+	return neon_on_host::add(a, b);
+}
+
+inline int16x8_t vaddq_s16(int16x8_t a, int16x8_t b) {
+	return neon_on_host::add(a, b);
+}
+
+inline int32x4_t vaddq_s32(int32x4_t a, int32x4_t b) {
+	return neon_on_host::add(a, b);
+}
+
+inline uint32x4_t vaddq_u32(uint32x4_t a, uint32x4_t b) {
+	return a + b;
+}
+
+inline int16x4_t vsub_s16(int16x4_t a, int16x4_t b) {
+	return neon_on_host::sub(a, b);
+}
+
+inline int16x8_t vsubq_s16(int16x8_t a, int16x8_t b) {
+	return neon_on_host::sub(a, b);
+}
+
+inline int32x2_t vpadd_s32(int32x2_t a, int32x2_t b) {
+	return int32x2_t{(int32_t)((uint32_t)a[0] + (uint32_t)a[1]), (int32_t)((uint32_t)b[0] + (uint32_t)b[1])};
+}
+
+inline int32x4_t vmull_s16(int16x4_t a, int16x4_t b) {
+	int32x4_t result;
+	for (int32_t i = 0; i < 4; i++) {
+		result[i] = (int32_t)a[i] * b[i];
+	}
+	return result;
+}
+
+inline int32x4_t vmlal_s16(int32x4_t sum, int16x4_t a, int16x4_t b) {
+	return neon_on_host::add(sum, vmull_s16(a, b));
+}
+
+inline int32x4_t vqdmull_s16(int16x4_t a, int16x4_t b) {
+	int32x4_t result;
+	for (int32_t i = 0; i < 4; i++) {
+		result[i] = neon_on_host::saturate32((int64_t)a[i] * b[i] * 2);
+	}
+	return result;
+}
+
+inline int32x4_t vqdmlal_s16(int32x4_t sum, int16x4_t a, int16x4_t b) {
+	int32x4_t product = vqdmull_s16(a, b);
+	for (int32_t i = 0; i < 4; i++) {
+		sum[i] = neon_on_host::saturate32((int64_t)sum[i] + product[i]);
+	}
+	return sum;
+}
+
+inline int16x8_t vqdmulhq_n_s16(int16x8_t a, int16_t b) {
+	int16x8_t result;
+	for (int32_t i = 0; i < 8; i++) {
+		result[i] = neon_on_host::saturate16(((int32_t)a[i] * b * 2) >> 16);
+	}
+	return result;
+}
+
+inline int32x4_t vqdmulhq_s32(int32x4_t a, int32x4_t b) {
+	int32x4_t result;
+	for (int32_t i = 0; i < 4; i++) {
+		result[i] = (a[i] == INT32_MIN && b[i] == INT32_MIN) ? INT32_MAX : (int32_t)(((int64_t)a[i] * b[i]) >> 31);
+	}
+	return result;
+}
+
+inline int32x4_t vqrdmulhq_s32(int32x4_t a, int32x4_t b) {
+	int32x4_t result;
+	for (int32_t i = 0; i < 4; i++) {
+		result[i] = (a[i] == INT32_MIN && b[i] == INT32_MIN)
+		                ? INT32_MAX
+		                : (int32_t)(((int64_t)a[i] * b[i] + ((int64_t)1 << 30)) >> 31);
+	}
+	return result;
+}
+
+inline int32x4_t vqrdmulhq_n_s32(int32x4_t a, int32_t b) {
+	return vqrdmulhq_s32(a, vdupq_n_s32(b));
+}
+
+// Bitwise and shifts
+
+inline int16x4_t vand_s16(int16x4_t a, int16x4_t b) {
+	return a & b;
+}
+
+inline int16x4_t vorr_s16(int16x4_t a, int16x4_t b) {
+	return a | b;
+}
+
+inline uint16x4_t vshr_n_u16(uint16x4_t v, int32_t shift) {
+	return v >> shift;
+}
+
+inline int32x4_t vshlq_n_s32(int32x4_t v, int32_t shift) {
+	return (int32x4_t)((uint32x4_t)v << shift);
+}
+
+inline uint32x4_t vshlq_n_u32(uint32x4_t v, int32_t shift) {
+	return v << shift;
+}
+
+inline int32x4_t vshll_n_s16(int16x4_t v, int32_t shift) {
+	int32x4_t result;
+	for (int32_t i = 0; i < 4; i++) {
+		result[i] = (int32_t)((uint32_t)(int32_t)v[i] << shift);
+	}
+	return result;
+}
+
+inline int16x4_t vshrn_n_s32(int32x4_t v, int32_t shift) {
+	int16x4_t result;
+	for (int32_t i = 0; i < 4; i++) {
+		result[i] = (int16_t)(v[i] >> shift);
+	}
+	return result;
+}
+
+inline uint16x4_t vshrn_n_u32(uint32x4_t v, int32_t shift) {
+	uint16x4_t result;
+	for (int32_t i = 0; i < 4; i++) {
+		result[i] = (uint16_t)(v[i] >> shift);
+	}
+	return result;
+}
+
+inline uint16x4_t vmovn_u32(uint32x4_t v) {
+	return vshrn_n_u32(v, 0);
+}
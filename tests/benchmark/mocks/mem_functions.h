@@ -0,0 +1,3 @@
+#pragma once
+// The host's own, which the firmware's declarations would clash with
+#include <string.h>
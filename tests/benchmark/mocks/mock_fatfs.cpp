@@ -0,0 +1,202 @@
+// FatFS, on the host's own files, for the offline renderer. Paths are relative to the current directory, which stands
+// in for the root of the card. f_open() gives each file a made-up start cluster - the only thing a FilePointer keeps -
+// so StorageManager::openFilePointer() and the f_read()s after it find their way back to the same host file.
+//
+// There's no card to read a sector at a time, which is how Samples and wavetables are streamed, so those just fail to
+// load. Nothing gets written either.
+
+#include <cstdio>
+#include <string>
+#include <sys/stat.h>
+#include <vector>
+
+extern "C" {
+#include "fatfs/diskio.h"
+#include "fatfs/ff.h"
+
+LBA_t clst2sect(FATFS* fs, DWORD clst);
+DWORD get_fat_from_fs(FATFS* fs, DWORD clst);
+DRESULT disk_read_without_streaming_first(BYTE pdrv, BYTE* buff, DWORD sector, UINT count);
+void disk_timerproc(UINT msPassed);
+
+uint8_t currentlyAccessingCard = 0;
+}
+
+namespace {
+// 32kB Clusters, as the Deluge likes its card formatted
+constexpr BYTE kSectorsPerCluster = 64;
+
+// Clusters 0 and 1 aren't real ones on a FAT volume, so the first file gets 2
+constexpr DWORD kFirstCluster = 2;
+
+bool mounted = false;
+std::vector<std::string> openedPaths;
+
+FILE* currentHostFile = nullptr;
+DWORD currentHostFileCluster = 0;
+
+FILE* getHostFile(DWORD sclust) {
+	if (sclust != currentHostFileCluster) {
+		if (currentHostFile) {
+			fclose(currentHostFile);
+			currentHostFile = nullptr;
+		}
+		if (sclust < kFirstCluster || sclust - kFirstCluster >= openedPaths.size()) {
+			return nullptr;
+		}
+		currentHostFile = fopen(openedPaths[sclust - kFirstCluster].c_str(), "rb");
+		currentHostFileCluster = sclust;
+	}
+	return currentHostFile;
+}
+} // namespace
+
+extern "C" {
+
+DSTATUS disk_status(BYTE pdrv) {
+	return mounted ? 0 : STA_NOINIT;
+}
+
+FRESULT f_mount(FATFS* fs, const TCHAR* path, BYTE opt) {
+	fs->csize = kSectorsPerCluster;
+	fs->id++;
+	mounted = true;
+	return FR_OK;
+}
+
+FRESULT f_open(FIL* fp, const TCHAR* path, BYTE mode) {
+	if (mode & (FA_WRITE | FA_CREATE_ALWAYS | FA_CREATE_NEW | FA_OPEN_ALWAYS)) {
+		return FR_WRITE_PROTECTED;
+	}
+
+	struct stat hostStat;
+	if (stat(path, &hostStat) || !S_ISREG(hostStat.st_mode)) {
+		return FR_NO_FILE;
+	}
+
+	DWORD sclust = 0;
+	while (sclust < openedPaths.size() && openedPaths[sclust] != path) {
+		sclust++;
+	}
+	if (sclust == openedPaths.size()) {
+		openedPaths.push_back(path);
+	}
+
+	fp->obj.sclust = sclust + kFirstCluster;
+	fp->obj.objsize = hostStat.st_size;
+	fp->flag = FA_READ;
+	fp->err = 0;
+	fp->fptr = 0;
+	return FR_OK;
+}
+
+FRESULT f_read(FIL* fp, void* buff, UINT btr, UINT* br) {
+	*br = 0;
+	FILE* hostFile = getHostFile(fp->obj.sclust);
+	if (!hostFile || fseek(hostFile, fp->fptr, SEEK_SET)) {
+		return FR_INVALID_OBJECT;
+	}
+	*br = fread(buff, 1, btr, hostFile);
+	fp->fptr += *br;
+	return FR_OK;
+}
+
+FRESULT f_lseek(FIL* fp, FSIZE_t ofs) {
+	fp->fptr = ofs;
+	return FR_OK;
+}
+
+FRESULT f_close(FIL* fp) {
+	return FR_OK;
+}
+
+FRESULT f_stat(const TCHAR* path, FILINFO* fno) {
+	struct stat hostStat;
+	if (stat(path, &hostStat)) {
+		return FR_NO_FILE;
+	}
+	fno->fsize = hostStat.st_size;
+	fno->fattrib = S_ISDIR(hostStat.st_mode) ? AM_DIR : 0;
+	return FR_OK;
+}
+
+// Browsing, and anything that would change the card
+
+FRESULT f_opendir(DIR* dp, const TCHAR* path) {
+	return FR_NO_PATH;
+}
+
+FRESULT f_closedir(DIR* dp) {
+	return FR_OK;
+}
+
+FRESULT f_readdir(DIR* dp, FILINFO* fno) {
+	return FR_NO_PATH;
+}
+
+FRESULT f_readdir_get_filepointer(DIR* dp, FILINFO* fno, FilePointer* filePointer) {
+	return FR_NO_PATH;
+}
+
+FRESULT f_write(FIL* fp, const void* buff, UINT btw, UINT* bw) {
+	*bw = 0;
+	return FR_WRITE_PROTECTED;
+}
+
+FRESULT f_truncate(FIL* fp) {
+	return FR_WRITE_PROTECTED;
+}
+
+FRESULT f_mkdir(const TCHAR* path) {
+	return FR_WRITE_PROTECTED;
+}
+
+FRESULT f_unlink(const TCHAR* path) {
+	return FR_WRITE_PROTECTED;
+}
+
+FRESULT f_rename(const TCHAR* path_old, const TCHAR* path_new) {
+	return FR_WRITE_PROTECTED;
+}
+
+// Going straight to the directory entries and the FAT, or to the card itself
+
+FRESULT create_name(DIR* dp, const TCHAR** path) {
+	return FR_INVALID_NAME;
+}
+
+FRESULT dir_find(DIR* dp) {
+	return FR_NO_FILE;
+}
+
+DWORD ld_dword(const BYTE* ptr) {
+	return ptr[0] | (ptr[1] << 8) | (ptr[2] << 16) | ((DWORD)ptr[3] << 24);
+}
+
+DWORD ld_clust(FATFS* fs, const BYTE* dir) {
+	return 0;
+}
+
+DWORD get_fat_from_fs(FATFS* fs, DWORD clst) {
+	return 0xFFFFFFFF;
+}
+
+LBA_t clst2sect(FATFS* fs, DWORD clst) {
+	return 0;
+}
+
+DRESULT disk_read(BYTE pdrv, BYTE* buff, LBA_t sector, UINT count) {
+	return RES_ERROR;
+}
+
+DRESULT disk_read_without_streaming_first(BYTE pdrv, BYTE* buff, DWORD sector, UINT count) {
+	return RES_ERROR;
+}
+
+DRESULT disk_write(BYTE pdrv, const BYTE* buff, LBA_t sector, UINT count) {
+	return RES_ERROR;
+}
+
+void disk_timerproc(UINT msPassed) {
+}
+}
@@ -0,0 +1,249 @@
+// The RZ/A1 drivers the firmware calls into, for the offline renderer. Nearly nothing here does anything: there's no
+// panel, card, MIDI or USB to talk to. Registers the firmware reads directly, like the timers, come from mock_memory.c
+// instead
+
+#include "RZA1/gpio/gpio.h"
+#include "RZA1/intc/devdrv_intc.h"
+#include "RZA1/oled/oled_low_level.h"
+#include "RZA1/rspi/rspi.h"
+#include "RZA1/spibsc/r_spibsc_flash_api.h"
+#include "RZA1/spibsc/spibsc_Deluge_setup.h"
+#include "RZA1/uart/sio_char.h"
+#include "RZA1/usb/r_usb_basic/r_usb_basic_if.h"
+#include "RZA1/usb/r_usb_hmidi/src/inc/r_usb_hmidi.h"
+#include "RZA1/usb/userdef/r_usb_hmidi_config.h"
+#include "definitions.h"
+#include "drivers/oled/oled.h"
+#include "drivers/ssi/ssi.h"
+#include "drivers/uart/uart.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+// Interrupts
+
+volatile uint32_t intc_func_active;
+
+int32_t R_INTC_Enable(uint16_t int_id) {
+	return 0;
+}
+
+int32_t R_INTC_Disable(uint16_t int_id) {
+	return 0;
+}
+
+uint8_t R_INTC_Enabled(uint16_t int_id) {
+	return 0;
+}
+
+// GPIO - every input reads low, so nothing's plugged in
+
+void setPinMux(uint8_t p, uint8_t q, uint8_t mux) {
+}
+
+void setPinAsOutput(uint8_t p, uint8_t q) {
+}
+
+void setPinAsInput(uint8_t p, uint8_t q) {
+}
+
+void setOutputState(uint8_t p, uint8_t q, uint16_t state) {
+}
+
+uint16_t readInput(uint8_t p, uint8_t q) {
+	return 0;
+}
+
+uint32_t triggerClockRisingEdgeTimes[TRIGGER_CLOCK_INPUT_NUM_TIMES_STORED];
+uint32_t triggerClockRisingEdgesReceived;
+uint32_t triggerClockRisingEdgesProcessed;
+
+// SPI, flash, OLED and CV
+
+volatile bool spiTransferQueueCurrentlySending;
+int oledWaitingForMessage = 256; // 256 means none
+
+void R_RSPI_Create(uint8_t channel, uint32_t bitRate, uint8_t phase, uint8_t dataSize) {
+}
+
+void R_RSPI_Start(uint8_t channel) {
+}
+
+void R_RSPI_SendBasic32(uint8_t channel, uint32_t data) {
+}
+
+void initSPIBSC() {
+}
+
+int32_t R_SFLASH_EraseSector(uint32_t addr, uint32_t ch_no, uint32_t dual, uint8_t data_width, uint8_t addr_mode) {
+	return -1;
+}
+
+int32_t R_SFLASH_ByteProgram(uint32_t addr, uint8_t* buf, int32_t size, uint32_t ch_no, uint32_t dual,
+                             uint8_t data_width, uint8_t addr_mode) {
+	return -1;
+}
+
+// Reads like freshly erased flash, so FlashStorage::readSettings() goes with the defaults
+int32_t R_SFLASH_ByteRead(uint32_t addr, uint8_t* buf, int32_t size, uint32_t ch_no, uint32_t dual,
+                          uint8_t data_width, uint8_t addr_mode) {
+	memset(buf, 0xFF, size);
+	return 0;
+}
+
+void oledMainInit() {
+}
+
+void oledDMAInit() {
+}
+
+void enqueueSPITransfer(int32_t whichOled, uint8_t const* image) {
+}
+
+void oledSelectingComplete() {
+}
+
+void oledDeselectionComplete() {
+}
+
+void oledLowLevelTimerCallback() {
+}
+
+void oledRoutine() {
+}
+
+void setupSPIInterrupts() {
+}
+
+void enqueueCVMessage(int channel, uint32_t message) {
+}
+
+void v7_dma_flush_range(uintptr_t start, uintptr_t end) {
+}
+
+// SSI. The "DMA" only moves when the renderer says so, so any AudioEngine::routine() calls made while loading find no
+// room to render into and go straight back
+
+int32_t ssiTxBuffer[SSI_TX_BUFFER_NUM_SAMPLES * NUM_MONO_OUTPUT_CHANNELS];
+int32_t ssiRxBuffer[SSI_RX_BUFFER_NUM_SAMPLES * NUM_MONO_INPUT_CHANNELS];
+static int32_t* txBufferCurrentPlace = ssiTxBuffer;
+
+void advanceTxBufferCurrentPlace(int32_t numSamples) {
+	txBufferCurrentPlace += numSamples * NUM_MONO_OUTPUT_CHANNELS;
+	if (txBufferCurrentPlace >= getTxBufferEnd()) {
+		txBufferCurrentPlace -= SSI_TX_BUFFER_NUM_SAMPLES * NUM_MONO_OUTPUT_CHANNELS;
+	}
+}
+
+void ssiInit(uint8_t ssiChannel, uint8_t dmaChannel) {
+}
+
+void* getTxBufferCurrentPlace() {
+	return txBufferCurrentPlace;
+}
+
+void* getRxBufferCurrentPlace() {
+	return ssiRxBuffer;
+}
+
+int32_t* getTxBufferStart() {
+	return ssiTxBuffer;
+}
+
+int32_t* getTxBufferEnd() {
+	return ssiTxBuffer + SSI_TX_BUFFER_NUM_SAMPLES * NUM_MONO_OUTPUT_CHANNELS;
+}
+
+int32_t* getRxBufferStart() {
+	return ssiRxBuffer;
+}
+
+int32_t* getRxBufferEnd() {
+	return ssiRxBuffer + SSI_RX_BUFFER_NUM_SAMPLES * NUM_MONO_INPUT_CHANNELS;
+}
+
+// UART, to the PIC and MIDI. What gets written just piles up in the buffers and is never sent
+
+struct UartItem uartItems[NUM_UART_ITEMS];
+uint8_t picTxBuffer[PIC_TX_BUFFER_SIZE];
+char midiTxBuffer[MIDI_TX_BUFFER_SIZE];
+
+void uartSetBaudRate(uint8_t scifID, uint32_t baudRate) {
+}
+
+uint8_t uartGetChar(int32_t item, char* readData) {
+	return 0;
+}
+
+uint32_t* uartGetCharWithTiming(int32_t timingCaptureItem, char* readData) {
+	return NULL;
+}
+
+void uartPutCharBack(int32_t item) {
+}
+
+void uartFlushIfNotSending(int32_t item) {
+}
+
+int32_t uartGetTxBufferFullnessByItem(int32_t item) {
+	return 0;
+}
+
+int32_t uartGetTxBufferSpace(int32_t item) {
+	return 0;
+}
+
+// Debug output, which would otherwise have gone out over RTT or MIDI
+
+void uartPrintln(char const* output) {
+	fprintf(stderr, "%s\n", output);
+}
+
+void uartPrint(char const* output) {
+	fputs(output, stderr);
+}
+
+void uartPrintNumber(int32_t number) {
+	fprintf(stderr, "%d\n", number);
+}
+
+void uartPrintlnFloat(float number) {
+	fprintf(stderr, "%f\n", number);
+}
+
+void putchar_(char c) {
+	fputc(c, stderr);
+}
+
+// USB - never connected
+
+uint16_t g_usb_usbmode;
+uint16_t g_usb_peri_connected;
+uint8_t anythingInitiallyAttachedAsUSBHost;
+uint16_t g_usb_hmidi_tmp_ep_tbl[USB_NUM_USBIP][MAX_NUM_USB_MIDI_DEVICES][(USB_EPL * 2) + 1];
+usb_utr_t* g_p_usb_pipe[USB_MAX_PIPE_NO + 1u];
+
+void openUSBHost() {
+}
+
+void closeUSBHost() {
+}
+
+void openUSBPeripheral() {
+}
+
+void usb_cstd_usb_task() {
+}
+
+usb_regadr_t usb_hstd_get_usb_ip_adr(uint16_t ipno) {
+	return NULL;
+}
+
+void change_destination_of_send_pipe(usb_utr_t* ptr, uint16_t pipe, uint16_t* tbl, int32_t sq) {
+}
+
+void usb_send_start_rohan(usb_utr_t* ptr, uint16_t pipe, uint8_t const* data, int32_t size) {
+}
+
+void usb_receive_start_rohan_midi(uint16_t pipe) {
+}
@@ -0,0 +1,72 @@
+// The firmware puts its memory regions, its stack, and some registers it reads at fixed addresses - so for the offline
+// renderer, those addresses get mapped before anything else runs. Where the regions are is set at link time, with
+// --defsym, as the Deluge's linker script would
+
+#define _GNU_SOURCE
+#include "RZA1/cpu_specific.h"
+#include "RZA1/system/iodefine.h"
+#include "RZA1/uart/sio_char.h"
+#include "definitions.h"
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+extern uint32_t __sdram_bss_end;
+extern uint32_t __heap_start;
+extern uint32_t program_stack_start;
+extern uint32_t program_stack_end;
+
+static void mapAt(uintptr_t start, uintptr_t end, char const* name) {
+	uintptr_t pageMask = getpagesize() - 1;
+	start &= ~pageMask;
+	end = (end + pageMask) & ~pageMask;
+
+	void* address = mmap((void*)start, end - start, PROT_READ | PROT_WRITE,
+	                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+	if (address != (void*)start) {
+		fprintf(stderr, "Couldn't map %s at 0x%08lx\n", name, (unsigned long)start);
+		exit(1);
+	}
+}
+
+// Ahead of the static constructors, some of which allocate
+__attribute__((constructor(101))) static void mapDelugeMemory() {
+	mapAt((uintptr_t)&__sdram_bss_end, EXTERNAL_MEMORY_END, "SDRAM");
+	mapAt((uintptr_t)&__heap_start, (uintptr_t)&program_stack_end, "internal RAM");
+
+	// Only ever reads 0 - so StorageManager never thinks it's time to yield, and nothing else that looks at the timers
+	// gets called offline
+	mapAt((uintptr_t)&MTU2, (uintptr_t)&MTU2 + sizeof(MTU2), "MTU2");
+
+	// Bytes for the PIC and MIDI get written through the uncached mirror of their buffers, and nothing reads them back
+	// - so all that's needed is somewhere for them to land. Both buffers are in mock_hardware.c, next to each other
+	uintptr_t txBuffersStart = (uintptr_t)picTxBuffer < (uintptr_t)midiTxBuffer ? (uintptr_t)picTxBuffer
+	                                                                              : (uintptr_t)midiTxBuffer;
+	uintptr_t txBuffersEnd = (uintptr_t)picTxBuffer < (uintptr_t)midiTxBuffer
+	                             ? (uintptr_t)midiTxBuffer + MIDI_TX_BUFFER_SIZE
+	                             : (uintptr_t)picTxBuffer + PIC_TX_BUFFER_SIZE;
+	mapAt(txBuffersStart + UNCACHED_MIRROR_OFFSET, txBuffersEnd + UNCACHED_MIRROR_OFFSET, "UART buffers' mirror");
+}
+
+// The firmware keeps an eye on how close the stack has got to program_stack_start, and keeps pointers to things on it
+// in uint32_ts - so it has to run on a stack where the Deluge's would be
+void* runOnDelugeStack(void* (*function)(void*), void* argument) {
+	pthread_attr_t attributes;
+	pthread_attr_init(&attributes);
+	pthread_attr_setstack(&attributes, &program_stack_start,
+	                      (uintptr_t)&program_stack_end - (uintptr_t)&program_stack_start);
+
+	pthread_t thread;
+	if (pthread_create(&thread, &attributes, function, argument)) {
+		fprintf(stderr, "Couldn't start a thread on the Deluge's stack\n");
+		exit(1);
+	}
+
+	void* result;
+	pthread_join(thread, &result);
+	pthread_attr_destroy(&attributes);
+	return result;
+}
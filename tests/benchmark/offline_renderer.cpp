@@ -0,0 +1,168 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "offline_renderer.h"
+#include "definitions_cxx.hpp"
+#include "gui/ui/ui.h"
+#include "gui/views/session_view.h"
+#include "hid/display/seven_segment.h"
+#include "memory/general_memory_allocator.h"
+#include "model/global_effectable/global_effectable.h"
+#include "model/settings/runtime_feature_settings.h"
+#include "model/song/song.h"
+#include "playback/mode/session.h"
+#include "playback/playback_handler.h"
+#include "processing/engines/audio_engine.h"
+#include "storage/audio/audio_file_manager.h"
+#include "storage/flash_storage.h"
+#include "storage/storage_manager.h"
+#include "util/functions.h"
+#include <algorithm>
+#include <chrono>
+
+extern "C" {
+#include "drivers/ssi/ssi.h"
+}
+
+extern void setupBlankSong();
+extern void deleteOldSongBeforeLoadingNew();
+
+// From mocks/mock_hardware.c
+extern "C" void advanceTxBufferCurrentPlace(int32_t numSamples);
+
+namespace deluge::benchmark {
+
+OfflineRenderer::OfflineRenderer(RenderConfig const& config)
+    : config(config), outputReadPos((int32_t*)AudioEngine::i2sTXBufferPos) {
+}
+
+void OfflineRenderer::initFirmware() {
+	functionsInit();
+	currentPlaybackMode = &session;
+	display = new deluge::hid::display::SevenSegment;
+
+	AudioEngine::init();
+	audioFileManager.init();
+
+	FlashStorage::readSettings();
+	runtimeFeatureSettings.init();
+
+	setupBlankSong();
+}
+
+int32_t OfflineRenderer::loadSong() {
+	FilePointer filePointer;
+	if (!storageManager.fileExists(config.songPath, &filePointer)) {
+		return ERROR_FILE_NOT_FOUND;
+	}
+
+	int32_t error = storageManager.openXMLFile(&filePointer, "song");
+	if (error) {
+		return error;
+	}
+
+	deleteOldSongBeforeLoadingNew();
+
+	void* songMemory = GeneralMemoryAllocator::get().allocMaxSpeed(sizeof(Song));
+	if (!songMemory) {
+		storageManager.closeFile();
+		return ERROR_INSUFFICIENT_RAM;
+	}
+
+	preLoadedSong = new (songMemory) Song();
+	error = preLoadedSong->paramManager.setupUnpatched();
+	if (!error) {
+		GlobalEffectable::initParams(&preLoadedSong->paramManager);
+		error = preLoadedSong->readFromFile();
+	}
+	storageManager.closeFile();
+	if (error) {
+		void* toDealloc = dynamic_cast<void*>(preLoadedSong);
+		preLoadedSong->~Song();
+		delugeDealloc(toDealloc);
+		preLoadedSong = NULL;
+		return error;
+	}
+
+	// As LoadSongUI::performLoad() does it when nothing's playing
+	preLoadedSong->loadAllSamples(true);
+	int32_t count = 0;
+	while (audioFileManager.loadingQueueHasAnyLowestPriorityElements() && count < 1024) {
+		audioFileManager.loadAnyEnqueuedClusters();
+		count++;
+	}
+
+	playbackHandler.doSongSwap();
+	audioFileManager.loadAnyEnqueuedClusters(99999);
+	currentSong->loadAllSamples();
+
+	// There's no UI running to do setUIForLoadedSong(), but playback looks at which view's open to decide between
+	// session and arranger
+	setRootUILowLevel(&sessionView);
+	return NO_ERROR;
+}
+
+void OfflineRenderer::startPlayback() {
+	playbackHandler.setupPlaybackUsingInternalClock(0, false);
+}
+
+void OfflineRenderer::render(int32_t numSamples, std::vector<int16_t>& output) {
+	int32_t stopAt = numSamplesOutput + numSamples;
+
+	while (numSamplesOutput < stopAt) {
+		advanceTxBufferCurrentPlace(config.dmaStepSamples);
+
+		// The host never falls behind the way the Deluge would, so there's never a reason to cull
+		AudioEngine::bypassCulling = true;
+
+		uint32_t startSample = AudioEngine::audioSampleTimer;
+		auto startTime = std::chrono::steady_clock::now();
+		AudioEngine::routine();
+		auto endTime = std::chrono::steady_clock::now();
+
+		uint32_t numSamplesRendered = AudioEngine::audioSampleTimer - startSample;
+		if (numSamplesRendered) {
+			windowStats.push_back({
+			    .startSample = startSample,
+			    .numSamples = (uint16_t)numSamplesRendered,
+			    .numVoices = (uint16_t)AudioEngine::getNumVoices(),
+			    .renderNanoseconds =
+			        (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - startTime).count(),
+			});
+		}
+
+		collectOutput(output);
+	}
+}
+
+void OfflineRenderer::collectOutput(std::vector<int16_t>& output) {
+	int32_t* writtenUpTo = (int32_t*)AudioEngine::i2sTXBufferPos;
+
+	while (outputReadPos != writtenUpTo) {
+		// What doSomeOutputting() wrote is already gained up and saturated for the codec - so just the top 16 bits
+		output.push_back(outputReadPos[0] >> 16);
+		output.push_back(outputReadPos[1] >> 16);
+		numSamplesOutput++;
+
+		outputReadPos += NUM_MONO_OUTPUT_CHANNELS;
+		if (outputReadPos == getTxBufferEnd()) {
+			outputReadPos = getTxBufferStart();
+		}
+	}
+}
+
+} // namespace deluge::benchmark
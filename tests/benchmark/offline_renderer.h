@@ -0,0 +1,78 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+/*
+ * Plays a song file through the firmware itself, on the host, faster than real time.
+ *
+ * All of src/deluge is linked in, against the RZ/A1 stand-ins in mocks/. The song gets loaded the way LoadSongUI does
+ * it, then played with the internal clock. Offline, nothing moves the SSI DMA, so the renderer moves the stub one
+ * dmaStepSamples at a time and calls AudioEngine::routine() after each move - the same thing the main loop does on
+ * the Deluge. routine() decides the window lengths, the timer ticks shorten them, and Song::renderAudio(),
+ * Sound::render() and Voice::render() do the rest. The output comes back out of ssiTxBuffer.
+ *
+ * Every routine() call that rendered something is timed with the host's monotonic clock, so the numbers are only
+ * meaningful relative to another run on the same machine - but that's exactly what's needed to catch regressions in
+ * CI.
+ */
+
+namespace deluge::benchmark {
+
+struct RenderConfig {
+	char const* songPath = nullptr;
+	int32_t dmaStepSamples = 16; // How far the "DMA" gets between routine() calls
+};
+
+struct WindowStats {
+	uint32_t startSample;
+	uint16_t numSamples;
+	uint16_t numVoices;
+	uint32_t renderNanoseconds;
+};
+
+class OfflineRenderer {
+public:
+	explicit OfflineRenderer(RenderConfig const& config);
+
+	/// Does what deluge_main() would have, short of the main loop. Call once, before anything else.
+	static void initFirmware();
+
+	/// Loads the song at config.songPath in place of the current one. Returns an error code, like the firmware does.
+	int32_t loadSong();
+
+	void startPlayback();
+
+	/// Renders numSamples more samples of audio, appending them to output as 16-bit interleaved stereo.
+	void render(int32_t numSamples, std::vector<int16_t>& output);
+
+	[[nodiscard]] std::vector<WindowStats> const& getWindowStats() const { return windowStats; }
+
+private:
+	void collectOutput(std::vector<int16_t>& output);
+
+	RenderConfig config;
+	int32_t* outputReadPos;
+	int32_t numSamplesOutput = 0;
+
+	std::vector<WindowStats> windowStats;
+};
+
+} // namespace deluge::benchmark
@@ -0,0 +1,209 @@
+/*
+ * Copyright © 2024 Synthstrom Audible Limited
+ *
+ * This file is part of The Synthstrom Audible Deluge Firmware.
+ *
+ * The Synthstrom Audible Deluge Firmware is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.
+ * If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Plays a song file through the firmware on the host, faster than real time, and reports how long each audio window
+// took. Usage:
+//
+//   RenderBenchmark [--song SONG.XML] [--seconds N] [--window N] [--wav out.wav] [--csv windows.csv]
+//
+// The song defaults to songs/BENCHMARK.XML, which only uses the synth engine - Samples can't be streamed offline.
+
+#include "definitions_cxx.hpp"
+#include "offline_renderer.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+using namespace deluge::benchmark;
+
+// From mocks/mock_memory.c
+extern "C" void* runOnDelugeStack(void* (*function)(void*), void* argument);
+
+namespace {
+
+// How much gets rendered between writes to the WAV file. Everything the firmware allocates, std::vector included,
+// comes out of its own RAM, so the whole render can't be held at once
+constexpr int32_t kChunkSamples = kSampleRate;
+
+void writeLE(FILE* file, uint32_t value, int32_t numBytes) {
+	for (int32_t i = 0; i < numBytes; i++) {
+		fputc((value >> (i * 8)) & 0xFF, file);
+	}
+}
+
+void writeWavHeader(FILE* file, uint32_t dataBytes) {
+	fwrite("RIFF", 1, 4, file);
+	writeLE(file, 36 + dataBytes, 4);
+	fwrite("WAVEfmt ", 1, 8, file);
+	writeLE(file, 16, 4);              // fmt chunk length
+	writeLE(file, 1, 2);               // PCM
+	writeLE(file, 2, 2);               // Channels
+	writeLE(file, kSampleRate, 4);     // Sample rate
+	writeLE(file, kSampleRate * 4, 4); // Byte rate
+	writeLE(file, 4, 2);               // Block align
+	writeLE(file, 16, 2);              // Bits per sample
+	fwrite("data", 1, 4, file);
+	writeLE(file, dataBytes, 4);
+}
+
+bool writeCSV(char const* path, std::vector<WindowStats> const& stats) {
+	FILE* file = fopen(path, "w");
+	if (!file) {
+		return false;
+	}
+	fprintf(file, "start_sample,num_samples,num_voices,render_ns\n");
+	for (WindowStats const& window : stats) {
+		fprintf(file, "%u,%u,%u,%u\n", window.startSample, window.numSamples, window.numVoices,
+		        window.renderNanoseconds);
+	}
+	fclose(file);
+	return true;
+}
+
+void printReport(RenderConfig const& config, std::vector<WindowStats> const& stats) {
+	if (stats.empty()) {
+		return;
+	}
+
+	std::vector<uint32_t> perSampleNs;
+	uint64_t totalNs = 0;
+	uint32_t numSamples = 0;
+	uint32_t maxVoices = 0;
+	uint64_t voiceSamples = 0;
+	for (WindowStats const& window : stats) {
+		totalNs += window.renderNanoseconds;
+		numSamples += window.numSamples;
+		perSampleNs.push_back(window.renderNanoseconds / window.numSamples);
+		maxVoices = std::max<uint32_t>(maxVoices, window.numVoices);
+		voiceSamples += (uint64_t)window.numVoices * window.numSamples;
+	}
+	std::sort(perSampleNs.begin(), perSampleNs.end());
+
+	double audioSeconds = (double)numSamples / kSampleRate;
+	double renderSeconds = totalNs / 1e9;
+
+	printf("song:                %s\n", config.songPath);
+	printf("DMA step:            %d samples\n", config.dmaStepSamples);
+	printf("windows rendered:    %zu\n", stats.size());
+	printf("audio rendered:      %.2f s\n", audioSeconds);
+	printf("render time:         %.3f s (%.1fx real time)\n", renderSeconds, audioSeconds / renderSeconds);
+	printf("load vs real time:   %.2f%%\n", 100 * renderSeconds / audioSeconds);
+	printf("voices:              %.1f mean, %u max\n", (double)voiceSamples / numSamples, maxVoices);
+	printf("ns per sample:       %u p50, %u p99, %u max\n", perSampleNs[perSampleNs.size() / 2],
+	       perSampleNs[perSampleNs.size() * 99 / 100], perSampleNs.back());
+	if (voiceSamples) {
+		printf("ns per voice-sample: %.2f\n", (double)totalNs / voiceSamples);
+	}
+}
+
+struct Options {
+	RenderConfig config;
+	float seconds = 10;
+	char const* wavPath = nullptr;
+	char const* csvPath = nullptr;
+};
+
+void* runBenchmark(void* optionsPointer) {
+	Options const& options = *(Options*)optionsPointer;
+
+	OfflineRenderer::initFirmware();
+	OfflineRenderer renderer(options.config);
+
+	int32_t error = renderer.loadSong();
+	if (error) {
+		fprintf(stderr, "Couldn't load %s: error %d\n", options.config.songPath, error);
+		return (void*)1;
+	}
+
+	FILE* wavFile = nullptr;
+	if (options.wavPath) {
+		wavFile = fopen(options.wavPath, "wb");
+		if (!wavFile) {
+			fprintf(stderr, "Couldn't write %s\n", options.wavPath);
+			return (void*)1;
+		}
+		writeWavHeader(wavFile, 0); // Sizes filled in at the end
+	}
+
+	renderer.startPlayback();
+
+	std::vector<int16_t> output;
+	uint32_t numSamples = options.seconds * kSampleRate;
+	uint32_t numSamplesDone = 0; // Windows don't end exactly on a chunk, so this can go a little past numSamples
+	while (numSamplesDone < numSamples) {
+		output.clear();
+		renderer.render(std::min<uint32_t>(kChunkSamples, numSamples - numSamplesDone), output);
+		numSamplesDone += output.size() / 2;
+		if (wavFile) {
+			for (int16_t sample : output) {
+				writeLE(wavFile, (uint16_t)sample, 2);
+			}
+		}
+	}
+
+	printReport(options.config, renderer.getWindowStats());
+
+	if (wavFile) {
+		fseek(wavFile, 0, SEEK_SET);
+		writeWavHeader(wavFile, numSamplesDone * 4);
+		fclose(wavFile);
+	}
+	if (options.csvPath && !writeCSV(options.csvPath, renderer.getWindowStats())) {
+		fprintf(stderr, "Couldn't write %s\n", options.csvPath);
+		return (void*)1;
+	}
+	return nullptr;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	Options options;
+	options.config.songPath = DEFAULT_SONG_PATH;
+
+	for (int32_t i = 1; i < argc; i++) {
+		bool hasValue = (i + 1 < argc);
+		if (!strcmp(argv[i], "--song") && hasValue) {
+			options.config.songPath = argv[++i];
+		}
+		else if (!strcmp(argv[i], "--seconds") && hasValue) {
+			options.seconds = atof(argv[++i]);
+		}
+		else if (!strcmp(argv[i], "--window") && hasValue) {
+			// Much more than half the buffer, and routine() could render right round into what the DMA hasn't sent yet
+			options.config.dmaStepSamples = std::clamp(atoi(argv[++i]), 1, SSI_TX_BUFFER_NUM_SAMPLES / 2);
+		}
+		else if (!strcmp(argv[i], "--wav") && hasValue) {
+			options.wavPath = argv[++i];
+		}
+		else if (!strcmp(argv[i], "--csv") && hasValue) {
+			options.csvPath = argv[++i];
+		}
+		else {
+			fprintf(stderr, "Unknown or incomplete argument: %s\n", argv[i]);
+			return 1;
+		}
+	}
+
+	int32_t result = runOnDelugeStack(runBenchmark, &options) ? 1 : 0;
+
+	// The firmware never gets torn down, and its static destructors aren't up to it - GeneralMemoryAllocator's frees
+	// its own arrays into itself. So leave without running them
+	fflush(stdout);
+	_Exit(result);
+}
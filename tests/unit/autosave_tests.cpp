@@ -0,0 +1,150 @@
+#include "CppUTest/TestHarness.h"
+#include "memory/general_memory_allocator.h"
+#include "storage/autosave_schedule.h"
+#include "storage/memory_file.h"
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace {
+constexpr uint32_t kQuiet = AutosaveSchedule::kQuietTimeSamples;
+constexpr uint32_t kInterval = AutosaveSchedule::kMinIntervalSamples;
+constexpr uint32_t kMemSize = 1 << 20;
+} // namespace
+
+TEST_GROUP(AutosaveSchedule){};
+
+TEST(AutosaveSchedule, nothingDueUntilEdited) {
+	AutosaveSchedule schedule;
+	CHECK(!schedule.isDue(kInterval * 10));
+
+	schedule.songSaved(0);
+	CHECK(!schedule.isDue(kInterval * 10));
+}
+
+TEST(AutosaveSchedule, waitsForQuietAfterLastEdit) {
+	AutosaveSchedule schedule;
+	schedule.songSaved(0);
+	uint32_t timeEdited = kInterval * 2;
+	schedule.songEdited(timeEdited);
+
+	CHECK(!schedule.isDue(timeEdited));
+	CHECK(!schedule.isDue(timeEdited + kQuiet - 1));
+	CHECK(schedule.isDue(timeEdited + kQuiet));
+
+	// Another edit puts it back
+	schedule.songEdited(timeEdited + kQuiet);
+	CHECK(!schedule.isDue(timeEdited + kQuiet));
+	CHECK(schedule.isDue(timeEdited + kQuiet * 2));
+}
+
+TEST(AutosaveSchedule, waitsForIntervalSinceLastSave) {
+	AutosaveSchedule schedule;
+	schedule.songSaved(1000);
+	schedule.songEdited(1000);
+
+	// Quiet long enough, but not long enough since the save
+	CHECK(!schedule.isDue(1000 + kQuiet));
+	CHECK(!schedule.isDue(1000 + kInterval - 1));
+	CHECK(schedule.isDue(1000 + kInterval));
+}
+
+TEST(AutosaveSchedule, editsDuringAutosaveAreForTheNextOne) {
+	AutosaveSchedule schedule;
+	schedule.songEdited(0);
+	uint32_t timeStarted = kInterval;
+	CHECK(schedule.isDue(timeStarted));
+
+	schedule.autosaveStarted(timeStarted);
+	CHECK(!schedule.hasUnsavedChanges());
+	CHECK(!schedule.isDue(timeStarted + kInterval));
+
+	// While the copy's still going onto the card
+	schedule.songEdited(timeStarted + 10);
+	CHECK(schedule.hasUnsavedChanges());
+	CHECK(!schedule.isDue(timeStarted + kInterval - 1));
+	CHECK(schedule.isDue(timeStarted + kInterval));
+}
+
+TEST(AutosaveSchedule, failedAutosaveIsRetriedAfterInterval) {
+	AutosaveSchedule schedule;
+	schedule.songEdited(0);
+	schedule.autosaveStarted(kInterval);
+	schedule.autosaveFailed();
+
+	CHECK(schedule.hasUnsavedChanges());
+	CHECK(!schedule.isDue(kInterval + kQuiet));
+	CHECK(schedule.isDue(kInterval * 2));
+}
+
+TEST(AutosaveSchedule, copesWithTimerWrapping) {
+	AutosaveSchedule schedule;
+	uint32_t timeSaved = 0xFFFFFFFF - kInterval / 2;
+	schedule.songSaved(timeSaved);
+	schedule.songEdited(timeSaved + 1);
+
+	CHECK(!schedule.isDue(timeSaved + kInterval - 1));
+	CHECK(schedule.isDue(timeSaved + kInterval));
+}
+
+TEST_GROUP(MemoryFile) {
+	// The allocator's regions are at the hardware's addresses, so give it some real memory instead
+	void setup() {
+		GeneralMemoryAllocator& allocator = GeneralMemoryAllocator::get();
+		uint32_t emptySpacesSize = sizeof(EmptySpaceRecord) * 512;
+		void* emptySpacesMemory = calloc(1, emptySpacesSize);
+		void* memory = calloc(1, kMemSize);
+		allocator.regions[MEMORY_REGION_EXTERNAL].setup(emptySpacesMemory, emptySpacesSize, (uint32_t)memory,
+		                                                (uint32_t)memory + kMemSize);
+	}
+};
+
+TEST(MemoryFile, readsBackWhatWasAppendedInSlices) {
+	std::vector<uint8_t> data(10000);
+	for (size_t i = 0; i < data.size(); i++) {
+		data[i] = (uint8_t)(i * 7 + (i >> 8));
+	}
+
+	MemoryFile file;
+	// Appended in uneven pieces, as the last Cluster of a file would be
+	for (size_t pos = 0; pos < data.size(); pos += 3000) {
+		CHECK_EQUAL(NO_ERROR, file.append(&data[pos], std::min<size_t>(3000, data.size() - pos)));
+	}
+	CHECK_EQUAL(data.size(), file.getSize());
+
+	std::vector<uint8_t> readBack;
+	void const* bytes;
+	int32_t numBytes;
+	while ((numBytes = file.readNext(&bytes, 1024))) {
+		CHECK(numBytes <= 1024);
+		readBack.insert(readBack.end(), (uint8_t const*)bytes, (uint8_t const*)bytes + numBytes);
+	}
+	CHECK(readBack == data);
+
+	// And again from the start
+	file.rewind();
+	CHECK_EQUAL(1024, file.readNext(&bytes, 1024));
+	CHECK(!memcmp(bytes, &data[0], 1024));
+}
+
+TEST(MemoryFile, emptyAfterClear) {
+	MemoryFile file;
+	uint8_t data[100] = {1, 2, 3};
+	CHECK_EQUAL(NO_ERROR, file.append(data, sizeof(data)));
+	file.clear();
+
+	void const* bytes;
+	CHECK_EQUAL(0, file.getSize());
+	CHECK_EQUAL(0, file.readNext(&bytes, 1024));
+
+	// And usable again
+	CHECK_EQUAL(NO_ERROR, file.append(data, 3));
+	CHECK_EQUAL(3, file.readNext(&bytes, 1024));
+}
+
+TEST(MemoryFile, failsWhenOutOfRAM) {
+	MemoryFile file;
+	std::vector<uint8_t> data(kMemSize * 2);
+	CHECK_EQUAL(ERROR_INSUFFICIENT_RAM, file.append(data.data(), data.size()));
+	CHECK_EQUAL(0, file.getSize());
+}
@@ -0,0 +1,220 @@
+#include "CppUTest/TestHarness.h"
+#include "definitions_cxx.hpp"
+#include "storage/binary_song_format.h"
+#include "util/d_string.h"
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+constexpr int32_t kNumNotes = 100;
+constexpr int32_t kNumNodes = 60;
+
+// Hands the bytes out a few at a time, so records keep straddling the ends of what's been read - as they would the
+// ends of Clusters on the card
+class MemorySource : public BinarySongFormat::Source {
+public:
+	MemorySource(std::vector<uint8_t> const& data, int32_t chunkSize) : data(data), chunkSize(chunkSize) {}
+
+	int32_t read(void* buffer, int32_t maxNumBytes) override {
+		int32_t numBytes = std::min<int32_t>({maxNumBytes, chunkSize, (int32_t)(data.size() - pos)});
+		memcpy(buffer, &data[pos], numBytes);
+		pos += numBytes;
+		return numBytes;
+	}
+
+	std::vector<uint8_t> const& data;
+	int32_t chunkSize;
+	size_t pos = 0;
+};
+
+class MemorySink : public BinarySongFormat::Sink {
+public:
+	bool write(void const* bytes, int32_t numBytes) override {
+		data.insert(data.end(), (uint8_t const*)bytes, (uint8_t const*)bytes + numBytes);
+		return true;
+	}
+
+	bool writeAt(uint32_t pos, void const* bytes, int32_t numBytes) override {
+		if (pos + numBytes > data.size()) {
+			return false;
+		}
+		memcpy(&data[pos], bytes, numBytes);
+		return true;
+	}
+
+	std::vector<uint8_t> data;
+};
+
+std::string toHex(uint32_t number, int32_t numChars) {
+	char buffer[9];
+	intToHex(number, buffer, numChars);
+	return buffer;
+}
+
+BinarySongFormat::NoteRecord getNote(int32_t n) {
+	return {n * 96 + 3, 48 - (n & 7), (uint8_t)(1 + n), (uint8_t)(127 - n), (uint8_t)(n % 20), 0};
+}
+
+BinarySongFormat::ParamNodeRecord getNode(int32_t n) {
+	return {(int32_t)(n * 0x01234567), n * 192, (uint8_t)(n & 1), {0, 0, 0}};
+}
+
+constexpr int32_t kCurrentValue = -0x12345678;
+
+// Laid out as the firmware would write it, with note data and automation long enough to cross several of the
+// converter's buffers
+std::vector<uint8_t> makeSongXML() {
+	std::string notesHex;
+	for (int32_t n = 0; n < kNumNotes; n++) {
+		BinarySongFormat::NoteRecord note = getNote(n);
+		notesHex += toHex(note.pos, 8) + toHex(note.length, 8) + toHex(note.velocity, 2) + toHex(note.lift, 2)
+		            + toHex(note.probability, 2);
+	}
+
+	std::string nodesHex;
+	for (int32_t n = 0; n < kNumNodes; n++) {
+		BinarySongFormat::ParamNodeRecord node = getNode(n);
+		nodesHex += toHex(node.value, 8) + toHex(node.pos | ((uint32_t)node.interpolated << 31), 8);
+	}
+
+	std::string xml = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<song\n\tfirmwareVersion=\"4.1.0\">\n"
+	                  "\t<noteRow\n\t\ty=\"60\"\n\t\tnoteDataWithLift=\"0x"
+	                  + notesHex + "\" />\n"
+	                  + "\t<defaultParams\n\t\tvolume=\"0x" + toHex(kCurrentValue, 8) + nodesHex + "\"\n"
+	                  + "\t\tpan = '0x" + toHex(kCurrentValue, 8) + nodesHex.substr(0, 16 * 3) + "'\n"
+	                  + "\t\treverbAmount=\"0x00000000\"\n\t\tname=\"Some > text\"\n"
+	                  + "\t\tclipInstances=\"0x" + nodesHex.substr(0, 24) + "\"\n"
+	                  + "\t\tnoteData=\"0x" + notesHex.substr(0, 40) + "\" />\n"
+	                  + "\t<value>0x" + toHex(kCurrentValue, 8) + nodesHex + "</value>\n</song>\n";
+	return std::vector<uint8_t>(xml.begin(), xml.end());
+}
+
+std::vector<uint8_t> convert(std::vector<uint8_t> const& input, bool toBinary, int32_t chunkSize,
+                             int32_t expectedError = NO_ERROR) {
+	MemorySource source(input, chunkSize);
+	MemorySink sink;
+	int32_t error = toBinary ? BinarySongFormat::convertXMLToBinary(source, sink)
+	                         : BinarySongFormat::convertBinaryToXML(source, sink);
+	CHECK_EQUAL(expectedError, error);
+	return sink.data;
+}
+
+// Reads back the records of the binary value which starts at pos, checking its layout along the way
+template <typename Record>
+std::vector<Record> readRecords(std::vector<uint8_t> const& binary, size_t pos, BinarySongFormat::ValueKind kind,
+                                int32_t expectedHeader) {
+	CHECK_EQUAL(BinarySongFormat::kBinaryValueMarker, binary[pos]);
+	CHECK_EQUAL((int32_t)kind, binary[pos + 1]);
+	int32_t header;
+	memcpy(&header, &binary[pos + 2], sizeof(header));
+	CHECK_EQUAL(expectedHeader, header);
+	pos += 6;
+
+	std::vector<Record> records;
+	while (true) {
+		uint32_t numBytes;
+		memcpy(&numBytes, &binary[pos], sizeof(numBytes));
+		pos += sizeof(numBytes);
+		if (!numBytes) {
+			break;
+		}
+		CHECK_EQUAL(0, numBytes % sizeof(Record));
+		size_t numRecordsBefore = records.size();
+		records.resize(numRecordsBefore + numBytes / sizeof(Record));
+		memcpy(&records[numRecordsBefore], &binary[pos], numBytes);
+		pos += numBytes;
+	}
+	CHECK_EQUAL('"', binary[pos]);
+	return records;
+}
+
+bool contains(std::vector<uint8_t> const& data, std::string const& text) {
+	return std::search(data.begin(), data.end(), text.begin(), text.end()) != data.end();
+}
+
+// Where the value of the attribute starting with this text begins
+size_t findValue(std::vector<uint8_t> const& data, std::string const& textBefore) {
+	auto found = std::search(data.begin(), data.end(), textBefore.begin(), textBefore.end());
+	CHECK(found != data.end());
+	return found - data.begin() + textBefore.size();
+}
+} // namespace
+
+TEST_GROUP(BinarySongFormat){};
+
+TEST(BinarySongFormat, roundTripsExactly) {
+	std::vector<uint8_t> xml = makeSongXML();
+
+	for (int32_t chunkSize : {1, 7, 13, 512, 4096}) {
+		std::vector<uint8_t> binary = convert(xml, true, chunkSize);
+		CHECK(binary.size() < xml.size());
+		std::vector<uint8_t> xmlAgain = convert(binary, false, chunkSize);
+		CHECK(xmlAgain == xml);
+	}
+}
+
+TEST(BinarySongFormat, hasHeaderAndDocumentChunk) {
+	std::vector<uint8_t> binary = convert(makeSongXML(), true, 7);
+
+	BinarySongFormat::FileHeader fileHeader;
+	BinarySongFormat::ChunkHeader chunkHeader;
+	memcpy(&fileHeader, &binary[0], sizeof(fileHeader));
+	memcpy(&chunkHeader, &binary[sizeof(fileHeader)], sizeof(chunkHeader));
+	CHECK_EQUAL(BinarySongFormat::kMagic, fileHeader.magic);
+	CHECK_EQUAL(BinarySongFormat::kVersion, fileHeader.version);
+	CHECK_EQUAL(BinarySongFormat::kDocumentChunk, chunkHeader.id);
+	CHECK_EQUAL(binary.size() - sizeof(fileHeader) - sizeof(chunkHeader), chunkHeader.length);
+}
+
+TEST(BinarySongFormat, notesAndNodesSurviveBufferBoundaries) {
+	std::vector<uint8_t> binary = convert(makeSongXML(), true, 13);
+
+	std::vector<BinarySongFormat::NoteRecord> notes = readRecords<BinarySongFormat::NoteRecord>(
+	    binary, findValue(binary, "noteDataWithLift=\""), BinarySongFormat::ValueKind::NOTES, 0);
+	CHECK_EQUAL(kNumNotes, notes.size());
+	for (int32_t n = 0; n < kNumNotes; n++) {
+		BinarySongFormat::NoteRecord expected = getNote(n);
+		CHECK_EQUAL(expected.pos, notes[n].pos);
+		CHECK_EQUAL(expected.length, notes[n].length);
+		CHECK_EQUAL(expected.velocity, notes[n].velocity);
+		CHECK_EQUAL(expected.lift, notes[n].lift);
+		CHECK_EQUAL(expected.probability, notes[n].probability);
+	}
+
+	std::vector<BinarySongFormat::ParamNodeRecord> nodes = readRecords<BinarySongFormat::ParamNodeRecord>(
+	    binary, findValue(binary, "volume=\""), BinarySongFormat::ValueKind::AUTOMATION, kCurrentValue);
+	CHECK_EQUAL(kNumNodes, nodes.size());
+	for (int32_t n = 0; n < kNumNodes; n++) {
+		BinarySongFormat::ParamNodeRecord expected = getNode(n);
+		CHECK_EQUAL(expected.value, nodes[n].value);
+		CHECK_EQUAL(expected.pos, nodes[n].pos);
+		CHECK_EQUAL(expected.interpolated, nodes[n].interpolated);
+	}
+}
+
+TEST(BinarySongFormat, leavesOtherValuesAsText) {
+	std::vector<uint8_t> xml = makeSongXML();
+	std::vector<uint8_t> binary = convert(xml, true, 512);
+
+	// Just the noteDataWithLift, volume and pan go binary
+	CHECK_EQUAL(BinarySongFormat::kBinaryValueMarker, binary[findValue(binary, "noteDataWithLift=\"")]);
+	CHECK_EQUAL(BinarySongFormat::kBinaryValueMarker, binary[findValue(binary, "volume=\"")]);
+	CHECK_EQUAL(BinarySongFormat::kBinaryValueMarker, binary[findValue(binary, "pan = '")]);
+	CHECK(contains(binary, "reverbAmount=\"0x00000000\""));
+	CHECK(contains(binary, "name=\"Some > text\""));
+	CHECK(contains(binary, "clipInstances=\"0x"));
+	CHECK(contains(binary, "noteData=\"0x"));
+	CHECK(contains(binary, "<value>0x" + toHex(kCurrentValue, 8)));
+}
+
+TEST(BinarySongFormat, refusesPartRecords) {
+	std::string xml = "<song\n\tvolume=\"0x" + toHex(0, 8) + toHex(1, 8) + toHex(2, 8) + "12345\" />\n";
+	convert(std::vector<uint8_t>(xml.begin(), xml.end()), true, 512, ERROR_FILE_CORRUPTED);
+}
+
+TEST(BinarySongFormat, refusesWhatIsntBinary) {
+	std::string xml = "<song />\n";
+	convert(std::vector<uint8_t>(xml.begin(), xml.end()), false, 512, ERROR_FILE_CORRUPTED);
+}
@@ -0,0 +1,114 @@
+#include "CppUTest/TestHarness.h"
+#include "storage/cluster/cluster_codec.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TEST_NUM_BYTES 32760 // A whole number of frames for all of 16/24-bit, mono/stereo
+
+namespace {
+uint8_t input[TEST_NUM_BYTES];
+uint8_t encoded[TEST_NUM_BYTES];
+uint8_t decoded[TEST_NUM_BYTES];
+
+void writeSine(int32_t byteDepth, int32_t numChannels, float noise) {
+	int32_t numFrames = TEST_NUM_BYTES / (byteDepth * numChannels);
+	uint8_t* pos = input;
+	for (int32_t i = 0; i < numFrames; i++) {
+		for (int32_t c = 0; c < numChannels; c++) {
+			float value = sinf(i * 0.01f * (c + 1)) * 0.5f + noise * ((rand() % 2001) - 1000) / 1000.f;
+			int32_t intValue = value * (byteDepth == 2 ? 32767 : 8388607);
+			for (int32_t b = 0; b < byteDepth; b++) {
+				*pos++ = intValue >> (b * 8);
+			}
+		}
+	}
+}
+
+uint32_t roundTrip(int32_t byteDepth, int32_t numChannels) {
+	uint32_t numEncoded = ClusterCodec::encode(input, TEST_NUM_BYTES, byteDepth, numChannels, encoded, TEST_NUM_BYTES);
+	if (numEncoded) {
+		memset(decoded, 0, TEST_NUM_BYTES);
+		CHECK(ClusterCodec::decode(encoded, numEncoded, byteDepth, numChannels, decoded, TEST_NUM_BYTES));
+		MEMCMP_EQUAL(input, decoded, TEST_NUM_BYTES);
+	}
+	return numEncoded;
+}
+} // namespace
+
+TEST_GROUP(ClusterCodec) {
+	void setup() { srand(1); }
+};
+
+TEST(ClusterCodec, smoothSignalsPackSmall) {
+	for (int32_t byteDepth = 2; byteDepth <= 3; byteDepth++) {
+		for (int32_t numChannels = 1; numChannels <= 2; numChannels++) {
+			writeSine(byteDepth, numChannels, 0);
+			uint32_t numEncoded = roundTrip(byteDepth, numChannels);
+			CHECK(numEncoded > 0);
+			CHECK(numEncoded < TEST_NUM_BYTES / 2);
+		}
+	}
+};
+
+TEST(ClusterCodec, noisySignalsStillRoundTrip) {
+	writeSine(3, 2, 0.3f);
+	CHECK(roundTrip(3, 2) > 0);
+};
+
+TEST(ClusterCodec, fullScaleJumpsEscape) {
+	// Now and then, a jump between the extremes - the biggest residual there can be
+	writeSine(3, 1, 0);
+	for (int32_t i = 0; i < TEST_NUM_BYTES; i += 3 * 500) {
+		input[i] = 0xFF;
+		input[i + 1] = 0xFF;
+		input[i + 2] = 0x7F;
+		input[i + 3] = 0x00;
+		input[i + 4] = 0x00;
+		input[i + 5] = 0x80;
+	}
+	CHECK(roundTrip(3, 1) > 0);
+};
+
+TEST(ClusterCodec, incompressibleDataDoesntFit) {
+	for (int32_t i = 0; i < TEST_NUM_BYTES; i++) {
+		input[i] = rand();
+	}
+	CHECK_EQUAL(0, ClusterCodec::encode(input, TEST_NUM_BYTES, 2, 2, encoded, TEST_NUM_BYTES * 3 / 4));
+};
+
+TEST(ClusterCodec, truncatedInputFails) {
+	writeSine(2, 2, 0.01f);
+	uint32_t numEncoded = ClusterCodec::encode(input, TEST_NUM_BYTES, 2, 2, encoded, TEST_NUM_BYTES);
+	CHECK(numEncoded > 100);
+	CHECK(!ClusterCodec::decode(encoded, numEncoded / 2, 2, 2, decoded, TEST_NUM_BYTES));
+};
+
+namespace {
+int32_t numTimesBetweenBlocks;
+void countBetweenBlocks() {
+	numTimesBetweenBlocks++;
+}
+} // namespace
+
+TEST(ClusterCodec, letsOthersGoAfterEveryBlock) {
+	writeSine(3, 2, 0.01f);
+	int32_t numFrames = TEST_NUM_BYTES / 6;
+	int32_t numBlocks = 2 * ((numFrames + ClusterCodec::kBlockSize - 1) / ClusterCodec::kBlockSize);
+
+	numTimesBetweenBlocks = 0;
+	uint32_t numEncoded =
+	    ClusterCodec::encode(input, TEST_NUM_BYTES, 3, 2, encoded, TEST_NUM_BYTES, countBetweenBlocks);
+	CHECK(numEncoded > 0);
+	CHECK_EQUAL(numBlocks, numTimesBetweenBlocks);
+
+	// And it's the same as without
+	CHECK_EQUAL(ClusterCodec::encode(input, TEST_NUM_BYTES, 3, 2, decoded, TEST_NUM_BYTES), numEncoded);
+	MEMCMP_EQUAL(encoded, decoded, numEncoded);
+
+	numTimesBetweenBlocks = 0;
+	memset(decoded, 0, TEST_NUM_BYTES);
+	CHECK(ClusterCodec::decode(encoded, numEncoded, 3, 2, decoded, TEST_NUM_BYTES, countBetweenBlocks));
+	CHECK_EQUAL(numBlocks, numTimesBetweenBlocks);
+	MEMCMP_EQUAL(input, decoded, TEST_NUM_BYTES);
+};
@@ -0,0 +1,134 @@
+#include "CppUTest/TestHarness.h"
+#include "storage/audio/prefetch_lookahead.h"
+#include "storage/audio/prefetched_cluster_list.h"
+#include <vector>
+
+namespace {
+// Never dereferenced - the list only keeps count of them
+Cluster* fakeCluster(uintptr_t n) {
+	return (Cluster*)(n * 64);
+}
+} // namespace
+
+TEST_GROUP(PrefetchedClusterList){};
+
+TEST(PrefetchedClusterList, releasesOnlyOnceDue) {
+	PrefetchedClusterList list;
+	list.add(fakeCluster(1), 1000);
+	list.add(fakeCluster(2), 2000);
+
+	POINTERS_EQUAL(nullptr, list.takeExpired(999));
+	POINTERS_EQUAL(fakeCluster(1), list.takeExpired(1000));
+	POINTERS_EQUAL(nullptr, list.takeExpired(1999));
+	CHECK_EQUAL(1, list.getNumClusters());
+	POINTERS_EQUAL(fakeCluster(2), list.takeExpired(2500));
+	CHECK_EQUAL(0, list.getNumClusters());
+}
+
+TEST(PrefetchedClusterList, holdingLongerNeverBringsReleaseForward) {
+	PrefetchedClusterList list;
+	list.add(fakeCluster(1), 1000);
+
+	CHECK(!list.holdLonger(fakeCluster(2), 5000));
+	CHECK(list.holdLonger(fakeCluster(1), 3000));
+	// A nearer note for the same Cluster mustn't cut short the hold for the later one
+	CHECK(list.holdLonger(fakeCluster(1), 1500));
+
+	POINTERS_EQUAL(nullptr, list.takeExpired(2999));
+	POINTERS_EQUAL(fakeCluster(1), list.takeExpired(3000));
+}
+
+TEST(PrefetchedClusterList, releaseTimesWrapWithTheTimer) {
+	PrefetchedClusterList list;
+	uint32_t timeNow = 0xFFFFFF00;
+	list.add(fakeCluster(1), timeNow + 0x200);
+
+	POINTERS_EQUAL(nullptr, list.takeExpired(timeNow));
+	POINTERS_EQUAL(nullptr, list.takeExpired(timeNow + 0x1FF));
+	POINTERS_EQUAL(fakeCluster(1), list.takeExpired(timeNow + 0x200));
+}
+
+TEST(PrefetchedClusterList, fillsUpAndEmptiesCompletely) {
+	PrefetchedClusterList list;
+	for (int32_t i = 0; i < PrefetchedClusterList::kMaxNumClusters; i++) {
+		CHECK(!list.isFull());
+		list.add(fakeCluster(i + 1), 1000 + i);
+	}
+	CHECK(list.isFull());
+
+	// Each one comes out exactly once
+	std::vector<bool> seen(PrefetchedClusterList::kMaxNumClusters + 1);
+	while (Cluster* cluster = list.takeAny()) {
+		uintptr_t n = (uintptr_t)cluster / 64;
+		CHECK(!seen[n]);
+		seen[n] = true;
+	}
+	CHECK_EQUAL(0, list.getNumClusters());
+	for (int32_t i = 1; i <= PrefetchedClusterList::kMaxNumClusters; i++) {
+		CHECK(seen[i]);
+	}
+}
+
+TEST(PrefetchedClusterList, priorityPutsSoonerNotesFirst) {
+	CHECK(getPrefetchPriorityRating(0) < getPrefetchPriorityRating(kPrefetchLookaheadSamples));
+	CHECK_EQUAL(kPrefetchPriorityRating, getPrefetchPriorityRating(0));
+
+	// However far off, it stays at the back of the queue rather than wrapping round to the front
+	CHECK_EQUAL(0xFFFFFFFF, getPrefetchPriorityRating(0xFFFFFFFF));
+	CHECK(getPrefetchPriorityRating(0x10000000) >= kPrefetchPriorityRating);
+}
+
+TEST_GROUP(PrefetchLookahead){};
+
+TEST(PrefetchLookahead, launchIsAfterTheLastRepeat) {
+	// Armed at tick 960 for a 384-tick launch length, 3 repeats to go
+	CHECK_EQUAL(960 + 2 * 384 - 900, getTicksUntilLaunch(960, 3, 384, 900));
+	CHECK_EQUAL(60, getTicksUntilLaunch(960, 1, 384, 900));
+	CHECK_EQUAL(0, getTicksUntilLaunch(960, 1, 384, 960));
+	CHECK(getTicksUntilLaunch(960, 1, 384, 961) < 0);
+
+	// Well beyond what an int32_t would hold
+	CHECK_EQUAL((int64_t)1 << 33, getTicksUntilLaunch(((int64_t)1 << 33) + 100, 1, 384, 100));
+}
+
+TEST(PrefetchLookahead, onlyLooksAtLaunchesWithinLookahead) {
+	uint32_t timePerTick = 100;
+	int64_t lastTickInLookahead = kPrefetchLookaheadSamples / timePerTick;
+
+	CHECK(isLaunchWithinLookahead(0, timePerTick));
+	CHECK(isLaunchWithinLookahead(lastTickInLookahead, timePerTick));
+	CHECK(!isLaunchWithinLookahead(lastTickInLookahead + 1, timePerTick));
+	CHECK(!isLaunchWithinLookahead(-1, timePerTick));
+
+	// Far enough off that ticks times timePerTick would overflow 32 bits
+	CHECK(!isLaunchWithinLookahead((int64_t)1 << 32, timePerTick));
+}
+
+TEST(PrefetchLookahead, lookaheadTicksShrinkAsStartGetsFurther) {
+	uint32_t timePerTick = 100;
+	int32_t fromNow = getLookaheadTicks(0, timePerTick);
+	CHECK_EQUAL((int32_t)(kPrefetchLookaheadSamples / timePerTick + 1), fromNow);
+
+	// A note on the last tick of the lookahead is still in it
+	CHECK((int64_t)(fromNow - 1) * timePerTick <= kPrefetchLookaheadSamples);
+
+	int32_t fromHalfway = getLookaheadTicks(kPrefetchLookaheadSamples / 2, timePerTick);
+	CHECK(fromHalfway < fromNow);
+	CHECK(fromHalfway > 0);
+
+	// Starting right at the end, only its very first notes count - and starting after it, none do
+	CHECK_EQUAL(1, getLookaheadTicks(kPrefetchLookaheadSamples, timePerTick));
+	CHECK_EQUAL(-1, getLookaheadTicks(kPrefetchLookaheadSamples + 1, timePerTick));
+}
+
+TEST(PrefetchLookahead, swapSamplesNeverExceedLookahead) {
+	// What ClusterPrefetcher passes as samplesUntilStart for the incoming Song
+	for (uint32_t timePerTick : {1u, 7u, 100u, 1000u, 20000u}) {
+		for (int64_t ticks = 0; ticks < 3000; ticks++) {
+			if (!isLaunchWithinLookahead(ticks, timePerTick)) {
+				continue;
+			}
+			CHECK(getLookaheadTicks(ticks * timePerTick, timePerTick) >= 1);
+		}
+	}
+}
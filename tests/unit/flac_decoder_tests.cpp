@@ -0,0 +1,363 @@
+#include "CppUTest/TestHarness.h"
+#include "storage/audio/flac_decoder.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TEST_BLOCK_SIZE 4096
+
+namespace {
+
+enum SubframeKind {
+	CONSTANT,
+	VERBATIM,
+	FIXED_2,
+	LPC_2,
+	FIXED_2_ESCAPED,
+};
+
+// Just enough of a FLAC encoder to make frames for the decoder to chew on
+class TestBitWriter {
+public:
+	TestBitWriter(uint8_t* newOutput) : output(newOutput) {}
+
+	void write(uint32_t value, int32_t numBits) {
+		for (int32_t b = numBits - 1; b >= 0; b--) {
+			if (!(bitPos & 7)) {
+				output[bitPos >> 3] = 0;
+			}
+			if ((value >> b) & 1) {
+				output[bitPos >> 3] |= 0x80 >> (bitPos & 7);
+			}
+			bitPos++;
+		}
+	}
+
+	void writeUnary(uint32_t numZeros) {
+		for (uint32_t i = 0; i < numZeros; i++) {
+			write(0, 1);
+		}
+		write(1, 1);
+	}
+
+	void writeRice(int32_t value, int32_t param) {
+		uint32_t zigzagged = ((uint32_t)value << 1) ^ (value >> 31);
+		writeUnary(zigzagged >> param);
+		write(zigzagged & ((1 << param) - 1), param);
+	}
+
+	void align() {
+		if (bitPos & 7) {
+			write(0, 8 - (bitPos & 7));
+		}
+	}
+
+	int32_t getNumBytes() { return bitPos >> 3; }
+
+private:
+	uint8_t* output;
+	int32_t bitPos = 0;
+};
+
+int32_t samples[2][TEST_BLOCK_SIZE];
+uint8_t frame[TEST_BLOCK_SIZE * 8];
+uint8_t decoded[TEST_BLOCK_SIZE * 2 * 3];
+int32_t workBuffer[FlacDecoder::kMaxNumChannels * FlacDecoder::kMaxBlockSize];
+
+FlacStreamInfo makeStreamInfo(int32_t numChannels, int32_t bitsPerSample) {
+	FlacStreamInfo info{};
+	info.minBlockSize = TEST_BLOCK_SIZE;
+	info.maxBlockSize = TEST_BLOCK_SIZE;
+	info.sampleRate = 44100;
+	info.numChannels = numChannels;
+	info.bitsPerSample = bitsPerSample;
+	return info;
+}
+
+void writeSine(int32_t numChannels, int32_t bitsPerSample, int32_t blockSize) {
+	int32_t amplitude = (1 << (bitsPerSample - 2)) - 1;
+	for (int32_t c = 0; c < numChannels; c++) {
+		for (int32_t i = 0; i < blockSize; i++) {
+			samples[c][i] = sinf(i * 0.01f * (c + 1)) * amplitude + (rand() % 7) - 3;
+		}
+	}
+}
+
+void writeResidual(TestBitWriter& writer, int32_t const* residuals, int32_t first, int32_t blockSize, bool escape) {
+	writer.write(0, 2); // 4-bit Rice parameters
+	writer.write(0, 4); // Just one partition
+	if (escape) {
+		writer.write(15, 4);
+		writer.write(26, 5);
+		for (int32_t i = first; i < blockSize; i++) {
+			writer.write(residuals[i] & ((1 << 26) - 1), 26);
+		}
+		return;
+	}
+
+	uint64_t sum = 0;
+	for (int32_t i = first; i < blockSize; i++) {
+		sum += abs(residuals[i]) * 2;
+	}
+	int32_t param = 0;
+	while (param < 14 && ((uint64_t)(blockSize - first) << (param + 1)) <= sum) {
+		param++;
+	}
+	writer.write(param, 4);
+	for (int32_t i = first; i < blockSize; i++) {
+		writer.writeRice(residuals[i], param);
+	}
+}
+
+void writeSubframe(TestBitWriter& writer, int32_t const* signal, int32_t blockSize, int32_t bitsPerSample,
+                   SubframeKind kind, int32_t wastedBits) {
+	static int32_t residuals[TEST_BLOCK_SIZE];
+	uint32_t mask = (bitsPerSample >= 32) ? 0xFFFFFFFF : ((1u << bitsPerSample) - 1);
+
+	writer.write(0, 1);
+	int32_t type = (kind == CONSTANT) ? 0 : (kind == VERBATIM) ? 1 : (kind == LPC_2) ? 33 : 10;
+	writer.write(type, 6);
+	if (wastedBits) {
+		writer.write(1, 1);
+		writer.writeUnary(wastedBits - 1);
+		bitsPerSample -= wastedBits;
+		mask >>= wastedBits;
+	}
+	else {
+		writer.write(0, 1);
+	}
+
+	switch (kind) {
+	case CONSTANT:
+		writer.write((signal[0] >> wastedBits) & mask, bitsPerSample);
+		break;
+
+	case VERBATIM:
+		for (int32_t i = 0; i < blockSize; i++) {
+			writer.write((signal[i] >> wastedBits) & mask, bitsPerSample);
+		}
+		break;
+
+	case FIXED_2:
+	case FIXED_2_ESCAPED:
+		writer.write(signal[0] & mask, bitsPerSample);
+		writer.write(signal[1] & mask, bitsPerSample);
+		for (int32_t i = 2; i < blockSize; i++) {
+			residuals[i] = signal[i] - 2 * signal[i - 1] + signal[i - 2];
+		}
+		writeResidual(writer, residuals, 2, blockSize, kind == FIXED_2_ESCAPED);
+		break;
+
+	case LPC_2:
+		writer.write(signal[0] & mask, bitsPerSample);
+		writer.write(signal[1] & mask, bitsPerSample);
+		writer.write(5, 4);         // Precision 6 bits
+		writer.write(4, 5);         // Shift 4
+		writer.write(31, 6);        // Coefficients 31/16 and -15/16
+		writer.write(-15 & 63, 6);
+		for (int32_t i = 2; i < blockSize; i++) {
+			residuals[i] = signal[i] - ((31 * (int64_t)signal[i - 1] - 15 * (int64_t)signal[i - 2]) >> 4);
+		}
+		writeResidual(writer, residuals, 2, blockSize, false);
+		break;
+	}
+}
+
+// Returns the frame's size
+int32_t encodeFrame(int32_t numChannels, int32_t bitsPerSample, int32_t blockSize, int32_t channelAssignment,
+                    SubframeKind kind, int32_t wastedBits = 0, uint32_t frameNumber = 0) {
+	static int32_t channelSignals[2][TEST_BLOCK_SIZE];
+
+	TestBitWriter writer(frame);
+	writer.write(0xFFF8, 16);
+	writer.write(7, 4); // Block size in 16 bits, after the number
+	writer.write(0, 4); // Sample rate from STREAMINFO
+	writer.write(channelAssignment, 4);
+	writer.write(0, 3); // Bits per sample from STREAMINFO
+	writer.write(0, 1);
+
+	// Frame number, UTF-8 style
+	if (frameNumber < 0x80) {
+		writer.write(frameNumber, 8);
+	}
+	else {
+		writer.write(0xE0 | (frameNumber >> 12), 8);
+		writer.write(0x80 | ((frameNumber >> 6) & 0x3F), 8);
+		writer.write(0x80 | (frameNumber & 0x3F), 8);
+	}
+	writer.write(blockSize - 1, 16);
+	writer.write(FlacDecoder::crc8(frame, writer.getNumBytes()), 8);
+
+	// Side channels need an extra bit
+	int32_t channelBitsPerSample[2] = {bitsPerSample, bitsPerSample};
+	if (channelAssignment == 8 || channelAssignment == 10) {
+		channelBitsPerSample[1]++;
+	}
+	else if (channelAssignment == 9) {
+		channelBitsPerSample[0]++;
+	}
+	for (int32_t i = 0; i < blockSize; i++) {
+		int32_t left = samples[0][i];
+		int32_t right = samples[1][i];
+		switch (channelAssignment) {
+		case 8: // Left / side
+			channelSignals[0][i] = left;
+			channelSignals[1][i] = left - right;
+			break;
+		case 9: // Side / right
+			channelSignals[0][i] = left - right;
+			channelSignals[1][i] = right;
+			break;
+		case 10: // Mid / side
+			channelSignals[0][i] = (left + right) >> 1;
+			channelSignals[1][i] = left - right;
+			break;
+		default:
+			channelSignals[0][i] = left;
+			channelSignals[1][i] = right;
+			break;
+		}
+	}
+	for (int32_t c = 0; c < numChannels; c++) {
+		writeSubframe(writer, channelSignals[c], blockSize, channelBitsPerSample[c], kind, wastedBits);
+	}
+
+	writer.align();
+	writer.write(FlacDecoder::crc16(frame, writer.getNumBytes()), 16);
+	return writer.getNumBytes();
+}
+
+void checkDecoded(int32_t numChannels, int32_t bitsPerSample, int32_t blockSize, int32_t byteDepth) {
+	int32_t shift = byteDepth * 8 - bitsPerSample;
+	uint8_t const* pos = decoded;
+	for (int32_t i = 0; i < blockSize; i++) {
+		for (int32_t c = 0; c < numChannels; c++) {
+			int32_t expected = (uint32_t)samples[c][i] << shift;
+			int32_t value = 0;
+			for (int32_t b = 0; b < byteDepth; b++) {
+				value |= *pos++ << (b * 8);
+			}
+			value = (uint32_t)value << (32 - byteDepth * 8);
+			LONGS_EQUAL((uint32_t)expected << (32 - byteDepth * 8), value);
+		}
+	}
+}
+
+void roundTrip(int32_t numChannels, int32_t bitsPerSample, int32_t byteDepth, int32_t channelAssignment,
+               SubframeKind kind, int32_t wastedBits = 0) {
+	FlacStreamInfo info = makeStreamInfo(numChannels, bitsPerSample);
+	int32_t frameSize = encodeFrame(numChannels, bitsPerSample, TEST_BLOCK_SIZE, channelAssignment, kind, wastedBits);
+
+	FlacFrameHeader header;
+	memset(decoded, 0, sizeof(decoded));
+	CHECK_EQUAL(frameSize, FlacDecoder::decodeFrame(frame, frameSize, info, byteDepth, workBuffer, decoded, &header));
+	CHECK_EQUAL(TEST_BLOCK_SIZE, header.blockSize);
+	checkDecoded(numChannels, bitsPerSample, TEST_BLOCK_SIZE, byteDepth);
+}
+
+} // namespace
+
+TEST_GROUP(FlacDecoder) {
+	void setup() { srand(1); }
+};
+
+TEST(FlacDecoder, streamInfoParses) {
+	uint8_t block[FlacDecoder::kStreamInfoSize] = {0};
+	TestBitWriter writer(block);
+	writer.write(4096, 16);
+	writer.write(4096, 16);
+	writer.write(14, 24);
+	writer.write(12345, 24);
+	writer.write(48000, 20);
+	writer.write(1, 3);  // Stereo
+	writer.write(23, 5); // 24-bit
+	writer.write(1, 4);
+	writer.write(0x00000010, 32);
+
+	FlacStreamInfo info;
+	CHECK(FlacDecoder::parseStreamInfo(block, &info));
+	CHECK_EQUAL(4096, info.maxBlockSize);
+	CHECK_EQUAL(12345, info.maxFrameSize);
+	CHECK_EQUAL(48000, info.sampleRate);
+	CHECK_EQUAL(2, info.numChannels);
+	CHECK_EQUAL(24, info.bitsPerSample);
+	CHECK(info.totalSamples == 0x100000010ull);
+};
+
+TEST(FlacDecoder, monoFixedPredictor) {
+	writeSine(1, 16, TEST_BLOCK_SIZE);
+	roundTrip(1, 16, 2, 0, FIXED_2);
+};
+
+TEST(FlacDecoder, stereoLPCMidSide) {
+	writeSine(2, 24, TEST_BLOCK_SIZE);
+	roundTrip(2, 24, 3, 10, LPC_2);
+};
+
+TEST(FlacDecoder, allChannelAssignments) {
+	writeSine(2, 16, TEST_BLOCK_SIZE);
+	for (int32_t channelAssignment : {1, 8, 9, 10}) {
+		roundTrip(2, 16, 2, channelAssignment, FIXED_2);
+	}
+};
+
+TEST(FlacDecoder, escapedPartition) {
+	writeSine(2, 24, TEST_BLOCK_SIZE);
+	roundTrip(2, 24, 3, 1, FIXED_2_ESCAPED);
+};
+
+TEST(FlacDecoder, verbatimWithWastedBits) {
+	writeSine(2, 16, TEST_BLOCK_SIZE);
+	for (int32_t i = 0; i < TEST_BLOCK_SIZE; i++) {
+		samples[0][i] &= ~3;
+		samples[1][i] &= ~3;
+	}
+	roundTrip(2, 16, 2, 1, VERBATIM, 2);
+};
+
+TEST(FlacDecoder, constant) {
+	for (int32_t i = 0; i < TEST_BLOCK_SIZE; i++) {
+		samples[0][i] = -1234;
+	}
+	roundTrip(1, 16, 2, 0, CONSTANT);
+};
+
+TEST(FlacDecoder, lowBitDepthGoesInTopBits) {
+	writeSine(1, 12, TEST_BLOCK_SIZE);
+	roundTrip(1, 12, 2, 0, FIXED_2);
+};
+
+TEST(FlacDecoder, frameNumberGivesFirstSample) {
+	writeSine(1, 16, 100);
+	FlacStreamInfo info = makeStreamInfo(1, 16);
+	int32_t frameSize = encodeFrame(1, 16, 100, 0, FIXED_2, 0, 3000);
+
+	FlacFrameHeader header;
+	CHECK(FlacDecoder::parseFrameHeader(frame, frameSize, info, &header) > 0);
+	CHECK(header.firstSample == 3000ull * TEST_BLOCK_SIZE);
+	CHECK_EQUAL(100, header.blockSize);
+};
+
+TEST(FlacDecoder, corruptFramesFail) {
+	writeSine(2, 16, TEST_BLOCK_SIZE);
+	FlacStreamInfo info = makeStreamInfo(2, 16);
+	int32_t frameSize = encodeFrame(2, 16, TEST_BLOCK_SIZE, 10, FIXED_2);
+	FlacFrameHeader header;
+
+	// Cut short
+	CHECK_EQUAL(0, FlacDecoder::decodeFrame(frame, frameSize - 1, info, 2, workBuffer, decoded, &header));
+
+	// Damaged in the middle
+	frame[frameSize / 2] ^= 0x10;
+	CHECK_EQUAL(0, FlacDecoder::decodeFrame(frame, frameSize, info, 2, workBuffer, decoded, &header));
+	frame[frameSize / 2] ^= 0x10;
+
+	// Damaged header
+	frame[2] ^= 0x01;
+	CHECK_EQUAL(0, FlacDecoder::parseFrameHeader(frame, frameSize, info, &header));
+	frame[2] ^= 0x01;
+
+	// Wrong number of channels for the stream
+	FlacStreamInfo monoInfo = makeStreamInfo(1, 16);
+	CHECK_EQUAL(0, FlacDecoder::parseFrameHeader(frame, frameSize, monoInfo, &header));
+};
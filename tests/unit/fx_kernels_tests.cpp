@@ -0,0 +1,204 @@
+#include "CppUTest/TestHarness.h"
+#include "dsp/convolution/impulse_response_processor.h"
+#include "dsp/delay/delay_buffer.h"
+#include "dsp/fx_kernels.h"
+#include "util/fixedpoint.h"
+#include <cstdlib>
+
+using namespace deluge::dsp::kernels;
+
+namespace {
+constexpr int32_t kNumSamples = 128;
+
+// A bit of everything, including values the feedback scaling will saturate on
+void fillTestSignal(q31_t* buffer, int32_t numValues) {
+	uint32_t state = 12345;
+	for (int32_t i = 0; i < numValues; i++) {
+		state = state * 1664525 + 1013904223;
+		buffer[i] = (i % 16 == 0) ? (q31_t)(state | 0x7FFF0000) : (q31_t)state >> (i % 5);
+	}
+}
+
+// What ModControllableAudio::processFX() used to do, a sample at a time
+
+void scalarDigitalFeedback(q31_t* buffer, int32_t numValues, q31_t feedbackAmount) {
+	for (int32_t i = 0; i < numValues; i++) {
+		buffer[i] = signed_saturate<32 - 3>(multiply_32x32_rshift32(buffer[i], feedbackAmount)) << 2;
+	}
+}
+
+void scalarPostHPF(q31_t* buffer, int32_t numSamples, q31_t& memoryL, q31_t& memoryR) {
+	for (int32_t i = 0; i < numSamples; i++) {
+		memoryL += (buffer[i * 2] - memoryL) >> 11;
+		buffer[i * 2] -= memoryL;
+		memoryR += (buffer[i * 2 + 1] - memoryR) >> 11;
+		buffer[i * 2 + 1] -= memoryR;
+	}
+}
+
+void scalarMix(StereoSample* audio, q31_t* buffer, int32_t numSamples, bool pingPong) {
+	for (int32_t i = 0; i < numSamples; i++) {
+		q31_t fromDelayL = buffer[i * 2];
+		q31_t fromDelayR = buffer[i * 2 + 1];
+		if (pingPong) {
+			buffer[i * 2] = fromDelayR;
+			buffer[i * 2 + 1] = ((audio[i].l + audio[i].r) >> 1) + fromDelayL;
+		}
+		else {
+			buffer[i * 2] = audio[i].l + fromDelayL;
+			buffer[i * 2 + 1] = audio[i].r + fromDelayR;
+		}
+		audio[i].l += fromDelayL;
+		audio[i].r += fromDelayR;
+	}
+}
+} // namespace
+
+TEST_GROUP(FXKernels){};
+
+TEST(FXKernels, digitalFeedbackMatchesScalar) {
+	q31_t feedbackAmounts[] = {0, 1 << 20, 1 << 30, 2147483647, -(1 << 29)};
+	for (q31_t feedbackAmount : feedbackAmounts) {
+		q31_t expected[kNumSamples * 2];
+		q31_t actual[kNumSamples * 2];
+		fillTestSignal(expected, kNumSamples * 2);
+		fillTestSignal(actual, kNumSamples * 2);
+
+		scalarDigitalFeedback(expected, kNumSamples * 2, feedbackAmount);
+		applyDigitalDelayFeedback(actual, actual + kNumSamples * 2, feedbackAmount);
+
+		MEMCMP_EQUAL(expected, actual, sizeof(expected));
+	}
+};
+
+TEST(FXKernels, postHPFMatchesScalar) {
+	q31_t expected[kNumSamples * 2];
+	q31_t actual[kNumSamples * 2];
+	fillTestSignal(expected, kNumSamples * 2);
+	fillTestSignal(actual, kNumSamples * 2);
+
+	q31_t expectedL = 1000, expectedR = -1000000;
+	q31_t actualL = expectedL, actualR = expectedR;
+	scalarPostHPF(expected, kNumSamples, expectedL, expectedR);
+	applyDelayPostHPF(actual, actual + kNumSamples * 2, actualL, actualR);
+
+	MEMCMP_EQUAL(expected, actual, sizeof(expected));
+	CHECK_EQUAL(expectedL, actualL);
+	CHECK_EQUAL(expectedR, actualR);
+};
+
+TEST(FXKernels, mixMatchesScalar) {
+	for (bool pingPong : {false, true}) {
+		StereoSample expectedAudio[kNumSamples];
+		StereoSample actualAudio[kNumSamples];
+		q31_t expected[kNumSamples * 2];
+		q31_t actual[kNumSamples * 2];
+		fillTestSignal((q31_t*)expectedAudio, kNumSamples * 2);
+		fillTestSignal((q31_t*)actualAudio, kNumSamples * 2);
+		for (int32_t i = 0; i < kNumSamples * 2; i++) {
+			// Quieter, so nothing overflows
+			expected[i] = actual[i] = ((q31_t*)expectedAudio)[kNumSamples * 2 - 1 - i] >> 3;
+			((q31_t*)expectedAudio)[i] >>= 3;
+			((q31_t*)actualAudio)[i] >>= 3;
+		}
+
+		scalarMix(expectedAudio, expected, kNumSamples, pingPong);
+		mixDelayOutput(actualAudio, actual, actual + kNumSamples * 2, pingPong);
+
+		MEMCMP_EQUAL(expected, actual, sizeof(expected));
+		MEMCMP_EQUAL(expectedAudio, actualAudio, sizeof(expectedAudio));
+	}
+};
+
+TEST(FXKernels, phaserAllpassesCloseToScalar) {
+	constexpr int32_t kNumAllpasses = 6;
+	StereoSample expectedMemory;
+	expectedMemory.l = 1 << 24;
+	expectedMemory.r = -(1 << 26);
+	StereoSample actualMemory = expectedMemory;
+	StereoSample expectedAllpasses[kNumAllpasses];
+	StereoSample actualAllpasses[kNumAllpasses];
+	fillTestSignal((q31_t*)expectedAllpasses, kNumAllpasses * 2);
+	for (int32_t i = 0; i < kNumAllpasses; i++) {
+		expectedAllpasses[i].l >>= 4;
+		expectedAllpasses[i].r >>= 4;
+		actualAllpasses[i] = expectedAllpasses[i];
+	}
+
+	q31_t a1 = 1073741824 - 300000000;
+	for (int32_t i = 0; i < kNumAllpasses; i++) {
+		StereoSample whatWasInput = expectedMemory;
+		expectedMemory.l = (multiply_32x32_rshift32_rounded(expectedMemory.l, -a1) << 2) + expectedAllpasses[i].l;
+		expectedAllpasses[i].l = (multiply_32x32_rshift32_rounded(expectedMemory.l, a1) << 2) + whatWasInput.l;
+		expectedMemory.r = (multiply_32x32_rshift32_rounded(expectedMemory.r, -a1) << 2) + expectedAllpasses[i].r;
+		expectedAllpasses[i].r = (multiply_32x32_rshift32_rounded(expectedMemory.r, a1) << 2) + whatWasInput.r;
+	}
+	doPhaserAllpasses(actualMemory, actualAllpasses, kNumAllpasses, a1);
+
+	// Rounding differs by a bit or so per multiply, and each stage's error feeds into the next
+	CHECK(std::abs(expectedMemory.l - actualMemory.l) <= 64);
+	CHECK(std::abs(expectedMemory.r - actualMemory.r) <= 64);
+	for (int32_t i = 0; i < kNumAllpasses; i++) {
+		CHECK(std::abs(expectedAllpasses[i].l - actualAllpasses[i].l) <= 64);
+		CHECK(std::abs(expectedAllpasses[i].r - actualAllpasses[i].r) <= 64);
+	}
+};
+
+TEST(FXKernels, delayBufferBlockReadMatchesSampleBySample) {
+	constexpr int32_t kBufferSize = 300;
+	StereoSample expectedStorage[kBufferSize];
+	StereoSample actualStorage[kBufferSize];
+
+	// Long enough for one read to wrap, and short enough for it to go round more than once
+	for (int32_t size : {kBufferSize, 100, kNumSamples}) {
+		for (bool clearBehind : {false, true}) {
+			fillTestSignal((q31_t*)expectedStorage, kBufferSize * 2);
+			fillTestSignal((q31_t*)actualStorage, kBufferSize * 2);
+
+			DelayBuffer expected;
+			DelayBuffer actual;
+			expected.bufferStart = expectedStorage;
+			expected.bufferEnd = expectedStorage + size;
+			expected.bufferCurrentPos = expectedStorage + size - 50;
+			actual.bufferStart = actualStorage;
+			actual.bufferEnd = actualStorage + size;
+			actual.bufferCurrentPos = actualStorage + size - 50;
+
+			StereoSample expectedOut[kNumSamples];
+			StereoSample actualOut[kNumSamples];
+			bool expectedWrapped = false;
+			for (int32_t i = 0; i < kNumSamples; i++) {
+				expectedWrapped = (clearBehind ? expected.clearAndMoveOn() : expected.moveOn()) || expectedWrapped;
+				expectedOut[i] = *expected.bufferCurrentPos;
+			}
+			bool actualWrapped = actual.moveOnAndRead(actualOut, kNumSamples, clearBehind);
+
+			CHECK_EQUAL(expectedWrapped, actualWrapped);
+			CHECK_EQUAL(expected.bufferCurrentPos - expectedStorage, actual.bufferCurrentPos - actualStorage);
+			MEMCMP_EQUAL(expectedOut, actualOut, sizeof(expectedOut));
+			MEMCMP_EQUAL(expectedStorage, actualStorage, sizeof(expectedStorage));
+
+			// Not ours to free
+			expected.bufferStart = nullptr;
+			actual.bufferStart = nullptr;
+		}
+	}
+};
+
+TEST(FXKernels, impulseResponseBlockMatchesPerSample) {
+	q31_t input[kNumSamples * 2];
+	fillTestSignal(input, kNumSamples * 2);
+
+	ImpulseResponseProcessor expected;
+	q31_t expectedOutput[kNumSamples * 2];
+	for (int32_t i = 0; i < kNumSamples; i++) {
+		expected.process(input[i * 2], input[i * 2 + 1], &expectedOutput[i * 2], &expectedOutput[i * 2 + 1]);
+	}
+
+	ImpulseResponseProcessor actual;
+	actual.processBlock(input, input + kNumSamples * 2);
+
+	for (int32_t i = 0; i < kNumSamples * 2; i++) {
+		CHECK_EQUAL(expectedOutput[i], input[i]);
+	}
+};
@@ -31,6 +31,13 @@ public:
 	int32_t testIndex;
 };
 
+class RelocatableTest : public StealableTest {
+public:
+	bool mayBeRelocated() { return true; }
+	void relocated(Stealable* oldAddress) { relocatedFrom = oldAddress; }
+	Stealable* relocatedFrom = nullptr;
+};
+
 bool testReadingMemory(void* address, uint32_t size) {
 	uint8_t* __restrict__ readPos = (uint8_t*)address;
 	uint8_t readValue = *readPos;
@@ -330,4 +337,41 @@ TEST(MemoryAllocation, stealableAllocations) {
 	CHECK(efficiency > 0.994);
 	mock().checkExpectations();
 };
+TEST(MemoryAllocation, relocateStealable) {
+	// Leave just a little room at the end, so the fragmentation shows
+	void* big = memreg.alloc(MEM_SIZE - 20000, false, NULL);
+	CHECK(big != NULL);
+
+	// Small allocations go at the end of the empty space, so these run right to left
+	void* allocations[6];
+	for (int i = 0; i < 6; i++) {
+		allocations[i] = memreg.alloc(1000, i & 1, NULL);
+		if (i & 1) {
+			RelocatableTest* stealable = new (allocations[i]) RelocatableTest();
+			stealable->testIndex = i;
+			memreg.cache_manager().QueueForReclamation(0, stealable);
+		}
+	}
+	CHECK_EQUAL(0, memreg.getFragmentation());
+
+	// A hole, away from the last stealable
+	memreg.dealloc(allocations[2]);
+	CHECK(memreg.getFragmentation() > 0);
+
+	CHECK(memreg.relocateOneStealable());
+	CHECK_EQUAL(0, memreg.getFragmentation());
+	CHECK_EQUAL(1, memreg.emptySpaces.getNumElements());
+
+	// It's taken the hole's place, and kept its own place in the queue
+	RelocatableTest* moved = (RelocatableTest*)allocations[2];
+	CHECK(moved->relocatedFrom == allocations[5]);
+	CHECK_EQUAL(5, moved->testIndex);
+	CHECK(((RelocatableTest*)allocations[3])->next == moved);
+	CHECK(moved->list != NULL);
+	vtableAddress = *(uint32_t*)moved;
+	CHECK(testAllocationStructure(moved, getAllocatedSize(moved), SPACE_HEADER_STEALABLE));
+
+	// And nothing more to do
+	CHECK(!memreg.relocateOneStealable());
+};
 } // namespace
@@ -9,3 +9,4 @@ void AudioEngine::logAction(char const* item) {
 }
 
 bool AudioEngine::bypassCulling;
+int32_t AudioEngine::cpuDireness = 0;
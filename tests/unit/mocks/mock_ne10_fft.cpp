@@ -0,0 +1,62 @@
+// The NEON FFTs can't run here, so these stand in for them with a plain DFT, scaled the same way: with scaling on, the
+// forward transform divides by the length, and so does the inverse
+
+#include "NE10.h"
+#include <cmath>
+#include <cstdlib>
+
+namespace {
+int32_t roundAndSaturate(double value) {
+	value = std::round(value);
+	if (value >= 2147483647.0) {
+		return 2147483647;
+	}
+	if (value <= -2147483648.0) {
+		return -2147483648;
+	}
+	return (int32_t)value;
+}
+} // namespace
+
+ne10_fft_r2c_cfg_int32_t ne10_fft_alloc_r2c_int32(ne10_int32_t nfft) {
+	ne10_fft_r2c_cfg_int32_t cfg = (ne10_fft_r2c_cfg_int32_t)calloc(1, sizeof(ne10_fft_r2c_state_int32_t));
+	cfg->nfft = nfft;
+	cfg->ncfft = nfft >> 1;
+	return cfg;
+}
+
+void ne10_fft_destroy_r2c_int32(ne10_fft_r2c_cfg_int32_t cfg) {
+	free(cfg);
+}
+
+void ne10_fft_r2c_1d_int32_neon(ne10_fft_cpx_int32_t* fout, ne10_int32_t* fin, ne10_fft_r2c_cfg_int32_t cfg,
+                                ne10_int32_t scaled_flag) {
+	int32_t n = cfg->nfft;
+	double scale = scaled_flag ? 1.0 / n : 1.0;
+	for (int32_t k = 0; k <= (n >> 1); k++) {
+		double r = 0;
+		double i = 0;
+		for (int32_t t = 0; t < n; t++) {
+			double angle = -2 * M_PI * (double)((int64_t)k * t % n) / n;
+			r += fin[t] * std::cos(angle);
+			i += fin[t] * std::sin(angle);
+		}
+		fout[k].r = roundAndSaturate(r * scale);
+		fout[k].i = roundAndSaturate(i * scale);
+	}
+}
+
+void ne10_fft_c2r_1d_int32_neon(ne10_int32_t* fout, ne10_fft_cpx_int32_t* fin, ne10_fft_r2c_cfg_int32_t cfg,
+                                ne10_int32_t scaled_flag) {
+	int32_t n = cfg->nfft;
+	double scale = scaled_flag ? 1.0 / n : 1.0;
+	for (int32_t t = 0; t < n; t++) {
+		// The bins above n / 2 are the conjugates of the ones below
+		double value = fin[0].r + ((t & 1) ? -1.0 : 1.0) * fin[n >> 1].r;
+		for (int32_t k = 1; k < (n >> 1); k++) {
+			double angle = 2 * M_PI * (double)((int64_t)k * t % n) / n;
+			value += 2 * (fin[k].r * std::cos(angle) - fin[k].i * std::sin(angle));
+		}
+		fout[t] = roundAndSaturate(value * scale);
+	}
+}
@@ -0,0 +1,110 @@
+#include "CppUTest/TestHarness.h"
+#include "dsp/convolution/partitioned_convolver.h"
+#include "memory/general_memory_allocator.h"
+#include "util/fixedpoint.h"
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+using deluge::dsp::PartitionedConvolver;
+
+namespace {
+constexpr int32_t kBlockSizeMagnitude = 4;
+constexpr int32_t kBlockSize = 1 << kBlockSizeMagnitude;
+constexpr int32_t kMaxImpulseLength = 64;
+constexpr int32_t kNumFrames = 300;
+constexpr uint32_t kMemSize = 1 << 20;
+
+void fillRandom(std::vector<q31_t>& buffer, uint32_t seed, int32_t shift) {
+	uint32_t state = seed;
+	for (q31_t& value : buffer) {
+		state = state * 1664525 + 1013904223;
+		value = (q31_t)state >> shift;
+	}
+}
+
+// Straight time-domain convolution, with each product rounded to Q31 the way the convolver's are, but summed exactly
+std::vector<q31_t> convolveNaively(std::vector<q31_t> const& input, std::vector<q31_t> const& impulse) {
+	std::vector<q31_t> output(input.size());
+	for (size_t n = 0; n < input.size(); n++) {
+		int64_t sum = 0;
+		for (size_t k = 0; k < impulse.size() && k <= n; k++) {
+			sum += (int64_t)input[n - k] * impulse[k];
+		}
+		output[n] = (q31_t)(sum >> 31);
+	}
+	return output;
+}
+
+// delugeDealloc() is just free() in the unit tests, so a convolver's memory can't be handed back - this one never gets
+// deleted
+PartitionedConvolver* makeConvolver(int32_t numOutputs) {
+	PartitionedConvolver* convolver = new PartitionedConvolver();
+	CHECK_EQUAL(NO_ERROR, convolver->init(kBlockSizeMagnitude, kMaxImpulseLength, numOutputs));
+	return convolver;
+}
+} // namespace
+
+TEST_GROUP(PartitionedConvolver) {
+	// The allocator's regions are at the hardware's addresses, so give it some real memory instead
+	void setup() {
+		GeneralMemoryAllocator& allocator = GeneralMemoryAllocator::get();
+		uint32_t emptySpacesSize = sizeof(EmptySpaceRecord) * 512;
+		for (int32_t r : {MEMORY_REGION_INTERNAL, MEMORY_REGION_EXTERNAL}) {
+			void* emptySpacesMemory = calloc(1, emptySpacesSize);
+			void* memory = calloc(1, kMemSize);
+			allocator.regions[r].setup(emptySpacesMemory, emptySpacesSize, (uint32_t)memory,
+			                           (uint32_t)memory + kMemSize);
+		}
+		void* slabMemory = calloc(1, SlabAllocator::kPageSize * 4);
+		allocator.slabs = SlabAllocator{};
+		allocator.slabs.setup((uint32_t)slabMemory, (uint32_t)slabMemory + SlabAllocator::kPageSize * 4);
+	}
+};
+
+TEST(PartitionedConvolver, matchesNaiveConvolution) {
+	// Several partitions, and a right that's shorter than the left, with its last partition part-empty
+	std::vector<q31_t> left(kMaxImpulseLength - 5);
+	std::vector<q31_t> right(kBlockSize * 2 + 3);
+	std::vector<q31_t> input(kNumFrames);
+	fillRandom(left, 1, 4);
+	fillRandom(right, 2, 4);
+	fillRandom(input, 3, 2);
+
+	PartitionedConvolver* convolver = makeConvolver(2);
+	convolver->setImpulseResponse(left, right);
+
+	// Odd-sized chunks, so block boundaries land all over the place within calls to process(), as the tail gets summed
+	// a bit at a time
+	std::vector<q31_t> outputL(kNumFrames);
+	std::vector<q31_t> outputR(kNumFrames);
+	int32_t chunkSizes[] = {1, 7, 16, 3, 40, 5, 13};
+	int32_t frame = 0;
+	for (int32_t c = 0; frame < kNumFrames; c++) {
+		int32_t chunkSize = std::min<int32_t>(chunkSizes[c % 7], kNumFrames - frame);
+		convolver->process(std::span<q31_t const>(&input[frame], chunkSize), [&](size_t f, q31_t l, q31_t r) {
+			outputL[frame + f] = l;
+			outputR[frame + f] = r;
+		});
+		frame += chunkSize;
+	}
+
+	// Output comes out a block late. The FFTs round to 32 bits a few times along the way, so allow a few bits for that
+	std::vector<q31_t> expectedL = convolveNaively(input, left);
+	std::vector<q31_t> expectedR = convolveNaively(input, right);
+	for (int32_t n = 0; n < kBlockSize; n++) {
+		CHECK_EQUAL(0, outputL[n]);
+		CHECK_EQUAL(0, outputR[n]);
+	}
+	for (int32_t n = kBlockSize; n < kNumFrames; n++) {
+		CHECK(std::abs(outputL[n] - expectedL[n - kBlockSize]) <= 128);
+		CHECK(std::abs(outputR[n] - expectedR[n - kBlockSize]) <= 128);
+	}
+};
+
+TEST(PartitionedConvolver, notActiveUntilInitialized) {
+	PartitionedConvolver* convolver = new PartitionedConvolver();
+	CHECK(!convolver->isActive());
+	CHECK_EQUAL(NO_ERROR, convolver->init(kBlockSizeMagnitude, kMaxImpulseLength, 1));
+	CHECK(convolver->isActive());
+};
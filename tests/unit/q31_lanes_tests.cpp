@@ -0,0 +1,102 @@
+#include "CppUTest/TestHarness.h"
+#include "dsp/q31_lanes.h"
+#include <cstdlib>
+#include <limits>
+
+using deluge::dsp::Q31x2;
+
+namespace {
+constexpr q31_t kMin = std::numeric_limits<q31_t>::min();
+constexpr q31_t kMax = std::numeric_limits<q31_t>::max();
+} // namespace
+
+TEST_GROUP(Q31Lanes){};
+
+TEST(Q31Lanes, loadStoreKeepsLanesApart) {
+	q31_t samples[2] = {123, -456};
+	Q31x2 lanes = Q31x2::load(samples);
+	CHECK_EQUAL(123, lanes.get<0>());
+	CHECK_EQUAL(-456, lanes.get<1>());
+
+	q31_t out[2];
+	(lanes + Q31x2::broadcast(1)).store(out);
+	CHECK_EQUAL(124, out[0]);
+	CHECK_EQUAL(-455, out[1]);
+};
+
+TEST(Q31Lanes, doublingMultiplyMatchesScalar) {
+	q31_t values[] = {0, 1, -1, 12345678, -987654321, 1 << 30, kMax, kMin + 1};
+	for (q31_t a : values) {
+		for (q31_t b : values) {
+			Q31x2 product = Q31x2::mulDoubledHigh(Q31x2::broadcast(a), Q31x2::fromLanes(b, -b));
+			// Within the bottom bit of the scalar version the filters used to use
+			CHECK(std::abs(product.get<0>() - 2 * multiply_32x32_rshift32(a, b)) <= 1);
+			CHECK(std::abs(product.get<1>() - 2 * multiply_32x32_rshift32(a, -b)) <= 1);
+
+			Q31x2 rounded = Q31x2::mulDoubledHighRounded(Q31x2::broadcast(a), Q31x2::broadcast(b));
+			CHECK(std::abs(rounded.get<0>() - (multiply_32x32_rshift32_rounded(a, b) << 1)) <= 1);
+		}
+	}
+};
+
+TEST(Q31Lanes, doublingMultiplySaturates) {
+	Q31x2 minLanes = Q31x2::broadcast(kMin);
+	CHECK_EQUAL(kMax, Q31x2::mulDoubledHigh(minLanes, minLanes).get<0>());
+	CHECK_EQUAL(kMax, Q31x2::mulDoubledHighRounded(minLanes, minLanes).get<1>());
+};
+
+TEST(Q31Lanes, shiftsAreArithmetic) {
+	Q31x2 lanes = Q31x2::fromLanes(-256, 256);
+	CHECK_EQUAL(-128, lanes.shiftRight<1>().get<0>());
+	CHECK_EQUAL(1024, lanes.shiftLeft<2>().get<1>());
+	CHECK_EQUAL(-1024, lanes.shiftLeft<2>().get<0>());
+};
+
+TEST(Q31Lanes, exactMultipliesMatchScalar) {
+	q31_t values[] = {0, 1, -1, 3, -3, 12345678, -987654321, 1 << 30, kMax, kMin + 1, kMin};
+	for (q31_t a : values) {
+		for (q31_t b : values) {
+			Q31x2 lanesA = Q31x2::fromLanes(a, b);
+			Q31x2 lanesB = Q31x2::fromLanes(b, ~a);
+			CHECK_EQUAL(multiply_32x32_rshift32(a, b), Q31x2::mulHigh(lanesA, lanesB).get<0>());
+			CHECK_EQUAL(multiply_32x32_rshift32(b, ~a), Q31x2::mulHigh(lanesA, lanesB).get<1>());
+			CHECK_EQUAL(multiply_32x32_rshift32_rounded(a, b), Q31x2::mulHighRounded(lanesA, lanesB).get<0>());
+			CHECK_EQUAL(multiply_32x32_rshift32_rounded(b, ~a), Q31x2::mulHighRounded(lanesA, lanesB).get<1>());
+			CHECK_EQUAL((q31_t)((uint32_t)a * (uint32_t)b), Q31x2::mulLow(lanesA, lanesB).get<0>());
+			if (a != kMin || b != kMin) {
+				CHECK_EQUAL((q31_t)(2 * (uint32_t)multiply_32x32_rshift32(a, b)),
+				            Q31x2::mulHighTimes2(lanesA, lanesB).get<0>());
+			}
+		}
+	}
+};
+
+TEST(Q31Lanes, saturatingShiftClipsAndUnsignedShiftDoesNotExtend) {
+	Q31x2 lanes = Q31x2::fromLanes(1 << 29, -(1 << 29) - 1);
+	CHECK_EQUAL(kMax, lanes.shiftLeftSaturating<2>().get<0>());
+	CHECK_EQUAL(kMin, lanes.shiftLeftSaturating<2>().get<1>());
+	CHECK_EQUAL(1 << 30, lanes.shiftLeftSaturating<1>().get<0>());
+
+	CHECK_EQUAL(0xFF, Q31x2::broadcast(-1).shiftRightUnsigned<24>().get<0>());
+	CHECK_EQUAL(-1, Q31x2::broadcast(-1).shiftRight<24>().get<0>());
+};
+
+TEST(Q31Lanes, tanHMatchesScalar) {
+	uint32_t state = 1;
+	for (int32_t i = 0; i < 10000; i++) {
+		state = state * 1664525 + 1013904223;
+		// Every size of value, so each saturation amount both clips and doesn't
+		q31_t a = (q31_t)state >> (i % 31);
+		q31_t b = (i % 64 == 0) ? kMin : (i % 64 == 1) ? kMax : ~a;
+		Q31x2 lanes = Q31x2::fromLanes(a, b);
+
+		CHECK_EQUAL(getTanHUnknown(a, 0), lanes.tanH<0>().get<0>());
+		CHECK_EQUAL(getTanHUnknown(b, 0), lanes.tanH<0>().get<1>());
+		CHECK_EQUAL(getTanHUnknown(a, 2), lanes.tanH<2>().get<0>());
+		CHECK_EQUAL(getTanHUnknown(b, 2), lanes.tanH<2>().get<1>());
+		CHECK_EQUAL(getTanHUnknown(a, 3), lanes.tanH<3>().get<0>());
+		CHECK_EQUAL(getTanHUnknown(b, 3), lanes.tanH<3>().get<1>());
+		CHECK_EQUAL(getTanHUnknown(a, 7), lanes.tanH<7>().get<0>());
+		CHECK_EQUAL(getTanHUnknown(b, 7), lanes.tanH<7>().get<1>());
+	}
+};
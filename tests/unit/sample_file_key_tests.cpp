@@ -0,0 +1,44 @@
+#include "CppUTest/TestHarness.h"
+#include "storage/audio/sample_file_key.h"
+
+namespace {
+// 2024-03-01 12:34:56, as FAT stores it
+constexpr uint32_t kModifiedTime = ((uint32_t)((44 << 9) | (3 << 5) | 1) << 16) | ((12 << 11) | (34 << 5) | (56 / 2));
+constexpr SampleFileKey kKey = {12345, 678900, kModifiedTime};
+} // namespace
+
+TEST_GROUP(SampleFileKey){};
+
+TEST(SampleFileKey, pathHashIgnoresCase) {
+	CHECK_EQUAL(hashSampleFilePath("SAMPLES/DRUMS/KICK.WAV"), hashSampleFilePath("samples/Drums/kick.wav"));
+	CHECK(hashSampleFilePath("SAMPLES/DRUMS/KICK.WAV") != hashSampleFilePath("SAMPLES/DRUMS/KICK2.WAV"));
+	CHECK(hashSampleFilePath("SAMPLES/A/KICK.WAV") != hashSampleFilePath("SAMPLES/B/KICK.WAV"));
+	// Only letters get folded
+	CHECK(hashSampleFilePath("SAMPLES/_.WAV") != hashSampleFilePath("SAMPLES/\x7F.WAV"));
+}
+
+TEST(SampleFileKey, pathHashIsFNV1a) {
+	CHECK_EQUAL(2166136261u, hashSampleFilePath(""));
+	CHECK_EQUAL(0xC40BF6CCu, hashSampleFilePath("A"));
+}
+
+TEST(SampleFileKey, sameFileMatches) {
+	CHECK(kKey.stillMatches({12345, 678900, kModifiedTime}));
+}
+
+TEST(SampleFileKey, fileEditedInPlaceIsStale) {
+	// Same sector and size, as a computer can leave it when it overwrites a file - only the time gives it away
+	CHECK(!kKey.stillMatches({12345, 678900, kModifiedTime + 1}));
+	CHECK(!kKey.stillMatches({12345, 678900, kModifiedTime + (1 << 16)}));
+}
+
+TEST(SampleFileKey, fileMovedOrResizedIsStale) {
+	CHECK(!kKey.stillMatches({12346, 678900, kModifiedTime}));
+	CHECK(!kKey.stillMatches({12345, 678901, kModifiedTime}));
+}
+
+TEST(SampleFileKey, unknownModifiedTimeNeverMatches) {
+	CHECK(!kKey.stillMatches({12345, 678900, 0}));
+	constexpr SampleFileKey keyWithoutTime = {12345, 678900, 0};
+	CHECK(!keyWithoutTime.stillMatches(keyWithoutTime));
+}
@@ -0,0 +1,113 @@
+#include "CppUTest/TestHarness.h"
+#include "model/sample/sample_peak_pyramid.h"
+#include <vector>
+
+namespace {
+constexpr uint64_t kBinSize = SamplePeakPyramid::kBinSize;
+constexpr int32_t kNumLevels = 4;
+
+struct Bin {
+	uint64_t startFrame;
+	uint64_t endFrame;
+};
+
+uint64_t getBinSize(int32_t level) {
+	return kBinSize << (level * SamplePeakPyramid::kLevelRatioMagnitude);
+}
+
+// The frames each bin getPeaks() would look at covers, in order. Empty if it'd give up
+std::vector<Bin> getBinsWithin(uint64_t startFrame, uint64_t endFrame, uint64_t lengthInSamples) {
+	std::vector<Bin> bins;
+	auto useBin = [&](int32_t level, int32_t binIndex) {
+		uint64_t binSize = getBinSize(level);
+		bins.push_back({binIndex * binSize, (binIndex + 1) * binSize});
+		return true;
+	};
+	if (!SamplePeakPyramid::forEachBinWithin(startFrame, endFrame, lengthInSamples, kNumLevels, useBin)) {
+		bins.clear();
+	}
+	return bins;
+}
+} // namespace
+
+TEST_GROUP(SamplePeakPyramid){};
+
+TEST(SamplePeakPyramid, exactlyOneBin) {
+	std::vector<Bin> bins = getBinsWithin(kBinSize, kBinSize * 2, 1 << 20);
+	CHECK_EQUAL(1, bins.size());
+	CHECK_EQUAL(kBinSize, bins[0].startFrame);
+	CHECK_EQUAL(kBinSize * 2, bins[0].endFrame);
+}
+
+// One frame either side of a bin's edges leaves that bin out, rather than taking in peaks from the next column
+TEST(SamplePeakPyramid, binsPartlyOutsideAreLeftOut) {
+	std::vector<Bin> bins = getBinsWithin(kBinSize - 1, kBinSize * 3 + 1, 1 << 20);
+	CHECK_EQUAL(2, bins.size());
+	CHECK_EQUAL(kBinSize, bins[0].startFrame);
+	CHECK_EQUAL(kBinSize * 3, bins[1].endFrame);
+
+	bins = getBinsWithin(kBinSize + 1, kBinSize * 3 - 1, 1 << 20);
+	CHECK_EQUAL(0, bins.size());
+
+	bins = getBinsWithin(kBinSize + 1, kBinSize * 3, 1 << 20);
+	CHECK_EQUAL(1, bins.size());
+	CHECK_EQUAL(kBinSize * 2, bins[0].startFrame);
+}
+
+TEST(SamplePeakPyramid, biggestBinsThatFit) {
+	// One bin from the level above covers it all
+	std::vector<Bin> bins = getBinsWithin(0, getBinSize(1), 1 << 20);
+	CHECK_EQUAL(1, bins.size());
+	CHECK_EQUAL(getBinSize(1), bins[0].endFrame);
+
+	// One frame short, and it's back to the smaller ones
+	bins = getBinsWithin(0, getBinSize(1) - 1, 1 << 20);
+	CHECK_EQUAL(SamplePeakPyramid::kLevelRatio - 1, bins.size());
+}
+
+// The Sample's last bin is short, so a column ending at the end of the Sample still gets it
+TEST(SamplePeakPyramid, lastBinOfSample) {
+	uint64_t lengthInSamples = kBinSize * 3 + 100;
+	std::vector<Bin> bins = getBinsWithin(kBinSize * 2, lengthInSamples, lengthInSamples);
+	CHECK_EQUAL(2, bins.size());
+	CHECK_EQUAL(kBinSize * 4, bins[1].endFrame);
+
+	bins = getBinsWithin(kBinSize * 3, lengthInSamples + 1000, lengthInSamples);
+	CHECK_EQUAL(1, bins.size());
+	CHECK_EQUAL(kBinSize * 3, bins[0].startFrame);
+
+	// Short of the end, it's partly outside like any other
+	bins = getBinsWithin(kBinSize * 2, lengthInSamples - 1, lengthInSamples);
+	CHECK_EQUAL(1, bins.size());
+	CHECK_EQUAL(kBinSize * 3, bins[0].endFrame);
+}
+
+// Side by side columns, as WaveformRenderer has them, at every offset and at widths either side of bin sizes. Each
+// one's bins have to cover all the whole bins within it, and nothing outside it
+TEST(SamplePeakPyramid, neighbouringColumnsNeverShareBins) {
+	uint64_t lengthInSamples = 100000;
+	for (uint64_t colWidth : {kBinSize * 2 - 1, kBinSize * 2, kBinSize * 2 + 1, getBinSize(1) + 3, getBinSize(2) - 5}) {
+		for (uint64_t offset = 0; offset < kBinSize * 2; offset += 7) {
+			for (uint64_t colStart = offset; colStart < lengthInSamples; colStart += colWidth) {
+				uint64_t colEnd = std::min(colStart + colWidth, lengthInSamples);
+				uint64_t firstWholeBinStart = (colStart + kBinSize - 1) / kBinSize * kBinSize;
+				uint64_t lastWholeBinEnd = colEnd / kBinSize * kBinSize;
+				if (colEnd == lengthInSamples) {
+					lastWholeBinEnd = (colEnd + kBinSize - 1) / kBinSize * kBinSize;
+				}
+
+				std::vector<Bin> bins = getBinsWithin(colStart, colEnd, lengthInSamples);
+				if (firstWholeBinStart >= lastWholeBinEnd) {
+					CHECK_EQUAL(0, bins.size());
+					continue;
+				}
+				CHECK(!bins.empty());
+				CHECK_EQUAL(firstWholeBinStart, bins.front().startFrame);
+				CHECK_EQUAL(lastWholeBinEnd, bins.back().endFrame);
+				for (size_t b = 1; b < bins.size(); b++) {
+					CHECK_EQUAL(bins[b - 1].endFrame, bins[b].startFrame);
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,97 @@
+#include "CppUTest/TestHarness.h"
+#include "memory/memory_region.h"
+#include "memory/slab_allocator.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define ARENA_SIZE (SlabAllocator::kMaxNumPages * SlabAllocator::kPageSize)
+
+namespace {
+uint32_t getAllocatedSize(void* address) {
+	uint32_t* header = (uint32_t*)((uint32_t)address - 4);
+	return (*header & SPACE_SIZE_MASK);
+}
+} // namespace
+
+TEST_GROUP(SlabAllocation) {
+	SlabAllocator slabs;
+	void* raw_mem = malloc(ARENA_SIZE + 8);
+
+	void setup() {
+		memset(raw_mem, 0, ARENA_SIZE + 8);
+		slabs = SlabAllocator{};
+		slabs.setup((uint32_t)raw_mem, (uint32_t)raw_mem + ARENA_SIZE + 8);
+	}
+};
+
+TEST(SlabAllocation, smallestClassThatFits) {
+	void* a = slabs.alloc(1);
+	void* b = slabs.alloc(25);
+	void* c = slabs.alloc(SlabAllocator::kMaxSize);
+	CHECK(a != NULL);
+	CHECK(b != NULL);
+	CHECK(c != NULL);
+	CHECK_EQUAL(8, getAllocatedSize(a));
+	CHECK_EQUAL(56, getAllocatedSize(b));
+	CHECK_EQUAL(SlabAllocator::kMaxSize, getAllocatedSize(c));
+	CHECK_EQUAL(SPACE_HEADER_ALLOCATED, *((uint32_t*)b - 1) & SPACE_TYPE_MASK);
+	CHECK_EQUAL(0, (uint32_t)b & 7);
+};
+
+TEST(SlabAllocation, tooBig) {
+	CHECK(slabs.alloc(SlabAllocator::kMaxSize + 1) == NULL);
+	CHECK(slabs.alloc(0) == NULL);
+};
+
+TEST(SlabAllocation, reusesFreedSlot) {
+	void* a = slabs.alloc(20);
+	slabs.alloc(20);
+	slabs.dealloc(a);
+	CHECK(slabs.alloc(20) == a);
+
+	SlabStats stats;
+	slabs.getStats(1, &stats);
+	CHECK_EQUAL(2, stats.numAllocated);
+	CHECK_EQUAL(3, stats.numAllocs);
+	CHECK_EQUAL(1, stats.numPages);
+	CHECK_EQUAL(SlabAllocator::kPageSize / 32 - 2, stats.numFree);
+};
+
+TEST(SlabAllocation, allocationsDontOverlap) {
+	void* allocations[512];
+	for (int i = 0; i < 512; i++) {
+		allocations[i] = slabs.alloc(24);
+		CHECK(allocations[i] != NULL);
+		memset(allocations[i], i & 255, 24);
+	}
+	for (int i = 0; i < 512; i++) {
+		uint8_t* bytes = (uint8_t*)allocations[i];
+		for (int j = 0; j < 24; j++) {
+			CHECK_EQUAL(i & 255, bytes[j]);
+		}
+		CHECK_EQUAL(24, getAllocatedSize(allocations[i]));
+	}
+};
+
+TEST(SlabAllocation, runsOutOfPages) {
+	int32_t numPerPage = SlabAllocator::kPageSize / 256;
+	int32_t numAllocated = 0;
+	while (slabs.alloc(200)) {
+		numAllocated++;
+	}
+	CHECK_EQUAL(SlabAllocator::kMaxNumPages * numPerPage, numAllocated);
+
+	// And a different size class has nowhere to go either
+	CHECK(slabs.alloc(8) == NULL);
+
+	SlabStats stats;
+	slabs.getStats(SlabAllocator::kNumSizeClasses - 1, &stats);
+	CHECK_EQUAL(1, stats.numOverflows);
+	CHECK_EQUAL(SlabAllocator::kMaxNumPages, stats.numPages);
+};
+
+TEST(SlabAllocation, contains) {
+	void* a = slabs.alloc(100);
+	CHECK(slabs.contains(a));
+	CHECK(!slabs.contains((void*)((uint32_t)raw_mem + ARENA_SIZE + 8)));
+};
@@ -0,0 +1,76 @@
+#include "CppUTest/TestHarness.h"
+#include "io/debug/trace.h"
+
+namespace {
+
+void busyWaitMicroseconds(uint32_t us) {
+	uint32_t start = Debug::readCycleCounter();
+	while (Debug::readCycleCounter() - start < us * Debug::uS) {}
+}
+
+} // namespace
+
+TEST_GROUP(Trace) {
+	void setup() { Debug::resetTrace(); }
+};
+
+TEST(Trace, scopeRecordsBeginAndEnd) {
+	{
+		TRACE_ZONE(TraceZone::REVERB, 64);
+	}
+	CHECK_EQUAL(2, Debug::traceBuffer.size());
+
+	Debug::TraceEvent const& begin = Debug::traceBuffer.get(0);
+	Debug::TraceEvent const& end = Debug::traceBuffer.get(1);
+	CHECK(begin.zone == TraceZone::REVERB);
+	CHECK(begin.phase == Debug::TracePhase::BEGIN);
+	CHECK_EQUAL(64, begin.arg);
+	CHECK(end.zone == TraceZone::REVERB);
+	CHECK(end.phase == Debug::TracePhase::END);
+	CHECK(end.cycles - begin.cycles < Debug::sec);
+};
+
+TEST(Trace, nestedZonesAccumulateSeparately) {
+	{
+		TRACE_ZONE(TraceZone::AUDIO_ROUTINE);
+		busyWaitMicroseconds(200);
+		{
+			TRACE_ZONE(TraceZone::FILTERS);
+			busyWaitMicroseconds(100);
+		}
+	}
+	{
+		TRACE_ZONE(TraceZone::FILTERS);
+		busyWaitMicroseconds(100);
+	}
+
+	Debug::TraceZoneStats const& routine = Debug::getTraceZoneStats(TraceZone::AUDIO_ROUTINE);
+	Debug::TraceZoneStats const& filters = Debug::getTraceZoneStats(TraceZone::FILTERS);
+	CHECK_EQUAL(1, routine.count);
+	CHECK_EQUAL(2, filters.count);
+	CHECK(routine.totalCycles >= 300 * Debug::uS);
+	CHECK(filters.totalCycles >= 200 * Debug::uS);
+	CHECK(filters.maxCycles >= 100 * Debug::uS);
+	CHECK_EQUAL(0, Debug::getTraceZoneStats(TraceZone::REVERB).count);
+};
+
+TEST(Trace, instantEventsAreCounted) {
+	TRACE_INSTANT(TraceZone::VOICE_CULL, 12);
+	CHECK_EQUAL(1, Debug::traceBuffer.size());
+	CHECK(Debug::traceBuffer.get(0).phase == Debug::TracePhase::INSTANT);
+	CHECK_EQUAL(1, Debug::getTraceZoneStats(TraceZone::VOICE_CULL).count);
+};
+
+TEST(Trace, ringBufferKeepsNewestEvents) {
+	for (uint32_t i = 0; i < Debug::kTraceBufferSize + 10; i++) {
+		TRACE_INSTANT(TraceZone::VOICE_CULL, i);
+	}
+	CHECK_EQUAL(Debug::kTraceBufferSize, Debug::traceBuffer.size());
+	CHECK_EQUAL(10, Debug::traceBuffer.get(0).arg);
+	CHECK_EQUAL(Debug::kTraceBufferSize + 9, Debug::traceBuffer.get(Debug::kTraceBufferSize - 1).arg);
+};
+
+TEST(Trace, zoneNames) {
+	STRCMP_EQUAL("reverb", Debug::getTraceZoneName(TraceZone::REVERB));
+	STRCMP_EQUAL("voice cull", Debug::getTraceZoneName(TraceZone::VOICE_CULL));
+};
@@ -0,0 +1,55 @@
+#include "CppUTest/TestHarness.h"
+#include "model/voice/voice_quality.h"
+#include <vector>
+
+namespace {
+// What cullVoice() does to the Voice it picks with degradation on: steps it down a tier if there's one left that
+// applies, otherwise fast-releases it. Returns the tiers it went through, in order, before being culled
+template <typename TierApplies>
+std::vector<VoiceQuality> degradeUntilCulled(TierApplies tierApplies) {
+	std::vector<VoiceQuality> tiers{VoiceQuality::FULL};
+	VoiceQuality quality = VoiceQuality::FULL;
+	while (true) {
+		VoiceQuality newQuality = getNextVoiceQuality(quality, tierApplies);
+		if (newQuality == quality) {
+			return tiers;
+		}
+		quality = newQuality;
+		tiers.push_back(quality);
+	}
+}
+} // namespace
+
+TEST_GROUP(VoiceQuality){};
+
+TEST(VoiceQuality, oneVoiceStepsThroughEveryTierBeforeCulling) {
+	std::vector<VoiceQuality> tiers = degradeUntilCulled([](VoiceQuality) { return true; });
+
+	std::vector<VoiceQuality> expected{VoiceQuality::FULL, VoiceQuality::LINEAR_INTERPOLATION, VoiceQuality::MONO,
+	                                   VoiceQuality::SVF_FILTER, VoiceQuality::SINGLE_UNISON};
+	CHECK(tiers == expected);
+	CHECK(tiers.back() == kLowestVoiceQuality);
+}
+
+TEST(VoiceQuality, skipsTiersThatWouldntHelp) {
+	// E.g. a mono synth with a ladder filter - no sample interpolation or unison to drop
+	std::vector<VoiceQuality> tiers =
+	    degradeUntilCulled([](VoiceQuality tier) { return tier == VoiceQuality::SVF_FILTER; });
+
+	std::vector<VoiceQuality> expected{VoiceQuality::FULL, VoiceQuality::SVF_FILTER};
+	CHECK(tiers == expected);
+}
+
+TEST(VoiceQuality, culledStraightAwayIfNoTierApplies) {
+	CHECK(getNextVoiceQuality(VoiceQuality::FULL, [](VoiceQuality) { return false; }) == VoiceQuality::FULL);
+	CHECK(getNextVoiceQuality(kLowestVoiceQuality, [](VoiceQuality) { return true; }) == kLowestVoiceQuality);
+}
+
+TEST(VoiceQuality, moreDegradedGoesFirstOnlyWhenRatingsTie) {
+	// The rating's still the main thing - a degraded Voice that's otherwise higher priority stays put
+	CHECK(isMoreCullable(100, VoiceQuality::FULL, 99, VoiceQuality::SINGLE_UNISON));
+	CHECK(!isMoreCullable(99, VoiceQuality::SINGLE_UNISON, 100, VoiceQuality::FULL));
+
+	CHECK(isMoreCullable(100, VoiceQuality::MONO, 100, VoiceQuality::LINEAR_INTERPOLATION));
+	CHECK(!isMoreCullable(100, VoiceQuality::MONO, 100, VoiceQuality::MONO));
+}
@@ -0,0 +1,30 @@
+#include "CppUTest/TestHarness.h"
+#include "storage/xml_tag.h"
+#include <string.h>
+
+TEST_GROUP(XMLTag){};
+
+TEST(XMLTag, everyTagFindsItself) {
+	for (int32_t t = 0; t < (int32_t)XMLTag::UNKNOWN; t++) {
+		char const* name = xmlTagToName((XMLTag)t);
+		CHECK(strlen(name) > 0);
+		CHECK((int32_t)xmlTagFromName(name) == t);
+	}
+}
+
+TEST(XMLTag, namesMatchEnum) {
+	STRCMP_EQUAL("osc1", xmlTagToName(XMLTag::osc1));
+	STRCMP_EQUAL("yScrollArrangementView", xmlTagToName(XMLTag::yScrollArrangementView));
+	CHECK(xmlTagFromName("reverb") == XMLTag::reverb);
+	CHECK(xmlTagFromName("reverbAmount") == XMLTag::reverbAmount);
+}
+
+TEST(XMLTag, unknownNames) {
+	CHECK(xmlTagFromName("") == XMLTag::UNKNOWN);
+	CHECK(xmlTagFromName("notATag") == XMLTag::UNKNOWN);
+	CHECK(xmlTagFromName("osc") == XMLTag::UNKNOWN);   // Start of a tag
+	CHECK(xmlTagFromName("osc12") == XMLTag::UNKNOWN); // A tag, with more on the end
+	CHECK(xmlTagFromName("Osc1") == XMLTag::UNKNOWN);  // Case matters, as with strcmp()
+	CHECK(xmlTagFromName("xScrol") == XMLTag::UNKNOWN);
+	STRCMP_EQUAL("", xmlTagToName(XMLTag::UNKNOWN));
+}